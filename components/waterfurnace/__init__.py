@@ -1,28 +1,174 @@
+import logging
+
 import esphome.codegen as cg
 import esphome.config_validation as cv
+import esphome.final_validate as fv
 from esphome.components import binary_sensor as binary_sensor_comp
+from esphome.components import sensor as sensor_comp
 from esphome.components import uart
 from esphome import pins
 from esphome.const import (
+    CONF_ADDRESS,
+    CONF_HOST,
     CONF_ID,
+    CONF_PORT,
+    CONF_TYPE,
+    CONF_UART_ID,
     CONF_UPDATE_INTERVAL,
     CONF_FLOW_CONTROL_PIN,
     DEVICE_CLASS_CONNECTIVITY,
     ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_MILLISECOND,
+    UNIT_PERCENT,
 )
+from esphome.core import CORE, ID, coroutine_with_priority
+
+from . import poll_plan
+
+_LOGGER = logging.getLogger(__name__)
+
+DOMAIN = "waterfurnace"
 
 CONF_CONNECTED = "connected"
 
-DEPENDENCIES = ["uart"]
-MULTI_CONF = False
+MULTI_CONF = True
 
 CONF_WATERFURNACE_ID = "waterfurnace_id"
 CONF_CONNECTED_TIMEOUT = "connected_timeout"
+CONF_POLL_MODE = "poll_mode"
+CONF_MIN_POLL_GAP = "min_poll_gap"
+CONF_ADAPTIVE_POLLING = "adaptive_polling"
+CONF_FAST_INTERVAL = "fast_interval"
+CONF_SLOW_INTERVAL = "slow_interval"
+CONF_HOLD_TIME = "hold_time"
+CONF_BUS_TASK = "bus_task"
+CONF_PASSIVE = "passive"
+CONF_MAX_AGE = "max_age"
+CONF_TCP_SERVER = "tcp_server"
+CONF_ALLOW_WRITES = "allow_writes"
+CONF_TRANSPORT = "transport"
+CONF_CORE = "core"
+CONF_BUS_STATISTICS = "bus_statistics"
+CONF_PROFILE_DISPATCH = "profile_dispatch"
+CONF_DISPATCH_BUDGET = "dispatch_budget"
+CONF_PREBUILT_POLL_PLAN = "prebuilt_poll_plan"
+CONF_CAPTURE = "capture"
+CONF_BUFFER_SIZE = "buffer_size"
+CONF_FREEZE_FRAME = "freeze_frame"
+CONF_SNAPSHOTS = "snapshots"
+CONF_REGISTERS = "registers"
+
+UNIT_BYTES = "B"
+
+
+def AUTO_LOAD():
+    # Sockets only for hubs behind a network gateway or serving Modbus TCP;
+    # a plain UART hub builds without the socket component
+    hubs = (getattr(CORE, "raw_config", None) or {}).get(DOMAIN, [])
+    if isinstance(hubs, dict):
+        hubs = [hubs]
+    if any(
+        isinstance(hub, dict) and (CONF_TCP_SERVER in hub or CONF_TRANSPORT in hub)
+        for hub in hubs
+    ):
+        return ["sensor", "socket"]
+    return ["sensor"]
+
 
 waterfurnace_ns = cg.esphome_ns.namespace("waterfurnace")
 WaterFurnace = waterfurnace_ns.class_(
     "WaterFurnace", cg.PollingComponent, uart.UARTDevice
 )
+BusArbiter = waterfurnace_ns.class_("BusArbiter")
+ModbusTcpServer = waterfurnace_ns.class_("ModbusTcpServer", cg.Component)
+TcpTransport = waterfurnace_ns.class_("TcpTransport")
+TcpFraming = TcpTransport.enum("Framing", is_class=True)
+TRANSPORT_FRAMINGS = {
+    "modbus_tcp": TcpFraming.MBAP,
+    "rtu_over_tcp": TcpFraming.RTU,
+}
+
+# Register metadata enums (registers.h); codegen passes these directly so
+# entities keep no per-instance strings
+RegisterCapability = waterfurnace_ns.enum("RegisterCapability", is_class=True)
+CAPABILITIES = {
+    "none": RegisterCapability.NONE,
+    "awl_thermostat": RegisterCapability.AWL_THERMOSTAT,
+    "awl_axb": RegisterCapability.AWL_AXB,
+    "awl_communicating": RegisterCapability.AWL_COMMUNICATING,
+    "axb": RegisterCapability.AXB,
+    "refrigeration": RegisterCapability.REFRIGERATION,
+    "energy": RegisterCapability.ENERGY,
+    "vs_drive": RegisterCapability.VS_DRIVE,
+    "iz2": RegisterCapability.IZ2,
+}
+
+RegisterType = waterfurnace_ns.enum("RegisterType", is_class=True)
+REGISTER_TYPES = {
+    "unsigned": RegisterType.UNSIGNED,
+    "signed": RegisterType.SIGNED,
+    "tenths": RegisterType.TENTHS,
+    "signed_tenths": RegisterType.SIGNED_TENTHS,
+    "hundredths": RegisterType.HUNDREDTHS,
+    "boolean": RegisterType.BOOLEAN,
+    "uint32": RegisterType.UINT32,
+    "int32": RegisterType.INT32,
+}
+
+PollMode = waterfurnace_ns.enum("PollMode", is_class=True)
+POLL_MODES = {
+    "burst": PollMode.BURST,
+    "paced": PollMode.PACED,
+}
+
+BusStatSensor = waterfurnace_ns.enum("BusStatSensor", is_class=True)
+
+
+def _counter_schema(icon, unit=None):
+    return sensor_comp.sensor_schema(
+        unit_of_measurement=unit,
+        icon=icon,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+
+def _gauge_schema(icon, unit=None, accuracy_decimals=0):
+    return sensor_comp.sensor_schema(
+        unit_of_measurement=unit,
+        icon=icon,
+        accuracy_decimals=accuracy_decimals,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+
+
+# key: (BusStatSensor, schema)
+BUS_STAT_SENSORS = {
+    "tx_bytes": (BusStatSensor.TX_BYTES, _counter_schema("mdi:upload", UNIT_BYTES)),
+    "rx_bytes": (BusStatSensor.RX_BYTES, _counter_schema("mdi:download", UNIT_BYTES)),
+    "transactions": (BusStatSensor.TRANSACTIONS, _counter_schema("mdi:swap-horizontal")),
+    "crc_errors": (BusStatSensor.CRC_ERRORS, _counter_schema("mdi:alert-circle-outline")),
+    "exceptions": (BusStatSensor.EXCEPTIONS, _counter_schema("mdi:alert-circle-outline")),
+    "timeouts": (BusStatSensor.TIMEOUTS, _counter_schema("mdi:timer-alert-outline")),
+    "value_count_mismatches": (
+        BusStatSensor.VALUE_COUNT_MISMATCHES,
+        _counter_schema("mdi:alert-circle-outline"),
+    ),
+    "rtt_min": (BusStatSensor.RTT_MIN, _gauge_schema("mdi:timer-outline", UNIT_MILLISECOND)),
+    "rtt_p50": (BusStatSensor.RTT_P50, _gauge_schema("mdi:timer-outline", UNIT_MILLISECOND)),
+    "rtt_p99": (BusStatSensor.RTT_P99, _gauge_schema("mdi:timer-outline", UNIT_MILLISECOND)),
+    "rtt_max": (BusStatSensor.RTT_MAX, _gauge_schema("mdi:timer-outline", UNIT_MILLISECOND)),
+    "bus_utilization": (
+        BusStatSensor.BUS_UTILIZATION,
+        _gauge_schema("mdi:gauge", UNIT_PERCENT, accuracy_decimals=1),
+    ),
+    "queue_depth": (BusStatSensor.QUEUE_DEPTH, _gauge_schema("mdi:tray-full")),
+    "deadline_misses": (BusStatSensor.DEADLINE_MISSES, _counter_schema("mdi:clock-alert-outline")),
+}
 
 WATERFURNACE_CLIENT_SCHEMA = cv.Schema(
     {
@@ -30,10 +176,68 @@ WATERFURNACE_CLIENT_SCHEMA = cv.Schema(
     }
 )
 
-CONFIG_SCHEMA = (
+
+def add_poll_registers(parent_id, registers):
+    """Record the (address, capability, when) listeners a child platform will
+    register, so the hub can plan its poll groups at build time."""
+    hubs = CORE.data.setdefault(DOMAIN, {}).setdefault("registers", {})
+    hubs.setdefault(str(parent_id), []).extend(registers)
+
+
+TRANSPORT_SCHEMA = cv.typed_schema(
+    {
+        # Modbus TCP gateway: MBAP framing, the slave address becomes the unit id
+        "modbus_tcp": cv.Schema(
+            {
+                cv.GenerateID(): cv.declare_id(TcpTransport),
+                cv.Required(CONF_HOST): cv.domain,
+                cv.Optional(CONF_PORT, default=502): cv.port,
+            }
+        ),
+        # Transparent serial bridge (ser2net and the like): RTU frames unchanged
+        "rtu_over_tcp": cv.Schema(
+            {
+                cv.GenerateID(): cv.declare_id(TcpTransport),
+                cv.Required(CONF_HOST): cv.domain,
+                cv.Required(CONF_PORT): cv.port,
+            }
+        ),
+    },
+    lower=True,
+)
+
+
+def _default_uart(config):
+    # Without a network transport the hub needs a UART; like UART_DEVICE_SCHEMA,
+    # an omitted uart_id picks the only one configured
+    if isinstance(config, dict) and CONF_TRANSPORT not in config:
+        config.setdefault(CONF_UART_ID, None)
+    return config
+
+
+def _validate_transport(config):
+    transport = config.get(CONF_TRANSPORT)
+    if transport is None:
+        return config
+    for key in (CONF_UART_ID, CONF_FLOW_CONTROL_PIN, CONF_BUS_TASK):
+        if key in config:
+            raise cv.Invalid(f"{key} cannot be used with a network transport", path=[key])
+    if CONF_PASSIVE in config and transport[CONF_TYPE] == "modbus_tcp":
+        # A Modbus TCP gateway only returns answers to our own requests
+        raise cv.Invalid(
+            "passive needs every byte on the bus; use rtu_over_tcp", path=[CONF_PASSIVE]
+        )
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    _default_uart,
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(WaterFurnace),
+            cv.Optional(CONF_ADDRESS, default=1): cv.int_range(min=1, max=247),
+            cv.Optional(CONF_UART_ID): cv.use_id(uart.UARTComponent),
+            cv.Optional(CONF_TRANSPORT): TRANSPORT_SCHEMA,
             cv.Optional(CONF_FLOW_CONTROL_PIN): pins.gpio_output_pin_schema,
             cv.Optional(CONF_CONNECTED): binary_sensor_comp.binary_sensor_schema(
                 device_class=DEVICE_CLASS_CONNECTIVITY,
@@ -43,17 +247,143 @@ CONFIG_SCHEMA = (
             cv.Optional(
                 CONF_CONNECTED_TIMEOUT, default="30s"
             ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_POLL_MODE, default="burst"): cv.enum(
+                POLL_MODES, lower=True
+            ),
+            cv.Optional(
+                CONF_MIN_POLL_GAP, default="50ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_ADAPTIVE_POLLING): cv.Schema(
+                {
+                    cv.Optional(
+                        CONF_FAST_INTERVAL, default="2s"
+                    ): cv.positive_time_period_milliseconds,
+                    cv.Optional(
+                        CONF_SLOW_INTERVAL, default="60s"
+                    ): cv.positive_time_period_milliseconds,
+                    cv.Optional(
+                        CONF_HOLD_TIME, default="30s"
+                    ): cv.positive_time_period_milliseconds,
+                }
+            ),
+            cv.Optional(CONF_BUS_TASK): cv.All(
+                cv.Schema(
+                    {
+                        cv.Optional(CONF_CORE, default=0): cv.int_range(min=0, max=1),
+                    }
+                ),
+                cv.only_on_esp32,
+            ),
+            cv.Optional(CONF_PASSIVE): cv.Schema(
+                {
+                    cv.Optional(CONF_MAX_AGE): cv.positive_time_period_milliseconds,
+                }
+            ),
+            cv.Optional(CONF_TCP_SERVER): cv.Schema(
+                {
+                    cv.GenerateID(): cv.declare_id(ModbusTcpServer),
+                    cv.Optional(CONF_PORT, default=502): cv.port,
+                    cv.Optional(CONF_MAX_AGE): cv.positive_time_period_milliseconds,
+                    # Any client on the network could change setpoints and configuration
+                    cv.Optional(CONF_ALLOW_WRITES, default=False): cv.boolean,
+                }
+            ),
+            cv.Optional(
+                CONF_DISPATCH_BUDGET, default="0ms"
+            ): cv.positive_time_period_microseconds,
+            cv.Optional(CONF_PROFILE_DISPATCH, default=False): cv.boolean,
+            cv.Optional(CONF_PREBUILT_POLL_PLAN, default=True): cv.boolean,
+            cv.Optional(CONF_CAPTURE): cv.Schema(
+                {
+                    cv.Optional(CONF_BUFFER_SIZE, default=8192): cv.int_range(
+                        min=512, max=262144
+                    ),
+                }
+            ),
+            # Snapshot the registers (default: FreezeFrame::DEFAULT_REGISTERS)
+            # as soon as REG_LAST_FAULT shows a new fault or a lockout
+            cv.Optional(CONF_FREEZE_FRAME): cv.Schema(
+                {
+                    cv.Optional(CONF_SNAPSHOTS, default=4): cv.int_range(
+                        min=1, max=16
+                    ),
+                    cv.Optional(CONF_REGISTERS): cv.All(
+                        cv.ensure_list(cv.uint16_t), cv.Length(min=1, max=64)
+                    ),
+                }
+            ),
+            cv.Optional(CONF_BUS_STATISTICS): cv.Schema(
+                {cv.Optional(key): schema for key, (_, schema) in BUS_STAT_SENSORS.items()}
+            ),
         }
     )
-    .extend(cv.polling_component_schema("10s"))
-    .extend(uart.UART_DEVICE_SCHEMA)
+    .extend(cv.polling_component_schema("10s")),
+    # The bus task owns the UART, so it cannot listen between transactions
+    cv.has_at_most_one_key(CONF_PASSIVE, CONF_BUS_TASK),
+    _validate_transport,
 )
 
+MAX_HUBS_PER_BUS = 8  # BusArbiter::MAX_CLIENTS
+
+
+def _hubs_on_bus(hubs, uart_id):
+    return [
+        hub for hub in hubs if CONF_UART_ID in hub and str(hub[CONF_UART_ID]) == str(uart_id)
+    ]
+
+
+def _final_validate(config):
+    if CONF_UART_ID not in config:
+        return config  # Each network transport has its own connection
+    hubs = fv.full_config.get()[DOMAIN]
+    shared = _hubs_on_bus(hubs, config[CONF_UART_ID])
+    if len(shared) < 2:
+        return config
+    if len(shared) > MAX_HUBS_PER_BUS:
+        raise cv.Invalid(f"At most {MAX_HUBS_PER_BUS} hubs can share one UART")
+    addresses = [hub[CONF_ADDRESS] for hub in shared]
+    if addresses.count(config[CONF_ADDRESS]) > 1:
+        raise cv.Invalid(
+            f"Address {config[CONF_ADDRESS]} is used by more than one hub on this UART",
+            path=[CONF_ADDRESS],
+        )
+    for key in (CONF_BUS_TASK, CONF_PASSIVE):
+        if key in config:
+            raise cv.Invalid(
+                f"{key} cannot be used when several hubs share a UART", path=[key]
+            )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
-    await uart.register_uart_device(var, config)
+    cg.add(var.set_address(config[CONF_ADDRESS]))
+
+    if CONF_TRANSPORT in config:
+        conf = config[CONF_TRANSPORT]
+        transport = cg.new_Pvariable(conf[CONF_ID], TRANSPORT_FRAMINGS[conf[CONF_TYPE]])
+        cg.add(transport.set_host(str(conf[CONF_HOST])))
+        cg.add(transport.set_port(conf[CONF_PORT]))
+        cg.add(var.set_transport(transport))
+    else:
+        await uart.register_uart_device(var, config)
+
+    hubs = CORE.config[DOMAIN]
+    if CONF_UART_ID in config and len(_hubs_on_bus(hubs, config[CONF_UART_ID])) > 1:
+        # One arbiter per UART, created by the first hub on it
+        arbiters = CORE.data.setdefault(DOMAIN, {}).setdefault("arbiters", {})
+        uart_id = str(config[CONF_UART_ID])
+        if uart_id not in arbiters:
+            arbiters[uart_id] = cg.new_Pvariable(
+                ID(f"{uart_id}_waterfurnace_arbiter", is_declaration=True, type=BusArbiter)
+            )
+        cg.add(var.set_bus_arbiter(arbiters[uart_id]))
+    if len(hubs) > 1:
+        cg.add(var.set_service_suffix(f"_{config[CONF_ID]}"))
 
     if CONF_FLOW_CONTROL_PIN in config:
         pin = await cg.gpio_pin_expression(config[CONF_FLOW_CONTROL_PIN])
@@ -64,3 +394,83 @@ async def to_code(config):
         cg.add(var.set_connected_sensor(sens))
 
     cg.add(var.set_connected_timeout(config[CONF_CONNECTED_TIMEOUT]))
+    cg.add(var.set_poll_mode(config[CONF_POLL_MODE]))
+    cg.add(var.set_min_poll_gap(config[CONF_MIN_POLL_GAP]))
+    cg.add(var.set_dispatch_budget(config[CONF_DISPATCH_BUDGET]))
+
+    if CONF_ADAPTIVE_POLLING in config:
+        conf = config[CONF_ADAPTIVE_POLLING]
+        cg.add(
+            var.set_adaptive_polling(
+                conf[CONF_FAST_INTERVAL], conf[CONF_SLOW_INTERVAL], conf[CONF_HOLD_TIME]
+            )
+        )
+
+    if CONF_BUS_TASK in config:
+        cg.add(var.set_bus_task_core(config[CONF_BUS_TASK][CONF_CORE]))
+
+    if CONF_PASSIVE in config:
+        max_age = config[CONF_PASSIVE].get(CONF_MAX_AGE)
+        cg.add(var.set_passive(max_age.total_milliseconds if max_age is not None else 0))
+
+    if CONF_TCP_SERVER in config or CONF_TRANSPORT in config:
+        cg.add_define("USE_WATERFURNACE_TCP")
+
+    if CONF_TCP_SERVER in config:
+        conf = config[CONF_TCP_SERVER]
+        server = cg.new_Pvariable(conf[CONF_ID], var)
+        await cg.register_component(server, conf)
+        cg.add(server.set_port(conf[CONF_PORT]))
+        if CONF_MAX_AGE in conf:
+            cg.add(server.set_max_age(conf[CONF_MAX_AGE]))
+        if conf[CONF_ALLOW_WRITES]:
+            cg.add(server.set_allow_writes(True))
+
+    if config[CONF_PROFILE_DISPATCH]:
+        cg.add_define("USE_WATERFURNACE_DISPATCH_PROFILING")
+
+    if CONF_CAPTURE in config:
+        cg.add(var.set_capture_buffer_size(config[CONF_CAPTURE][CONF_BUFFER_SIZE]))
+
+    if CONF_FREEZE_FRAME in config:
+        conf = config[CONF_FREEZE_FRAME]
+        cg.add(var.set_freeze_frame_depth(conf[CONF_SNAPSHOTS]))
+        if CONF_REGISTERS in conf:
+            cg.add(var.set_freeze_frame_registers(conf[CONF_REGISTERS]))
+        # The hub listens on the last fault register itself
+        add_poll_registers(config[CONF_ID], [(25, "none", None)])
+
+    if CONF_BUS_STATISTICS in config:
+        conf = config[CONF_BUS_STATISTICS]
+        for key, (which, _) in BUS_STAT_SENSORS.items():
+            if key in conf:
+                sens = await sensor_comp.new_sensor(conf[key])
+                cg.add(var.set_bus_stat_sensor(which, sens))
+
+    if config[CONF_PREBUILT_POLL_PLAN]:
+        CORE.add_job(_generate_poll_plan, var, config)
+
+
+@coroutine_with_priority(-100.0)
+async def _generate_poll_plan(var, config):
+    # Runs after every child platform has reported its registers
+    hub_id = str(config[CONF_ID])
+    registers = CORE.data.get(DOMAIN, {}).get("registers", {}).get(hub_id, [])
+    plans, variants = poll_plan.plan_variants(
+        registers, CONF_ADAPTIVE_POLLING in config
+    )
+    prefix = f"{hub_id}_poll"
+    cg.add_global(
+        cg.RawStatement(
+            poll_plan.render_cpp(prefix, plans, variants, config[CONF_ADDRESS])
+        )
+    )
+    cg.add(
+        var.set_poll_plans(
+            cg.RawExpression(f"{prefix}_plans"),
+            cg.RawExpression(f"{prefix}_variants"),
+            len(variants),
+        )
+    )
+    for line in poll_plan.report(plans, variants):
+        _LOGGER.info("%s: %s", hub_id, line)
@@ -7,7 +7,7 @@ from esphome.const import (
     DEVICE_CLASS_RUNNING,
     ENTITY_CATEGORY_DIAGNOSTIC,
 )
-from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA
+from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA, CAPABILITIES, add_poll_registers
 
 DEPENDENCIES = ["waterfurnace"]
 
@@ -125,4 +125,5 @@ async def to_code(config):
         cg.add(var.set_parent(parent))
         cg.add(var.set_register_address(register))
         cg.add(var.set_bitmask(bitmask))
-        cg.add(var.set_capability(capability))
+        cg.add(var.set_capability(CAPABILITIES[capability]))
+        add_poll_registers(config[CONF_WATERFURNACE_ID], [(register, capability, None)])
@@ -16,7 +16,7 @@ class WaterFurnaceBinarySensor : public binary_sensor::BinarySensor, public Comp
   void set_parent(WaterFurnace *parent) { parent_ = parent; }
   void set_register_address(uint16_t addr) { register_address_ = addr; }
   void set_bitmask(uint16_t mask) { bitmask_ = mask; }
-  void set_capability(const std::string &cap) { capability_ = capability_from_string(cap.c_str()); }
+  void set_capability(RegisterCapability cap) { capability_ = cap; }
 
  protected:
   WaterFurnace *parent_{nullptr};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Shares one RS-485 bus between several hubs, one per ABC slave address.
+/// A hub holds the bus from sending a request until its response, error or
+/// timeout has been handled. When the bus is released, the waiting hubs are
+/// served round-robin starting after the previous owner, so a hub with a long
+/// queue cannot starve the others.
+class BusArbiter {
+ public:
+  static constexpr uint8_t MAX_CLIENTS = 8;
+  static constexpr uint8_t NO_CLIENT = 0xFF;
+
+  /// Slot for a new hub, or NO_CLIENT if all slots are taken
+  uint8_t add_client() { return this->num_clients_ < MAX_CLIENTS ? this->num_clients_++ : NO_CLIENT; }
+  uint8_t num_clients() const { return this->num_clients_; }
+  uint8_t owner() const { return this->owner_; }
+
+  /// Take the bus for `client`. Returns false (and queues the client for its
+  /// turn) while another hub holds it or has an earlier turn.
+  bool acquire(uint8_t client) {
+    if (client >= this->num_clients_)
+      return false;
+    if (this->owner_ == client)
+      return true;
+    this->waiting_ |= 1u << client;
+    if (this->owner_ != NO_CLIENT)
+      return false;
+    for (uint8_t i = 0; i < this->num_clients_; i++) {
+      uint8_t candidate = (this->next_ + i) % this->num_clients_;
+      if (this->waiting_ & (1u << candidate)) {
+        if (candidate != client)
+          return false;
+        break;
+      }
+    }
+    this->owner_ = client;
+    this->waiting_ &= ~(1u << client);
+    return true;
+  }
+
+  /// Drop a queued request for the bus (the hub found nothing left to send)
+  void withdraw(uint8_t client) {
+    if (client < this->num_clients_)
+      this->waiting_ &= ~(1u << client);
+  }
+
+  void release(uint8_t client) {
+    if (this->owner_ != client)
+      return;
+    this->owner_ = NO_CLIENT;
+    this->next_ = (client + 1) % this->num_clients_;
+  }
+
+ protected:
+  uint8_t num_clients_{0};
+  uint8_t owner_{NO_CLIENT};
+  uint8_t next_{0};     // First client considered at the next grant
+  uint8_t waiting_{0};  // Bit per client that asked for the bus and has not had it yet
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,195 @@
+#include "bus_capture.h"
+#include "protocol.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace waterfurnace {
+
+namespace {
+
+const uint8_t MAGIC[4] = {'W', 'F', 'C', '1'};
+// TIME record: type, delta 0, length 4, micros()
+const size_t TIME_RECORD_SIZE = 7;
+
+size_t put_varint(uint8_t *out, uint32_t value) {
+  size_t n = 0;
+  while (value >= 0x80) {
+    out[n++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  out[n++] = value;
+  return n;
+}
+
+void put_u32(uint8_t *out, uint32_t value) {
+  for (int i = 0; i < 4; i++)
+    out[i] = (value >> (8 * i)) & 0xFF;
+}
+
+uint32_t get_u32(const uint8_t *in) { return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24); }
+
+}  // namespace
+
+void BusCapture::begin() {
+  if (this->size_ > 0 && this->ring_ == nullptr)
+    this->ring_.reset(new uint8_t[this->size_]);
+}
+
+size_t BusCapture::encode_(uint8_t *out, Record type, uint32_t delta_us, const uint8_t *data, size_t len) {
+  size_t n = 0;
+  out[n++] = static_cast<uint8_t>(type);
+  n += put_varint(out + n, delta_us);
+  n += put_varint(out + n, len);
+  memcpy(out + n, data, len);
+  return n + len;
+}
+
+void BusCapture::record(Record type, const uint8_t *data, size_t len, uint32_t now_us, bool setup) {
+  if (this->ring_ == nullptr || len == 0 || len > MAX_FRAME_SIZE)
+    return;
+  uint8_t encoded[1 + 5 + 5 + MAX_FRAME_SIZE];
+  this->records_++;
+
+  if (setup) {
+    if (this->setup_used_ == 0)
+      this->setup_first_us_ = this->setup_last_us_ = now_us;
+    size_t n = encode_(encoded, type, now_us - this->setup_last_us_, data, len);
+    if (this->setup_used_ + n > SETUP_SIZE) {
+      this->dropped_++;
+      return;
+    }
+    memcpy(this->setup_ + this->setup_used_, encoded, n);
+    this->setup_used_ += n;
+    this->setup_last_us_ = now_us;
+    return;
+  }
+
+  if (this->used_ == 0)
+    this->ring_base_us_ = this->ring_last_us_ = now_us;
+  size_t n = encode_(encoded, type, now_us - this->ring_last_us_, data, len);
+  if (n > this->size_) {
+    this->dropped_++;
+    return;
+  }
+  while (this->used_ + n > this->size_)
+    this->drop_oldest_();
+  size_t head = (this->tail_ + this->used_) % this->size_;
+  size_t first = std::min(n, this->size_ - head);
+  memcpy(&this->ring_[head], encoded, first);
+  memcpy(&this->ring_[0], encoded + first, n - first);
+  this->used_ += n;
+  this->ring_last_us_ = now_us;
+}
+
+size_t BusCapture::ring_record_(size_t index, uint32_t &delta_us) const {
+  size_t pos = index + 1;  // Past the type
+  uint32_t values[2] = {0, 0};
+  for (auto &value : values) {
+    for (int shift = 0;; shift += 7) {
+      uint8_t b = this->ring_at_(pos++);
+      value |= static_cast<uint32_t>(b & 0x7F) << shift;
+      if ((b & 0x80) == 0)
+        break;
+    }
+  }
+  delta_us = values[0];
+  return pos - index + values[1];
+}
+
+void BusCapture::drop_oldest_() {
+  uint32_t delta_us;
+  size_t n = this->ring_record_(0, delta_us);
+  this->ring_base_us_ += delta_us;
+  this->tail_ = (this->tail_ + n) % this->size_;
+  this->used_ -= n;
+  this->dropped_++;
+}
+
+size_t BusCapture::file_size() const {
+  return HEADER_SIZE + this->setup_used_ + (this->used_ > 0 ? TIME_RECORD_SIZE + this->used_ : 0);
+}
+
+uint8_t BusCapture::file_byte_(size_t offset) const {
+  if (offset < HEADER_SIZE) {
+    uint8_t header[HEADER_SIZE] = {MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3], this->slave_, 0, 0, 0};
+    put_u32(header + 8, this->setup_used_ > 0 ? this->setup_first_us_ : this->ring_base_us_);
+    return header[offset];
+  }
+  offset -= HEADER_SIZE;
+  if (offset < this->setup_used_)
+    return this->setup_[offset];
+  offset -= this->setup_used_;
+  if (offset < TIME_RECORD_SIZE) {
+    uint8_t time[TIME_RECORD_SIZE] = {static_cast<uint8_t>(Record::TIME), 0, 4};
+    put_u32(time + 3, this->ring_base_us_);
+    return time[offset];
+  }
+  return this->ring_at_(offset - TIME_RECORD_SIZE);
+}
+
+size_t BusCapture::read(size_t offset, uint8_t *buf, size_t len) const {
+  size_t total = this->file_size();
+  size_t n = 0;
+  for (; n < len && offset + n < total; n++)
+    buf[n] = this->file_byte_(offset + n);
+  return n;
+}
+
+bool CaptureReader::open(const uint8_t *data, size_t len) {
+  if (len < BusCapture::HEADER_SIZE || memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+    return false;
+  this->data_ = data;
+  this->len_ = len;
+  this->pos_ = BusCapture::HEADER_SIZE;
+  this->slave_ = data[4];
+  this->last_us_ = get_u32(data + 8);
+  this->now_us_ = 0;
+  return true;
+}
+
+bool CaptureReader::varint_(uint32_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 35 && this->pos_ < this->len_; shift += 7) {
+    uint8_t b = this->data_[this->pos_++];
+    value |= static_cast<uint32_t>(b & 0x7F) << shift;
+    if ((b & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+bool CaptureReader::next(Entry &entry) {
+  while (this->pos_ < this->len_) {
+    uint8_t type = this->data_[this->pos_++];
+    uint32_t delta_us, len;
+    if (!this->varint_(delta_us) || !this->varint_(len) || len > this->len_ - this->pos_)
+      return false;
+    const uint8_t *data = this->data_ + this->pos_;
+    this->pos_ += len;
+    this->now_us_ += delta_us;
+    this->last_us_ += delta_us;
+
+    switch (static_cast<BusCapture::Record>(type)) {
+      case BusCapture::Record::TX:
+      case BusCapture::Record::RX:
+        entry = {static_cast<BusCapture::Record>(type), this->now_us_, data, len};
+        return true;
+      case BusCapture::Record::TIME:
+        if (len == 4) {
+          uint32_t base = get_u32(data);
+          this->now_us_ += base - this->last_us_;
+          this->last_us_ = base;
+        }
+        break;
+      default:
+        // Unknown record types are skipped
+        break;
+    }
+  }
+  return false;
+}
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Flight recorder for the hub's bus traffic: every request it sends and
+/// every response frame it receives (CRC errors included; raw chunks of
+/// bytes in passive mode), with micros() timestamps, in a fixed RAM
+/// ring that drops the oldest records when full. The frames of the setup
+/// exchange (system identification and component detection) are kept apart
+/// and never overwritten, so any capture can be replayed from setup on.
+///
+/// Capture file format (all integers little-endian):
+///
+///   header  "WFC1", slave address (1 byte), 3 reserved bytes,
+///           micros() the first record's delta counts from (4 bytes)
+///   record  type (1 byte), µs since the previous record (varint),
+///           length (varint), `length` bytes
+///
+/// Varints are LEB128: 7 bits per byte, low bits first, high bit set on
+/// every byte but the last. A TIME record carries a 4-byte micros() that
+/// the next record's delta counts from. It sits where the setup frames end
+/// and the ring begins; records in between may have been dropped, and the
+/// gap is only known modulo micros() wrapping (71 minutes).
+class BusCapture {
+ public:
+  enum class Record : uint8_t {
+    TX = 0,    // A request the hub sent
+    RX = 1,    // A received frame, or bytes as they arrived
+    TIME = 2,  // micros() the next record's delta counts from
+  };
+
+  static constexpr size_t HEADER_SIZE = 12;
+  static constexpr size_t SETUP_SIZE = 256;
+
+  /// Ring size in bytes; 0 (the default) disables capture
+  void set_buffer_size(size_t size) { this->size_ = size; }
+  size_t buffer_size() const { return this->size_; }
+  void set_slave(uint8_t slave) { this->slave_ = slave; }
+  /// Allocate the ring, once, from setup()
+  void begin();
+  bool enabled() const { return this->ring_ != nullptr; }
+
+  /// Record a frame, or a chunk of bytes. `setup` records go to the setup
+  /// area, the rest to the ring.
+  void record(Record type, const uint8_t *data, size_t len, uint32_t now_us, bool setup);
+  /// Forget the setup frames, when setup starts over
+  void restart_setup() { this->setup_used_ = 0; }
+
+  uint32_t records() const { return this->records_; }
+  uint32_t dropped() const { return this->dropped_; }
+
+  /// Size of the capture file, and random access to its bytes
+  size_t file_size() const;
+  size_t read(size_t offset, uint8_t *buf, size_t len) const;
+
+ protected:
+  static size_t encode_(uint8_t *out, Record type, uint32_t delta_us, const uint8_t *data, size_t len);
+  uint8_t ring_at_(size_t index) const { return this->ring_[(this->tail_ + index) % this->size_]; }
+  // Decode the record header at ring offset `index`; returns the record's total size
+  size_t ring_record_(size_t index, uint32_t &delta_us) const;
+  void drop_oldest_();
+  uint8_t file_byte_(size_t offset) const;
+
+  uint8_t slave_{1};
+  uint8_t setup_[SETUP_SIZE];
+  size_t setup_used_{0};
+  uint32_t setup_first_us_{0};
+  uint32_t setup_last_us_{0};
+
+  std::unique_ptr<uint8_t[]> ring_;
+  size_t size_{0};
+  size_t tail_{0};  // Oldest record
+  size_t used_{0};
+  uint32_t ring_base_us_{0};  // micros() the oldest record's delta counts from
+  uint32_t ring_last_us_{0};
+  bool ring_empty_{true};
+
+  uint32_t records_{0};
+  uint32_t dropped_{0};
+};
+
+/// Walks the records of a capture file
+class CaptureReader {
+ public:
+  struct Entry {
+    BusCapture::Record type;
+    uint64_t at_us;  // Since the start of the capture, across TIME records and micros() wraps
+    const uint8_t *data;
+    size_t len;
+  };
+
+  /// False if `data` does not start with a capture header
+  bool open(const uint8_t *data, size_t len);
+  uint8_t slave() const { return this->slave_; }
+  /// The next TX or RX record; false at the end, or at a truncated record
+  bool next(Entry &entry);
+
+ protected:
+  bool varint_(uint32_t &value);
+
+  const uint8_t *data_{nullptr};
+  size_t len_{0};
+  size_t pos_{0};
+  uint8_t slave_{0};
+  uint64_t now_us_{0};
+  uint32_t last_us_{0};  // micros() of the last record
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,196 @@
+#include "bus_sniffer.h"
+
+namespace esphome {
+namespace waterfurnace {
+
+namespace {
+
+// Smallest length (from `first` in steps of `step`) at which the buffer holds
+// a CRC-valid frame, or 0. The CRC runs over the buffer once.
+size_t find_crc_length(const uint8_t *data, size_t avail, size_t first, size_t step) {
+  uint16_t crc = 0xFFFF;
+  size_t crc_len = 0;
+  for (size_t len = first; len <= avail && len <= MAX_FRAME_SIZE; len += step) {
+    for (; crc_len < len - 2; crc_len++) {
+      crc ^= data[crc_len];
+      for (int bit = 0; bit < 8; bit++)
+        crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+    if (data[len - 2] == (crc & 0xFF) && data[len - 1] == (crc >> 8))
+      return len;
+  }
+  return 0;
+}
+
+}  // namespace
+
+bool BusSniffer::feed(const uint8_t *data, size_t len, uint32_t now) {
+  if (len > 0) {
+    // A long silence ends whatever partial frame was buffered
+    if (this->head_ < this->buffer_.size() && now - this->last_byte_time_ > RESYNC_TIME) {
+      this->dropped_bytes_ += this->buffer_.size() - this->head_;
+      this->head_ = this->buffer_.size();
+    }
+    this->buffer_.insert(this->buffer_.end(), data, data + len);
+    this->last_byte_time_ = now;
+  }
+  this->values_.clear();
+
+  bool paired = false;
+  while (!paired && this->decode_(paired)) {
+  }
+
+  if (this->head_ == this->buffer_.size()) {
+    this->buffer_.clear();
+    this->head_ = 0;
+  } else if (this->head_ >= MAX_FRAME_SIZE) {
+    this->buffer_.erase(this->buffer_.begin(), this->buffer_.begin() + this->head_);
+    this->head_ = 0;
+  }
+  return paired;
+}
+
+bool BusSniffer::decode_(bool &paired) {
+  size_t avail = this->buffer_.size() - this->head_;
+  if (avail == 0)
+    return false;
+  const uint8_t *p = this->buffer_.data() + this->head_;
+  if (p[0] != this->slave_) {
+    this->consume_(1);
+    this->dropped_bytes_++;
+    return true;
+  }
+  if (avail < MIN_FRAME_SIZE)
+    return false;
+
+  Match match = Match::NONE;
+  if (this->pending_func_ != 0) {
+    match = this->decode_response_(paired);
+  } else if (p[1] == FUNC_READ_RANGES || p[1] == FUNC_READ_REGISTERS) {
+    // A response whose request we missed (started listening mid-transaction)
+    size_t size = get_response_frame_size(p, avail);
+    if (size <= avail && validate_frame_crc(p, size)) {
+      this->consume_(size);
+      return true;
+    }
+  }
+  // A complete request wins over a response that is still arriving: the
+  // other master may have given up on its last request and sent a new one
+  if (match == Match::FRAME || this->decode_request_())
+    return true;
+
+  // Wait for the rest of a frame that could still be valid
+  if (avail < MAX_FRAME_SIZE && (p[1] == FUNC_READ_RANGES || p[1] == FUNC_READ_REGISTERS ||
+                                 p[1] == FUNC_WRITE_REGISTERS || p[1] == FUNC_WRITE_SINGLE ||
+                                 (this->pending_func_ != 0 && p[1] == (this->pending_func_ | ERROR_MASK))))
+    return false;
+  this->consume_(1);
+  this->dropped_bytes_++;
+  return true;
+}
+
+BusSniffer::Match BusSniffer::decode_response_(bool &paired) {
+  const uint8_t *p = this->buffer_.data() + this->head_;
+  size_t avail = this->buffer_.size() - this->head_;
+  uint8_t func = p[1];
+
+  if (func == (this->pending_func_ | ERROR_MASK)) {
+    if (avail < 5)
+      return Match::INCOMPLETE;
+    if (!validate_frame_crc(p, 5))
+      return Match::NONE;
+    this->exceptions_++;
+    this->pending_func_ = 0;
+    this->consume_(5);
+    return Match::FRAME;
+  }
+  if (func != this->pending_func_)
+    return Match::NONE;
+  size_t size = get_response_frame_size(p, avail);
+  if (size < MIN_FRAME_SIZE || size > MAX_FRAME_SIZE)
+    return Match::NONE;
+  if (avail < size)
+    return Match::INCOMPLETE;
+  if (!validate_frame_crc(p, size))
+    return Match::NONE;
+
+  switch (func) {
+    case FUNC_READ_RANGES:
+    case FUNC_READ_REGISTERS:
+      if (p[2] == this->pending_addresses_.size() * 2) {
+        for (size_t i = 0; i < this->pending_addresses_.size(); i++)
+          this->values_.emplace_back(this->pending_addresses_[i], (p[3 + 2 * i] << 8) | p[4 + 2 * i]);
+        paired = true;
+      }
+      break;
+    case FUNC_WRITE_REGISTERS:
+      this->values_.assign(this->pending_writes_.begin(), this->pending_writes_.end());
+      paired = true;
+      break;
+    case FUNC_WRITE_SINGLE:
+      this->values_.emplace_back((p[2] << 8) | p[3], (p[4] << 8) | p[5]);
+      paired = true;
+      break;
+  }
+  if (paired)
+    this->frames_++;
+  this->pending_func_ = 0;
+  this->consume_(size);
+  return Match::FRAME;
+}
+
+bool BusSniffer::decode_request_() {
+  const uint8_t *p = this->buffer_.data() + this->head_;
+  size_t avail = this->buffer_.size() - this->head_;
+  size_t len = 0;
+  switch (p[1]) {
+    case FUNC_READ_RANGES:
+    case FUNC_WRITE_REGISTERS:
+      len = find_crc_length(p, avail, 8, 4);
+      break;
+    case FUNC_READ_REGISTERS:
+      len = find_crc_length(p, avail, 6, 2);
+      break;
+    case FUNC_WRITE_SINGLE:
+      len = find_crc_length(p, avail, 8, 8);
+      break;
+    default:
+      return false;
+  }
+  if (len == 0)
+    return false;
+  this->set_pending_(p, len);
+  this->consume_(len);
+  return true;
+}
+
+void BusSniffer::set_pending_(const uint8_t *frame, size_t len) {
+  const uint8_t *payload = frame + 2;
+  size_t payload_len = len - 4;
+  this->pending_func_ = frame[1];
+  this->pending_addresses_.clear();
+  this->pending_writes_.clear();
+  switch (frame[1]) {
+    case FUNC_READ_RANGES:
+      for (size_t i = 0; i + 4 <= payload_len; i += 4) {
+        uint16_t start = (payload[i] << 8) | payload[i + 1];
+        uint16_t count = (payload[i + 2] << 8) | payload[i + 3];
+        for (uint16_t j = 0; j < count && this->pending_addresses_.size() < MAX_FRAME_SIZE; j++)
+          this->pending_addresses_.push_back(start + j);
+      }
+      break;
+    case FUNC_READ_REGISTERS:
+      for (size_t i = 0; i + 2 <= payload_len; i += 2)
+        this->pending_addresses_.push_back((payload[i] << 8) | payload[i + 1]);
+      break;
+    case FUNC_WRITE_REGISTERS:
+      for (size_t i = 0; i + 4 <= payload_len; i += 4)
+        this->pending_writes_.emplace_back((payload[i] << 8) | payload[i + 1], (payload[i + 2] << 8) | payload[i + 3]);
+      break;
+  }
+}
+
+void BusSniffer::consume_(size_t len) { this->head_ += len; }
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "protocol.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Decodes another master's traffic on the bus. Requests to `slave` are
+/// recognised by their CRC, and the response that follows is paired with
+/// the request to recover register addresses for the returned values.
+/// Reads (func 65/66), multi-writes (func 67) and single writes (func 6) are
+/// understood; frames for other slaves are skipped.
+///
+/// Requests carry no length field, so the decoder tries each length the
+/// function code allows and takes the first with a valid CRC. Bytes that
+/// start no valid frame are dropped one at a time until the stream lines up.
+class BusSniffer {
+ public:
+  /// Longest gap inside a frame before partial bytes are thrown away
+  static constexpr uint32_t RESYNC_TIME = 50;
+
+  void set_slave(uint8_t slave) { this->slave_ = slave; }
+
+  /// Add received bytes. Returns true once a request/response pair has been
+  /// decoded; the (address, value) pairs are then in values() until the next
+  /// call. Call again with len 0 to continue decoding buffered bytes.
+  bool feed(const uint8_t *data, size_t len, uint32_t now);
+  /// Register values the last decoded pair carried
+  const std::vector<std::pair<uint16_t, uint16_t>> &values() const { return this->values_; }
+
+  uint32_t frames() const { return this->frames_; }                // Paired responses decoded
+  uint32_t exceptions() const { return this->exceptions_; }        // Exception responses seen
+  uint32_t dropped_bytes() const { return this->dropped_bytes_; }  // Bytes skipped while resyncing
+  /// millis() of the last byte seen on the bus
+  uint32_t last_activity() const { return this->last_byte_time_; }
+
+ protected:
+  enum class Match : uint8_t {
+    NONE,        // Not this kind of frame
+    INCOMPLETE,  // Could be, once more bytes arrive
+    FRAME,       // Decoded and consumed
+  };
+
+  // Try to decode a frame at the start of the buffer. Returns true if bytes
+  // were consumed; sets `paired` when a request/response pair completed.
+  bool decode_(bool &paired);
+  Match decode_response_(bool &paired);
+  bool decode_request_();
+  void set_pending_(const uint8_t *frame, size_t len);
+  void consume_(size_t len);
+
+  uint8_t slave_{SLAVE_ADDRESS};
+  std::vector<uint8_t> buffer_;
+  size_t head_{0};  // Start of undecoded bytes in buffer_
+  uint32_t last_byte_time_{0};
+
+  // Request waiting for its response
+  uint8_t pending_func_{0};
+  std::vector<uint16_t> pending_addresses_;
+  std::vector<std::pair<uint16_t, uint16_t>> pending_writes_;
+
+  std::vector<std::pair<uint16_t, uint16_t>> values_;
+  uint32_t frames_{0};
+  uint32_t exceptions_{0};
+  uint32_t dropped_bytes_{0};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
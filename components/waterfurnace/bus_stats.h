@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Round-trip time histogram with log-spaced buckets: 1 ms resolution below
+/// 8 ms, then four buckets per power of two up to 8191 ms (at most ~25% wide).
+/// Min and max are tracked exactly; percentiles report the upper edge of the
+/// bucket holding the requested sample, clamped to [min, max].
+class RttHistogram {
+ public:
+  void record(uint32_t ms) {
+    this->counts_[bucket_(ms)]++;
+    this->count_++;
+    if (ms < this->min_)
+      this->min_ = ms;
+    if (ms > this->max_)
+      this->max_ = ms;
+  }
+
+  uint32_t count() const { return this->count_; }
+  uint32_t min() const { return this->count_ ? this->min_ : 0; }
+  uint32_t max() const { return this->max_; }
+
+  uint32_t percentile(uint8_t pct) const {
+    if (this->count_ == 0)
+      return 0;
+    // Rank of the sample (1-based, rounded up) that pct% of samples are at or below
+    uint32_t rank = (static_cast<uint64_t>(this->count_) * pct + 99) / 100;
+    if (rank == 0)
+      rank = 1;
+    uint32_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+      seen += this->counts_[i];
+      if (seen >= rank) {
+        if (i == BUCKETS - 1)
+          return this->max_;  // Overflow bucket has no upper edge
+        uint32_t upper = bucket_upper_(i);
+        if (upper > this->max_)
+          return this->max_;
+        return upper < this->min_ ? this->min_ : upper;
+      }
+    }
+    return this->max_;
+  }
+
+  void reset() { *this = RttHistogram(); }
+
+  static constexpr size_t BUCKETS = 8 + 10 * 4;
+
+ protected:
+  static size_t bucket_(uint32_t ms) {
+    if (ms < 8)
+      return ms;
+    uint8_t exp = 31 - __builtin_clz(ms);  // ≥ 3
+    if (exp > 12)
+      return BUCKETS - 1;
+    uint8_t sub = (ms >> (exp - 2)) & 3;
+    return 8 + (exp - 3) * 4 + sub;
+  }
+
+  static uint32_t bucket_upper_(size_t idx) {
+    if (idx < 8)
+      return idx;
+    uint8_t exp = 3 + (idx - 8) / 4;
+    uint8_t sub = (idx - 8) % 4;
+    uint32_t lower = static_cast<uint32_t>(4 + sub) << (exp - 2);
+    return lower + (1u << (exp - 2)) - 1;
+  }
+
+  uint32_t counts_[BUCKETS]{};
+  uint32_t count_{0};
+  uint32_t min_{UINT32_MAX};
+  uint32_t max_{0};
+};
+
+/// Cumulative RS-485 link counters kept by the hub
+struct BusStats {
+  uint32_t tx_bytes{0};
+  uint32_t rx_bytes{0};
+  // Requests sent, per function code
+  uint32_t read_ranges{0};      // 65
+  uint32_t read_registers{0};   // 66
+  uint32_t write_registers{0};  // 67
+  uint32_t write_single{0};     // 6
+  uint32_t other_functions{0};
+  // Failures
+  uint32_t crc_errors{0};
+  uint32_t exceptions{0};
+  uint32_t timeouts{0};
+  uint32_t value_count_mismatches{0};
+  // Time with a request outstanding (response or timeout)
+  uint32_t busy_ms{0};
+  // Every completed transaction, including setup and writes
+  RttHistogram rtt;
+
+  uint32_t transactions() const {
+    return this->read_ranges + this->read_registers + this->write_registers + this->write_single +
+           this->other_functions;
+  }
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
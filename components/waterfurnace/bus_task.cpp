@@ -0,0 +1,160 @@
+#include "bus_task.h"
+#include "esphome/core/log.h"
+
+#include <cstring>
+
+#ifndef USE_ESP32
+#include <chrono>
+#endif
+
+namespace esphome {
+namespace waterfurnace {
+
+static const char *const BUS_TASK_TAG = "waterfurnace.bus_task";
+
+#ifdef USE_ESP32
+static constexpr uint32_t BUS_TASK_STACK_SIZE = 4096;
+static constexpr UBaseType_t BUS_TASK_PRIORITY = 5;  // Above the ESPHome loop task (1)
+
+void BusTask::task_entry_(void *arg) {
+  auto *task = static_cast<BusTask *>(arg);
+  task->run_();
+  task->running_.store(false, std::memory_order_release);
+  vTaskDelete(nullptr);
+}
+#endif
+
+bool BusTask::start(uint8_t core) {
+  if (this->is_running())
+    return true;
+  this->stop_requested_.store(false, std::memory_order_release);
+  this->running_.store(true, std::memory_order_release);
+#ifdef USE_ESP32
+  BaseType_t res = xTaskCreatePinnedToCore(&BusTask::task_entry_, "wf_bus", BUS_TASK_STACK_SIZE, this,
+                                           BUS_TASK_PRIORITY, &this->handle_, core);
+  if (res != pdPASS) {
+    this->running_.store(false, std::memory_order_release);
+    ESP_LOGE(BUS_TASK_TAG, "Failed to create bus task");
+    return false;
+  }
+#else
+  (void) core;
+  this->thread_ = std::thread([this]() {
+    this->run_();
+    this->running_.store(false, std::memory_order_release);
+  });
+#endif
+  return true;
+}
+
+void BusTask::stop() {
+  this->stop_requested_.store(true, std::memory_order_release);
+#ifndef USE_ESP32
+  if (this->thread_.joinable())
+    this->thread_.join();
+#endif
+}
+
+bool BusTask::submit(uint32_t seq, const uint8_t *data, size_t len) {
+  if (len > MAX_FRAME_SIZE)
+    return false;
+  BusRequest request;
+  request.seq = seq;
+  request.len = len;
+  memcpy(request.data, data, len);
+  if (!this->requests_.push(request))
+    return false;
+#ifdef USE_ESP32
+  if (this->handle_ != nullptr)
+    xTaskNotifyGive(this->handle_);
+#endif
+  return true;
+}
+
+void BusTask::run_() {
+  BusRequest request;
+  while (!this->stop_requested_.load(std::memory_order_acquire)) {
+    if (this->requests_.pop(request)) {
+      this->transact_(request);
+    } else {
+      this->wait_for_request_();
+    }
+  }
+}
+
+void BusTask::transact_(const BusRequest &request) {
+  // Discard anything left on the line from a previous (late or corrupt) response
+  uint8_t discard;
+  while (this->uart_->available())
+    this->uart_->read_byte(&discard);
+
+  if (this->flow_control_pin_ != nullptr)
+    this->flow_control_pin_->digital_write(true);
+  this->uart_->write_array(request.data, request.len);
+  this->uart_->flush();
+  if (this->flow_control_pin_ != nullptr)
+    this->flow_control_pin_->digital_write(false);
+
+  BusResponse response;
+  response.seq = request.seq;
+  response.len = 0;
+  uint32_t start = millis();
+
+  while (true) {
+    // Read byte-by-byte so trailing garbage stays on the line for the next discard
+    size_t expected = get_response_frame_size(response.data, response.len);
+    while ((expected == 0 || response.len < expected) && response.len < MAX_FRAME_SIZE &&
+           this->uart_->available()) {
+      if (this->uart_->read_byte(&response.data[response.len]))
+        response.len++;
+      expected = get_response_frame_size(response.data, response.len);
+    }
+
+    if (expected != 0 && response.len >= expected) {
+      response.status = validate_frame_crc(response.data, response.len) ? BusResponse::Status::OK
+                                                                          : BusResponse::Status::CRC_ERROR;
+      break;
+    }
+    if (response.len >= MAX_FRAME_SIZE) {
+      response.status = BusResponse::Status::CRC_ERROR;
+      break;
+    }
+    if (millis() - start > this->response_timeout_) {
+      response.status = BusResponse::Status::TIMEOUT;
+      break;
+    }
+    if (this->stop_requested_.load(std::memory_order_acquire))
+      return;
+    this->wait_for_bytes_();
+  }
+
+  this->deliver_(response);
+}
+
+void BusTask::deliver_(const BusResponse &response) {
+  // loop() drains responses every iteration, so a full queue is transient
+  while (!this->responses_.push(response)) {
+    if (this->stop_requested_.load(std::memory_order_acquire))
+      return;
+    this->wait_for_bytes_();
+  }
+}
+
+void BusTask::wait_for_request_() {
+#ifdef USE_ESP32
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+#else
+  std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+}
+
+void BusTask::wait_for_bytes_() {
+#ifdef USE_ESP32
+  vTaskDelay(1);
+#else
+  std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+}
+
+}  // namespace waterfurnace
+}  // namespace esphome
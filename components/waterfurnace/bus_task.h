@@ -0,0 +1,98 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#include "esphome/core/gpio.h"
+#include "esphome/core/hal.h"
+#include "esphome/components/uart/uart.h"
+#include "protocol.h"
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <vector>
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+
+namespace esphome {
+namespace waterfurnace {
+
+/// A request frame handed from loop() to the bus task
+struct BusRequest {
+  uint32_t seq{0};
+  uint16_t len{0};
+  uint8_t data[MAX_FRAME_SIZE];
+};
+
+/// A framed (and CRC-checked) response handed from the bus task back to loop()
+struct BusResponse {
+  enum class Status : uint8_t {
+    OK,
+    CRC_ERROR,
+    TIMEOUT,
+  };
+  uint32_t seq{0};
+  Status status{Status::OK};
+  uint16_t len{0};
+  uint8_t data[MAX_FRAME_SIZE];
+};
+
+/// Dedicated bus I/O task. Owns the UART and the request/response cycle so bus
+/// timing is independent of the main loop's workload. Requests and responses
+/// cross between the task and loop() through lock-free SPSC ring buffers; loop()
+/// is the only producer of requests and the only consumer of responses.
+///
+/// On ESP32 this runs as a FreeRTOS task pinned to a core; elsewhere (host
+/// builds, unit tests) it runs on a std::thread.
+class BusTask {
+ public:
+  BusTask(uart::UARTDevice *uart, GPIOPin *flow_control_pin, uint32_t response_timeout)
+      : uart_(uart), flow_control_pin_(flow_control_pin), response_timeout_(response_timeout) {}
+  ~BusTask() { this->stop(); }
+
+  /// Start the task. `core` is only honoured on ESP32.
+  bool start(uint8_t core);
+  /// Stop the task and wait for it to exit (host builds only; a no-op request on ESP32)
+  void stop();
+  bool is_running() const { return this->running_.load(std::memory_order_acquire); }
+
+  /// Queue a request frame (loop() side). Returns false if the queue is full.
+  bool submit(uint32_t seq, const uint8_t *data, size_t len);
+  bool submit(uint32_t seq, const std::vector<uint8_t> &frame) { return this->submit(seq, frame.data(), frame.size()); }
+  /// Fetch the next completed transaction (loop() side). Returns false if none.
+  bool poll(BusResponse &response) { return this->responses_.pop(response); }
+
+  size_t pending_requests() const { return this->requests_.size(); }
+
+  static constexpr size_t QUEUE_DEPTH = 4;
+
+ protected:
+  void run_();
+  void transact_(const BusRequest &request);
+  void deliver_(const BusResponse &response);
+  // Block briefly while waiting for a request or for RX bytes
+  void wait_for_request_();
+  void wait_for_bytes_();
+
+  uart::UARTDevice *uart_;
+  GPIOPin *flow_control_pin_;
+  uint32_t response_timeout_;
+
+  SpscQueue<BusRequest, QUEUE_DEPTH> requests_;
+  SpscQueue<BusResponse, QUEUE_DEPTH> responses_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> stop_requested_{false};
+
+#ifdef USE_ESP32
+  static void task_entry_(void *arg);
+  TaskHandle_t handle_{nullptr};
+#else
+  std::thread thread_;
+#endif
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -2,12 +2,17 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import climate
 from esphome.const import CONF_ID
-from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA
+from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA, add_poll_registers
+from ..poll_plan import WHEN_IZ2, WHEN_NO_IZ2
 
 DEPENDENCIES = ["waterfurnace"]
 
 CONF_ZONE = "zone"
 
+# Zone 1 reads the AWL thermostat registers unless an IZ2 is detected
+THERMOSTAT_REGISTERS = [502, 745, 746, 12006, 12005]
+IZ2_ZONE_BASE = 31007
+
 WaterFurnaceClimate = waterfurnace_ns.class_(
     "WaterFurnaceClimate", climate.Climate, cg.Component
 )
@@ -27,3 +32,13 @@ async def to_code(config):
     parent = await cg.get_variable(config[CONF_WATERFURNACE_ID])
     cg.add(var.set_parent(parent))
     cg.add(var.set_zone(config[CONF_ZONE]))
+
+    zone = config[CONF_ZONE]
+    iz2_base = IZ2_ZONE_BASE + (zone - 1) * 3
+    registers = [(741, "awl_communicating", None)]
+    if zone == 1:
+        registers += [(addr, "awl_thermostat", WHEN_NO_IZ2) for addr in THERMOSTAT_REGISTERS]
+        registers += [(addr, "iz2", WHEN_IZ2) for addr in range(iz2_base, iz2_base + 3)]
+    else:
+        registers += [(addr, "iz2", None) for addr in range(iz2_base, iz2_base + 3)]
+    add_poll_registers(config[CONF_WATERFURNACE_ID], registers)
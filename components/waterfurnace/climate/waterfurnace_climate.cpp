@@ -19,22 +19,22 @@ void WaterFurnaceClimate::setup() {
 
 void WaterFurnaceClimate::register_listeners_() {
   // Humidity is shared across all zones (single sensor on the unit)
-  this->parent_->register_listener(REG_HUMIDITY, [this](uint16_t v) { this->on_humidity_(v); }, RegisterCapability::AWL_COMMUNICATING);
+  this->parent_->register_listener(REG_HUMIDITY, [this](uint16_t v) { this->on_humidity_(v); }, RegisterCapability::AWL_COMMUNICATING, this);
 
   if (this->zone_ == 1 && !this->parent_->has_iz2()) {
     // Zone 1 without IZ2 - use thermostat registers
     // Use register 502 for ambient temp (register 747 may read 0 when mode is OFF)
-    this->parent_->register_listener(REG_TSTAT_AMBIENT, [this](uint16_t v) { this->on_ambient_temp_(v); }, RegisterCapability::AWL_THERMOSTAT);
-    this->parent_->register_listener(REG_HEATING_SETPOINT, [this](uint16_t v) { this->on_heating_setpoint_(v); }, RegisterCapability::AWL_THERMOSTAT);
-    this->parent_->register_listener(REG_COOLING_SETPOINT, [this](uint16_t v) { this->on_cooling_setpoint_(v); }, RegisterCapability::AWL_THERMOSTAT);
-    this->parent_->register_listener(REG_MODE_CONFIG, [this](uint16_t v) { this->on_mode_config_(v); }, RegisterCapability::AWL_THERMOSTAT);
-    this->parent_->register_listener(REG_FAN_CONFIG, [this](uint16_t v) { this->on_fan_config_(v); }, RegisterCapability::AWL_THERMOSTAT);
+    this->parent_->register_listener(REG_TSTAT_AMBIENT, [this](uint16_t v) { this->on_ambient_temp_(v); }, RegisterCapability::AWL_THERMOSTAT, this);
+    this->parent_->register_listener(REG_HEATING_SETPOINT, [this](uint16_t v) { this->on_heating_setpoint_(v); }, RegisterCapability::AWL_THERMOSTAT, this);
+    this->parent_->register_listener(REG_COOLING_SETPOINT, [this](uint16_t v) { this->on_cooling_setpoint_(v); }, RegisterCapability::AWL_THERMOSTAT, this);
+    this->parent_->register_listener(REG_MODE_CONFIG, [this](uint16_t v) { this->on_mode_config_(v); }, RegisterCapability::AWL_THERMOSTAT, this);
+    this->parent_->register_listener(REG_FAN_CONFIG, [this](uint16_t v) { this->on_fan_config_(v); }, RegisterCapability::AWL_THERMOSTAT, this);
   } else {
     // IZ2 zone mode (zone 1 with IZ2, or zones 2-6)
     uint16_t base = REG_IZ2_ZONE_BASE + (this->zone_ - 1) * 3;
-    this->parent_->register_listener(base, [this](uint16_t v) { this->on_ambient_temp_(v); }, RegisterCapability::IZ2);
-    this->parent_->register_listener(base + 1, [this](uint16_t v) { this->on_iz2_config1_(v); }, RegisterCapability::IZ2);
-    this->parent_->register_listener(base + 2, [this](uint16_t v) { this->on_iz2_config2_(v); }, RegisterCapability::IZ2);
+    this->parent_->register_listener(base, [this](uint16_t v) { this->on_ambient_temp_(v); }, RegisterCapability::IZ2, this);
+    this->parent_->register_listener(base + 1, [this](uint16_t v) { this->on_iz2_config1_(v); }, RegisterCapability::IZ2, this);
+    this->parent_->register_listener(base + 2, [this](uint16_t v) { this->on_iz2_config2_(v); }, RegisterCapability::IZ2, this);
   }
 }
 
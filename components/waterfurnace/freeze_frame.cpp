@@ -0,0 +1,143 @@
+#include "freeze_frame.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace esphome {
+namespace waterfurnace {
+
+const FreezeFrame::Register FreezeFrame::DEFAULT_REGISTERS[] = {
+    {REG_LINE_VOLTAGE, RegisterCapability::ENERGY},
+    {REG_FP1_TEMP, RegisterCapability::NONE},
+    {REG_FP2_TEMP, RegisterCapability::NONE},
+    {REG_OUTPUTS_AT_LOCKOUT, RegisterCapability::NONE},
+    {REG_INPUTS_AT_LOCKOUT, RegisterCapability::NONE},
+    {REG_SYSTEM_OUTPUTS, RegisterCapability::NONE},
+    {REG_STATUS, RegisterCapability::NONE},
+    {REG_BLOWER_AMPS, RegisterCapability::AXB},
+    {REG_AUX_AMPS, RegisterCapability::AXB},
+    {REG_COMPRESSOR_1_AMPS, RegisterCapability::AXB},
+    {REG_COMPRESSOR_2_AMPS, RegisterCapability::AXB},
+    {REG_HEATING_LIQUID_LINE, RegisterCapability::REFRIGERATION},
+    {REG_LEAVING_WATER, RegisterCapability::AXB},
+    {REG_ENTERING_WATER, RegisterCapability::AXB},
+    {REG_SUCTION_TEMP, RegisterCapability::AXB},
+    {REG_DISCHARGE_PRESSURE, RegisterCapability::AXB},
+    {REG_SUCTION_PRESSURE, RegisterCapability::AXB},
+    {REG_WATERFLOW, RegisterCapability::AXB},
+    {REG_VS_SPEED_ACTUAL, RegisterCapability::VS_DRIVE},
+    {REG_VS_DRIVE_STATUS, RegisterCapability::VS_DRIVE},
+    {REG_VS_DISCHARGE_PRESS, RegisterCapability::VS_DRIVE},
+    {REG_VS_SUCTION_PRESS, RegisterCapability::VS_DRIVE},
+    {REG_VS_DISCHARGE_TEMP, RegisterCapability::VS_DRIVE},
+    {REG_VS_DRIVE_TEMP, RegisterCapability::VS_DRIVE},
+    {REG_VS_INVERTER_TEMP, RegisterCapability::VS_DRIVE},
+};
+const size_t FreezeFrame::NUM_DEFAULT_REGISTERS = sizeof(DEFAULT_REGISTERS) / sizeof(DEFAULT_REGISTERS[0]);
+
+void FreezeFrame::set_registers(const std::vector<Register> &registers) {
+  this->registers_ = registers;
+  // Sorted, so record() can binary search
+  std::sort(this->registers_.begin(), this->registers_.end(),
+            [](const Register &a, const Register &b) { return a.address < b.address; });
+  this->registers_.erase(
+      std::unique(this->registers_.begin(), this->registers_.end(),
+                  [](const Register &a, const Register &b) { return a.address == b.address; }),
+      this->registers_.end());
+  if (this->registers_.size() > MAX_REGISTERS)
+    this->registers_.resize(MAX_REGISTERS);
+}
+
+bool FreezeFrame::begin() {
+  if (this->depth_ == 0)
+    return false;
+  if (this->registers_.empty())
+    this->set_registers(std::vector<Register>(DEFAULT_REGISTERS, DEFAULT_REGISTERS + NUM_DEFAULT_REGISTERS));
+  this->slots_.assign(this->depth_, Snapshot{0, 0, 0, 0});
+  this->values_.assign(this->slots_.size() * this->registers_.size(), 0);
+  this->head_ = 0;
+  this->count_ = 0;
+  this->capturing_ = false;
+  return true;
+}
+
+bool FreezeFrame::on_fault(uint16_t value) {
+  uint16_t old = this->last_fault_;
+  bool first = !this->have_fault_;
+  this->have_fault_ = true;
+  this->last_fault_ = value;
+  if (first || value == old)
+    return false;
+  uint16_t code = value & ~FAULT_LOCKOUT_FLAG;
+  bool new_code = code != 0 && code != (old & ~FAULT_LOCKOUT_FLAG);
+  bool lockout = (value & FAULT_LOCKOUT_FLAG) != 0 && (old & FAULT_LOCKOUT_FLAG) == 0;
+  return new_code || lockout;
+}
+
+void FreezeFrame::open(uint32_t now, uint16_t fault) {
+  if (!this->enabled())
+    return;
+  Snapshot &slot = this->slots_[this->head_];
+  slot = Snapshot{now, 0, fault, 0};
+  std::fill_n(this->values_.begin() + this->head_ * this->registers_.size(), this->registers_.size(), 0);
+  this->head_ = (this->head_ + 1) % this->slots_.size();
+  this->count_ = std::min(this->count_ + 1, this->slots_.size());
+  this->capturing_ = true;
+  this->triggers_++;
+}
+
+void FreezeFrame::record(uint16_t addr, uint16_t value) {
+  if (!this->capturing_)
+    return;
+  auto it = std::lower_bound(this->registers_.begin(), this->registers_.end(), addr,
+                             [](const Register &r, uint16_t a) { return r.address < a; });
+  if (it == this->registers_.end() || it->address != addr)
+    return;
+  size_t reg = it - this->registers_.begin();
+  size_t slot = this->slot_(0);
+  this->values_[slot * this->registers_.size() + reg] = value;
+  this->slots_[slot].read |= uint64_t{1} << reg;
+}
+
+void FreezeFrame::close(uint32_t now) {
+  if (!this->capturing_)
+    return;
+  Snapshot &slot = this->slots_[this->slot_(0)];
+  slot.duration = now - slot.at;
+  this->capturing_ = false;
+}
+
+bool FreezeFrame::value(size_t i, size_t reg, uint16_t &value) const {
+  if (i >= this->count_ || reg >= this->registers_.size())
+    return false;
+  size_t slot = this->slot_(i);
+  if ((this->slots_[slot].read & (uint64_t{1} << reg)) == 0)
+    return false;
+  value = this->values_[slot * this->registers_.size() + reg];
+  return true;
+}
+
+std::string FreezeFrame::to_text(size_t i) const {
+  if (i >= this->count_)
+    return "";
+  const Snapshot &snapshot = this->snapshot(i);
+  char fault[FAULT_HISTORY_BUFFER_SIZE];
+  format_fault_history(REG_LAST_FAULT, snapshot.fault, fault, sizeof(fault));
+  char line[160];
+  snprintf(line, sizeof(line), "# Freeze frame %u/%u: %s at %u ms, read in %u ms\n", static_cast<unsigned>(i + 1),
+           static_cast<unsigned>(this->count_), fault, static_cast<unsigned>(snapshot.at),
+           static_cast<unsigned>(snapshot.duration));
+  std::string text = line;
+  for (size_t reg = 0; reg < this->registers_.size(); reg++) {
+    uint16_t v;
+    if (!this->value(i, reg, v))
+      continue;
+    snprintf(line, sizeof(line), "%u: %u\n", static_cast<unsigned>(this->registers_[reg].address),
+             static_cast<unsigned>(v));
+    text += line;
+  }
+  return text;
+}
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "registers.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Fault freeze frames: when the ABC reports a new fault or a lockout, the
+/// hub reads a set of registers at once and keeps the values here, so the
+/// conditions at the moment of the fault outlive the poll cycles that follow.
+///
+/// The last `depth` snapshots are kept in a ring allocated once by begin();
+/// taking a snapshot never allocates. Snapshot text uses the YAML fixture
+/// format (tests/fixtures/sample_registers.yml), so a frame loads into the
+/// simulator as it is.
+class FreezeFrame {
+ public:
+  struct Register {
+    uint16_t address;
+    RegisterCapability capability;
+  };
+
+  /// Registers per snapshot (one bit each in Snapshot::read)
+  static constexpr size_t MAX_REGISTERS = 64;
+  static constexpr uint8_t MAX_DEPTH = 16;
+  /// What a snapshot holds when no registers are configured: line voltage,
+  /// freeze protection and refrigerant temperatures, pressures, currents and
+  /// the VS drive's status
+  static const Register DEFAULT_REGISTERS[];
+  static const size_t NUM_DEFAULT_REGISTERS;
+
+  struct Snapshot {
+    uint32_t at;        // millis() when the fault was seen
+    uint32_t duration;  // From then until the last register was read
+    uint16_t fault;     // The REG_LAST_FAULT value that triggered it
+    uint64_t read;      // Bit i: registers()[i] was read
+  };
+
+  /// Registers to snapshot, in any order (at most MAX_REGISTERS are kept);
+  /// empty for DEFAULT_REGISTERS
+  void set_registers(const std::vector<Register> &registers);
+  void set_depth(uint8_t depth) { this->depth_ = depth < MAX_DEPTH ? depth : MAX_DEPTH; }
+  /// Allocate the ring; false when the feature is off (depth 0)
+  bool begin();
+  bool enabled() const { return !this->slots_.empty(); }
+  /// Snapshots the ring holds when full
+  size_t depth() const { return this->slots_.size(); }
+  const std::vector<Register> &registers() const { return this->registers_; }
+
+  /// A REG_LAST_FAULT value; true when it should start a snapshot: a new,
+  /// non-zero fault code, or the lockout flag newly set. The first value
+  /// seen only sets the baseline (a fault from before boot is not news).
+  bool on_fault(uint16_t value);
+
+  /// Start a snapshot in the ring's next slot, replacing the oldest when full
+  void open(uint32_t now, uint16_t fault);
+  bool capturing() const { return this->capturing_; }
+  /// A value read while capturing; addresses outside the set are ignored
+  void record(uint16_t addr, uint16_t value);
+  void close(uint32_t now);
+
+  /// Snapshots held, newest first
+  size_t size() const { return this->count_; }
+  const Snapshot &snapshot(size_t i) const { return this->slots_[this->slot_(i)]; }
+  /// registers()[reg] in snapshot i; false if it was not read
+  bool value(size_t i, size_t reg, uint16_t &value) const;
+  /// Snapshot i as fixture text: a comment line and one "address: value" line per register read
+  std::string to_text(size_t i) const;
+  /// Snapshots started since boot, including those the ring has since dropped
+  uint32_t triggers() const { return this->triggers_; }
+
+ protected:
+  size_t slot_(size_t i) const { return (this->head_ + this->slots_.size() - 1 - i) % this->slots_.size(); }
+
+  std::vector<Register> registers_;
+  uint8_t depth_{0};
+  std::vector<Snapshot> slots_;
+  std::vector<uint16_t> values_;  // slots_.size() x registers_.size()
+  size_t head_{0};                // Slot the next snapshot goes into
+  size_t count_{0};
+  bool capturing_{false};
+  bool have_fault_{false};
+  uint16_t last_fault_{0};
+  uint32_t triggers_{0};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
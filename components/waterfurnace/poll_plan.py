@@ -0,0 +1,309 @@
+"""Build-time poll planner.
+
+Runs the same grouping as WaterFurnace::build_poll_groups_() for every
+hardware combination the hub can detect, so the device only has to pick the
+matching plan. Keep in step with waterfurnace.cpp and registers.h; the hub
+checks each plan against its live listeners and falls back to the runtime
+planner on any mismatch.
+"""
+
+# Hardware flags (PlanFlag in waterfurnace.h)
+FLAG_AWL_THERMOSTAT = 1 << 0
+FLAG_AWL_AXB = 1 << 1
+FLAG_AWL_IZ2 = 1 << 2
+FLAG_AXB = 1 << 3
+FLAG_REFRIGERATION = 1 << 4
+FLAG_ENERGY = 1 << 5
+FLAG_VS_DRIVE = 1 << 6
+FLAG_IZ2 = 1 << 7
+
+# Listener conditions beyond capability (climate zone 1 switches on IZ2 presence)
+WHEN_ALWAYS = None
+WHEN_IZ2 = "iz2"
+WHEN_NO_IZ2 = "no_iz2"
+
+SLAVE_ADDRESS = 1
+FUNC_READ_RANGES = 65
+FUNC_READ_REGISTERS = 66
+REGISTER_BREAKPOINT_1 = 12100
+REGISTER_BREAKPOINT_2 = 12500
+MAX_GAP = 8
+MAX_REGS_PER_GROUP = 25
+
+REG_SYSTEM_OUTPUTS = 30
+REG_STATUS = 31
+REG_ENTERING_AIR_ABC = 567
+REG_ENTERING_AIR = 740
+
+# 19200 baud, 8E1: 11 bits per byte
+BYTE_TIME_MS = 11 * 1000.0 / 19200
+
+
+def capability_met(capability, flags):
+    if capability == "none":
+        return True
+    if capability == "awl_thermostat":
+        return bool(flags & FLAG_AWL_THERMOSTAT)
+    if capability == "awl_axb":
+        return bool(flags & FLAG_AWL_AXB)
+    if capability == "awl_communicating":
+        return bool(flags & (FLAG_AWL_THERMOSTAT | FLAG_AWL_IZ2))
+    if capability == "axb":
+        return bool(flags & FLAG_AXB)
+    if capability == "refrigeration":
+        return bool(flags & FLAG_REFRIGERATION)
+    if capability == "energy":
+        return bool(flags & FLAG_ENERGY)
+    if capability == "vs_drive":
+        return bool(flags & FLAG_VS_DRIVE)
+    if capability == "iz2":
+        return bool(flags & FLAG_AWL_IZ2)
+    return True
+
+
+def condition_met(when, flags):
+    if when == WHEN_IZ2:
+        return bool(flags & FLAG_IZ2)
+    if when == WHEN_NO_IZ2:
+        return not flags & FLAG_IZ2
+    return True
+
+
+def hardware_variants():
+    """Flag combinations detection can produce (AWL AXB, refrigeration and
+    energy need an AXB; energy implies refrigeration; AWL IZ2 needs an IZ2)."""
+    axb_options = [0]
+    for awl_axb in (0, FLAG_AWL_AXB):
+        for monitor in (0, FLAG_REFRIGERATION, FLAG_REFRIGERATION | FLAG_ENERGY):
+            axb_options.append(FLAG_AXB | awl_axb | monitor)
+    for axb in axb_options:
+        for thermostat in (0, FLAG_AWL_THERMOSTAT):
+            for iz2 in (0, FLAG_IZ2, FLAG_IZ2 | FLAG_AWL_IZ2):
+                for vs_drive in (0, FLAG_VS_DRIVE):
+                    yield axb | thermostat | iz2 | vs_drive
+
+
+def is_state_dependent_register(addr):
+    # registers.h is_state_dependent_register()
+    if addr == 344:
+        return True
+    if 1105 <= addr <= 1109:
+        return True
+    if addr in (1112, 1113, 1115, 1116, 1117):
+        return True
+    if 1124 <= addr <= 1165:
+        return True
+    return 3000 <= addr < 4000
+
+
+def pollable_addresses(listeners, flags):
+    """Sorted, de-duplicated addresses the hub would poll for `flags`."""
+    addrs = {
+        addr
+        for addr, capability, when in listeners
+        if capability_met(capability, flags) and condition_met(when, flags)
+    }
+    if not flags & FLAG_AWL_AXB:
+        # The hub registers a 567 -> 740 forwarding listener on non-AWL AXB systems
+        addrs.discard(REG_ENTERING_AIR)
+        addrs.add(REG_ENTERING_AIR_ABC)
+    return sorted(addrs)
+
+
+def merge_to_ranges(addrs, max_gap=MAX_GAP):
+    ranges = []
+    for addr in addrs:
+        if ranges and addr - (ranges[-1][0] + ranges[-1][1] - 1) <= max_gap:
+            ranges[-1][1] = addr - ranges[-1][0] + 1
+        else:
+            ranges.append([addr, 1])
+    return [tuple(r) for r in ranges]
+
+
+def split_around(ranges, exclude):
+    split = []
+    for start, count in ranges:
+        end = start + count - 1
+        for addr in sorted(a for a in exclude if start <= a <= end):
+            split.append((start, addr - start))
+            start = addr + 1
+        split.append((start, end - start + 1))
+    return [r for r in split if r[1] > 0]
+
+
+def group_ranges(ranges):
+    groups = []
+    current = []
+    count = 0
+    for start, length in ranges:
+        if count > 0 and count + length > MAX_REGS_PER_GROUP:
+            groups.append({"ranges": current, "individual": []})
+            current = []
+            count = 0
+        current.append((start, length))
+        count += length
+    if current:
+        groups.append({"ranges": current, "individual": []})
+    return groups
+
+
+def build_groups(addrs, exclude=()):
+    segment_a = [a for a in addrs if a < REGISTER_BREAKPOINT_1]
+    segment_b = [a for a in addrs if REGISTER_BREAKPOINT_1 <= a < REGISTER_BREAKPOINT_2]
+    segment_c = [a for a in addrs if a >= REGISTER_BREAKPOINT_2]
+    groups = group_ranges(split_around(merge_to_ranges(segment_a), exclude))
+    if segment_b:
+        groups.append({"ranges": [], "individual": list(segment_b)})
+    groups += group_ranges(split_around(merge_to_ranges(segment_c), exclude))
+    return groups
+
+
+def build_plan(listeners, flags, adaptive):
+    """Returns (addresses, groups); state-dependent groups carry "state": True."""
+    addrs = pollable_addresses(listeners, flags)
+    state_addrs = []
+    base_addrs = addrs
+    if adaptive:
+        state_addrs = [a for a in addrs if is_state_dependent_register(a)]
+        base_addrs = sorted(
+            {a for a in addrs if not is_state_dependent_register(a)}
+            | {REG_SYSTEM_OUTPUTS, REG_STATUS}
+        )
+    if not base_addrs:
+        return addrs, []
+    groups = [dict(g, state=False) for g in build_groups(base_addrs, state_addrs)]
+    groups += [dict(g, state=True) for g in build_groups(state_addrs, base_addrs)]
+    return addrs, groups
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def group_frame(group, slave=SLAVE_ADDRESS):
+    frame = [slave]
+    if group["ranges"]:
+        frame.append(FUNC_READ_RANGES)
+        for start, count in group["ranges"]:
+            frame += [start >> 8, start & 0xFF, count >> 8, count & 0xFF]
+    else:
+        frame.append(FUNC_READ_REGISTERS)
+        for addr in group["individual"]:
+            frame += [addr >> 8, addr & 0xFF]
+    crc = crc16(frame)
+    frame += [crc & 0xFF, crc >> 8]
+    assert len(frame) < 256, "poll group frame too long"
+    return frame
+
+
+def group_registers(group):
+    return sum(count for _, count in group["ranges"]) + len(group["individual"])
+
+
+def group_bus_ms(group):
+    """Wire time for request plus response (address, func, count, values, CRC)."""
+    response = 3 + 2 * group_registers(group) + 2
+    return (len(group_frame(group)) + response) * BYTE_TIME_MS
+
+
+def plan_variants(listeners, adaptive):
+    """Distinct plans and the flag combinations that select each one.
+
+    Returns (plans, variants): plans is a list of (addresses, groups) and
+    variants a list of (flags, plan index)."""
+    plans = []
+    index = {}
+    variants = []
+    for flags in hardware_variants():
+        addrs, groups = build_plan(listeners, flags, adaptive)
+        key = (
+            tuple(addrs),
+            tuple(
+                (tuple(g["ranges"]), tuple(g["individual"]), g["state"])
+                for g in groups
+            ),
+        )
+        if key not in index:
+            index[key] = len(plans)
+            plans.append((addrs, groups))
+        variants.append((flags, index[key]))
+    return plans, variants
+
+
+def render_cpp(prefix, plans, variants, slave=SLAVE_ADDRESS):
+    """C++ definitions for the plan tables (types from waterfurnace.h), with
+    request frames addressed to `slave`.
+
+    Plans for neighbouring hardware variants mostly share groups, so frames
+    and range lists are emitted once and referenced from every plan."""
+    ns = "esphome::waterfurnace"
+    lines = []
+    shared = {}
+    plan_entries = []
+
+    def array(ctype, kind, values):
+        key = (kind, tuple(values))
+        if key not in shared:
+            name = f"{prefix}_{kind}{len(shared)}"
+            shared[key] = name
+            lines.append(f"static const {ctype} {name}[] = {{{', '.join(values)}}};")
+        return shared[key]
+
+    for p, (addrs, groups) in enumerate(plans):
+        entries = []
+        for group in groups:
+            frame = array("uint8_t", "f", [f"0x{b:02X}" for b in group_frame(group, slave)])
+            ranges = "nullptr"
+            if group["ranges"]:
+                ranges = array(
+                    f"{ns}::PlannedRange", "r", [f"{{{s}, {c}}}" for s, c in group["ranges"]]
+                )
+            individual = "nullptr"
+            if group["individual"]:
+                individual = array("uint16_t", "i", [str(a) for a in group["individual"]])
+            entries.append(
+                f"{{{ranges}, {individual}, {frame}, {len(group['ranges'])}, "
+                f"{len(group['individual'])}, sizeof({frame}), "
+                f"{'true' if group['state'] else 'false'}}}"
+            )
+        addresses = array("uint16_t", "a", [str(a) for a in addrs] or ["0"])
+        groups_name = "nullptr"
+        if entries:
+            groups_name = f"{prefix}_p{p}_groups"
+            lines.append(
+                f"static const {ns}::PlannedGroup {groups_name}[] = {{{', '.join(entries)}}};"
+            )
+        plan_entries.append(f"{{{groups_name}, {len(groups)}, {addresses}, {len(addrs)}}}")
+    lines.append(
+        f"static const {ns}::PollPlan {prefix}_plans[] = {{{', '.join(plan_entries)}}};"
+    )
+    variant_entries = ", ".join(f"{{{flags}, {p}}}" for flags, p in variants)
+    lines.append(
+        f"static const {ns}::PollPlanVariant {prefix}_variants[] = {{{variant_entries}}};"
+    )
+    return "\n".join(lines)
+
+
+def report(plans, variants):
+    """One line per distinct plan: transactions and wire time per cycle."""
+    lines = []
+    for p, (addrs, groups) in enumerate(plans):
+        base = [g for g in groups if not g["state"]]
+        state = [g for g in groups if g["state"]]
+        count = sum(1 for _, idx in variants if idx == p)
+        line = (
+            f"plan {p} ({count} hardware variants): {len(addrs)} registers, "
+            f"{len(base)} transactions/cycle, {sum(map(group_bus_ms, base)):.1f} ms bus time"
+        )
+        if state:
+            line += (
+                f" + {len(state)} state-dependent transactions, "
+                f"{sum(map(group_bus_ms, state)):.1f} ms"
+            )
+        lines.append(line)
+    return lines
@@ -1,5 +1,7 @@
 #include "protocol.h"
 
+#include <algorithm>
+
 namespace esphome {
 namespace waterfurnace {
 
@@ -25,9 +27,9 @@ static void append_crc(std::vector<uint8_t> &frame) {
 }
 
 std::vector<uint8_t> build_read_ranges_request(
-    const std::vector<std::pair<uint16_t, uint16_t>> &ranges) {
+    const std::vector<std::pair<uint16_t, uint16_t>> &ranges, uint8_t slave) {
   std::vector<uint8_t> frame;
-  frame.push_back(SLAVE_ADDRESS);
+  frame.push_back(slave);
   frame.push_back(FUNC_READ_RANGES);
 
   for (const auto &range : ranges) {
@@ -43,9 +45,9 @@ std::vector<uint8_t> build_read_ranges_request(
 }
 
 std::vector<uint8_t> build_read_registers_request(
-    const std::vector<uint16_t> &addresses) {
+    const std::vector<uint16_t> &addresses, uint8_t slave) {
   std::vector<uint8_t> frame;
-  frame.push_back(SLAVE_ADDRESS);
+  frame.push_back(slave);
   frame.push_back(FUNC_READ_REGISTERS);
 
   for (uint16_t addr : addresses) {
@@ -58,9 +60,9 @@ std::vector<uint8_t> build_read_registers_request(
 }
 
 std::vector<uint8_t> build_write_registers_request(
-    const std::vector<std::pair<uint16_t, uint16_t>> &writes) {
+    const std::vector<std::pair<uint16_t, uint16_t>> &writes, uint8_t slave) {
   std::vector<uint8_t> frame;
-  frame.push_back(SLAVE_ADDRESS);
+  frame.push_back(slave);
   frame.push_back(FUNC_WRITE_REGISTERS);
 
   for (const auto &w : writes) {
@@ -76,9 +78,9 @@ std::vector<uint8_t> build_write_registers_request(
   return frame;
 }
 
-std::vector<uint8_t> build_write_single_request(uint16_t address, uint16_t value) {
+std::vector<uint8_t> build_write_single_request(uint16_t address, uint16_t value, uint8_t slave) {
   std::vector<uint8_t> frame;
-  frame.push_back(SLAVE_ADDRESS);
+  frame.push_back(slave);
   frame.push_back(FUNC_WRITE_SINGLE);
   frame.push_back((address >> 8) & 0xFF);
   frame.push_back(address & 0xFF);
@@ -128,6 +130,26 @@ size_t get_response_header_size(uint8_t function_code) {
   }
 }
 
+size_t get_response_frame_size(const uint8_t *data, size_t len) {
+  // Need at least: slave_addr + func_code + something
+  if (len < 3)
+    return 0;
+
+  uint8_t func_code = data[1];
+  if (is_error_response(func_code))
+    return 5;
+
+  switch (func_code) {
+    case FUNC_WRITE_REGISTERS:
+    case FUNC_WRITE_SINGLE:
+      return get_response_header_size(func_code);
+    default:
+      // Variable length: slave + func + byte_count + data[byte_count] + CRC(2)
+      // Unknown functions are assumed to follow the same layout
+      return 3 + data[2] + 2;
+  }
+}
+
 std::vector<uint16_t> parse_register_values(const uint8_t *data, size_t data_len) {
   std::vector<uint16_t> values;
   // data_len is the number of data bytes (from byte_count field)
@@ -138,5 +160,76 @@ std::vector<uint16_t> parse_register_values(const uint8_t *data, size_t data_len
   return values;
 }
 
+bool parse_register_ranges(const std::string &spec, std::vector<std::pair<uint16_t, uint16_t>> &ranges) {
+  ranges.clear();
+  // Inclusive {first, last}, sorted and merged once the whole list is read
+  std::vector<std::pair<uint32_t, uint32_t>> items;
+  size_t pos = 0;
+  // An address at `pos`, skipping the spaces around it
+  auto number = [&spec, &pos](uint32_t &value) {
+    while (pos < spec.size() && spec[pos] == ' ')
+      pos++;
+    size_t start = pos;
+    value = 0;
+    while (pos < spec.size() && spec[pos] >= '0' && spec[pos] <= '9' && value <= 65535)
+      value = value * 10 + (spec[pos++] - '0');
+    while (pos < spec.size() && spec[pos] == ' ')
+      pos++;
+    return pos > start && value <= 65535;
+  };
+  while (true) {
+    uint32_t first, last;
+    if (!number(first))
+      return false;
+    last = first;
+    if (pos < spec.size() && spec[pos] == '-') {
+      pos++;
+      if (!number(last) || last < first)
+        return false;
+    }
+    items.push_back({first, last});
+    if (pos == spec.size())
+      break;
+    if (spec[pos++] != ',')
+      return false;
+  }
+  std::sort(items.begin(), items.end());
+  auto add = [&ranges](uint32_t first, uint32_t last) {
+    // Only 0-65535 is too long for one {start, count} pair
+    if (last - first + 1 > 65535) {
+      ranges.push_back({static_cast<uint16_t>(first), 65535});
+      first += 65535;
+    }
+    ranges.push_back({static_cast<uint16_t>(first), static_cast<uint16_t>(last - first + 1)});
+  };
+  uint32_t first = items[0].first, last = items[0].second;
+  for (const auto &item : items) {
+    if (item.first > last + 1) {
+      add(first, last);
+      first = item.first;
+    }
+    last = std::max(last, item.second);
+  }
+  add(first, last);
+  return true;
+}
+
+bool parse_register_list(const std::string &spec, std::vector<uint16_t> &addresses, size_t max_count) {
+  addresses.clear();
+  std::vector<std::pair<uint16_t, uint16_t>> ranges;
+  if (!parse_register_ranges(spec, ranges))
+    return false;
+  size_t count = 0;
+  for (const auto &range : ranges)
+    count += range.second;
+  if (count > max_count)
+    return false;
+  for (const auto &range : ranges) {
+    for (uint32_t addr = range.first; addr < range.first + range.second; addr++)
+      addresses.push_back(addr);
+  }
+  return true;
+}
+
 }  // namespace waterfurnace
 }  // namespace esphome
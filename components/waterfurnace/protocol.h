@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <string>
 #include <vector>
 #include <utility>
 
@@ -14,6 +15,7 @@ static constexpr uint8_t FUNC_READ_REGISTERS = 66;    // Read multiple discontig
 static constexpr uint8_t FUNC_WRITE_REGISTERS = 67;   // Write multiple discontiguous registers
 static constexpr uint8_t FUNC_WRITE_SINGLE = 6;       // Standard ModBus write single register
 
+// Default ABC slave address; each hub can be given its own (several units on one bus)
 static constexpr uint8_t SLAVE_ADDRESS = 1;
 static constexpr uint8_t ERROR_MASK = 0x80;
 
@@ -23,30 +25,33 @@ static constexpr size_t MAX_REGISTERS_PER_REQUEST = 100;
 // Frame size limits
 static constexpr size_t MIN_FRAME_SIZE = 4;            // slave + func + 2 CRC bytes minimum
 static constexpr size_t MAX_FRAME_SIZE = 256;
+// Writes per function 67 request: slave, func and CRC, then 4 bytes per write
+static constexpr size_t MAX_WRITES_PER_REQUEST = (MAX_FRAME_SIZE - 4) / 4;
 
 /// Calculate ModBus CRC16 using polynomial 0xA001
 uint16_t crc16(const uint8_t *data, size_t len);
 
 /// Build a function 65 request: read multiple register ranges
-/// Each pair is (start_address, quantity)
+/// Each pair is (start_address, quantity); `slave` is the ABC's bus address
 /// Returns complete RTU frame with CRC
 std::vector<uint8_t> build_read_ranges_request(
-    const std::vector<std::pair<uint16_t, uint16_t>> &ranges);
+    const std::vector<std::pair<uint16_t, uint16_t>> &ranges, uint8_t slave = SLAVE_ADDRESS);
 
 /// Build a function 66 request: read individual discontiguous registers
 /// Returns complete RTU frame with CRC
 std::vector<uint8_t> build_read_registers_request(
-    const std::vector<uint16_t> &addresses);
+    const std::vector<uint16_t> &addresses, uint8_t slave = SLAVE_ADDRESS);
 
 /// Build a function 67 request: write multiple discontiguous registers
 /// Each pair is (address, value)
 /// Returns complete RTU frame with CRC
 std::vector<uint8_t> build_write_registers_request(
-    const std::vector<std::pair<uint16_t, uint16_t>> &writes);
+    const std::vector<std::pair<uint16_t, uint16_t>> &writes, uint8_t slave = SLAVE_ADDRESS);
 
 /// Build a function 6 request: write single holding register
 /// Returns complete RTU frame with CRC
-std::vector<uint8_t> build_write_single_request(uint16_t address, uint16_t value);
+std::vector<uint8_t> build_write_single_request(uint16_t address, uint16_t value,
+                                                uint8_t slave = SLAVE_ADDRESS);
 
 /// Validate a received frame's CRC
 /// Returns true if CRC is valid
@@ -59,10 +64,23 @@ bool is_error_response(uint8_t function_code);
 /// For variable-length responses (func 65/66), returns the header size before byte count
 size_t get_response_header_size(uint8_t function_code);
 
+/// Get the total size of the response frame at the start of a receive buffer
+/// Returns 0 while too few bytes have arrived to determine the size
+size_t get_response_frame_size(const uint8_t *data, size_t len);
+
 /// Parse a function 65/66 response payload into register values
 /// The response data should start after slave_addr and function_code bytes
 /// Returns vector of uint16_t values in order
 std::vector<uint16_t> parse_register_values(const uint8_t *data, size_t data_len);
 
+/// Parse a register list such as "25, 30-35, 12101" into sorted {start, count}
+/// ranges, overlapping and adjacent items merged
+/// Returns false on anything else (empty items, reversed ranges, addresses over 65535)
+bool parse_register_ranges(const std::string &spec, std::vector<std::pair<uint16_t, uint16_t>> &ranges);
+
+/// The same list as sorted unique addresses; also false when it names more than
+/// `max_count` addresses
+bool parse_register_list(const std::string &spec, std::vector<uint16_t> &addresses, size_t max_count = 1024);
+
 }  // namespace waterfurnace
 }  // namespace esphome
@@ -0,0 +1,153 @@
+#include "register_dump.h"
+#include "protocol.h"
+#include "registers.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace waterfurnace {
+
+// Func 65 request: slave, function, 4 bytes per range, CRC
+static constexpr size_t MAX_RANGES_PER_REQUEST = (MAX_FRAME_SIZE - 4) / 4;
+
+size_t RegisterDump::Batch::size() const {
+  size_t n = 0;
+  for (const auto &range : this->ranges)
+    n += range.second;
+  return n;
+}
+
+void RegisterDump::start(std::vector<Range> ranges, Sink sink) {
+  this->ranges_ = std::move(ranges);
+  this->range_index_ = 0;
+  this->next_addr_ = this->ranges_.empty() ? 0 : this->ranges_[0].first;
+  this->pending_.clear();
+  this->sink_ = std::move(sink);
+  this->read_ = 0;
+  this->quarantined_ = 0;
+  this->batches_ = 0;
+  this->active_ = true;
+}
+
+bool RegisterDump::take_(Batch &batch) {
+  batch = Batch();
+  // Skip to the first unscanned address
+  while (this->range_index_ < this->ranges_.size()) {
+    const Range &range = this->ranges_[this->range_index_];
+    this->next_addr_ = std::max<uint32_t>(this->next_addr_, range.first);
+    if (this->next_addr_ < static_cast<uint32_t>(range.first) + range.second)
+      break;
+    this->range_index_++;
+  }
+  if (this->range_index_ == this->ranges_.size())
+    return false;
+
+  // A request never crosses a breakpoint; between them the ABC only answers func 66
+  uint32_t segment_end = 0x10000;
+  if (this->next_addr_ < REGISTER_BREAKPOINT_1) {
+    segment_end = REGISTER_BREAKPOINT_1;
+  } else if (this->next_addr_ < REGISTER_BREAKPOINT_2) {
+    segment_end = REGISTER_BREAKPOINT_2;
+    batch.individual = true;
+  }
+  size_t count = 0;
+  while (this->range_index_ < this->ranges_.size() && count < MAX_REGISTERS_PER_REQUEST &&
+         (batch.individual || batch.ranges.size() < MAX_RANGES_PER_REQUEST)) {
+    const Range &range = this->ranges_[this->range_index_];
+    this->next_addr_ = std::max<uint32_t>(this->next_addr_, range.first);
+    if (this->next_addr_ >= segment_end)
+      break;
+    uint32_t range_end = static_cast<uint32_t>(range.first) + range.second;
+    uint32_t take = std::min<uint32_t>(std::min(range_end, segment_end) - this->next_addr_,
+                                       MAX_REGISTERS_PER_REQUEST - count);
+    batch.ranges.push_back({static_cast<uint16_t>(this->next_addr_), static_cast<uint16_t>(take)});
+    count += take;
+    this->next_addr_ += take;
+    if (this->next_addr_ < range_end)
+      break;
+    this->range_index_++;
+  }
+  return true;
+}
+
+bool RegisterDump::next(Batch &batch) {
+  if (!this->active_)
+    return false;
+  if (!this->pending_.empty()) {
+    this->current_ = std::move(this->pending_.back());
+    this->pending_.pop_back();
+  } else if (!this->take_(this->current_)) {
+    this->active_ = false;
+    this->sink_("# " + std::to_string(this->read_) + " registers read, " + std::to_string(this->quarantined_) +
+                " left out, " + std::to_string(this->batches_) + " requests\n");
+    return false;
+  }
+  this->batches_++;
+  batch = this->current_;
+  return true;
+}
+
+void RegisterDump::on_values(const uint8_t *data, size_t count) {
+  std::string text;
+  size_t i = 0;
+  for (const auto &range : this->current_.ranges) {
+    for (uint32_t addr = range.first; addr < static_cast<uint32_t>(range.first) + range.second && i < count;
+         addr++, i++) {
+      text += std::to_string(addr) + ": " + std::to_string((data[2 * i] << 8) | data[2 * i + 1]) + "\n";
+    }
+  }
+  this->read_ += i;
+  this->sink_(text);
+}
+
+void RegisterDump::on_exception(uint8_t code) {
+  size_t size = this->current_.size();
+  if (size <= 1) {
+    this->quarantined_ += size;
+    if (size == 1) {
+      this->sink_("# " + std::to_string(this->current_.ranges[0].first) + ": exception " + std::to_string(code) +
+                  "\n");
+    }
+    return;
+  }
+  // Read each half on its own, the first half next
+  Batch first, second;
+  first.individual = second.individual = this->current_.individual;
+  size_t half = size / 2, n = 0;
+  for (const auto &range : this->current_.ranges) {
+    if (n >= half) {
+      second.ranges.push_back(range);
+    } else if (n + range.second <= half) {
+      first.ranges.push_back(range);
+    } else {
+      uint16_t head = half - n;
+      first.ranges.push_back({range.first, head});
+      second.ranges.push_back({static_cast<uint16_t>(range.first + head), static_cast<uint16_t>(range.second - head)});
+    }
+    n += range.second;
+  }
+  this->pending_.push_back(std::move(second));
+  this->pending_.push_back(std::move(first));
+}
+
+void RegisterDump::on_failure() {
+  if (++this->current_.attempts < MAX_ATTEMPTS) {
+    this->pending_.push_back(this->current_);
+    return;
+  }
+  std::string text = "#";
+  for (const auto &range : this->current_.ranges)
+    append_range_(text, range);
+  this->quarantined_ += this->current_.size();
+  this->sink_(text + ": no response\n");
+}
+
+void RegisterDump::append_range_(std::string &text, const Range &range) {
+  text += text.size() > 1 ? ", " : " ";
+  text += std::to_string(range.first);
+  if (range.second > 1)
+    text += "-" + std::to_string(range.first + range.second - 1);
+}
+
+}  // namespace waterfurnace
+}  // namespace esphome
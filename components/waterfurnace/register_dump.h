@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Plans a scan of the ABC's register map and writes what it reads in the
+/// YAML fixture format (tests/fixtures/sample_registers.yml): one
+/// "address: value" line per register, and comments for addresses that
+/// could not be read.
+///
+/// The scan reads as many registers per request as the protocol allows:
+/// func 65 below REGISTER_BREAKPOINT_1 and from REGISTER_BREAKPOINT_2 up,
+/// func 66 between them, 100 registers per request. When the ABC answers a
+/// batch with an exception, the batch is split in half and each half read
+/// again, down to single addresses, which are then skipped (quarantined).
+/// A batch with no usable response is retried up to MAX_ATTEMPTS times.
+///
+/// Output is handed to the sink a batch at a time, so memory stays bounded
+/// by the batch size rather than by the size of the scan.
+class RegisterDump {
+ public:
+  using Range = std::pair<uint16_t, uint16_t>;  // {start, count}
+  using Sink = std::function<void(const std::string &text)>;
+
+  static constexpr uint8_t MAX_ATTEMPTS = 3;
+  /// What dump_registers scans when given no ranges: the system, AXB, VS
+  /// drive, thermostat and IZ2 register areas
+  static constexpr const char *DEFAULT_RANGES = "0-1199, 3000-3999, 12000-12499, 31000-31499";
+
+  /// One request: func 65 ranges, or func 66 addresses (`individual`)
+  struct Batch {
+    std::vector<Range> ranges;
+    bool individual{false};
+    uint8_t attempts{0};
+    size_t size() const;
+  };
+
+  /// Start scanning `ranges` (sorted, non-overlapping, as from
+  /// parse_register_ranges()); YAML text goes to `sink`
+  void start(std::vector<Range> ranges, Sink sink);
+  bool active() const { return this->active_; }
+
+  /// The next batch to send, or false when the scan is done (the summary
+  /// has then been written and the dump is no longer active)
+  bool next(Batch &batch);
+  /// Answers to the batch last returned by next(): the response's values
+  /// (big-endian, two bytes per register, in request order), an exception
+  /// code, or no usable response (timeout, CRC error, wrong value count)
+  void on_values(const uint8_t *data, size_t count);
+  void on_exception(uint8_t code);
+  void on_failure();
+
+  uint32_t registers_read() const { return this->read_; }
+  /// Addresses left out: rejected on their own, or in a batch that never got an answer
+  uint32_t quarantined() const { return this->quarantined_; }
+  uint32_t batches() const { return this->batches_; }
+
+ protected:
+  // Take the next batch from the unscanned ranges
+  bool take_(Batch &batch);
+  static void append_range_(std::string &text, const Range &range);
+
+  std::vector<Range> ranges_;
+  size_t range_index_{0};
+  uint32_t next_addr_{0};  // First unscanned address in ranges_[range_index_]
+  // Halves of rejected batches still to read, last one next
+  std::vector<Batch> pending_;
+  Batch current_;
+  bool active_{false};
+  Sink sink_;
+  uint32_t read_{0};
+  uint32_t quarantined_{0};
+  uint32_t batches_{0};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
-#include <cstring>
+#include <cstddef>
+#include <cstdio>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -24,17 +27,28 @@ enum class RegisterCapability : uint8_t {
   IZ2,                // IZ2 with AWL v2.0+ (31000+)
 };
 
-/// Convert a Python-provided capability string to enum
-inline RegisterCapability capability_from_string(const char *str) {
-  if (strcmp(str, "awl_thermostat") == 0) return RegisterCapability::AWL_THERMOSTAT;
-  if (strcmp(str, "awl_axb") == 0) return RegisterCapability::AWL_AXB;
-  if (strcmp(str, "awl_communicating") == 0) return RegisterCapability::AWL_COMMUNICATING;
-  if (strcmp(str, "axb") == 0) return RegisterCapability::AXB;
-  if (strcmp(str, "refrigeration") == 0) return RegisterCapability::REFRIGERATION;
-  if (strcmp(str, "energy") == 0) return RegisterCapability::ENERGY;
-  if (strcmp(str, "vs_drive") == 0) return RegisterCapability::VS_DRIVE;
-  if (strcmp(str, "iz2") == 0) return RegisterCapability::IZ2;
-  return RegisterCapability::NONE;
+/// Capability name for logs (codegen passes the enum directly)
+inline const char *capability_name(RegisterCapability cap) {
+  switch (cap) {
+    case RegisterCapability::AWL_THERMOSTAT:
+      return "awl_thermostat";
+    case RegisterCapability::AWL_AXB:
+      return "awl_axb";
+    case RegisterCapability::AWL_COMMUNICATING:
+      return "awl_communicating";
+    case RegisterCapability::AXB:
+      return "axb";
+    case RegisterCapability::REFRIGERATION:
+      return "refrigeration";
+    case RegisterCapability::ENERGY:
+      return "energy";
+    case RegisterCapability::VS_DRIVE:
+      return "vs_drive";
+    case RegisterCapability::IZ2:
+      return "iz2";
+    default:
+      return "none";
+  }
 }
 
 // --- Register data type conversions ---
@@ -50,6 +64,48 @@ enum class RegisterType : uint8_t {
   INT32,            // Two consecutive registers, signed
 };
 
+/// Static decode rules per RegisterType (indexed by the enum value)
+struct RegisterTypeInfo {
+  RegisterType type;
+  const char *name;   // Codegen/log name
+  uint8_t words;      // Registers per value (hi word first)
+  bool has_sentinel;  // ±999.9 means "not available"
+};
+
+static constexpr RegisterTypeInfo REGISTER_TYPE_INFO[] = {
+    {RegisterType::UNSIGNED, "unsigned", 1, false},
+    {RegisterType::SIGNED, "signed", 1, false},
+    {RegisterType::TENTHS, "tenths", 1, true},
+    {RegisterType::SIGNED_TENTHS, "signed_tenths", 1, true},
+    {RegisterType::HUNDREDTHS, "hundredths", 1, false},
+    {RegisterType::BOOLEAN, "boolean", 1, false},
+    {RegisterType::UINT32, "uint32", 2, false},
+    {RegisterType::INT32, "int32", 2, false},
+};
+static constexpr size_t REGISTER_TYPE_INFO_SIZE = sizeof(REGISTER_TYPE_INFO) / sizeof(REGISTER_TYPE_INFO[0]);
+
+constexpr bool register_type_info_ordered(size_t i = 0) {
+  return i == REGISTER_TYPE_INFO_SIZE ||
+         (static_cast<size_t>(REGISTER_TYPE_INFO[i].type) == i && register_type_info_ordered(i + 1));
+}
+static_assert(register_type_info_ordered(), "REGISTER_TYPE_INFO must be indexed by RegisterType");
+static_assert(REGISTER_TYPE_INFO_SIZE == static_cast<size_t>(RegisterType::INT32) + 1,
+              "REGISTER_TYPE_INFO must cover every RegisterType");
+
+constexpr const RegisterTypeInfo &register_type_info(RegisterType type) {
+  return REGISTER_TYPE_INFO[static_cast<size_t>(type)];
+}
+
+/// Per-entity register metadata, fixed at codegen time
+struct RegisterMeta {
+  uint16_t address;
+  RegisterType type;
+  RegisterCapability capability;
+
+  constexpr bool is_32bit() const { return register_type_info(type).words == 2; }
+  constexpr bool has_sentinel() const { return register_type_info(type).has_sentinel; }
+};
+
 /// Convert a raw register value to float based on its type
 inline float convert_register(uint16_t raw, RegisterType type) {
   switch (type) {
@@ -194,6 +250,91 @@ static constexpr BitLabel INPUT_BITS[] = {
 };
 static constexpr size_t INPUT_BITS_SIZE = sizeof(INPUT_BITS) / sizeof(INPUT_BITS[0]);
 
+// AXB output bits (register 1104)
+static constexpr uint16_t AXB_OUTPUT_DHW = 0x01;
+static constexpr uint16_t AXB_OUTPUT_LOOP_PUMP = 0x02;
+static constexpr uint16_t AXB_OUTPUT_DIVERTING_VALVE = 0x04;
+static constexpr uint16_t AXB_OUTPUT_DEHUMIDIFIER = 0x08;   // Dehumidifier/reheat
+static constexpr uint16_t AXB_OUTPUT_ACCESSORY2 = 0x10;
+
+static constexpr BitLabel AXB_OUTPUT_BITS[] = {
+    {AXB_OUTPUT_DHW, "DHW"},
+    {AXB_OUTPUT_LOOP_PUMP, "Loop Pump"},
+    {AXB_OUTPUT_DIVERTING_VALVE, "Diverting Valve"},
+    {AXB_OUTPUT_DEHUMIDIFIER, "Dehumidifier"},
+    {AXB_OUTPUT_ACCESSORY2, "Accessory 2"},
+};
+static constexpr size_t AXB_OUTPUT_BITS_SIZE = sizeof(AXB_OUTPUT_BITS) / sizeof(AXB_OUTPUT_BITS[0]);
+
+// Direct-index form of a BitLabel array: label[n] names bit n (nullptr if unnamed)
+struct BitLabelTable {
+  const char *label[16];
+};
+
+constexpr BitLabelTable make_bit_label_table(const BitLabel *bits, size_t count) {
+  BitLabelTable table{};
+  for (size_t i = 0; i < count; i++) {
+    for (uint8_t bit = 0; bit < 16; bit++) {
+      if (bits[i].mask == (1u << bit))
+        table.label[bit] = bits[i].label;
+    }
+  }
+  return table;
+}
+
+// Every entry must be a single, distinct bit
+constexpr bool bit_labels_valid(const BitLabel *bits, size_t count) {
+  uint16_t seen = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint16_t mask = bits[i].mask;
+    if (mask == 0 || (mask & (mask - 1)) != 0 || (seen & mask) != 0)
+      return false;
+    seen |= mask;
+  }
+  return true;
+}
+
+// Length of "A, B, C" with every label set
+constexpr size_t bit_labels_length(const BitLabel *bits, size_t count) {
+  size_t length = 0;
+  for (size_t i = 0; i < count; i++)
+    length += std::char_traits<char>::length(bits[i].label) + (i > 0 ? 2 : 0);
+  return length;
+}
+
+static_assert(bit_labels_valid(OUTPUT_BITS, OUTPUT_BITS_SIZE), "OUTPUT_BITS masks must be distinct single bits");
+static_assert(bit_labels_valid(INPUT_BITS, INPUT_BITS_SIZE), "INPUT_BITS masks must be distinct single bits");
+static_assert(bit_labels_valid(AXB_OUTPUT_BITS, AXB_OUTPUT_BITS_SIZE),
+              "AXB_OUTPUT_BITS masks must be distinct single bits");
+
+static constexpr BitLabelTable OUTPUT_BIT_LABELS = make_bit_label_table(OUTPUT_BITS, OUTPUT_BITS_SIZE);
+static constexpr BitLabelTable INPUT_BIT_LABELS = make_bit_label_table(INPUT_BITS, INPUT_BITS_SIZE);
+static constexpr BitLabelTable AXB_OUTPUT_BIT_LABELS = make_bit_label_table(AXB_OUTPUT_BITS, AXB_OUTPUT_BITS_SIZE);
+
+inline const char *bit_label(const BitLabelTable &table, uint8_t bit) {
+  return bit < 16 ? table.label[bit] : nullptr;
+}
+
+/// Write the labels of the set bits as "A, B, C" ("None" if no labelled bit is set).
+/// Visits set bits only; truncates to `size` and always terminates.
+inline void format_bit_labels(char *buf, size_t size, uint16_t value, const BitLabelTable &table) {
+  size_t pos = 0;
+  buf[0] = '\0';
+  while (value != 0 && pos + 1 < size) {
+    uint8_t bit = __builtin_ctz(value);
+    value &= value - 1;
+    const char *label = table.label[bit];
+    if (label == nullptr)
+      continue;
+    int written = snprintf(buf + pos, size - pos, "%s%s", pos > 0 ? ", " : "", label);
+    if (written < 0)
+      break;
+    pos = std::min(pos + static_cast<size_t>(written), size - 1);
+  }
+  if (pos == 0)
+    snprintf(buf, size, "None");
+}
+
 // --- Thermostat registers (single zone, AWL) ---
 
 static constexpr uint16_t REG_ENTERING_AIR = 740;       // SIGNED_TENTHS
@@ -322,6 +463,57 @@ static constexpr uint16_t FAN_AUTO = 0;
 static constexpr uint16_t FAN_CONTINUOUS = 1;
 static constexpr uint16_t FAN_INTERMITTENT = 2;
 
+// --- Adaptive polling ---
+
+// Outputs that mean the unit is running (compressor, blower or aux heat)
+static constexpr uint16_t OUTPUT_ACTIVE_MASK = OUTPUT_CC | OUTPUT_CC2 | OUTPUT_BLOWER | OUTPUT_EH1 | OUTPUT_EH2;
+
+/// Registers that only move while the unit is running: blower/aux/compressor
+/// amps, refrigeration temperatures and pressures, watts, ECM and VS drive.
+/// With adaptive polling these are read fast during a cycle and slowly in standby.
+inline bool is_state_dependent_register(uint16_t addr) {
+  if (addr == REG_ECM_SPEED)
+    return true;
+  if (addr >= REG_BLOWER_AMPS && addr <= REG_HEATING_LIQUID_LINE)
+    return true;
+  switch (addr) {
+    case REG_REFRIG_LEAVING_AIR:
+    case REG_SUCTION_TEMP:
+    case REG_DISCHARGE_PRESSURE:
+    case REG_SUCTION_PRESSURE:
+    case REG_WATERFLOW:
+      return true;
+    default:
+      break;
+  }
+  if (addr >= REG_SAT_EVAP_TEMP && addr <= REG_PUMP_WATTS_LO)
+    return true;
+  return addr >= REG_VS_SPEED_DESIRED && addr < 4000;
+}
+
+// --- Event-triggered refresh ---
+
+/// When `trigger` changes value, poll groups covering any register in
+/// [first, last] are re-read ahead of the regular cycle.
+struct RegisterDependency {
+  uint16_t trigger;
+  uint16_t first;
+  uint16_t last;
+};
+
+static constexpr RegisterDependency REGISTER_DEPENDENCIES[] = {
+    // Compressor/blower/aux staging: amps, refrigeration, watts, ECM and VS speed
+    {REG_SYSTEM_OUTPUTS, REG_ECM_SPEED, REG_ECM_SPEED},
+    {REG_SYSTEM_OUTPUTS, REG_BLOWER_AMPS, REG_HEATING_LIQUID_LINE},
+    {REG_SYSTEM_OUTPUTS, REG_REFRIG_LEAVING_AIR, REG_WATERFLOW},
+    {REG_SYSTEM_OUTPUTS, REG_SAT_EVAP_TEMP, REG_PUMP_WATTS_LO},
+    {REG_SYSTEM_OUTPUTS, REG_VS_SPEED_DESIRED, REG_VS_SUPERHEAT_TEMP},
+    // AXB outputs switch the loop and DHW pumps
+    {REG_AXB_OUTPUTS, REG_WATERFLOW, REG_WATERFLOW},
+    {REG_AXB_OUTPUTS, REG_PUMP_WATTS_HI, REG_PUMP_WATTS_LO},
+};
+static constexpr size_t REGISTER_DEPENDENCIES_SIZE = sizeof(REGISTER_DEPENDENCIES) / sizeof(REGISTER_DEPENDENCIES[0]);
+
 // --- VS Drive program names ---
 // Register 88 decoded: "ABCVSP", "ABCVSPR", "ABCSPLVS" indicate VS drive
 
@@ -392,14 +584,87 @@ static constexpr FaultInfo FAULT_TABLE[] = {
 
 static constexpr size_t FAULT_TABLE_SIZE = sizeof(FAULT_TABLE) / sizeof(FAULT_TABLE[0]);
 
-inline const char *fault_code_to_string(uint8_t code) {
+// Direct-index form of FAULT_TABLE: description[code] for codes 0-127
+static constexpr uint16_t MAX_FAULT_CODE = 127;
+
+struct FaultCodeTable {
+  const char *description[MAX_FAULT_CODE + 1];
+};
+
+constexpr FaultCodeTable make_fault_code_table() {
+  FaultCodeTable table{};
+  for (size_t i = 0; i < FAULT_TABLE_SIZE; i++)
+    table.description[FAULT_TABLE[i].code] = FAULT_TABLE[i].description;
+  return table;
+}
+
+static constexpr FaultCodeTable FAULT_CODE_TABLE = make_fault_code_table();
+
+// Codes must be in range and unique, and every code must index back to its own entry
+constexpr bool fault_code_table_valid() {
+  size_t described = 0;
   for (size_t i = 0; i < FAULT_TABLE_SIZE; i++) {
-    if (FAULT_TABLE[i].code == code)
-      return FAULT_TABLE[i].description;
+    if (FAULT_TABLE[i].code == 0 || FAULT_TABLE[i].code > MAX_FAULT_CODE)
+      return false;
+    if (FAULT_CODE_TABLE.description[FAULT_TABLE[i].code] != FAULT_TABLE[i].description)
+      return false;
   }
+  for (const char *description : FAULT_CODE_TABLE.description) {
+    if (description != nullptr)
+      described++;
+  }
+  return described == FAULT_TABLE_SIZE;
+}
+static_assert(fault_code_table_valid(), "FAULT_TABLE codes must be unique and within 1-127");
+
+inline const char *fault_code_to_string(uint16_t code) {
+  if (code <= MAX_FAULT_CODE && FAULT_CODE_TABLE.description[code] != nullptr)
+    return FAULT_CODE_TABLE.description[code];
   return "Unknown Fault";
 }
 
+// --- Fault history (registers 25-28) ---
+
+static constexpr uint16_t FAULT_LOCKOUT_FLAG = 0x8000;
+static constexpr size_t FAULT_HISTORY_BUFFER_SIZE = 96;
+
+static_assert(bit_labels_length(OUTPUT_BITS, OUTPUT_BITS_SIZE) < FAULT_HISTORY_BUFFER_SIZE,
+              "OUTPUT_BITS labels do not fit FAULT_HISTORY_BUFFER_SIZE");
+static_assert(bit_labels_length(INPUT_BITS, INPUT_BITS_SIZE) < FAULT_HISTORY_BUFFER_SIZE,
+              "INPUT_BITS labels do not fit FAULT_HISTORY_BUFFER_SIZE");
+
+inline bool is_fault_history_register(uint16_t address) {
+  return address >= REG_LAST_FAULT && address <= REG_INPUTS_AT_LOCKOUT;
+}
+
+/// Decode a fault history register into text:
+///   25/26 (last fault/lockout): "E<code> <description>[ (LOCKOUT)]" or "No Fault"
+///   27 (outputs at lockout) and 28 (inputs at lockout): set bit labels or "None"
+/// Returns false for addresses outside 25-28.
+inline bool format_fault_history(uint16_t address, uint16_t value, char *buf, size_t size) {
+  switch (address) {
+    case REG_LAST_FAULT:
+    case REG_LAST_LOCKOUT: {
+      uint16_t code = value & ~FAULT_LOCKOUT_FLAG;
+      if (code == 0) {
+        snprintf(buf, size, "No Fault");
+      } else {
+        snprintf(buf, size, "E%u %s%s", static_cast<unsigned>(code), fault_code_to_string(code),
+                 (value & FAULT_LOCKOUT_FLAG) ? " (LOCKOUT)" : "");
+      }
+      return true;
+    }
+    case REG_OUTPUTS_AT_LOCKOUT:
+      format_bit_labels(buf, size, value, OUTPUT_BIT_LABELS);
+      return true;
+    case REG_INPUTS_AT_LOCKOUT:
+      format_bit_labels(buf, size, value, INPUT_BIT_LABELS);
+      return true;
+    default:
+      return false;
+  }
+}
+
 // --- Polling register groups ---
 
 // Group 0: System ID (read once at setup)
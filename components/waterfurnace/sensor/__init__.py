@@ -15,7 +15,15 @@ from esphome.const import (
     UNIT_AMPERE,
     UNIT_PERCENT,
 )
-from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA
+from .. import (
+    waterfurnace_ns,
+    WaterFurnace,
+    CONF_WATERFURNACE_ID,
+    WATERFURNACE_CLIENT_SCHEMA,
+    CAPABILITIES,
+    REGISTER_TYPES,
+    add_poll_registers,
+)
 
 DEPENDENCIES = ["waterfurnace"]
 
@@ -86,67 +94,68 @@ CONF_VS_SUPERHEAT_TEMPERATURE = "vs_superheat_temperature"
 CONF_IZ2_OUTDOOR_TEMPERATURE = "iz2_outdoor_temperature"
 CONF_IZ2_DEMAND = "iz2_demand"
 
-# Register address, register type, is_32bit, capability
+# Register address, register type, capability
 # register_type: "signed_tenths", "tenths", "unsigned", "uint32", "int32"
+#                (uint32/int32 span address and address + 1)
 # capability: "none", "awl_thermostat", "awl_axb", "awl_communicating",
 #             "axb", "refrigeration", "energy", "vs_drive", "iz2"
 SENSOR_TYPES = {
-    CONF_ENTERING_WATER_TEMPERATURE: (1111, "signed_tenths", False, "axb"),
-    CONF_LEAVING_WATER_TEMPERATURE: (1110, "signed_tenths", False, "axb"),
-    CONF_OUTDOOR_TEMPERATURE: (742, "signed_tenths", False, "awl_communicating"),
-    CONF_ENTERING_AIR_TEMPERATURE: (740, "signed_tenths", False, "none"),
-    CONF_LEAVING_AIR_TEMPERATURE: (900, "signed_tenths", False, "awl_axb"),
-    CONF_SUCTION_TEMPERATURE: (1113, "signed_tenths", False, "axb"),
-    CONF_DHW_TEMPERATURE: (1114, "signed_tenths", False, "axb"),
-    CONF_DISCHARGE_PRESSURE: (1115, "tenths", False, "axb"),
-    CONF_SUCTION_PRESSURE: (1116, "tenths", False, "axb"),
-    CONF_LOOP_PRESSURE: (1119, "tenths", False, "axb"),
-    CONF_WATERFLOW: (1117, "tenths", False, "axb"),
-    CONF_COMPRESSOR_POWER: (1146, "uint32", True, "energy"),
-    CONF_BLOWER_POWER: (1148, "uint32", True, "energy"),
-    CONF_AUX_HEAT_POWER: (1150, "uint32", True, "energy"),
-    CONF_TOTAL_POWER: (1152, "uint32", True, "energy"),
-    CONF_PUMP_POWER: (1164, "uint32", True, "energy"),
-    CONF_LINE_VOLTAGE: (16, "unsigned", False, "energy"),
-    CONF_COMPRESSOR_AMPS: (1107, "tenths", False, "axb"),
-    CONF_BLOWER_AMPS: (1105, "tenths", False, "axb"),
-    CONF_RELATIVE_HUMIDITY: (741, "unsigned", False, "awl_communicating"),
-    CONF_COMPRESSOR_SPEED: (3001, "unsigned", False, "vs_drive"),
-    CONF_HEAT_OF_EXTRACTION: (1154, "int32", True, "refrigeration"),
-    CONF_HEAT_OF_REJECTION: (1156, "int32", True, "refrigeration"),
-    CONF_AMBIENT_TEMPERATURE: (502, "signed_tenths", False, "awl_thermostat"),
-    CONF_FP1_TEMPERATURE: (19, "signed_tenths", False, "none"),
-    CONF_FP2_TEMPERATURE: (20, "signed_tenths", False, "none"),
-    CONF_SAT_EVAP_TEMPERATURE: (1124, "signed_tenths", False, "refrigeration"),
-    CONF_SUPERHEAT: (1125, "signed_tenths", False, "refrigeration"),
-    CONF_VS_DRIVE_TEMPERATURE: (3327, "signed_tenths", False, "vs_drive"),
-    CONF_VS_LINE_VOLTAGE: (3331, "unsigned", False, "vs_drive"),
-    CONF_VS_THERMO_POWER: (3332, "unsigned", False, "vs_drive"),
-    CONF_VS_COMPRESSOR_POWER: (3422, "uint32", True, "vs_drive"),
-    CONF_VS_SUPPLY_VOLTAGE: (3424, "uint32", True, "vs_drive"),
-    CONF_VS_UDC_VOLTAGE: (3523, "unsigned", False, "vs_drive"),
-    CONF_VS_COMPRESSOR_SPEED_REQUESTED: (3027, "unsigned", False, "vs_drive"),
-    CONF_VS_EEV2_OPEN: (3808, "unsigned", False, "vs_drive"),
-    CONF_VS_DISCHARGE_PRESSURE: (3322, "tenths", False, "vs_drive"),
-    CONF_VS_SUCTION_PRESSURE: (3323, "tenths", False, "vs_drive"),
-    CONF_VS_DISCHARGE_TEMPERATURE: (3325, "signed_tenths", False, "vs_drive"),
-    CONF_VS_COMPRESSOR_AMBIENT_TEMPERATURE: (3326, "signed_tenths", False, "vs_drive"),
-    CONF_VS_ENTERING_WATER_TEMPERATURE: (3330, "signed_tenths", False, "vs_drive"),
-    CONF_VS_INVERTER_TEMPERATURE: (3522, "signed_tenths", False, "vs_drive"),
-    CONF_VS_FAN_SPEED: (3524, "unsigned", False, "vs_drive"),
-    CONF_VS_SUCTION_TEMPERATURE: (3903, "signed_tenths", False, "vs_drive"),
-    CONF_VS_SAT_EVAP_DISCHARGE_TEMPERATURE: (3905, "signed_tenths", False, "vs_drive"),
-    CONF_VS_SUPERHEAT_TEMPERATURE: (3906, "signed_tenths", False, "vs_drive"),
-    CONF_HEATING_LIQUID_LINE_TEMPERATURE: (1109, "signed_tenths", False, "refrigeration"),
-    CONF_REFRIGERANT_LEAVING_AIR_TEMPERATURE: (1112, "signed_tenths", False, "axb"),
-    CONF_AUX_HEAT_AMPS: (1106, "tenths", False, "axb"),
-    CONF_COMPRESSOR_2_AMPS: (1108, "tenths", False, "axb"),
-    CONF_SAT_COND_TEMPERATURE: (1134, "signed_tenths", False, "refrigeration"),
-    CONF_SUBCOOLING_HEATING: (1135, "signed_tenths", False, "vs_drive"),
-    CONF_SUBCOOLING_COOLING: (1136, "signed_tenths", False, "vs_drive"),
-    CONF_ECM_SPEED: (344, "unsigned", False, "none"),
-    CONF_IZ2_OUTDOOR_TEMPERATURE: (31003, "signed_tenths", False, "iz2"),
-    CONF_IZ2_DEMAND: (31005, "unsigned", False, "iz2"),
+    CONF_ENTERING_WATER_TEMPERATURE: (1111, "signed_tenths", "axb"),
+    CONF_LEAVING_WATER_TEMPERATURE: (1110, "signed_tenths", "axb"),
+    CONF_OUTDOOR_TEMPERATURE: (742, "signed_tenths", "awl_communicating"),
+    CONF_ENTERING_AIR_TEMPERATURE: (740, "signed_tenths", "none"),
+    CONF_LEAVING_AIR_TEMPERATURE: (900, "signed_tenths", "awl_axb"),
+    CONF_SUCTION_TEMPERATURE: (1113, "signed_tenths", "axb"),
+    CONF_DHW_TEMPERATURE: (1114, "signed_tenths", "axb"),
+    CONF_DISCHARGE_PRESSURE: (1115, "tenths", "axb"),
+    CONF_SUCTION_PRESSURE: (1116, "tenths", "axb"),
+    CONF_LOOP_PRESSURE: (1119, "tenths", "axb"),
+    CONF_WATERFLOW: (1117, "tenths", "axb"),
+    CONF_COMPRESSOR_POWER: (1146, "uint32", "energy"),
+    CONF_BLOWER_POWER: (1148, "uint32", "energy"),
+    CONF_AUX_HEAT_POWER: (1150, "uint32", "energy"),
+    CONF_TOTAL_POWER: (1152, "uint32", "energy"),
+    CONF_PUMP_POWER: (1164, "uint32", "energy"),
+    CONF_LINE_VOLTAGE: (16, "unsigned", "energy"),
+    CONF_COMPRESSOR_AMPS: (1107, "tenths", "axb"),
+    CONF_BLOWER_AMPS: (1105, "tenths", "axb"),
+    CONF_RELATIVE_HUMIDITY: (741, "unsigned", "awl_communicating"),
+    CONF_COMPRESSOR_SPEED: (3001, "unsigned", "vs_drive"),
+    CONF_HEAT_OF_EXTRACTION: (1154, "int32", "refrigeration"),
+    CONF_HEAT_OF_REJECTION: (1156, "int32", "refrigeration"),
+    CONF_AMBIENT_TEMPERATURE: (502, "signed_tenths", "awl_thermostat"),
+    CONF_FP1_TEMPERATURE: (19, "signed_tenths", "none"),
+    CONF_FP2_TEMPERATURE: (20, "signed_tenths", "none"),
+    CONF_SAT_EVAP_TEMPERATURE: (1124, "signed_tenths", "refrigeration"),
+    CONF_SUPERHEAT: (1125, "signed_tenths", "refrigeration"),
+    CONF_VS_DRIVE_TEMPERATURE: (3327, "signed_tenths", "vs_drive"),
+    CONF_VS_LINE_VOLTAGE: (3331, "unsigned", "vs_drive"),
+    CONF_VS_THERMO_POWER: (3332, "unsigned", "vs_drive"),
+    CONF_VS_COMPRESSOR_POWER: (3422, "uint32", "vs_drive"),
+    CONF_VS_SUPPLY_VOLTAGE: (3424, "uint32", "vs_drive"),
+    CONF_VS_UDC_VOLTAGE: (3523, "unsigned", "vs_drive"),
+    CONF_VS_COMPRESSOR_SPEED_REQUESTED: (3027, "unsigned", "vs_drive"),
+    CONF_VS_EEV2_OPEN: (3808, "unsigned", "vs_drive"),
+    CONF_VS_DISCHARGE_PRESSURE: (3322, "tenths", "vs_drive"),
+    CONF_VS_SUCTION_PRESSURE: (3323, "tenths", "vs_drive"),
+    CONF_VS_DISCHARGE_TEMPERATURE: (3325, "signed_tenths", "vs_drive"),
+    CONF_VS_COMPRESSOR_AMBIENT_TEMPERATURE: (3326, "signed_tenths", "vs_drive"),
+    CONF_VS_ENTERING_WATER_TEMPERATURE: (3330, "signed_tenths", "vs_drive"),
+    CONF_VS_INVERTER_TEMPERATURE: (3522, "signed_tenths", "vs_drive"),
+    CONF_VS_FAN_SPEED: (3524, "unsigned", "vs_drive"),
+    CONF_VS_SUCTION_TEMPERATURE: (3903, "signed_tenths", "vs_drive"),
+    CONF_VS_SAT_EVAP_DISCHARGE_TEMPERATURE: (3905, "signed_tenths", "vs_drive"),
+    CONF_VS_SUPERHEAT_TEMPERATURE: (3906, "signed_tenths", "vs_drive"),
+    CONF_HEATING_LIQUID_LINE_TEMPERATURE: (1109, "signed_tenths", "refrigeration"),
+    CONF_REFRIGERANT_LEAVING_AIR_TEMPERATURE: (1112, "signed_tenths", "axb"),
+    CONF_AUX_HEAT_AMPS: (1106, "tenths", "axb"),
+    CONF_COMPRESSOR_2_AMPS: (1108, "tenths", "axb"),
+    CONF_SAT_COND_TEMPERATURE: (1134, "signed_tenths", "refrigeration"),
+    CONF_SUBCOOLING_HEATING: (1135, "signed_tenths", "vs_drive"),
+    CONF_SUBCOOLING_COOLING: (1136, "signed_tenths", "vs_drive"),
+    CONF_ECM_SPEED: (344, "unsigned", "none"),
+    CONF_IZ2_OUTDOOR_TEMPERATURE: (31003, "signed_tenths", "iz2"),
+    CONF_IZ2_DEMAND: (31005, "unsigned", "iz2"),
 }
 
 # Default sensor schemas with device class and units
@@ -546,7 +555,7 @@ CONFIG_SCHEMA = cv.Schema(
 async def to_code(config):
     parent = await cg.get_variable(config[CONF_WATERFURNACE_ID])
 
-    for key, (register, reg_type, is_32bit, capability) in SENSOR_TYPES.items():
+    for key, (register, reg_type, capability) in SENSOR_TYPES.items():
         if key not in config:
             continue
         conf = config[key]
@@ -555,6 +564,9 @@ async def to_code(config):
         await sensor.register_sensor(var, conf)
         cg.add(var.set_parent(parent))
         cg.add(var.set_register_address(register))
-        cg.add(var.set_register_type(reg_type))
-        cg.add(var.set_is_32bit(is_32bit))
-        cg.add(var.set_capability(capability))
+        cg.add(var.set_register_type(REGISTER_TYPES[reg_type]))
+        cg.add(var.set_capability(CAPABILITIES[capability]))
+        registers = [(register, capability, None)]
+        if reg_type in ("uint32", "int32"):
+            registers.append((register + 1, capability, None))
+        add_poll_registers(config[CONF_WATERFURNACE_ID], registers)
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Lock-free single-producer/single-consumer ring buffer.
+/// Exactly one thread may call push() and exactly one thread may call pop().
+/// N must be a power of two; the queue holds at most N entries.
+template<typename T, size_t N> class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+ public:
+  /// Producer side. Returns false (and drops nothing) when the queue is full.
+  bool push(const T &item) {
+    size_t head = this->head_.load(std::memory_order_relaxed);
+    size_t tail = this->tail_.load(std::memory_order_acquire);
+    if (head - tail >= N)
+      return false;
+    this->slots_[head & (N - 1)] = item;
+    this->head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side. Returns false when the queue is empty.
+  bool pop(T &item) {
+    size_t tail = this->tail_.load(std::memory_order_relaxed);
+    size_t head = this->head_.load(std::memory_order_acquire);
+    if (tail == head)
+      return false;
+    item = this->slots_[tail & (N - 1)];
+    this->tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Approximate number of queued entries (exact when called from either endpoint)
+  size_t size() const {
+    return this->head_.load(std::memory_order_acquire) - this->tail_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return this->size() == 0; }
+  static constexpr size_t capacity() { return N; }
+
+ protected:
+  T slots_[N];
+  // Producer and consumer indices live on separate cache lines
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -5,7 +5,7 @@ from esphome.const import (
     CONF_ID,
     ENTITY_CATEGORY_CONFIG,
 )
-from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA
+from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA, CAPABILITIES, add_poll_registers
 
 DEPENDENCIES = ["waterfurnace"]
 
@@ -37,4 +37,5 @@ async def to_code(config):
         cg.add(var.set_parent(parent))
         cg.add(var.set_register_address(400))
         cg.add(var.set_write_address(400))
-        cg.add(var.set_capability("axb"))
+        cg.add(var.set_capability(CAPABILITIES["axb"]))
+        add_poll_registers(config[CONF_WATERFURNACE_ID], [(400, "axb", None)])
@@ -16,7 +16,7 @@ class WaterFurnaceSwitch : public switch_::Switch, public Component {
   void set_parent(WaterFurnace *parent) { parent_ = parent; }
   void set_register_address(uint16_t addr) { register_address_ = addr; }
   void set_write_address(uint16_t addr) { write_address_ = addr; }
-  void set_capability(const std::string &cap) { capability_ = capability_from_string(cap.c_str()); }
+  void set_capability(RegisterCapability cap) { capability_ = cap; }
 
  protected:
   void write_state(bool state) override;
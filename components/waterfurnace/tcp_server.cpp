@@ -0,0 +1,229 @@
+#include "tcp_server.h"
+#include "esphome/core/log.h"
+
+#include <cerrno>
+
+#ifdef USE_WATERFURNACE_TCP
+
+namespace esphome {
+namespace waterfurnace {
+
+static const char *const TCP_TAG = "waterfurnace.tcp";
+
+// MBAP header: transaction id (2), protocol id (2), length (2), unit id (1)
+static constexpr size_t MBAP_HEADER_SIZE = 7;
+// Longest PDU a Modbus TCP ADU may carry
+static constexpr size_t MAX_PDU_SIZE = 253;
+
+void ModbusTcpServer::setup() {
+  this->socket_ = socket::socket_ip(SOCK_STREAM, 0);
+  if (this->socket_ == nullptr) {
+    ESP_LOGE(TCP_TAG, "Could not create socket");
+    this->mark_failed();
+    return;
+  }
+  int enable = 1;
+  this->socket_->setsockopt(SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  this->socket_->setblocking(false);
+
+  struct sockaddr_storage server;
+  socklen_t len = socket::set_sockaddr_any(reinterpret_cast<struct sockaddr *>(&server), sizeof(server), this->port_);
+  if (len == 0 || this->socket_->bind(reinterpret_cast<struct sockaddr *>(&server), len) != 0 ||
+      this->socket_->listen(MAX_CLIENTS) != 0) {
+    ESP_LOGE(TCP_TAG, "Could not listen on port %u (errno %d)", this->port_, errno);
+    this->mark_failed();
+    return;
+  }
+  this->clients_.reserve(MAX_CLIENTS);
+}
+
+void ModbusTcpServer::loop() {
+  this->accept_();
+  for (size_t i = 0; i < this->clients_.size();) {
+    if (this->serve_(this->clients_[i])) {
+      i++;
+      continue;
+    }
+    this->clients_[i].sock->close();
+    this->clients_.erase(this->clients_.begin() + i);
+  }
+}
+
+void ModbusTcpServer::dump_config() {
+  ESP_LOGCONFIG(TCP_TAG, "WaterFurnace Modbus TCP server:");
+  ESP_LOGCONFIG(TCP_TAG, "  Port: %u", this->port_);
+  ESP_LOGCONFIG(TCP_TAG, "  Writes: %s", this->allow_writes_ ? "allowed" : "refused");
+  if (this->max_age_ > 0) {
+    ESP_LOGCONFIG(TCP_TAG, "  Max age: %ums", this->max_age_);
+  }
+  ESP_LOGCONFIG(TCP_TAG, "  Clients: %u/%u, requests: %u, exceptions: %u", this->clients_.size(), MAX_CLIENTS,
+                this->requests_, this->exceptions_);
+}
+
+void ModbusTcpServer::accept_() {
+  while (true) {
+    struct sockaddr_storage source;
+    socklen_t len = sizeof(source);
+    auto sock = this->socket_->accept(reinterpret_cast<struct sockaddr *>(&source), &len);
+    if (sock == nullptr)
+      return;
+    if (this->clients_.size() >= MAX_CLIENTS) {
+      ESP_LOGW(TCP_TAG, "Too many clients, refusing connection");
+      sock->close();
+      continue;
+    }
+    sock->setblocking(false);
+    this->clients_.push_back({std::move(sock), {}});
+  }
+}
+
+bool ModbusTcpServer::serve_(Client &client) {
+  uint8_t buf[128];
+  while (true) {
+    ssize_t n = client.sock->read(buf, sizeof(buf));
+    if (n == 0)
+      return false;  // Closed by the client
+    if (n < 0) {
+      if (errno == EWOULDBLOCK || errno == EAGAIN)
+        break;
+      return false;
+    }
+    client.rx.insert(client.rx.end(), buf, buf + n);
+  }
+
+  size_t pos = 0;
+  std::vector<uint8_t> &response = this->response_;
+  while (client.rx.size() - pos >= MBAP_HEADER_SIZE) {
+    const uint8_t *adu = client.rx.data() + pos;
+    uint16_t protocol = (adu[2] << 8) | adu[3];
+    uint16_t length = (adu[4] << 8) | adu[5];  // Unit id plus PDU
+    if (protocol != 0 || length < 2 || length > MAX_PDU_SIZE + 1) {
+      ESP_LOGW(TCP_TAG, "Malformed MBAP header, closing connection");
+      return false;
+    }
+    if (client.rx.size() - pos < 6u + length)
+      break;
+
+    this->requests_++;
+    this->handle_pdu(adu + MBAP_HEADER_SIZE, length - 1, response);
+    // Same transaction, protocol and unit id; the length covers the new PDU
+    this->tx_.assign(adu, adu + MBAP_HEADER_SIZE);
+    this->tx_[4] = (response.size() + 1) >> 8;
+    this->tx_[5] = (response.size() + 1) & 0xFF;
+    this->tx_.insert(this->tx_.end(), response.begin(), response.end());
+    if (client.sock->write(this->tx_.data(), this->tx_.size()) != static_cast<ssize_t>(this->tx_.size()))
+      return false;
+    pos += 6u + length;
+  }
+  client.rx.erase(client.rx.begin(), client.rx.begin() + pos);
+  return true;
+}
+
+void ModbusTcpServer::handle_pdu(const uint8_t *pdu, size_t len, std::vector<uint8_t> &response) {
+  response.clear();
+  if (len == 0)
+    return this->exception_(0, EXC_ILLEGAL_FUNCTION, response);
+  uint8_t func = pdu[0];
+  const uint8_t *data = pdu + 1;
+  size_t data_len = len - 1;
+  this->addresses_.clear();
+
+  switch (func) {
+    case FUNC_READ_HOLDING: {
+      if (data_len != 4)
+        return this->exception_(func, EXC_ILLEGAL_VALUE, response);
+      uint16_t start = (data[0] << 8) | data[1];
+      uint16_t count = (data[2] << 8) | data[3];
+      if (count == 0 || count > MAX_REGISTERS_PER_REQUEST)
+        return this->exception_(func, EXC_ILLEGAL_VALUE, response);
+      for (uint16_t i = 0; i < count; i++)
+        this->addresses_.push_back(start + i);
+      return this->read_response_(func, this->addresses_, response);
+    }
+    case FUNC_READ_RANGES: {
+      if (data_len == 0 || data_len % 4 != 0)
+        return this->exception_(func, EXC_ILLEGAL_VALUE, response);
+      for (size_t i = 0; i < data_len; i += 4) {
+        uint16_t start = (data[i] << 8) | data[i + 1];
+        uint16_t count = (data[i + 2] << 8) | data[i + 3];
+        if (this->addresses_.size() + count > MAX_REGISTERS_PER_REQUEST)
+          return this->exception_(func, EXC_ILLEGAL_VALUE, response);
+        for (uint16_t j = 0; j < count; j++)
+          this->addresses_.push_back(start + j);
+      }
+      return this->read_response_(func, this->addresses_, response);
+    }
+    case FUNC_READ_REGISTERS: {
+      if (data_len == 0 || data_len % 2 != 0 || data_len / 2 > MAX_REGISTERS_PER_REQUEST)
+        return this->exception_(func, EXC_ILLEGAL_VALUE, response);
+      for (size_t i = 0; i < data_len; i += 2)
+        this->addresses_.push_back((data[i] << 8) | data[i + 1]);
+      return this->read_response_(func, this->addresses_, response);
+    }
+    case FUNC_WRITE_REGISTERS: {
+      if (!this->allow_writes_)
+        return this->exception_(func, EXC_ILLEGAL_FUNCTION, response);
+      if (data_len == 0 || data_len % 4 != 0)
+        return this->exception_(func, EXC_ILLEGAL_VALUE, response);
+      // Writes queued before the queue filled up stay queued; repeating the
+      // whole request once the client sees busy writes the same values again
+      for (size_t i = 0; i < data_len; i += 4) {
+        if (!this->parent_->write_register((data[i] << 8) | data[i + 1], (data[i + 2] << 8) | data[i + 3]))
+          return this->exception_(func, EXC_SLAVE_BUSY, response);
+      }
+      response.push_back(func);
+      return;
+    }
+    case FUNC_WRITE_SINGLE: {
+      if (!this->allow_writes_)
+        return this->exception_(func, EXC_ILLEGAL_FUNCTION, response);
+      if (data_len != 4)
+        return this->exception_(func, EXC_ILLEGAL_VALUE, response);
+      if (!this->parent_->write_register((data[0] << 8) | data[1], (data[2] << 8) | data[3]))
+        return this->exception_(func, EXC_SLAVE_BUSY, response);
+      response.assign(pdu, pdu + len);  // Echo
+      return;
+    }
+    default:
+      return this->exception_(func, EXC_ILLEGAL_FUNCTION, response);
+  }
+}
+
+uint8_t ModbusTcpServer::read_cached_(uint16_t addr, uint16_t &value) const {
+  if (!this->parent_->get_register(addr, value))
+    return EXC_ILLEGAL_ADDRESS;
+  if (this->max_age_ > 0) {
+    uint32_t age;
+    if (!this->parent_->get_register_age(addr, age) || age > this->max_age_)
+      return EXC_TARGET_NO_RESPONSE;
+  }
+  return 0;
+}
+
+void ModbusTcpServer::read_response_(uint8_t func, const std::vector<uint16_t> &addresses,
+                                     std::vector<uint8_t> &response) {
+  response.push_back(func);
+  response.push_back(addresses.size() * 2);
+  for (uint16_t addr : addresses) {
+    uint16_t value = 0;
+    uint8_t code = this->read_cached_(addr, value);
+    if (code != 0) {
+      ESP_LOGD(TCP_TAG, "Register %u not served (exception 0x%02X)", addr, code);
+      return this->exception_(func, code, response);
+    }
+    response.push_back(value >> 8);
+    response.push_back(value & 0xFF);
+  }
+}
+
+void ModbusTcpServer::exception_(uint8_t func, uint8_t code, std::vector<uint8_t> &response) {
+  this->exceptions_++;
+  response.clear();
+  response.push_back(func | ERROR_MASK);
+  response.push_back(code);
+}
+
+}  // namespace waterfurnace
+}  // namespace esphome
+
+#endif  // USE_WATERFURNACE_TCP
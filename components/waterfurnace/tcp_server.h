@@ -0,0 +1,86 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_WATERFURNACE_TCP
+
+#include "esphome/core/component.h"
+#include "esphome/components/socket/socket.h"
+#include "waterfurnace.h"
+
+#include <memory>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Modbus TCP server in front of the hub's register cache. Reads (func 3, 65
+/// and 66) are answered from the cache and never reach the RS-485 bus;
+/// writes (func 67 and 6), when allowed, go into the hub's write queue and are
+/// acknowledged once queued, or refused as busy while the queue is full. Registers the hub does not have cached, or (with a max age)
+/// has not read recently enough, are refused with an exception.
+class ModbusTcpServer : public Component {
+ public:
+  static constexpr uint8_t MAX_CLIENTS = 4;
+  static constexpr uint8_t FUNC_READ_HOLDING = 3;
+  // Modbus exception codes
+  static constexpr uint8_t EXC_ILLEGAL_FUNCTION = 0x01;
+  static constexpr uint8_t EXC_ILLEGAL_ADDRESS = 0x02;
+  static constexpr uint8_t EXC_ILLEGAL_VALUE = 0x03;
+  static constexpr uint8_t EXC_SLAVE_BUSY = 0x06;  // Write queue full
+  static constexpr uint8_t EXC_TARGET_NO_RESPONSE = 0x0B;  // Cached value older than max age
+
+  explicit ModbusTcpServer(WaterFurnace *parent) : parent_(parent) {}
+
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::AFTER_WIFI; }
+
+  void set_port(uint16_t port) { port_ = port; }
+  // Accept writes; off, they get an illegal function exception
+  void set_allow_writes(bool allow_writes) { allow_writes_ = allow_writes; }
+  // Refuse cached values older than this (ms); 0 serves any cached value
+  void set_max_age(uint32_t max_age) {
+    max_age_ = max_age;
+    if (max_age > 0)
+      parent_->track_read_times();
+  }
+
+  /// Answer one request PDU (function code onwards) into `response`
+  void handle_pdu(const uint8_t *pdu, size_t len, std::vector<uint8_t> &response);
+
+  uint32_t requests() const { return requests_; }
+  uint32_t exceptions() const { return exceptions_; }
+
+ protected:
+  struct Client {
+    std::unique_ptr<socket::Socket> sock;
+    std::vector<uint8_t> rx;
+  };
+
+  void accept_();
+  // Read what the client sent and answer every complete ADU; false once it should be dropped
+  bool serve_(Client &client);
+  // 0 if the register can be served, else the exception code
+  uint8_t read_cached_(uint16_t addr, uint16_t &value) const;
+  void read_response_(uint8_t func, const std::vector<uint16_t> &addresses, std::vector<uint8_t> &response);
+  void exception_(uint8_t func, uint8_t code, std::vector<uint8_t> &response);
+
+  WaterFurnace *parent_;
+  uint16_t port_{502};
+  uint32_t max_age_{0};
+  bool allow_writes_{false};
+  std::unique_ptr<socket::Socket> socket_;
+  std::vector<Client> clients_;
+  std::vector<uint16_t> addresses_;  // Reused per read request
+  std::vector<uint8_t> response_;    // Reused per response PDU
+  std::vector<uint8_t> tx_;          // Reused per response ADU
+  uint32_t requests_{0};
+  uint32_t exceptions_{0};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
+
+#endif  // USE_WATERFURNACE_TCP
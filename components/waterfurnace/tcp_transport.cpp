@@ -0,0 +1,246 @@
+#include "tcp_transport.h"
+#include "protocol.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
+#ifdef USE_WATERFURNACE_TCP
+
+#if defined(USE_ESP32) || defined(USE_ESP8266) || defined(USE_RP2040) || defined(USE_LIBRETINY)
+#define WATERFURNACE_LWIP_DNS
+#include <lwip/dns.h>
+#endif
+
+namespace esphome {
+namespace waterfurnace {
+
+static const char *const TRANSPORT_TAG = "waterfurnace.transport";
+
+// MBAP header: transaction id (2), protocol id (2), length (2), unit id (1)
+static constexpr size_t MBAP_HEADER_SIZE = 7;
+
+void TcpTransport::loop() {
+  uint32_t now = millis();
+  if (this->socket_ != nullptr) {
+    if (!this->connected_)
+      this->check_connect_(now);
+    return;
+  }
+  if (this->lookup_ != Lookup::NONE) {
+    // The attempt goes on once the gateway's name has been looked up
+    if (this->lookup_ == Lookup::PENDING)
+      return;
+    this->last_attempt_ = now;
+    this->connect_();
+    return;
+  }
+  if (this->attempted_ && now - this->last_attempt_ < RECONNECT_INTERVAL)
+    return;
+  this->attempted_ = true;
+  this->last_attempt_ = now;
+  this->connect_();
+}
+
+void TcpTransport::connect_() {
+  struct sockaddr_storage server;
+  socklen_t len = this->resolve_(reinterpret_cast<struct sockaddr *>(&server), sizeof(server));
+  if (len == 0)
+    return;
+  auto sock = socket::socket_ip(SOCK_STREAM, 0);
+  if (sock == nullptr) {
+    ESP_LOGW(TRANSPORT_TAG, "Could not create socket");
+    return;
+  }
+  int enable = 1;
+  sock->setsockopt(IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  // Non-blocking connect: loop() must not stall while an unreachable gateway times out
+  sock->setblocking(false);
+  if (sock->connect(reinterpret_cast<struct sockaddr *>(&server), len) != 0 && errno != EINPROGRESS) {
+    ESP_LOGW(TRANSPORT_TAG, "Could not connect to %s:%u (errno %d)", this->host_.c_str(), this->port_, errno);
+    sock->close();
+    return;
+  }
+  this->socket_ = std::move(sock);
+  this->connected_ = false;
+  this->check_connect_(this->last_attempt_);
+}
+
+socklen_t TcpTransport::resolve_(struct sockaddr *addr, socklen_t addrlen) {
+  Lookup lookup = this->lookup_;
+  this->lookup_ = Lookup::NONE;
+  if (lookup == Lookup::FOUND) {
+    const auto *octets = reinterpret_cast<const volatile uint8_t *>(&this->resolved_);
+    char ip[16];
+    snprintf(ip, sizeof(ip), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+    return socket::set_sockaddr(addr, addrlen, ip, this->port_);
+  }
+  if (lookup == Lookup::FAILED) {
+    ESP_LOGW(TRANSPORT_TAG, "Could not resolve %s", this->host_.c_str());
+    return 0;
+  }
+  // An address needs no lookup
+  socklen_t len = socket::set_sockaddr(addr, addrlen, this->host_, this->port_);
+  if (len != 0)
+    return len;
+#ifdef WATERFURNACE_LWIP_DNS
+  ip_addr_t found;
+  this->lookup_ = Lookup::PENDING;
+  err_t err = dns_gethostbyname(
+      this->host_.c_str(), &found,
+      [](const char *, const ip_addr_t *ip, void *arg) {
+        auto *self = static_cast<TcpTransport *>(arg);
+        if (ip != nullptr)
+          self->resolved_ = ip4_addr_get_u32(ip_2_ip4(ip));
+        self->lookup_ = ip != nullptr ? Lookup::FOUND : Lookup::FAILED;
+      },
+      this);
+  if (err == ERR_OK) {
+    // Cached: connect straight away
+    this->resolved_ = ip4_addr_get_u32(ip_2_ip4(&found));
+    this->lookup_ = Lookup::FOUND;
+    return this->resolve_(addr, addrlen);
+  }
+  if (err != ERR_INPROGRESS) {
+    this->lookup_ = Lookup::NONE;
+    ESP_LOGW(TRANSPORT_TAG, "Could not resolve %s (error %d)", this->host_.c_str(), err);
+  }
+#else
+  ESP_LOGW(TRANSPORT_TAG, "Invalid gateway address %s", this->host_.c_str());
+#endif
+  return 0;
+}
+
+void TcpTransport::check_connect_(uint32_t now) {
+  struct sockaddr_storage peer;
+  socklen_t len = sizeof(peer);
+  if (this->socket_->getpeername(reinterpret_cast<struct sockaddr *>(&peer), &len) == 0) {
+    this->connected_ = true;
+    this->connects_++;
+    ESP_LOGI(TRANSPORT_TAG, "Connected to %s:%u", this->host_.c_str(), this->port_);
+    return;
+  }
+  int error = 0;
+  socklen_t error_len = sizeof(error);
+  this->socket_->getsockopt(SOL_SOCKET, SO_ERROR, &error, &error_len);
+  if (error != 0 || now - this->last_attempt_ >= CONNECT_TIMEOUT) {
+    ESP_LOGW(TRANSPORT_TAG, "Could not connect to %s:%u (error %d)", this->host_.c_str(), this->port_, error);
+    this->socket_->close();
+    this->socket_.reset();
+  }
+}
+
+void TcpTransport::disconnect_(const char *reason) {
+  ESP_LOGW(TRANSPORT_TAG, "Connection to %s:%u lost (%s)", this->host_.c_str(), this->port_, reason);
+  this->socket_->close();
+  this->socket_.reset();
+  this->connected_ = false;
+  this->disconnects_++;
+  this->mbap_.clear();
+  this->rx_.clear();
+  this->rx_head_ = 0;
+  this->last_attempt_ = millis();
+}
+
+void TcpTransport::send(const uint8_t *frame, size_t len) {
+  if (!this->connected_ || len < MIN_FRAME_SIZE)
+    return;
+  const uint8_t *out = frame;
+  size_t out_len = len;
+  if (this->framing_ == Framing::MBAP) {
+    // Unit id and PDU: the RTU frame without its CRC
+    size_t length = len - 2;
+    this->transaction_id_++;
+    this->tx_.assign({static_cast<uint8_t>(this->transaction_id_ >> 8),
+                      static_cast<uint8_t>(this->transaction_id_ & 0xFF), 0, 0, static_cast<uint8_t>(length >> 8),
+                      static_cast<uint8_t>(length & 0xFF)});
+    this->tx_.insert(this->tx_.end(), frame, frame + length);
+    out = this->tx_.data();
+    out_len = this->tx_.size();
+  }
+  ssize_t written = this->socket_->write(out, out_len);
+  if (written < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) {
+    // The hub times the request out and carries on
+    ESP_LOGW(TRANSPORT_TAG, "Send buffer full, request dropped");
+    return;
+  }
+  if (written != static_cast<ssize_t>(out_len))
+    this->disconnect_("write failed");
+}
+
+size_t TcpTransport::read(uint8_t *buf, size_t len) {
+  this->receive_();
+  size_t n = std::min(len, this->rx_.size() - this->rx_head_);
+  std::copy(this->rx_.begin() + this->rx_head_, this->rx_.begin() + this->rx_head_ + n, buf);
+  this->rx_head_ += n;
+  if (this->rx_head_ == this->rx_.size()) {
+    this->rx_.clear();
+    this->rx_head_ = 0;
+  }
+  return n;
+}
+
+void TcpTransport::receive_() {
+  if (!this->connected_)
+    return;
+  std::vector<uint8_t> &dest = this->framing_ == Framing::MBAP ? this->mbap_ : this->rx_;
+  uint8_t buf[128];
+  while (true) {
+    ssize_t n = this->socket_->read(buf, sizeof(buf));
+    if (n == 0) {
+      this->disconnect_("closed by gateway");
+      return;
+    }
+    if (n < 0) {
+      if (errno == EWOULDBLOCK || errno == EAGAIN)
+        break;
+      this->disconnect_("read failed");
+      return;
+    }
+    dest.insert(dest.end(), buf, buf + n);
+  }
+  if (this->framing_ == Framing::MBAP)
+    this->unwrap_mbap_();
+}
+
+void TcpTransport::unwrap_mbap_() {
+  size_t pos = 0;
+  while (this->mbap_.size() - pos >= MBAP_HEADER_SIZE) {
+    const uint8_t *adu = this->mbap_.data() + pos;
+    uint16_t transaction = (adu[0] << 8) | adu[1];
+    uint16_t protocol = (adu[2] << 8) | adu[3];
+    uint16_t length = (adu[4] << 8) | adu[5];  // Unit id plus PDU
+    if (protocol != 0 || length < 2 || length > MAX_FRAME_SIZE - 2) {
+      this->disconnect_("malformed MBAP header");
+      return;
+    }
+    if (this->mbap_.size() - pos < 6u + length)
+      break;
+    if (transaction == this->transaction_id_) {
+      // Back to RTU: unit id and PDU, then the CRC the gateway stripped
+      size_t start = this->rx_.size();
+      this->rx_.insert(this->rx_.end(), adu + 6, adu + 6 + length);
+      uint16_t crc = crc16(this->rx_.data() + start, length);
+      this->rx_.push_back(crc & 0xFF);
+      this->rx_.push_back(crc >> 8);
+    } else {
+      ESP_LOGD(TRANSPORT_TAG, "Dropping response to stale transaction %u", transaction);
+    }
+    pos += 6u + length;
+  }
+  this->mbap_.erase(this->mbap_.begin(), this->mbap_.begin() + pos);
+}
+
+void TcpTransport::dump_config() {
+  ESP_LOGCONFIG(TRANSPORT_TAG, "  Transport: %s to %s:%u (%s)",
+                this->framing_ == Framing::MBAP ? "Modbus TCP" : "RTU over TCP", this->host_.c_str(), this->port_,
+                this->connected_ ? "connected" : "disconnected");
+  ESP_LOGCONFIG(TRANSPORT_TAG, "    Connects: %u, disconnects: %u", this->connects_, this->disconnects_);
+}
+
+}  // namespace waterfurnace
+}  // namespace esphome
+
+#endif  // USE_WATERFURNACE_TCP
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_WATERFURNACE_TCP
+
+#include "esphome/components/socket/socket.h"
+#include "transport.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Reaches the heat pump through a network gateway.
+///
+/// MBAP: a Modbus TCP gateway. Each request loses its slave address and CRC
+/// and gains an MBAP header (the slave address becomes the unit id); each
+/// response is turned back into an RTU frame with a freshly computed CRC.
+/// Responses whose transaction id does not match the last request are
+/// dropped, so a late answer to a timed-out request cannot be mistaken for
+/// the current one.
+///
+/// RTU: a transparent serial bridge (ser2net and the like). Frames pass
+/// through unchanged, so everything on the bus, including another master's
+/// traffic, reaches the hub.
+///
+/// The gateway's host is an IPv4 address or a host name; names are looked up
+/// with lwIP's asynchronous resolver before every connection attempt.
+class TcpTransport : public Transport {
+ public:
+  enum class Framing : uint8_t {
+    MBAP,
+    RTU,
+  };
+  /// Wait between connection attempts
+  static constexpr uint32_t RECONNECT_INTERVAL = 5000;
+  /// Give up on a connection attempt the gateway has not answered
+  static constexpr uint32_t CONNECT_TIMEOUT = 3000;
+
+  explicit TcpTransport(Framing framing) : framing_(framing) {}
+
+  void set_host(const std::string &host) { host_ = host; }
+  void set_port(uint16_t port) { port_ = port; }
+
+  void loop() override;
+  bool is_connected() const override { return connected_; }
+  void send(const uint8_t *frame, size_t len) override;
+  size_t read(uint8_t *buf, size_t len) override;
+  void dump_config() override;
+
+  uint32_t connects() const { return connects_; }
+  uint32_t disconnects() const { return disconnects_; }
+
+ protected:
+  void connect_();
+  // host_ as a socket address, or 0 while its lookup is pending or after it failed
+  socklen_t resolve_(struct sockaddr *addr, socklen_t addrlen);
+  // Finish a pending non-blocking connect (or give up on it)
+  void check_connect_(uint32_t now);
+  void disconnect_(const char *reason);
+  // Move what the socket has into rx_ (unwrapping MBAP responses)
+  void receive_();
+  void unwrap_mbap_();
+
+  Framing framing_;
+  std::string host_;
+  uint16_t port_{502};
+  enum class Lookup : uint8_t {
+    NONE,
+    PENDING,
+    FOUND,
+    FAILED,
+  };
+  // Written by the resolver's callback, which may run in the network stack's task
+  volatile Lookup lookup_{Lookup::NONE};
+  volatile uint32_t resolved_{0};  // IPv4 address, network byte order
+  std::unique_ptr<socket::Socket> socket_;
+  bool connected_{false};  // False while a connect is still pending
+  uint32_t last_attempt_{0};
+  bool attempted_{false};
+  uint16_t transaction_id_{0};
+  std::vector<uint8_t> tx_;    // Reused per MBAP request
+  std::vector<uint8_t> mbap_;  // MBAP bytes not yet unwrapped
+  std::vector<uint8_t> rx_;    // RTU bytes for the hub
+  size_t rx_head_{0};
+  uint32_t connects_{0};
+  uint32_t disconnects_{0};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
+
+#endif  // USE_WATERFURNACE_TCP
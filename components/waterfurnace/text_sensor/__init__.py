@@ -5,7 +5,7 @@ from esphome.const import (
     CONF_ID,
     ENTITY_CATEGORY_DIAGNOSTIC,
 )
-from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA
+from .. import waterfurnace_ns, WaterFurnace, CONF_WATERFURNACE_ID, WATERFURNACE_CLIENT_SCHEMA, add_poll_registers
 
 DEPENDENCIES = ["waterfurnace"]
 
@@ -14,6 +14,7 @@ WaterFurnaceTextSensor = waterfurnace_ns.class_(
 )
 
 CONF_CURRENT_FAULT = "current_fault"
+CONF_LAST_LOCKOUT = "last_lockout"
 CONF_MODEL_NUMBER = "model_number"
 CONF_SERIAL_NUMBER = "serial_number"
 CONF_SYSTEM_MODE = "system_mode"
@@ -22,6 +23,7 @@ CONF_INPUTS_AT_LOCKOUT = "inputs_at_lockout"
 
 TEXT_SENSOR_TYPES = {
     CONF_CURRENT_FAULT: "fault",
+    CONF_LAST_LOCKOUT: "last_lockout",
     CONF_MODEL_NUMBER: "model",
     CONF_SERIAL_NUMBER: "serial",
     CONF_SYSTEM_MODE: "mode",
@@ -29,11 +31,26 @@ TEXT_SENSOR_TYPES = {
     CONF_INPUTS_AT_LOCKOUT: "inputs_at_lockout",
 }
 
+# Registers each type listens on: (address, capability, when)
+TEXT_SENSOR_REGISTERS = {
+    "fault": [(25, "none", None)],
+    "last_lockout": [(26, "none", None)],
+    "model": [],
+    "serial": [],
+    "mode": [(30, "none", None), (362, "vs_drive", None), (6, "none", None)],
+    "outputs_at_lockout": [(27, "none", None)],
+    "inputs_at_lockout": [(28, "none", None)],
+}
+
 TEXT_SENSOR_SCHEMAS = {
     CONF_CURRENT_FAULT: text_sensor.text_sensor_schema(
         entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
         icon="mdi:alert",
     ),
+    CONF_LAST_LOCKOUT: text_sensor.text_sensor_schema(
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        icon="mdi:alert-octagon",
+    ),
     CONF_MODEL_NUMBER: text_sensor.text_sensor_schema(
         entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
         icon="mdi:information",
@@ -79,3 +96,4 @@ async def to_code(config):
         await text_sensor.register_text_sensor(var, conf)
         cg.add(var.set_parent(parent))
         cg.add(var.set_sensor_type(sensor_type))
+        add_poll_registers(config[CONF_WATERFURNACE_ID], TEXT_SENSOR_REGISTERS[sensor_type])
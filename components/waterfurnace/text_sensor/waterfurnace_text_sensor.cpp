@@ -6,52 +6,45 @@ namespace waterfurnace {
 
 static const char *const TAG = "waterfurnace.text_sensor";
 
-static std::string bitmask_to_string(uint16_t value, const BitLabel *bits, size_t count) {
-  if (value == 0)
-    return "None";
-  std::string result;
-  for (size_t i = 0; i < count; i++) {
-    if (value & bits[i].mask) {
-      if (!result.empty())
-        result += ", ";
-      result += bits[i].label;
-    }
-  }
-  return result.empty() ? "None" : result;
-}
+// System mode states; dedup compares these pointers
+static const char *const MODE_LOCKOUT = "Lockout";
+static const char *const MODE_DEHUMIDIFY = "Dehumidify";
+static const char *const MODE_COOLING = "Cooling";
+static const char *const MODE_HEATING_WITH_AUX = "Heating with Aux";
+static const char *const MODE_HEATING = "Heating";
+static const char *const MODE_EMERGENCY_HEAT = "Emergency Heat";
+static const char *const MODE_FAN_ONLY = "Fan Only";
+static const char *const MODE_WAITING = "Waiting";
+static const char *const MODE_STANDBY = "Standby";
 
 void WaterFurnaceTextSensor::setup() {
   if (this->sensor_type_ == "fault") {
-    this->parent_->register_listener(REG_LAST_FAULT, [this](uint16_t v) {
-      this->on_fault_register_(v);
-    });
+    this->register_fault_history_(REG_LAST_FAULT);
+  } else if (this->sensor_type_ == "last_lockout") {
+    this->register_fault_history_(REG_LAST_LOCKOUT);
   } else if (this->sensor_type_ == "model") {
     // Model is read once during hub setup; publish after detection completes
     this->parent_->register_setup_callback([this]() {
-      this->publish_state_dedup_(this->parent_->model_number());
+      this->publish_state(this->parent_->model_number());
     });
   } else if (this->sensor_type_ == "serial") {
     this->parent_->register_setup_callback([this]() {
-      this->publish_state_dedup_(this->parent_->serial_number());
+      this->publish_state(this->parent_->serial_number());
     });
   } else if (this->sensor_type_ == "mode") {
     this->parent_->register_listener(REG_SYSTEM_OUTPUTS, [this](uint16_t v) {
       this->on_system_outputs_(v);
-    });
+    }, RegisterCapability::NONE, this);
     this->parent_->register_listener(REG_ACTIVE_DEHUMIDIFY, [this](uint16_t v) {
       this->on_active_dehumidify_(v);
-    }, RegisterCapability::VS_DRIVE);
+    }, RegisterCapability::VS_DRIVE, this);
     this->parent_->register_listener(REG_COMPRESSOR_DELAY, [this](uint16_t v) {
       this->on_compressor_delay_(v);
-    });
+    }, RegisterCapability::NONE, this);
   } else if (this->sensor_type_ == "outputs_at_lockout") {
-    this->parent_->register_listener(REG_OUTPUTS_AT_LOCKOUT, [this](uint16_t v) {
-      this->publish_state_dedup_(bitmask_to_string(v, OUTPUT_BITS, OUTPUT_BITS_SIZE));
-    });
+    this->register_fault_history_(REG_OUTPUTS_AT_LOCKOUT);
   } else if (this->sensor_type_ == "inputs_at_lockout") {
-    this->parent_->register_listener(REG_INPUTS_AT_LOCKOUT, [this](uint16_t v) {
-      this->publish_state_dedup_(bitmask_to_string(v, INPUT_BITS, INPUT_BITS_SIZE));
-    });
+    this->register_fault_history_(REG_INPUTS_AT_LOCKOUT);
   }
 }
 
@@ -60,20 +53,14 @@ void WaterFurnaceTextSensor::dump_config() {
   ESP_LOGCONFIG(TAG, "  Type: %s", this->sensor_type_.c_str());
 }
 
-void WaterFurnaceTextSensor::on_fault_register_(uint16_t value) {
-  bool locked_out = (value & 0x8000) != 0;
-  uint8_t fault_code = value & 0x7FFF;
-
-  if (fault_code == 0) {
-    this->publish_state_dedup_("No Fault");
-    return;
-  }
-
-  char buf[64];
-  const char *desc = fault_code_to_string(fault_code);
-  snprintf(buf, sizeof(buf), "E%d %s%s", fault_code, desc,
-           locked_out ? " (LOCKOUT)" : "");
-  this->publish_state_dedup_(buf);
+void WaterFurnaceTextSensor::register_fault_history_(uint16_t address) {
+  this->parent_->register_listener(address, [this, address](uint16_t v) {
+    if (!this->raw_changed_(v))
+      return;
+    char buf[FAULT_HISTORY_BUFFER_SIZE];
+    format_fault_history(address, v, buf, sizeof(buf));
+    this->publish_state(buf);
+  }, RegisterCapability::NONE, this);
 }
 
 void WaterFurnaceTextSensor::on_system_outputs_(uint16_t value) {
@@ -98,35 +85,43 @@ void WaterFurnaceTextSensor::compute_system_mode_() {
   uint16_t outputs = this->system_outputs_;
 
   if (outputs & OUTPUT_LOCKOUT) {
-    this->publish_state_dedup_("Lockout");
+    this->publish_mode_(MODE_LOCKOUT);
   } else if (this->active_dehumidify_ != 0) {
-    this->publish_state_dedup_("Dehumidify");
+    this->publish_mode_(MODE_DEHUMIDIFY);
   } else if ((outputs & OUTPUT_CC) || (outputs & OUTPUT_CC2)) {
     // Compressor running - check if cooling, heating with aux, or plain heating
     if (outputs & OUTPUT_RV) {
-      this->publish_state_dedup_("Cooling");
+      this->publish_mode_(MODE_COOLING);
     } else if (outputs & (OUTPUT_EH1 | OUTPUT_EH2)) {
-      this->publish_state_dedup_("Heating with Aux");
+      this->publish_mode_(MODE_HEATING_WITH_AUX);
     } else {
-      this->publish_state_dedup_("Heating");
+      this->publish_mode_(MODE_HEATING);
     }
   } else if (outputs & (OUTPUT_EH1 | OUTPUT_EH2)) {
     // EH without compressor = emergency heat
-    this->publish_state_dedup_("Emergency Heat");
+    this->publish_mode_(MODE_EMERGENCY_HEAT);
   } else if (outputs & OUTPUT_BLOWER) {
-    this->publish_state_dedup_("Fan Only");
+    this->publish_mode_(MODE_FAN_ONLY);
   } else if (this->compressor_delay_ != 0) {
-    this->publish_state_dedup_("Waiting");
+    this->publish_mode_(MODE_WAITING);
   } else {
-    this->publish_state_dedup_("Standby");
+    this->publish_mode_(MODE_STANDBY);
   }
 }
 
-void WaterFurnaceTextSensor::publish_state_dedup_(const std::string &state) {
-  if (state == this->last_published_state_)
+bool WaterFurnaceTextSensor::raw_changed_(uint16_t value) {
+  if (this->has_last_raw_ && value == this->last_raw_)
+    return false;
+  this->last_raw_ = value;
+  this->has_last_raw_ = true;
+  return true;
+}
+
+void WaterFurnaceTextSensor::publish_mode_(const char *mode) {
+  if (mode == this->last_mode_)
     return;
-  this->last_published_state_ = state;
-  this->publish_state(state);
+  this->last_mode_ = mode;
+  this->publish_state(mode);
 }
 
 }  // namespace waterfurnace
@@ -19,16 +19,22 @@ class WaterFurnaceTextSensor : public text_sensor::TextSensor, public Component
   void set_sensor_type(const std::string &type) { sensor_type_ = type; }
 
  protected:
-  void on_fault_register_(uint16_t value);
+  // Fault history registers (25-28) share one decoder
+  void register_fault_history_(uint16_t address);
   void on_system_outputs_(uint16_t value);
   void on_active_dehumidify_(uint16_t value);
   void on_compressor_delay_(uint16_t value);
   void compute_system_mode_();
-  void publish_state_dedup_(const std::string &state);
+  // Dedup on the raw register value, so unchanged values are never formatted
+  bool raw_changed_(uint16_t value);
+  // `mode` must be one of the static MODE_* strings; dedup compares pointers
+  void publish_mode_(const char *mode);
 
   WaterFurnace *parent_{nullptr};
   std::string sensor_type_;
-  std::string last_published_state_;
+  uint16_t last_raw_{0};
+  bool has_last_raw_{false};
+  const char *last_mode_{nullptr};
 
   // Cached register values for system mode computation
   uint16_t system_outputs_{0};
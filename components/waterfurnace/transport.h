@@ -0,0 +1,68 @@
+#pragma once
+
+#include "esphome/core/gpio.h"
+#include "esphome/components/uart/uart.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Carries RTU frames between the hub and the heat pump. The hub always
+/// speaks RTU (slave address, PDU, CRC); a backend that puts something else
+/// on the wire translates in both directions, so the state machine, poll
+/// planner and cache never see the difference.
+class Transport {
+ public:
+  virtual ~Transport() = default;
+
+  /// Called from the hub's loop(); network backends (re)connect here
+  virtual void loop() {}
+  /// False while a network backend has no connection; the hub holds its
+  /// transactions until it comes back
+  virtual bool is_connected() const { return true; }
+  /// Send one complete RTU request frame
+  virtual void send(const uint8_t *frame, size_t len) = 0;
+  /// Copy up to `len` received bytes into `buf`; returns how many
+  virtual size_t read(uint8_t *buf, size_t len) = 0;
+  virtual void dump_config() {}
+
+  /// Throw away whatever has been received but not read
+  void discard() {
+    uint8_t buf[32];
+    while (this->read(buf, sizeof(buf)) > 0) {
+    }
+  }
+};
+
+/// RS-485 through a local UART, with an optional driver-enable pin
+class UartTransport : public Transport {
+ public:
+  explicit UartTransport(uart::UARTDevice *uart) : uart_(uart) {}
+
+  void set_flow_control_pin(GPIOPin *pin) { flow_control_pin_ = pin; }
+
+  void send(const uint8_t *frame, size_t len) override {
+    if (this->flow_control_pin_ != nullptr)
+      this->flow_control_pin_->digital_write(true);
+    this->uart_->write_array(frame, len);
+    this->uart_->flush();
+    if (this->flow_control_pin_ != nullptr)
+      this->flow_control_pin_->digital_write(false);
+  }
+
+  size_t read(uint8_t *buf, size_t len) override {
+    size_t n = 0;
+    while (n < len && this->uart_->available() && this->uart_->read_byte(&buf[n]))
+      n++;
+    return n;
+  }
+
+ protected:
+  uart::UARTDevice *uart_;
+  GPIOPin *flow_control_pin_{nullptr};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -3,6 +3,7 @@
 #include "esphome/core/helpers.h"
 
 #include <algorithm>
+#include <bitset>
 
 #ifdef USE_API_CUSTOM_SERVICES
 #include "esphome/components/api/custom_api_device.h"
@@ -22,35 +23,107 @@ void WaterFurnace::setup() {
   this->setup_phase_ = 0;
   this->last_successful_response_ = millis();
   this->update_connected_(false);
+  this->sniffer_.set_slave(this->address_);
+  this->passive_since_ = millis();
+  this->capture_.set_slave(this->address_);
+  this->capture_.begin();
+  if (this->freeze_frame_.begin())
+    this->register_listener(REG_LAST_FAULT, [this](uint16_t value) { this->note_fault_(value); });
+
+  if (this->use_bus_task_) {
+    this->bus_task_ = new BusTask(this, this->flow_control_pin_, RESPONSE_TIMEOUT);
+    if (!this->bus_task_->start(this->bus_task_core_)) {
+      ESP_LOGE(TAG, "Bus task failed to start, falling back to inline UART I/O");
+      delete this->bus_task_;
+      this->bus_task_ = nullptr;
+    }
+  }
 
 #ifdef USE_API_CUSTOM_SERVICES
-  register_service(&WaterFurnace::on_write_register_service_, "write_register",
+  register_service(&WaterFurnace::on_write_register_service_, "write_register" + this->service_suffix_,
                    {"address", "value"});
+  register_service(&WaterFurnace::on_read_registers_service_, "read_registers" + this->service_suffix_,
+                   {"registers", "max_age"});
+  register_service(&WaterFurnace::on_dump_registers_service_, "dump_registers" + this->service_suffix_,
+                   {"registers", "duty_cycle"});
+  // read_registers serves cached values by age
+  this->track_read_times_ = true;
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+  register_service(&WaterFurnace::on_dump_dispatch_profile_service_, "dump_dispatch_profile" + this->service_suffix_,
+                   {"top"});
+  register_service(&WaterFurnace::on_reset_dispatch_profile_service_,
+                   "reset_dispatch_profile" + this->service_suffix_);
+#endif
+  if (this->capture_.enabled())
+    register_service(&WaterFurnace::on_dump_capture_service_, "dump_capture" + this->service_suffix_);
+  if (this->freeze_frame_.enabled())
+    register_service(&WaterFurnace::on_dump_freeze_frames_service_, "dump_freeze_frames" + this->service_suffix_);
 #endif
 
   ESP_LOGI(TAG, "WaterFurnace hub initializing...");
 }
 
 void WaterFurnace::update() {
-  // PollingComponent::update() triggers a new poll cycle
-  // The actual polling happens in loop() via the state machine
-  if (this->state_ == State::IDLE) {
-    this->current_poll_group_ = 0;
-    this->poll_next_group_();
+  // PollingComponent::update() queues a new poll cycle
+  // The actual polling happens in loop() as the transaction queue drains
+  this->publish_bus_stats_();
+
+  uint32_t now = millis();
+  uint32_t interval = this->get_update_interval();
+  // Burst: every group released now. Paced: one group per slot across the interval.
+  uint32_t spacing = this->poll_mode_ == PollMode::PACED ? this->poll_spacing_() : 0;
+  bool overrun = false;
+  for (size_t i = 0; i < this->poll_groups_.size(); i++) {
+    PollGroup *group = &this->poll_groups_[i];
+    if (this->is_queued_(group)) {
+      overrun = true;
+      continue;
+    }
+    uint32_t release = now + i * spacing;
+    if (this->passive_) {
+      this->enqueue_stale_(group, TransactionClass::POLL_FAST, release, release + interval, now);
+      continue;
+    }
+    this->enqueue_group_(group, TransactionClass::POLL_FAST, release, release + interval);
   }
+  if (overrun)
+    ESP_LOGD(TAG, "Previous poll cycle still running, %u transactions queued", this->queue_.size());
+
+  if (this->state_ == State::IDLE)
+    this->start_next_transaction_(now);
 }
 
 void WaterFurnace::loop() {
   uint32_t now = millis();
+  this->transport_->loop();
 
   // Connectivity timeout check
   if (this->connected_ && (now - this->last_successful_response_) > this->connected_timeout_) {
     this->update_connected_(false);
   }
 
+  // Finish publishing earlier frames before taking on more bus work
+  this->drain_dispatch_queue_();
+
+  // Passive mode: everything on the bus outside our own transactions is the other master's
+  bool sniffed = false;
+  if (this->passive_ && this->state_ != State::WAITING_RESPONSE)
+    sniffed = this->sniff_();
+
   switch (this->state_) {
     case State::SETUP_READ_ID: {
-      if (this->setup_phase_ == 0) {
+      if (this->passive_ && this->setup_phase_ == 0) {
+        if (sniffed && this->sniffed_all_(get_system_id_ranges())) {
+          ESP_LOGI(TAG, "System identification seen on the bus");
+          this->finish_system_id_();
+          break;
+        }
+        // Give the other master up to max_age to read it before asking ourselves
+        if (this->passive_max_age_ == 0 || now - this->passive_since_ < this->passive_max_age_ ||
+            !this->bus_quiet_(now))
+          break;
+      }
+      if (this->setup_phase_ == 0 && this->acquire_bus_()) {
         ESP_LOGI(TAG, "Reading system identification...");
         this->read_system_id_();
         this->setup_phase_ = 1;
@@ -61,7 +134,17 @@ void WaterFurnace::loop() {
     }
 
     case State::SETUP_DETECT_COMPONENTS: {
-      if (this->setup_phase_ == 0) {
+      if (this->passive_ && this->setup_phase_ == 0) {
+        if (this->sniffed_all_(get_component_detect_ranges())) {
+          ESP_LOGI(TAG, "Installed components seen on the bus");
+          this->finish_component_detection_();
+          break;
+        }
+        if (this->passive_max_age_ == 0 || now - this->passive_since_ < this->passive_max_age_ ||
+            !this->bus_quiet_(now))
+          break;
+      }
+      if (this->setup_phase_ == 0 && this->acquire_bus_()) {
         ESP_LOGI(TAG, "Detecting installed components...");
         this->detect_components_();
         this->setup_phase_ = 1;
@@ -72,19 +155,27 @@ void WaterFurnace::loop() {
     }
 
     case State::IDLE: {
-      // Process any pending writes first
-      if (!this->pending_writes_.empty()) {
-        this->process_pending_writes_();
+      this->schedule_state_groups_(now);
+      this->schedule_register_reads_(now);
+      this->schedule_dump_(now);
+      this->schedule_freeze_frame_(now);
+      if (this->start_next_transaction_(now))
         return;
-      }
       break;
     }
 
     case State::WAITING_RESPONSE: {
       // Try to read a complete frame
-      std::vector<uint8_t> frame;
+      std::vector<uint8_t> &frame = this->rx_frame_;
       if (this->read_frame_(frame)) {
+        this->release_bus_();
+        if (this->passive_ && !this->rx_buffer_.empty()) {
+          // The other master spoke while we waited
+          this->sniff_bytes_(this->rx_buffer_.data(), this->rx_buffer_.size(), now);
+          this->rx_buffer_.clear();
+        }
         this->last_response_time_ = now;
+        this->record_response_(now - this->last_request_time_);
         this->process_response_(frame);
         return;
       }
@@ -93,12 +184,29 @@ void WaterFurnace::loop() {
       if (now - this->last_request_time_ > RESPONSE_TIMEOUT) {
         ESP_LOGW(TAG, "Response timeout (waited %ums)", RESPONSE_TIMEOUT);
         this->rx_buffer_.clear();
+        this->bus_stats_.timeouts++;
+        this->bus_stats_.busy_ms += now - this->last_request_time_;
+
+        if (this->dumping_()) {
+          // A dump batch never touched the cache, and polling must not stall behind
+          // it: the dump alone waits, long enough to keep the timeout within its duty cycle
+          this->dump_.on_failure();
+          this->dump_release_ = now + RESPONSE_TIMEOUT * (100 - this->dump_duty_cycle_) / this->dump_duty_cycle_;
+          this->in_flight_ = false;
+          this->release_bus_();
+          this->state_ = State::IDLE;
+          break;
+        }
 
         // Staleness: erase expected addresses from cache on timeout
         for (uint16_t addr : this->expected_addresses_) {
           this->registers_.erase(addr);
         }
 
+        // The failed transaction is dropped; the rest of the queue resumes after backoff
+        this->in_flight_ = false;
+        this->release_bus_();
+
         this->error_backoff_until_ = now + ERROR_BACKOFF_TIME;
         this->state_ = State::ERROR_BACKOFF;
       }
@@ -132,6 +240,10 @@ void WaterFurnace::dump_config() {
   ESP_LOGCONFIG(TAG, "WaterFurnace Aurora:");
   ESP_LOGCONFIG(TAG, "  Model: %s", this->model_number_.c_str());
   ESP_LOGCONFIG(TAG, "  Serial: %s", this->serial_number_.c_str());
+  ESP_LOGCONFIG(TAG, "  Slave address: %u", this->address_);
+  if (this->arbiter_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Shared bus: %u hubs", this->arbiter_->num_clients());
+  }
   ESP_LOGCONFIG(TAG, "  Program: %s", this->abc_program_.c_str());
   ESP_LOGCONFIG(TAG, "  Thermostat: %s (AWL: %s)",
                 YESNO(this->has_thermostat_), YESNO(this->awl_thermostat_));
@@ -145,19 +257,151 @@ void WaterFurnace::dump_config() {
   if (this->flow_control_pin_ != nullptr) {
     LOG_PIN("  Flow Control Pin: ", this->flow_control_pin_);
   }
+  this->transport_->dump_config();
   ESP_LOGCONFIG(TAG, "  Connected timeout: %ums", this->connected_timeout_);
-  ESP_LOGCONFIG(TAG, "  Poll groups: %d", this->poll_groups_.size());
+  if (this->capture_.enabled()) {
+    ESP_LOGCONFIG(TAG, "  Bus capture: %u byte ring", (unsigned) this->capture_.buffer_size());
+  }
+  if (this->freeze_frame_.enabled()) {
+    ESP_LOGCONFIG(TAG, "  Fault freeze frames: last %u, %u registers in %u requests, %u taken",
+                  (unsigned) this->freeze_frame_.depth(), (unsigned) this->freeze_frame_.registers().size(),
+                  (unsigned) this->freeze_groups_.size(), (unsigned) this->freeze_frame_.triggers());
+  }
+  if (this->bus_task_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Bus task: core %u", this->bus_task_core_);
+  }
+  if (this->passive_) {
+    if (this->passive_max_age_ > 0) {
+      ESP_LOGCONFIG(TAG, "  Passive: polls registers older than %ums", this->passive_max_age_);
+    } else {
+      ESP_LOGCONFIG(TAG, "  Passive: listen only");
+    }
+    ESP_LOGCONFIG(TAG, "  Sniffed: %u frames, %u exceptions, %u bytes skipped", this->sniffer_.frames(),
+                  this->sniffer_.exceptions(), this->sniffer_.dropped_bytes());
+  }
+  ESP_LOGCONFIG(TAG, "  Poll groups: %d (%s)", this->poll_groups_.size(),
+                this->using_poll_plan_ ? "prebuilt plan" : "planned at runtime");
+  if (this->poll_mode_ == PollMode::PACED) {
+    ESP_LOGCONFIG(TAG, "  Poll mode: paced (spacing %ums, min gap %ums)", this->poll_spacing_(),
+                  this->min_poll_gap_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Poll mode: burst");
+  }
+  if (this->adaptive_polling_) {
+    ESP_LOGCONFIG(TAG, "  Adaptive polling: %d state groups, fast %ums, slow %ums, hold %ums",
+                  this->state_groups_.size(), this->fast_poll_interval_, this->slow_poll_interval_,
+                  this->state_hold_time_);
+  }
+  ESP_LOGCONFIG(TAG, "  Transaction queue: depth %u (peak %u), deadline misses %u", this->queue_.size(),
+                this->peak_queue_depth_, this->deadline_misses_);
   ESP_LOGCONFIG(TAG, "  Registered listeners: %d", this->listeners_.size());
+  if (this->dispatch_budget_us_ > 0) {
+    ESP_LOGCONFIG(TAG, "  Dispatch budget: %uus per loop (peak backlog %u registers)", this->dispatch_budget_us_,
+                  this->peak_dispatch_backlog_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Dispatch budget: none (whole frame per loop)");
+  }
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+  ESP_LOGCONFIG(TAG, "  Dispatch profiling: enabled");
+#endif
+
+  const auto &stats = this->bus_stats_;
+  ESP_LOGCONFIG(TAG, "  Bus: TX %u bytes, RX %u bytes, busy %ums", stats.tx_bytes, stats.rx_bytes, stats.busy_ms);
+  ESP_LOGCONFIG(TAG, "  Transactions: func65=%u func66=%u func67=%u func6=%u other=%u", stats.read_ranges,
+                stats.read_registers, stats.write_registers, stats.write_single, stats.other_functions);
+  ESP_LOGCONFIG(TAG, "  Errors: CRC %u, exceptions %u, timeouts %u, value count mismatches %u", stats.crc_errors,
+                stats.exceptions, stats.timeouts, stats.value_count_mismatches);
+  ESP_LOGCONFIG(TAG, "  RTT (all): n=%u min=%ums p50=%ums p99=%ums max=%ums", stats.rtt.count(), stats.rtt.min(),
+                stats.rtt.percentile(50), stats.rtt.percentile(99), stats.rtt.max());
+  auto log_group_rtt = [](const char *kind, size_t i, const PollGroup &group) {
+    ESP_LOGCONFIG(TAG, "    %s group %u: n=%u min=%ums p50=%ums p99=%ums max=%ums", kind, i, group.rtt.count(),
+                  group.rtt.min(), group.rtt.percentile(50), group.rtt.percentile(99), group.rtt.max());
+  };
+  for (size_t i = 0; i < this->poll_groups_.size(); i++)
+    log_group_rtt("Poll", i, this->poll_groups_[i]);
+  for (size_t i = 0; i < this->state_groups_.size(); i++)
+    log_group_rtt("State", i, this->state_groups_[i]);
 }
 
 void WaterFurnace::register_listener(uint16_t register_addr, std::function<void(uint16_t)> callback,
-                                      RegisterCapability capability) {
+                                      RegisterCapability capability, const EntityBase *owner) {
   this->listeners_.push_back({register_addr, std::move(callback), capability});
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+  this->listeners_.back().owner = owner;
+#endif
 }
 
-void WaterFurnace::write_register(uint16_t addr, uint16_t value) {
-  this->pending_writes_.push_back({addr, value});
+bool WaterFurnace::write_register(uint16_t addr, uint16_t value) {
   ESP_LOGD(TAG, "Queued write: register %u = %u", addr, value);
+  // Coalesce into the queued (not yet sent) writes; a repeated address keeps the last value,
+  // and a new one goes into the first write with room left in its frame
+  Transaction *open = nullptr;
+  for (auto &txn : this->queue_) {
+    if (txn.cls != TransactionClass::WRITE)
+      continue;
+    for (auto &write : txn.writes) {
+      if (write.first == addr) {
+        write.second = value;
+        return true;
+      }
+    }
+    if (open == nullptr && txn.writes.size() < MAX_WRITES_PER_REQUEST)
+      open = &txn;
+  }
+  if (open != nullptr) {
+    open->writes.push_back({addr, value});
+    return true;
+  }
+  uint32_t now = millis();
+  Transaction txn;
+  txn.cls = TransactionClass::WRITE;
+  txn.release = now;
+  txn.deadline = now + WRITE_DEADLINE;
+  txn.writes.push_back({addr, value});
+  return this->enqueue_(std::move(txn));
+}
+
+void WaterFurnace::request_read(const std::vector<uint16_t> &addresses) {
+  uint32_t now = millis();
+  for (size_t i = 0; i < addresses.size(); i += MAX_REGISTERS_PER_REQUEST) {
+    Transaction txn;
+    txn.cls = TransactionClass::ON_DEMAND;
+    txn.release = now;
+    txn.deadline = now + ON_DEMAND_DEADLINE;
+    size_t end = std::min(addresses.size(), i + MAX_REGISTERS_PER_REQUEST);
+    txn.addresses.assign(addresses.begin() + i, addresses.begin() + end);
+    this->enqueue_(std::move(txn));
+  }
+}
+
+void WaterFurnace::read_registers(const std::vector<uint16_t> &addresses, uint32_t max_age,
+                                  RegisterReadCallback callback) {
+  if (addresses.size() > MAX_REGISTER_READ_SIZE || this->register_reads_.size() >= MAX_REGISTER_READS) {
+    ESP_LOGW(TAG, "Register read of %u registers refused (%u reads waiting)", addresses.size(),
+             this->register_reads_.size());
+    callback({}, addresses);
+    return;
+  }
+  // Without tracking from boot, only values read from here on count as cached
+  this->track_read_times_ = true;
+  RegisterRead read;
+  read.addresses = addresses;
+  std::sort(read.addresses.begin(), read.addresses.end());
+  read.addresses.erase(std::unique(read.addresses.begin(), read.addresses.end()), read.addresses.end());
+  read.requested_at = millis();
+  read.max_age = max_age;
+  read.callback = std::move(callback);
+  this->register_reads_.push_back(std::move(read));
+}
+
+bool WaterFurnace::dump_registers(std::vector<RegisterDump::Range> ranges, uint8_t duty_cycle,
+                                  RegisterDump::Sink sink) {
+  if (this->dump_.active())
+    return false;
+  this->dump_duty_cycle_ = std::max<uint8_t>(1, std::min<uint8_t>(duty_cycle, 100));
+  this->dump_release_ = millis();
+  this->dump_.start(std::move(ranges), std::move(sink));
+  return true;
 }
 
 bool WaterFurnace::get_register(uint16_t addr, uint16_t &value) const {
@@ -169,6 +413,14 @@ bool WaterFurnace::get_register(uint16_t addr, uint16_t &value) const {
   return false;
 }
 
+bool WaterFurnace::get_register_age(uint16_t addr, uint32_t &age) const {
+  auto it = this->read_at_.find(addr);
+  if (it == this->read_at_.end())
+    return false;
+  age = millis() - it->second;
+  return true;
+}
+
 void WaterFurnace::update_connected_(bool connected) {
   if (this->connected_ == connected)
     return;
@@ -183,97 +435,259 @@ void WaterFurnace::update_connected_(bool connected) {
   }
 }
 
-void WaterFurnace::send_frame_(const std::vector<uint8_t> &frame) {
-  // Assert DE pin for transmit
-  if (this->flow_control_pin_ != nullptr) {
-    this->flow_control_pin_->digital_write(true);
+void WaterFurnace::record_response_(uint32_t rtt) {
+  if (this->dumping_())
+    this->dump_release_ = millis() + rtt * (100 - this->dump_duty_cycle_) / this->dump_duty_cycle_;
+  this->bus_stats_.busy_ms += rtt;
+  this->bus_stats_.rtt.record(rtt);
+  if (this->in_flight_ && this->current_.group != nullptr)
+    this->current_.group->rtt.record(rtt);
+}
+
+void WaterFurnace::publish_bus_stats_() {
+  const auto &stats = this->bus_stats_;
+  auto publish = [this](BusStatSensor which, float value) {
+    sensor::Sensor *sens = this->bus_stat_sensors_[static_cast<uint8_t>(which)];
+    if (sens != nullptr)
+      sens->publish_state(value);
+  };
+  publish(BusStatSensor::TX_BYTES, stats.tx_bytes);
+  publish(BusStatSensor::RX_BYTES, stats.rx_bytes);
+  publish(BusStatSensor::TRANSACTIONS, stats.transactions());
+  publish(BusStatSensor::CRC_ERRORS, stats.crc_errors);
+  publish(BusStatSensor::EXCEPTIONS, stats.exceptions);
+  publish(BusStatSensor::TIMEOUTS, stats.timeouts);
+  publish(BusStatSensor::VALUE_COUNT_MISMATCHES, stats.value_count_mismatches);
+  if (stats.rtt.count() > 0) {
+    publish(BusStatSensor::RTT_MIN, stats.rtt.min());
+    publish(BusStatSensor::RTT_P50, stats.rtt.percentile(50));
+    publish(BusStatSensor::RTT_P99, stats.rtt.percentile(99));
+    publish(BusStatSensor::RTT_MAX, stats.rtt.max());
   }
+  publish(BusStatSensor::QUEUE_DEPTH, this->queue_.size());
+  publish(BusStatSensor::DEADLINE_MISSES, this->deadline_misses_);
 
-  this->write_array(frame.data(), frame.size());
-  this->flush();
+  // Utilization: share of wall time with a request outstanding since the last publish
+  uint32_t now = millis();
+  uint32_t elapsed = now - this->last_stats_publish_;
+  if (this->last_stats_publish_ != 0 && elapsed > 0) {
+    uint32_t busy = stats.busy_ms - this->last_stats_busy_ms_;
+    publish(BusStatSensor::BUS_UTILIZATION, std::min(100.0f, busy * 100.0f / elapsed));
+  }
+  this->last_stats_publish_ = now;
+  this->last_stats_busy_ms_ = stats.busy_ms;
+}
 
-  // De-assert DE pin for receive
-  if (this->flow_control_pin_ != nullptr) {
-    this->flow_control_pin_->digital_write(false);
+void WaterFurnace::send_frame_(const uint8_t *frame, size_t len) {
+  this->record_capture_(BusCapture::Record::TX, frame, len);
+  this->bus_stats_.tx_bytes += len;
+  switch (len > 1 ? frame[1] : 0) {
+    case FUNC_READ_RANGES:
+      this->bus_stats_.read_ranges++;
+      break;
+    case FUNC_READ_REGISTERS:
+      this->bus_stats_.read_registers++;
+      break;
+    case FUNC_WRITE_REGISTERS:
+      this->bus_stats_.write_registers++;
+      break;
+    case FUNC_WRITE_SINGLE:
+      this->bus_stats_.write_single++;
+      break;
+    default:
+      this->bus_stats_.other_functions++;
+      break;
+  }
+
+  if (this->bus_task_ != nullptr) {
+    // The bus task owns the UART; hand the frame over and return immediately
+    this->bus_seq_++;
+    if (!this->bus_task_->submit(this->bus_seq_, frame, len)) {
+      ESP_LOGW(TAG, "Bus task request queue full, frame dropped");
+    }
+    this->last_request_time_ = millis();
+    ESP_LOGV(TAG, "TX frame (%d bytes, queued): %s", len, format_hex_pretty(frame, len).c_str());
+    return;
   }
 
+  // Discard anything left on the line from a previous (late or duplicated) response,
+  // as the bus task does, so it cannot be taken for the answer to this request
+  this->transport_->discard();
+  this->transport_->send(frame, len);
   this->last_request_time_ = millis();
   this->rx_buffer_.clear();
 
-  ESP_LOGV(TAG, "TX frame (%d bytes): %s", frame.size(),
-           format_hex_pretty(frame).c_str());
+  ESP_LOGV(TAG, "TX frame (%d bytes): %s", len, format_hex_pretty(frame, len).c_str());
 }
 
 bool WaterFurnace::read_frame_(std::vector<uint8_t> &frame) {
+  if (this->bus_task_ != nullptr)
+    return this->read_bus_task_frame_(frame);
+
   // Read all available bytes into buffer
-  while (this->available()) {
-    uint8_t byte;
-    if (this->read_byte(&byte)) {
-      this->rx_buffer_.push_back(byte);
-    }
+  uint8_t buf[64];
+  for (size_t n = this->transport_->read(buf, sizeof(buf)); n > 0; n = this->transport_->read(buf, sizeof(buf))) {
+    this->rx_buffer_.insert(this->rx_buffer_.end(), buf, buf + n);
+    this->bus_stats_.rx_bytes += n;
   }
 
-  // Need at least: slave_addr + func_code + something
-  if (this->rx_buffer_.size() < 3)
+  size_t expected_size = get_response_frame_size(this->rx_buffer_.data(), this->rx_buffer_.size());
+  if (expected_size == 0 || this->rx_buffer_.size() < expected_size)
     return false;
 
-  uint8_t func_code = this->rx_buffer_[1];
+  frame.assign(this->rx_buffer_.begin(), this->rx_buffer_.begin() + expected_size);
+  this->rx_buffer_.erase(this->rx_buffer_.begin(), this->rx_buffer_.begin() + expected_size);
+  this->record_capture_(BusCapture::Record::RX, frame.data(), frame.size());
 
-  // Error response: 5 bytes total
-  if (is_error_response(func_code)) {
-    if (this->rx_buffer_.size() >= 5) {
-      frame.assign(this->rx_buffer_.begin(), this->rx_buffer_.begin() + 5);
-      this->rx_buffer_.erase(this->rx_buffer_.begin(), this->rx_buffer_.begin() + 5);
-      return validate_frame_crc(frame.data(), frame.size());
-    }
+  ESP_LOGV(TAG, "RX frame (%d bytes): %s", frame.size(),
+           format_hex_pretty(frame).c_str());
+
+  if (!validate_frame_crc(frame.data(), frame.size())) {
+    ESP_LOGW(TAG, "CRC validation failed");
+    this->bus_stats_.crc_errors++;
     return false;
   }
 
-  size_t expected_size;
+  return this->is_own_frame_(frame);
+}
 
-  switch (func_code) {
-    case FUNC_READ_RANGES:
-    case FUNC_READ_REGISTERS: {
-      // Variable length: slave + func + byte_count + data[byte_count] + CRC(2)
-      if (this->rx_buffer_.size() < 3)
+bool WaterFurnace::read_bus_task_frame_(std::vector<uint8_t> &frame) {
+  BusResponse response;
+  while (this->bus_task_->poll(response)) {
+    // Drop completions for requests we already gave up on
+    this->bus_stats_.rx_bytes += response.len;
+    if (response.seq != this->bus_seq_)
+      continue;
+    this->record_capture_(BusCapture::Record::RX, response.data, response.len);
+
+    switch (response.status) {
+      case BusResponse::Status::OK:
+        frame.assign(response.data, response.data + response.len);
+        ESP_LOGV(TAG, "RX frame (%d bytes): %s", frame.size(),
+                 format_hex_pretty(frame).c_str());
+        return this->is_own_frame_(frame);
+      case BusResponse::Status::CRC_ERROR:
+        ESP_LOGW(TAG, "CRC validation failed");
+        this->bus_stats_.crc_errors++;
         return false;
-      uint8_t byte_count = this->rx_buffer_[2];
-      expected_size = 3 + byte_count + 2;  // header + data + CRC
-      break;
-    }
-    case FUNC_WRITE_REGISTERS:
-      // Minimal echo response: slave + func + CRC(2) = 4
-      expected_size = 4;
-      break;
-    case FUNC_WRITE_SINGLE:
-      // Echo: slave + func + addr(2) + value(2) + CRC(2) = 8
-      expected_size = 8;
-      break;
-    default:
-      // Unknown function, try variable length
-      if (this->rx_buffer_.size() < 3)
+      case BusResponse::Status::TIMEOUT:
+        // loop() applies its own response timeout
         return false;
-      expected_size = 3 + this->rx_buffer_[2] + 2;
-      break;
+    }
   }
+  return false;
+}
 
-  if (this->rx_buffer_.size() < expected_size)
-    return false;
+bool WaterFurnace::is_own_frame_(const std::vector<uint8_t> &frame) const {
+  if (frame[0] == this->address_)
+    return true;
+  ESP_LOGW(TAG, "Ignoring frame from slave %u (expected %u)", frame[0], this->address_);
+  return false;
+}
 
-  frame.assign(this->rx_buffer_.begin(), this->rx_buffer_.begin() + expected_size);
-  this->rx_buffer_.erase(this->rx_buffer_.begin(), this->rx_buffer_.begin() + expected_size);
+bool WaterFurnace::sniff_() {
+  uint8_t buf[64];
+  bool seen = false;
+  for (size_t len = this->transport_->read(buf, sizeof(buf)); len > 0;
+       len = this->transport_->read(buf, sizeof(buf))) {
+    this->bus_stats_.rx_bytes += len;
+    this->record_capture_(BusCapture::Record::RX, buf, len);
+    seen |= this->sniff_bytes_(buf, len, millis());
+  }
+  return seen;
+}
 
-  ESP_LOGV(TAG, "RX frame (%d bytes): %s", frame.size(),
-           format_hex_pretty(frame).c_str());
+bool WaterFurnace::sniff_bytes_(const uint8_t *data, size_t len, uint32_t now) {
+  bool seen = false;
+  for (bool decoded = this->sniffer_.feed(data, len, now); decoded; decoded = this->sniffer_.feed(nullptr, 0, now)) {
+    for (const auto &entry : this->sniffer_.values()) {
+      if (this->adaptive_polling_ && (entry.first == REG_SYSTEM_OUTPUTS || entry.first == REG_STATUS))
+        this->note_operating_state_(entry.first, entry.second);
+      this->registers_[entry.first] = entry.second;
+      this->read_at_[entry.first] = now;
+      this->queue_dispatch_(entry.first, entry.second);
+    }
+    // The ABC is answering, even if not to us
+    this->last_successful_response_ = now;
+    this->update_connected_(true);
+    seen = true;
+  }
+  return seen;
+}
 
-  if (!validate_frame_crc(frame.data(), frame.size())) {
-    ESP_LOGW(TAG, "CRC validation failed");
-    return false;
+void WaterFurnace::enqueue_stale_(PollGroup *group, TransactionClass cls, uint32_t release, uint32_t deadline,
+                                  uint32_t now) {
+  if (this->passive_max_age_ == 0)
+    return;
+  std::vector<uint16_t> stale;
+  size_t listened = 0;
+  auto check = [&](uint16_t addr) {
+    // Gap registers inside a range only matter if something listens on them
+    bool wanted = std::any_of(this->listeners_.begin(), this->listeners_.end(),
+                              [addr](const RegisterListener &l) { return l.address == addr; });
+    if (!wanted)
+      return;
+    listened++;
+    auto it = this->read_at_.find(addr);
+    if (it == this->read_at_.end() || now - it->second >= this->passive_max_age_)
+      stale.push_back(addr);
+  };
+  for (const auto &range : group->ranges) {
+    for (uint16_t i = 0; i < range.second; i++)
+      check(range.first + i);
+  }
+  for (uint16_t addr : group->individual)
+    check(addr);
+
+  if (stale.empty())
+    return;
+  if (stale.size() == listened) {
+    this->enqueue_group_(group, cls, release, deadline);
+    return;
+  }
+  // Only part of the group is stale: read just those registers (func 66)
+  Transaction txn;
+  txn.cls = cls;
+  txn.release = release;
+  txn.deadline = deadline;
+  txn.addresses = std::move(stale);
+  this->enqueue_(std::move(txn));
+}
+
+bool WaterFurnace::sniffed_all_(const std::vector<std::pair<uint16_t, uint16_t>> &ranges) const {
+  for (const auto &range : ranges) {
+    for (uint16_t i = 0; i < range.second; i++) {
+      if (this->read_at_.count(range.first + i) == 0)
+        return false;
+    }
   }
+  return true;
+}
 
+bool WaterFurnace::bus_quiet_(uint32_t now) const {
+  return now - this->sniffer_.last_activity() >= PASSIVE_QUIET_TIME;
+}
+
+bool WaterFurnace::acquire_bus_() {
+  // Hold everything while a network gateway is unreachable
+  if (!this->transport_->is_connected())
+    return false;
+  if (this->arbiter_ == nullptr)
+    return true;
+  if (this->arbiter_->owner() == this->arbiter_client_)
+    return true;
+  if (!this->arbiter_->acquire(this->arbiter_client_))
+    return false;
+  // Drop anything a previous owner's late response left in the UART
+  this->transport_->discard();
   return true;
 }
 
+void WaterFurnace::release_bus_() {
+  if (this->arbiter_ != nullptr)
+    this->arbiter_->release(this->arbiter_client_);
+}
+
 void WaterFurnace::process_response_(const std::vector<uint8_t> &frame) {
   if (frame.size() < MIN_FRAME_SIZE)
     return;
@@ -283,13 +697,22 @@ void WaterFurnace::process_response_(const std::vector<uint8_t> &frame) {
   // Handle error responses
   if (is_error_response(func_code)) {
     uint8_t error_code = (frame.size() > 2) ? frame[2] : 0;
-    ESP_LOGW(TAG, "Error response: func=0x%02X error=0x%02X", func_code, error_code);
+    this->bus_stats_.exceptions++;
+    if (this->dumping_()) {
+      // Expected while a dump probes the register map
+      ESP_LOGD(TAG, "Register dump: func=0x%02X error=0x%02X", func_code, error_code);
+      this->dump_.on_exception(error_code);
+    } else {
+      ESP_LOGW(TAG, "Error response: func=0x%02X error=0x%02X", func_code, error_code);
+    }
 
     // If we're in setup, go to error backoff
     if (this->state_ == State::WAITING_RESPONSE && !this->setup_complete_) {
       this->error_backoff_until_ = millis() + ERROR_BACKOFF_TIME;
       this->state_ = State::ERROR_BACKOFF;
     } else {
+      // Drop the rejected transaction rather than retrying it at once
+      this->in_flight_ = false;
       this->state_ = State::IDLE;
     }
     return;
@@ -300,24 +723,46 @@ void WaterFurnace::process_response_(const std::vector<uint8_t> &frame) {
     if (frame.size() < 5)
       return;
 
+    // Values are decoded in place rather than through parse_register_values(),
+    // so a poll cycle does not allocate
     uint8_t byte_count = frame[2];
-    auto values = parse_register_values(frame.data() + 3, byte_count);
+    size_t count = std::min<size_t>(byte_count, frame.size() - 3) / 2;
 
     // Map values back to register addresses
-    if (values.size() == this->expected_addresses_.size()) {
+    if (count == this->expected_addresses_.size() && this->dumping_()) {
+      this->last_successful_response_ = millis();
+      this->update_connected_(true);
+      // Dumped values go to the dump's output, not the cache or the listeners
+      this->dump_.on_values(&frame[3], count);
+    } else if (count == this->expected_addresses_.size()) {
       // Successful read response - update connectivity
       this->last_successful_response_ = millis();
       this->update_connected_(true);
+      bool freeze_frame = this->freeze_frame_.capturing() && this->is_freeze_group_(this->current_.group);
 
-      for (size_t i = 0; i < values.size(); i++) {
+      for (size_t i = 0; i < count; i++) {
         uint16_t addr = this->expected_addresses_[i];
-        uint16_t val = values[i];
+        uint16_t val = (frame[3 + 2 * i] << 8) | frame[4 + 2 * i];
+        if (this->adaptive_polling_ && (addr == REG_SYSTEM_OUTPUTS || addr == REG_STATUS))
+          this->note_operating_state_(addr, val);
+        if (!this->refresh_targets_.empty()) {
+          auto old = this->registers_.find(addr);
+          if (old != this->registers_.end() && old->second != val)
+            this->queue_dependent_refresh_(addr);
+        }
+        if (this->track_read_times_)
+          this->read_at_[addr] = this->last_successful_response_;
+        if (freeze_frame)
+          this->freeze_frame_.record(addr, val);
         this->registers_[addr] = val;
-        this->dispatch_register_(addr, val);
+        this->queue_dispatch_(addr, val);
       }
     } else {
       ESP_LOGW(TAG, "Response value count mismatch: got %d, expected %d",
-               values.size(), this->expected_addresses_.size());
+               count, this->expected_addresses_.size());
+      this->bus_stats_.value_count_mismatches++;
+      if (this->dumping_())
+        this->dump_.on_failure();
     }
   }
 
@@ -334,7 +779,9 @@ void WaterFurnace::process_response_(const std::vector<uint8_t> &frame) {
     uint16_t val = (frame[4] << 8) | frame[5];
     ESP_LOGD(TAG, "Write single acknowledged: reg %u = %u", addr, val);
     this->registers_[addr] = val;
-    this->dispatch_register_(addr, val);
+    if (this->track_read_times_)
+      this->read_at_[addr] = millis();
+    this->queue_dispatch_(addr, val);
     this->last_successful_response_ = millis();
     this->update_connected_(true);
   }
@@ -343,123 +790,204 @@ void WaterFurnace::process_response_(const std::vector<uint8_t> &frame) {
   if (this->state_ == State::WAITING_RESPONSE) {
     if (this->poll_groups_.empty() && this->model_number_.empty()) {
       // Just received system ID response
-      // Decode system ID from received registers
-      this->abc_program_ = decode_string_(this->registers_, REG_ABC_PROGRAM, 4);
-      this->model_number_ = decode_string_(this->registers_, REG_MODEL_NUMBER, 12);
-      this->serial_number_ = decode_string_(this->registers_, REG_SERIAL_NUMBER, 5);
-
-      // Trim trailing spaces/nulls
-      while (!this->abc_program_.empty() && (this->abc_program_.back() == ' ' || this->abc_program_.back() == '\0'))
-        this->abc_program_.pop_back();
-      while (!this->model_number_.empty() && (this->model_number_.back() == ' ' || this->model_number_.back() == '\0'))
-        this->model_number_.pop_back();
-      while (!this->serial_number_.empty() && (this->serial_number_.back() == ' ' || this->serial_number_.back() == '\0'))
-        this->serial_number_.pop_back();
-
-      ESP_LOGI(TAG, "System ID: program=%s model=%s serial=%s",
-               this->abc_program_.c_str(), this->model_number_.c_str(),
-               this->serial_number_.c_str());
-
-      // Detect VS drive from program name
-      this->has_vs_drive_ = (this->abc_program_ == "ABCVSP" ||
-                              this->abc_program_ == "ABCVSPR" ||
-                              this->abc_program_ == "ABCSPLVS");
-
-      this->state_ = State::SETUP_DETECT_COMPONENTS;
-      this->setup_phase_ = 0;
+      this->finish_system_id_();
     } else if (this->setup_phase_ != 0) {
       // Just finished component detection
-      // Decode component status from registers
-      auto check_component = [this](uint16_t status_reg) -> bool {
-        auto it = this->registers_.find(status_reg);
-        if (it == this->registers_.end())
-          return false;
-        return it->second != COMPONENT_REMOVED && it->second != COMPONENT_MISSING && it->second != 0;
-      };
-
-      auto get_version = [this](uint16_t version_reg) -> float {
-        auto it = this->registers_.find(version_reg);
-        if (it == this->registers_.end())
-          return 0.0f;
-        return it->second / 100.0f;
-      };
-
-      this->has_thermostat_ = check_component(REG_THERMOSTAT_STATUS);
-      this->has_axb_ = check_component(REG_AXB_STATUS);
-      this->has_iz2_ = check_component(REG_IZ2_STATUS);
-      this->has_aoc_ = check_component(REG_AOC_STATUS);
-      this->has_moc_ = check_component(REG_MOC_STATUS);
-
-      // AWL versions
-      float therm_ver = get_version(REG_THERMOSTAT_VERSION);
-      float axb_ver = get_version(REG_AXB_VERSION);
-      float iz2_ver = get_version(REG_IZ2_VERSION);
-
-      this->awl_thermostat_ = this->has_thermostat_ && therm_ver >= 3.0f;
-      this->awl_axb_ = this->has_axb_ && axb_ver >= 2.0f;
-      this->awl_iz2_ = this->has_iz2_ && iz2_ver >= 2.0f;
-
-      // Refrigeration monitoring requires AXB + energy monitor type >= 1 (register 412)
-      // Energy monitoring requires AXB + energy monitor type == 2 (register 412)
-      {
-        auto em_it = this->registers_.find(REG_ENERGY_MONITOR);
-        uint16_t energy_monitor_type = (em_it != this->registers_.end()) ? em_it->second : 0;
-        this->has_refrigeration_monitoring_ = this->has_axb_ && energy_monitor_type >= 1;
-        this->has_energy_monitoring_ = this->has_axb_ && energy_monitor_type == 2;
-      }
+      this->finish_component_detection_();
+    } else {
+      this->complete_transaction_();
+      // Keep the bus busy: start whatever is next without waiting for another loop()
+      // (passive mode listens first, in case the other master spoke meanwhile)
+      if (!this->passive_)
+        this->start_next_transaction_(millis());
+    }
+  }
+}
 
-      // IZ2 zone count
-      if (this->awl_iz2_) {
-        auto it = this->registers_.find(REG_IZ2_ZONE_COUNT);
-        if (it != this->registers_.end() && it->second > 0 && it->second <= 6) {
-          this->iz2_zone_count_ = it->second;
-        }
-      }
+void WaterFurnace::finish_system_id_() {
+  // Decode system ID from received registers
+  this->abc_program_ = decode_string_(this->registers_, REG_ABC_PROGRAM, 4);
+  this->model_number_ = decode_string_(this->registers_, REG_MODEL_NUMBER, 12);
+  this->serial_number_ = decode_string_(this->registers_, REG_SERIAL_NUMBER, 5);
+
+  // Trim trailing spaces/nulls
+  while (!this->abc_program_.empty() && (this->abc_program_.back() == ' ' || this->abc_program_.back() == '\0'))
+    this->abc_program_.pop_back();
+  while (!this->model_number_.empty() && (this->model_number_.back() == ' ' || this->model_number_.back() == '\0'))
+    this->model_number_.pop_back();
+  while (!this->serial_number_.empty() && (this->serial_number_.back() == ' ' || this->serial_number_.back() == '\0'))
+    this->serial_number_.pop_back();
+
+  ESP_LOGI(TAG, "System ID: program=%s model=%s serial=%s",
+           this->abc_program_.c_str(), this->model_number_.c_str(),
+           this->serial_number_.c_str());
+
+  // Detect VS drive from program name
+  this->has_vs_drive_ = (this->abc_program_ == "ABCVSP" ||
+                          this->abc_program_ == "ABCVSPR" ||
+                          this->abc_program_ == "ABCSPLVS");
+
+  this->state_ = State::SETUP_DETECT_COMPONENTS;
+  this->setup_phase_ = 0;
+}
 
-      ESP_LOGI(TAG, "Components detected: thermostat=%s(v%.1f) axb=%s(v%.1f) iz2=%s(v%.1f, %d zones) vs=%s",
-               YESNO(this->has_thermostat_), therm_ver,
-               YESNO(this->has_axb_), axb_ver,
-               YESNO(this->has_iz2_), iz2_ver, this->iz2_zone_count_,
-               YESNO(this->has_vs_drive_));
+void WaterFurnace::finish_component_detection_() {
+  // Decode component status from registers
+  auto check_component = [this](uint16_t status_reg) -> bool {
+    auto it = this->registers_.find(status_reg);
+    if (it == this->registers_.end())
+      return false;
+    return it->second != COMPONENT_REMOVED && it->second != COMPONENT_MISSING && it->second != 0;
+  };
 
-      this->setup_complete_ = true;
+  auto get_version = [this](uint16_t version_reg) -> float {
+    auto it = this->registers_.find(version_reg);
+    if (it == this->registers_.end())
+      return 0.0f;
+    return it->second / 100.0f;
+  };
 
-      // Fire deferred setup callbacks (child entities register their listeners here)
-      for (auto &cb : this->setup_callbacks_) {
-        cb();
-      }
-      this->setup_callbacks_.clear();
+  this->has_thermostat_ = check_component(REG_THERMOSTAT_STATUS);
+  this->has_axb_ = check_component(REG_AXB_STATUS);
+  this->has_iz2_ = check_component(REG_IZ2_STATUS);
+  this->has_aoc_ = check_component(REG_AOC_STATUS);
+  this->has_moc_ = check_component(REG_MOC_STATUS);
+
+  // AWL versions
+  float therm_ver = get_version(REG_THERMOSTAT_VERSION);
+  float axb_ver = get_version(REG_AXB_VERSION);
+  float iz2_ver = get_version(REG_IZ2_VERSION);
+
+  this->awl_thermostat_ = this->has_thermostat_ && therm_ver >= 3.0f;
+  this->awl_axb_ = this->has_axb_ && axb_ver >= 2.0f;
+  this->awl_iz2_ = this->has_iz2_ && iz2_ver >= 2.0f;
+
+  // Refrigeration monitoring requires AXB + energy monitor type >= 1 (register 412)
+  // Energy monitoring requires AXB + energy monitor type == 2 (register 412)
+  {
+    auto em_it = this->registers_.find(REG_ENERGY_MONITOR);
+    uint16_t energy_monitor_type = (em_it != this->registers_.end()) ? em_it->second : 0;
+    this->has_refrigeration_monitoring_ = this->has_axb_ && energy_monitor_type >= 1;
+    this->has_energy_monitoring_ = this->has_axb_ && energy_monitor_type == 2;
+  }
 
-      // Build polling groups from registered listener addresses
-      this->build_poll_groups_();
+  // IZ2 zone count
+  if (this->awl_iz2_) {
+    auto it = this->registers_.find(REG_IZ2_ZONE_COUNT);
+    if (it != this->registers_.end() && it->second > 0 && it->second <= 6) {
+      this->iz2_zone_count_ = it->second;
+    }
+  }
 
-      this->setup_phase_ = 0;
-      this->state_ = State::IDLE;
+  ESP_LOGI(TAG, "Components detected: thermostat=%s(v%.1f) axb=%s(v%.1f) iz2=%s(v%.1f, %d zones) vs=%s",
+           YESNO(this->has_thermostat_), therm_ver,
+           YESNO(this->has_axb_), axb_ver,
+           YESNO(this->has_iz2_), iz2_ver, this->iz2_zone_count_,
+           YESNO(this->has_vs_drive_));
 
-      ESP_LOGI(TAG, "Setup complete, %d poll groups configured", this->poll_groups_.size());
-    } else {
-      // Normal polling cycle - advance to next group or back to idle
-      this->current_poll_group_++;
-      if (this->current_poll_group_ < this->poll_groups_.size()) {
-        // Small delay between groups
-        this->poll_next_group_();
-      } else {
-        this->state_ = State::IDLE;
-      }
-    }
+  this->setup_complete_ = true;
+
+  // Fire deferred setup callbacks (child entities register their listeners here)
+  for (auto &cb : this->setup_callbacks_) {
+    cb();
   }
+  this->setup_callbacks_.clear();
+
+  // Build polling groups from registered listener addresses
+  this->build_poll_groups_();
+  this->build_freeze_groups_();
+
+  this->setup_phase_ = 0;
+  this->state_ = State::IDLE;
+
+  ESP_LOGI(TAG, "Setup complete, %d poll groups configured", this->poll_groups_.size());
 }
 
 void WaterFurnace::dispatch_register_(uint16_t addr, uint16_t value) {
   for (auto &listener : this->listeners_) {
     if (listener.address == addr) {
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+      uint32_t start = micros();
+      listener.callback(value);
+      listener.profile.add(micros() - start);
+#else
       listener.callback(value);
+#endif
     }
   }
 }
 
+void WaterFurnace::queue_dispatch_(uint16_t addr, uint16_t value) {
+  if (this->dispatch_budget_us_ == 0) {
+    this->dispatch_register_(addr, value);
+    return;
+  }
+  this->pending_dispatch_.emplace_back(addr, value);
+  if (this->dispatch_backlog() > this->peak_dispatch_backlog_)
+    this->peak_dispatch_backlog_ = this->dispatch_backlog();
+}
+
+void WaterFurnace::drain_dispatch_queue_() {
+  // Always make progress on at least one register, then stop once the budget is spent.
+  // FIFO order keeps every value of a frame ahead of the next frame's values.
+  uint32_t start = micros();
+  while (this->dispatch_head_ < this->pending_dispatch_.size()) {
+    auto entry = this->pending_dispatch_[this->dispatch_head_++];
+    this->dispatch_register_(entry.first, entry.second);
+    if (micros() - start >= this->dispatch_budget_us_)
+      break;
+  }
+  if (this->dispatch_head_ == this->pending_dispatch_.size()) {
+    this->pending_dispatch_.clear();
+    this->dispatch_head_ = 0;
+  }
+}
+
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+void WaterFurnace::log_dispatch_profile(size_t top) const {
+  std::vector<const RegisterListener *> by_listener;
+  std::map<uint16_t, DispatchProfile> by_register;
+  for (const auto &listener : this->listeners_) {
+    if (listener.profile.calls == 0)
+      continue;
+    by_listener.push_back(&listener);
+    by_register[listener.address].merge(listener.profile);
+  }
+  std::sort(by_listener.begin(), by_listener.end(), [](const RegisterListener *a, const RegisterListener *b) {
+    return a->profile.max_us > b->profile.max_us;
+  });
+  std::vector<std::pair<uint16_t, DispatchProfile>> registers(by_register.begin(), by_register.end());
+  std::sort(registers.begin(), registers.end(),
+            [](const std::pair<uint16_t, DispatchProfile> &a, const std::pair<uint16_t, DispatchProfile> &b) {
+              return a.second.max_us > b.second.max_us;
+            });
+
+  ESP_LOGI(TAG, "Dispatch profile, slowest listeners:");
+  for (size_t i = 0; i < by_listener.size() && i < top; i++) {
+    const RegisterListener *listener = by_listener[i];
+    ESP_LOGI(TAG, "  %-32s reg %5u: calls=%u max=%uus mean=%uus total=%uus",
+             listener->owner != nullptr ? listener->owner->get_name().c_str() : "(hub)", listener->address,
+             listener->profile.calls, listener->profile.max_us, listener->profile.total_us / listener->profile.calls,
+             listener->profile.total_us);
+  }
+  ESP_LOGI(TAG, "Dispatch profile, slowest registers:");
+  for (size_t i = 0; i < registers.size() && i < top; i++) {
+    ESP_LOGI(TAG, "  reg %5u: calls=%u max=%uus mean=%uus total=%uus", registers[i].first,
+             registers[i].second.calls, registers[i].second.max_us,
+             registers[i].second.total_us / registers[i].second.calls, registers[i].second.total_us);
+  }
+}
+
+void WaterFurnace::reset_dispatch_profile() {
+  for (auto &listener : this->listeners_)
+    listener.profile = DispatchProfile();
+}
+#endif
+
 void WaterFurnace::read_system_id_() {
   auto ranges = get_system_id_ranges();
+  // Only the last attempt at setup is kept for replay
+  this->capture_.restart_setup();
 
   // Build expected addresses list
   this->expected_addresses_.clear();
@@ -469,7 +997,7 @@ void WaterFurnace::read_system_id_() {
     }
   }
 
-  auto frame = build_read_ranges_request(ranges);
+  auto frame = build_read_ranges_request(ranges, this->address_);
   this->send_frame_(frame);
   this->state_ = State::WAITING_RESPONSE;
 }
@@ -484,7 +1012,7 @@ void WaterFurnace::detect_components_() {
     }
   }
 
-  auto frame = build_read_ranges_request(ranges);
+  auto frame = build_read_ranges_request(ranges, this->address_);
   this->send_frame_(frame);
   this->state_ = State::WAITING_RESPONSE;
 }
@@ -537,6 +1065,8 @@ bool WaterFurnace::has_capability_(RegisterCapability cap) const {
 }
 
 void WaterFurnace::build_poll_groups_() {
+  // Queued reads point into the group vectors
+  this->queue_.clear();
   this->poll_groups_.clear();
 
   // Register forwarding listener: poll 567 but dispatch to 740 on non-AWL AXB systems
@@ -546,6 +1076,12 @@ void WaterFurnace::build_poll_groups_() {
     });
   }
 
+  this->using_poll_plan_ = this->apply_poll_plan_();
+  if (this->using_poll_plan_) {
+    this->build_refresh_targets_();
+    return;
+  }
+
   // 1. Collect unique addresses from listeners whose capability is satisfied
   std::vector<uint16_t> addrs;
   addrs.reserve(this->listeners_.size());
@@ -570,7 +1106,26 @@ void WaterFurnace::build_poll_groups_() {
     addrs.erase(std::unique(addrs.begin(), addrs.end()), addrs.end());
   }
 
-  // 3. Use capability-filtered addresses as pollable set
+  // 3. Adaptive polling: state-dependent registers get their own groups on their own
+  // timers; the system outputs/status registers that drive the rate are always polled
+  std::vector<uint16_t> state_addrs;
+  if (this->adaptive_polling_) {
+    std::vector<uint16_t> base_addrs;
+    for (uint16_t addr : addrs) {
+      if (is_state_dependent_register(addr)) {
+        state_addrs.push_back(addr);
+      } else {
+        base_addrs.push_back(addr);
+      }
+    }
+    base_addrs.push_back(REG_SYSTEM_OUTPUTS);
+    base_addrs.push_back(REG_STATUS);
+    std::sort(base_addrs.begin(), base_addrs.end());
+    base_addrs.erase(std::unique(base_addrs.begin(), base_addrs.end()), base_addrs.end());
+    addrs = std::move(base_addrs);
+  }
+
+  // 4. Use capability-filtered addresses as pollable set
   std::vector<uint16_t> &pollable = addrs;
 
   if (pollable.empty()) {
@@ -578,12 +1133,149 @@ void WaterFurnace::build_poll_groups_() {
     return;
   }
 
-  // 4. Segment by protocol boundaries
+  this->append_poll_groups_(pollable, this->poll_groups_, state_addrs);
+  this->state_groups_.clear();
+  this->append_poll_groups_(state_addrs, this->state_groups_, pollable);
+
+  ESP_LOGI(TAG, "Built %d poll groups from %d listener addresses",
+           this->poll_groups_.size(), pollable.size());
+  if (this->adaptive_polling_) {
+    ESP_LOGI(TAG, "Built %d state-dependent poll groups from %d listener addresses",
+             this->state_groups_.size(), state_addrs.size());
+  }
+
+  this->build_refresh_targets_();
+}
+
+uint8_t WaterFurnace::plan_flags_() const {
+  uint8_t flags = 0;
+  if (this->awl_thermostat_)
+    flags |= PLAN_AWL_THERMOSTAT;
+  if (this->awl_axb_)
+    flags |= PLAN_AWL_AXB;
+  if (this->awl_iz2_)
+    flags |= PLAN_AWL_IZ2;
+  if (this->has_axb_)
+    flags |= PLAN_AXB;
+  if (this->has_refrigeration_monitoring_)
+    flags |= PLAN_REFRIGERATION;
+  if (this->has_energy_monitoring_)
+    flags |= PLAN_ENERGY;
+  if (this->has_vs_drive_)
+    flags |= PLAN_VS_DRIVE;
+  if (this->has_iz2_)
+    flags |= PLAN_IZ2;
+  return flags;
+}
+
+bool WaterFurnace::apply_poll_plan_() {
+  if (this->poll_plans_ == nullptr)
+    return false;
+
+  uint8_t flags = this->plan_flags_();
+  const PollPlan *plan = nullptr;
+  for (size_t i = 0; i < this->num_poll_plan_variants_; i++) {
+    if (this->poll_plan_variants_[i].flags == flags) {
+      plan = &this->poll_plans_[this->poll_plan_variants_[i].plan];
+      break;
+    }
+  }
+  if (plan == nullptr) {
+    ESP_LOGW(TAG, "No prebuilt poll plan for hardware flags 0x%02X, planning at runtime", flags);
+    return false;
+  }
+
+  // The plan must cover exactly the addresses the listeners need (lambdas or
+  // late registrations can add registers the build-time planner never saw)
+  static constexpr size_t MAX_PLAN_ADDRESSES = 512;
+  if (plan->num_addresses > MAX_PLAN_ADDRESSES)
+    return false;
+  std::bitset<MAX_PLAN_ADDRESSES> seen;
+  for (const auto &listener : this->listeners_) {
+    if (!this->has_capability_(listener.capability))
+      continue;
+    uint16_t addr = listener.address;
+    if (addr == REG_ENTERING_AIR && !this->awl_axb_)
+      addr = REG_ENTERING_AIR_ABC;
+    const uint16_t *end = plan->addresses + plan->num_addresses;
+    const uint16_t *it = std::lower_bound(plan->addresses, end, addr);
+    if (it == end || *it != addr) {
+      ESP_LOGW(TAG, "Prebuilt poll plan misses register %u, planning at runtime", addr);
+      return false;
+    }
+    seen.set(it - plan->addresses);
+  }
+  if (seen.count() != plan->num_addresses) {
+    ESP_LOGW(TAG, "Prebuilt poll plan reads unused registers, planning at runtime");
+    return false;
+  }
+
+  this->state_groups_.clear();
+  for (uint8_t i = 0; i < plan->num_groups; i++) {
+    const PlannedGroup &planned = plan->groups[i];
+    PollGroup group;
+    for (uint8_t r = 0; r < planned.num_ranges; r++)
+      group.ranges.push_back({planned.ranges[r].start, planned.ranges[r].count});
+    group.individual.assign(planned.individual, planned.individual + planned.num_individual);
+    // Frames are built for the configured address; fall back to building them if it differs
+    if (planned.frame[0] == this->address_) {
+      group.frame = planned.frame;
+      group.frame_len = planned.frame_len;
+    }
+    if (planned.state_dependent) {
+      this->state_groups_.push_back(std::move(group));
+    } else {
+      this->poll_groups_.push_back(std::move(group));
+    }
+  }
+  ESP_LOGI(TAG, "Using prebuilt poll plan: %d poll groups, %d state-dependent groups, %d registers",
+           this->poll_groups_.size(), this->state_groups_.size(), plan->num_addresses);
+  return true;
+}
+
+void WaterFurnace::build_refresh_targets_() {
+  this->refresh_targets_.clear();
+
+  auto covers = [](const PollGroup &group, uint16_t first, uint16_t last) {
+    for (const auto &range : group.ranges) {
+      if (range.first <= last && range.first + range.second - 1 >= first)
+        return true;
+    }
+    for (uint16_t addr : group.individual) {
+      if (addr >= first && addr <= last)
+        return true;
+    }
+    return false;
+  };
+  auto add_target = [this](uint16_t trigger, PollGroup *group) {
+    for (const auto &target : this->refresh_targets_) {
+      if (target.first == trigger && target.second == group)
+        return;
+    }
+    this->refresh_targets_.push_back({trigger, group});
+  };
+
+  for (size_t i = 0; i < REGISTER_DEPENDENCIES_SIZE; i++) {
+    const auto &dep = REGISTER_DEPENDENCIES[i];
+    for (auto &group : this->poll_groups_) {
+      if (covers(group, dep.first, dep.last))
+        add_target(dep.trigger, &group);
+    }
+    for (auto &group : this->state_groups_) {
+      if (covers(group, dep.first, dep.last))
+        add_target(dep.trigger, &group);
+    }
+  }
+}
+
+void WaterFurnace::append_poll_groups_(const std::vector<uint16_t> &addrs, std::vector<PollGroup> &groups,
+                                       const std::vector<uint16_t> &exclude) {
+  // 1. Segment by protocol boundaries
   std::vector<uint16_t> segment_a;  // addr < 12100: func 65 ranges
   std::vector<uint16_t> segment_b;  // 12100 ≤ addr < 12500: func 66 individual
   std::vector<uint16_t> segment_c;  // addr ≥ 31000: func 65 ranges (IZ2)
 
-  for (uint16_t addr : pollable) {
+  for (uint16_t addr : addrs) {
     if (addr < REGISTER_BREAKPOINT_1) {
       segment_a.push_back(addr);
     } else if (addr < REGISTER_BREAKPOINT_2) {
@@ -593,19 +1285,44 @@ void WaterFurnace::build_poll_groups_() {
     }
   }
 
-  // 5. Merge nearby addresses within func-65 segments into ranges (gap ≤ 8)
+  // 2. Merge nearby addresses within func-65 segments into ranges (gap ≤ 8)
   auto ranges_a = merge_to_ranges(segment_a);
   auto ranges_c = merge_to_ranges(segment_c);
 
-  // 6. Split into PollGroups (max ~25 registers per group)
+  // Gap filling must not pull in registers that belong to the other polling tier
+  auto split_around_excluded = [&exclude](std::vector<std::pair<uint16_t, uint16_t>> &ranges) {
+    if (exclude.empty())
+      return;
+    std::vector<std::pair<uint16_t, uint16_t>> split;
+    for (const auto &range : ranges) {
+      uint16_t start = range.first;
+      uint16_t end = range.first + range.second - 1;
+      for (auto it = std::lower_bound(exclude.begin(), exclude.end(), start); it != exclude.end() && *it <= end;
+           ++it) {
+        // Range endpoints are always wanted addresses, so *it is strictly inside
+        split.push_back({start, static_cast<uint16_t>(*it - start)});
+        start = *it + 1;
+      }
+      split.push_back({start, static_cast<uint16_t>(end - start + 1)});
+    }
+    // Drop the empty pieces left between adjacent excluded addresses
+    split.erase(std::remove_if(split.begin(), split.end(),
+                               [](const std::pair<uint16_t, uint16_t> &r) { return r.second == 0; }),
+                split.end());
+    ranges = std::move(split);
+  };
+  split_around_excluded(ranges_a);
+  split_around_excluded(ranges_c);
+
+  // 3. Split into PollGroups (max ~25 registers per group)
   static constexpr uint16_t MAX_REGS_PER_GROUP = 25;
 
-  auto add_ranges_to_groups = [this](const std::vector<std::pair<uint16_t, uint16_t>> &ranges) {
+  auto add_ranges_to_groups = [&groups](const std::vector<std::pair<uint16_t, uint16_t>> &ranges) {
     PollGroup current;
     uint16_t count = 0;
     for (const auto &range : ranges) {
       if (count > 0 && count + range.second > MAX_REGS_PER_GROUP) {
-        this->poll_groups_.push_back(std::move(current));
+        groups.push_back(std::move(current));
         current = PollGroup();
         count = 0;
       }
@@ -613,7 +1330,7 @@ void WaterFurnace::build_poll_groups_() {
       count += range.second;
     }
     if (!current.ranges.empty()) {
-      this->poll_groups_.push_back(std::move(current));
+      groups.push_back(std::move(current));
     }
   };
 
@@ -622,21 +1339,301 @@ void WaterFurnace::build_poll_groups_() {
   if (!segment_b.empty()) {
     PollGroup group;
     group.individual = segment_b;
-    this->poll_groups_.push_back(std::move(group));
+    groups.push_back(std::move(group));
   }
 
   add_ranges_to_groups(ranges_c);
+}
 
-  ESP_LOGI(TAG, "Built %d poll groups from %d listener addresses",
-           this->poll_groups_.size(), pollable.size());
+void WaterFurnace::queue_dependent_refresh_(uint16_t trigger) {
+  uint32_t now = millis();
+  for (auto &target : this->refresh_targets_) {
+    // The group carrying the trigger value is already fresh
+    if (target.first != trigger || (this->in_flight_ && target.second == this->current_.group))
+      continue;
+    ESP_LOGV(TAG, "Register %u changed, refreshing dependent group", trigger);
+    this->enqueue_group_(target.second, TransactionClass::ON_DEMAND, now, now + ON_DEMAND_DEADLINE);
+  }
+}
+
+bool WaterFurnace::enqueue_(Transaction txn) {
+  if (this->queue_.size() >= MAX_QUEUE_DEPTH) {
+    ESP_LOGW(TAG, "Transaction queue full, dropping request");
+    return false;
+  }
+  txn.seq = this->txn_seq_++;
+  this->queue_.push_back(std::move(txn));
+  this->peak_queue_depth_ = std::max(this->peak_queue_depth_, this->queue_.size());
+  return true;
+}
+
+bool WaterFurnace::enqueue_group_(PollGroup *group, TransactionClass cls, uint32_t release, uint32_t deadline) {
+  for (auto &txn : this->queue_) {
+    if (txn.group != group)
+      continue;
+    // Already queued: promote it rather than reading the group twice
+    if (cls < txn.cls) {
+      txn.cls = cls;
+      txn.release = release;
+      txn.deadline = deadline;
+    }
+    return true;
+  }
+  Transaction txn;
+  txn.cls = cls;
+  txn.release = release;
+  txn.deadline = deadline;
+  txn.group = group;
+  return this->enqueue_(std::move(txn));
+}
+
+bool WaterFurnace::is_queued_(const PollGroup *group) const {
+  if (this->in_flight_ && this->current_.group == group)
+    return true;
+  for (const auto &txn : this->queue_) {
+    if (txn.group == group)
+      return true;
+  }
+  return false;
+}
+
+bool WaterFurnace::start_next_transaction_(uint32_t now) {
+  if (this->in_flight_ || this->state_ != State::IDLE)
+    return false;
+  // Passive mode: only talk in a gap in the other master's traffic (update()
+  // can get here before loop() has drained the UART, so listen first)
+  if (this->passive_) {
+    this->sniff_();
+    if (!this->bus_quiet_(now))
+      return false;
+  }
+
+  // Most urgent released entry: class first, then earliest deadline, then FIFO
+  int best = -1;
+  for (size_t i = 0; i < this->queue_.size(); i++) {
+    const auto &txn = this->queue_[i];
+    if (static_cast<int32_t>(now - txn.release) < 0)
+      continue;
+    if (best < 0) {
+      best = i;
+      continue;
+    }
+    const auto &cur = this->queue_[best];
+    int32_t slack = static_cast<int32_t>(txn.deadline - now);
+    int32_t cur_slack = static_cast<int32_t>(cur.deadline - now);
+    if (txn.cls < cur.cls || (txn.cls == cur.cls && (slack < cur_slack || (slack == cur_slack && txn.seq < cur.seq))))
+      best = i;
+  }
+  if (best < 0) {
+    if (this->arbiter_ != nullptr)
+      this->arbiter_->withdraw(this->arbiter_client_);
+    return false;
+  }
+  if (!this->acquire_bus_())
+    return false;
+
+  this->current_ = std::move(this->queue_[best]);
+  this->queue_.erase(this->queue_.begin() + best);
+  this->in_flight_ = true;
+
+  if (static_cast<int32_t>(now - this->current_.deadline) > 0) {
+    this->deadline_misses_++;
+    ESP_LOGD(TAG, "Transaction (class %u) started %ums past its deadline", static_cast<uint8_t>(this->current_.cls),
+             now - this->current_.deadline);
+  }
+
+  if (this->current_.cls == TransactionClass::WRITE) {
+    // Send all queued writes in one func 67 request; nothing comes back but the echo
+    ESP_LOGD(TAG, "Sending %d register writes", this->current_.writes.size());
+    this->expected_addresses_.clear();
+    this->send_frame_(build_write_registers_request(this->current_.writes, this->address_));
+    this->state_ = State::WAITING_RESPONSE;
+  } else if (this->current_.group != nullptr) {
+    this->current_.group->last_poll = now;
+    this->current_.group->polled = true;
+    this->send_poll_group_(*this->current_.group);
+  } else if (!this->current_.ranges.empty()) {
+    this->expected_addresses_.clear();
+    for (const auto &range : this->current_.ranges) {
+      for (uint16_t i = 0; i < range.second; i++)
+        this->expected_addresses_.push_back(range.first + i);
+    }
+    this->send_frame_(build_read_ranges_request(this->current_.ranges, this->address_));
+    this->state_ = State::WAITING_RESPONSE;
+  } else {
+    this->expected_addresses_ = this->current_.addresses;
+    this->send_frame_(build_read_registers_request(this->current_.addresses, this->address_));
+    this->state_ = State::WAITING_RESPONSE;
+  }
+  return true;
+}
+
+bool WaterFurnace::register_fresh_(uint16_t addr, const RegisterRead &read) const {
+  if (this->registers_.count(addr) == 0)
+    return false;
+  auto it = this->read_at_.find(addr);
+  // Read after the request, or at most max_age before it
+  return it != this->read_at_.end() && static_cast<int32_t>(read.requested_at - it->second) <= (int32_t) read.max_age;
+}
+
+bool WaterFurnace::reading_registers_() const {
+  auto ad_hoc = [](const Transaction &txn) {
+    return txn.group == nullptr && txn.cls == TransactionClass::ON_DEMAND;
+  };
+  if (this->in_flight_ && ad_hoc(this->current_))
+    return true;
+  return std::any_of(this->queue_.begin(), this->queue_.end(), ad_hoc);
 }
 
-void WaterFurnace::poll_next_group_() {
-  if (this->current_poll_group_ >= this->poll_groups_.size())
+void WaterFurnace::schedule_register_reads_(uint32_t now) {
+  if (this->register_reads_.empty())
     return;
+  // One batch at a time: whatever is requested meanwhile goes into the next one
+  bool batch_queued = this->reading_registers_();
+  std::vector<uint16_t> wanted;
+  for (size_t i = 0; i < this->register_reads_.size();) {
+    RegisterRead &read = this->register_reads_[i];
+    bool complete = std::all_of(read.addresses.begin(), read.addresses.end(),
+                                [this, &read](uint16_t addr) { return this->register_fresh_(addr, read); });
+    bool failed = (read.sent && !batch_queued) || now - read.requested_at > REGISTER_READ_TIMEOUT;
+    if (complete || failed) {
+      std::vector<std::pair<uint16_t, uint16_t>> values;
+      std::vector<uint16_t> missing;
+      for (uint16_t addr : read.addresses) {
+        if (this->register_fresh_(addr, read)) {
+          values.push_back({addr, this->registers_[addr]});
+        } else {
+          missing.push_back(addr);
+        }
+      }
+      // The callback may ask for more reads
+      RegisterReadCallback callback = std::move(read.callback);
+      this->register_reads_.erase(this->register_reads_.begin() + i);
+      callback(values, missing);
+      continue;
+    }
+    if (!read.sent && !batch_queued) {
+      for (uint16_t addr : read.addresses) {
+        if (!this->register_fresh_(addr, read))
+          wanted.push_back(addr);
+      }
+      read.sent = true;
+    }
+    i++;
+  }
+  if (wanted.empty())
+    return;
+  std::sort(wanted.begin(), wanted.end());
+  wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+  this->enqueue_register_reads_(wanted, now);
+}
 
-  const auto &group = this->poll_groups_[this->current_poll_group_];
+void WaterFurnace::schedule_dump_(uint32_t now) {
+  if (!this->dump_.active() || this->dumping_() || this->queue_.size() >= MAX_QUEUE_DEPTH)
+    return;
+  for (const auto &txn : this->queue_) {
+    if (txn.cls == TransactionClass::DUMP)
+      return;
+  }
+  RegisterDump::Batch batch;
+  if (!this->dump_.next(batch)) {
+    ESP_LOGI(TAG, "Register dump finished: %u registers, %u left out, %u requests", this->dump_.registers_read(),
+             this->dump_.quarantined(), this->dump_.batches());
+    return;
+  }
+  Transaction txn;
+  txn.cls = TransactionClass::DUMP;
+  txn.release = static_cast<int32_t>(this->dump_release_ - now) > 0 ? this->dump_release_ : now;
+  txn.deadline = txn.release + DUMP_DEADLINE;
+  if (batch.individual) {
+    for (const auto &range : batch.ranges) {
+      for (uint32_t addr = range.first; addr < static_cast<uint32_t>(range.first) + range.second; addr++)
+        txn.addresses.push_back(addr);
+    }
+  } else {
+    txn.ranges = std::move(batch.ranges);
+  }
+  this->enqueue_(std::move(txn));
+}
+
+void WaterFurnace::enqueue_register_reads_(const std::vector<uint16_t> &addrs, uint32_t now) {
+  auto enqueue = [this, now](Transaction &txn) {
+    txn.cls = TransactionClass::ON_DEMAND;
+    txn.release = now;
+    txn.deadline = now + ON_DEMAND_DEADLINE;
+    this->enqueue_(std::move(txn));
+    txn = Transaction();
+  };
+  // Func 65 below the first breakpoint and from the second one up: contiguous
+  // runs only (a gap could be an address the ABC rejects), packed up to the
+  // register and frame limits
+  static constexpr size_t MAX_RANGES = (MAX_FRAME_SIZE - 4) / 4;
+  auto enqueue_ranges = [&](std::vector<uint16_t>::const_iterator first, std::vector<uint16_t>::const_iterator last) {
+    Transaction txn;
+    size_t count = 0;
+    for (auto range : merge_to_ranges(std::vector<uint16_t>(first, last), 1)) {
+      while (range.second > 0) {
+        if (count == MAX_REGISTERS_PER_REQUEST || txn.ranges.size() == MAX_RANGES) {
+          enqueue(txn);
+          count = 0;
+        }
+        uint16_t take = std::min<size_t>(range.second, MAX_REGISTERS_PER_REQUEST - count);
+        txn.ranges.push_back({range.first, take});
+        count += take;
+        range.first += take;
+        range.second -= take;
+      }
+    }
+    if (!txn.ranges.empty())
+      enqueue(txn);
+  };
+  auto b_first = std::lower_bound(addrs.begin(), addrs.end(), REGISTER_BREAKPOINT_1);
+  auto c_first = std::lower_bound(addrs.begin(), addrs.end(), REGISTER_BREAKPOINT_2);
+  enqueue_ranges(addrs.begin(), b_first);
+  // Between the breakpoints the ABC only answers func 66
+  for (auto it = b_first; it != c_first;) {
+    Transaction txn;
+    auto end = c_first - it > (ptrdiff_t) MAX_REGISTERS_PER_REQUEST ? it + MAX_REGISTERS_PER_REQUEST : c_first;
+    txn.addresses.assign(it, end);
+    enqueue(txn);
+    it = end;
+  }
+  enqueue_ranges(c_first, addrs.end());
+}
 
+void WaterFurnace::complete_transaction_() {
+  this->in_flight_ = false;
+  this->state_ = State::IDLE;
+
+  if (this->current_.cls == TransactionClass::WRITE) {
+    // Read back the written registers that something listens on
+    uint32_t now = millis();
+    Transaction verify;
+    verify.cls = TransactionClass::WRITE_VERIFY;
+    verify.release = now;
+    verify.deadline = now + WRITE_VERIFY_DEADLINE;
+    for (const auto &write : this->current_.writes) {
+      for (const auto &listener : this->listeners_) {
+        if (listener.address == write.first && this->has_capability_(listener.capability)) {
+          verify.addresses.push_back(write.first);
+          verify.writes.push_back(write);
+          break;
+        }
+      }
+    }
+    if (!verify.addresses.empty())
+      this->enqueue_(std::move(verify));
+  } else if (this->current_.cls == TransactionClass::WRITE_VERIFY) {
+    for (const auto &write : this->current_.writes) {
+      uint16_t value;
+      if (this->get_register(write.first, value) && value != write.second) {
+        ESP_LOGW(TAG, "Write verify: register %u reads %u, expected %u", write.first, value, write.second);
+      }
+    }
+  }
+}
+
+void WaterFurnace::send_poll_group_(PollGroup &group) {
   // Build expected addresses
   this->expected_addresses_.clear();
   for (const auto &range : group.ranges) {
@@ -649,56 +1646,160 @@ void WaterFurnace::poll_next_group_() {
   }
 
   // Send the request
-  if (!group.ranges.empty() && group.individual.empty()) {
-    // All ranges - use func 65
-    auto frame = build_read_ranges_request(group.ranges);
-    this->send_frame_(frame);
-  } else if (group.ranges.empty() && !group.individual.empty()) {
-    // All individual - use func 66
-    auto frame = build_read_registers_request(group.individual);
-    this->send_frame_(frame);
-  } else {
-    // Mixed: convert ranges to individual addresses and use func 66
-    std::vector<uint16_t> all_addrs;
-    for (const auto &range : group.ranges) {
-      for (uint16_t i = 0; i < range.second; i++) {
-        all_addrs.push_back(range.first + i);
+  if (group.frame != nullptr) {
+    // Prebuilt at compile time by the poll planner
+    this->send_frame_(group.frame, group.frame_len);
+    this->state_ = State::WAITING_RESPONSE;
+    return;
+  }
+  if (group.request.empty()) {
+    if (!group.ranges.empty() && group.individual.empty()) {
+      // All ranges - use func 65
+      group.request = build_read_ranges_request(group.ranges, this->address_);
+    } else if (group.ranges.empty() && !group.individual.empty()) {
+      // All individual - use func 66
+      group.request = build_read_registers_request(group.individual, this->address_);
+    } else {
+      // Mixed: convert ranges to individual addresses and use func 66
+      std::vector<uint16_t> all_addrs;
+      for (const auto &range : group.ranges) {
+        for (uint16_t i = 0; i < range.second; i++) {
+          all_addrs.push_back(range.first + i);
+        }
+      }
+      for (uint16_t addr : group.individual) {
+        all_addrs.push_back(addr);
+      }
+
+      if (all_addrs.size() <= MAX_REGISTERS_PER_REQUEST) {
+        group.request = build_read_registers_request(all_addrs, this->address_);
+      } else {
+        // Split if too many - just send ranges portion via func 65
+        group.request = build_read_ranges_request(group.ranges, this->address_);
+        // Individual registers will need to be a separate poll group
+        // This shouldn't happen with our current group sizes
+        ESP_LOGW(TAG, "Poll group too large, individual registers skipped");
       }
     }
-    for (uint16_t addr : group.individual) {
-      all_addrs.push_back(addr);
-    }
+  }
+  this->send_frame_(group.request);
+
+  this->state_ = State::WAITING_RESPONSE;
+}
+
+uint32_t WaterFurnace::poll_spacing_() const {
+  if (this->poll_groups_.empty())
+    return this->min_poll_gap_;
+  uint32_t even = this->get_update_interval() / this->poll_groups_.size();
+  return std::max(even, this->min_poll_gap_);
+}
 
-    if (all_addrs.size() <= MAX_REGISTERS_PER_REQUEST) {
-      auto frame = build_read_registers_request(all_addrs);
-      this->send_frame_(frame);
+void WaterFurnace::schedule_state_groups_(uint32_t now) {
+  if (!this->setup_complete_ || this->state_groups_.empty())
+    return;
+  bool fast = this->fast_rate_active_(now);
+  uint32_t interval = fast ? this->fast_poll_interval_ : this->slow_poll_interval_;
+  TransactionClass cls = fast ? TransactionClass::POLL_FAST : TransactionClass::POLL_SLOW;
+  for (auto &group : this->state_groups_) {
+    bool due = (!group.polled || now - group.last_poll >= interval) && !this->is_queued_(&group);
+    if (!due)
+      continue;
+    if (this->passive_) {
+      // Whatever another master keeps current is skipped; check again after one interval
+      this->enqueue_stale_(&group, cls, now, now + interval, now);
+      group.polled = true;
+      group.last_poll = now;
     } else {
-      // Split if too many - just send ranges portion via func 65
-      auto frame = build_read_ranges_request(group.ranges);
-      this->send_frame_(frame);
-      // Individual registers will need to be a separate poll group
-      // This shouldn't happen with our current group sizes
-      ESP_LOGW(TAG, "Poll group too large, individual registers skipped");
+      this->enqueue_group_(&group, cls, now, now + interval);
     }
   }
+}
 
-  this->state_ = State::WAITING_RESPONSE;
+bool WaterFurnace::fast_rate_active_(uint32_t now) const {
+  if (this->unit_active_)
+    return true;
+  return this->state_changed_ && now - this->last_state_change_ < this->state_hold_time_;
 }
 
-void WaterFurnace::process_pending_writes_() {
-  if (this->pending_writes_.empty())
+void WaterFurnace::note_operating_state_(uint16_t addr, uint16_t value) {
+  uint32_t now = millis();
+  bool was_fast = this->fast_rate_active_(now);
+
+  auto it = this->registers_.find(addr);
+  if (it != this->registers_.end() && it->second != value) {
+    this->state_changed_ = true;
+    this->last_state_change_ = now;
+  }
+  if (addr == REG_SYSTEM_OUTPUTS)
+    this->unit_active_ = (value & OUTPUT_ACTIVE_MASK) != 0;
+
+  bool fast = this->fast_rate_active_(now);
+  if (fast != was_fast) {
+    ESP_LOGD(TAG, "Adaptive polling: %s rate (outputs active: %s)", fast ? "fast" : "slow",
+             YESNO(this->unit_active_));
+  }
+}
+
+void WaterFurnace::note_fault_(uint16_t value) {
+  if (!this->freeze_frame_.on_fault(value) || this->freeze_groups_.empty())
     return;
+  char fault[FAULT_HISTORY_BUFFER_SIZE];
+  format_fault_history(REG_LAST_FAULT, value, fault, sizeof(fault));
+  if (this->freeze_frame_.capturing() || this->fault_pending_) {
+    // The frame being read already shows the conditions around this one
+    ESP_LOGW(TAG, "Fault: %s (freeze frame already being read)", fault);
+    return;
+  }
+  ESP_LOGW(TAG, "Fault: %s, reading freeze frame", fault);
+  this->fault_pending_ = true;
+  this->pending_fault_ = value;
+  this->fault_seen_at_ = millis();
+  this->start_freeze_frame_();
+}
 
-  // Send all pending writes in one func 67 request
-  auto frame = build_write_registers_request(this->pending_writes_);
-  ESP_LOGD(TAG, "Sending %d register writes", this->pending_writes_.size());
+bool WaterFurnace::start_freeze_frame_() {
+  // All reads or none: a frame without them would only push a real one out of the ring
+  if (this->queue_.size() + this->freeze_groups_.size() > MAX_QUEUE_DEPTH)
+    return false;
+  uint32_t now = millis();
+  for (auto &group : this->freeze_groups_) {
+    if (!this->enqueue_group_(&group, TransactionClass::ON_DEMAND, now, now + ON_DEMAND_DEADLINE))
+      return false;
+  }
+  this->fault_pending_ = false;
+  this->freeze_frame_.open(this->fault_seen_at_, this->pending_fault_);
+  return true;
+}
 
-  // Build expected addresses (for write, we don't expect data back, just echo)
-  this->expected_addresses_.clear();
+void WaterFurnace::build_freeze_groups_() {
+  this->freeze_frame_.close(millis());
+  this->fault_pending_ = false;
+  this->freeze_groups_.clear();
+  if (!this->freeze_frame_.enabled())
+    return;
+  std::vector<uint16_t> addrs;
+  for (const auto &reg : this->freeze_frame_.registers()) {
+    if (this->has_capability_(reg.capability))
+      addrs.push_back(reg.address);
+  }
+  this->append_poll_groups_(addrs, this->freeze_groups_);
+  ESP_LOGI(TAG, "Fault freeze frames: %d of %d registers present, %d requests", addrs.size(),
+           this->freeze_frame_.registers().size(), this->freeze_groups_.size());
+}
 
-  this->pending_writes_.clear();
-  this->send_frame_(frame);
-  this->state_ = State::WAITING_RESPONSE;
+void WaterFurnace::schedule_freeze_frame_(uint32_t now) {
+  if (this->fault_pending_ && !this->start_freeze_frame_())
+    return;
+  if (!this->freeze_frame_.capturing())
+    return;
+  // Done once every freeze group has been answered or dropped
+  for (const auto &group : this->freeze_groups_) {
+    if (this->is_queued_(&group))
+      return;
+  }
+  this->freeze_frame_.close(now);
+  const auto &snapshot = this->freeze_frame_.snapshot(0);
+  ESP_LOGI(TAG, "Freeze frame: %d registers read in %ums", __builtin_popcountll(snapshot.read), snapshot.duration);
 }
 
 std::string WaterFurnace::decode_string_(const std::map<uint16_t, uint16_t> &regs,
@@ -732,6 +1833,120 @@ void WaterFurnace::on_write_register_service_(int32_t address, int32_t value) {
   this->write_register(static_cast<uint16_t>(address), static_cast<uint16_t>(value));
 }
 
+void WaterFurnace::on_read_registers_service_(std::string registers, int32_t max_age) {
+  std::vector<uint16_t> addresses;
+  if (!parse_register_list(registers, addresses, MAX_REGISTER_READ_SIZE) || addresses.empty() || max_age < 0) {
+    ESP_LOGW(TAG, "API read_registers: invalid args registers='%s' max_age=%d", registers.c_str(), (int) max_age);
+    return;
+  }
+  ESP_LOGI(TAG, "API read_registers: %u registers, max_age=%dms", addresses.size(), (int) max_age);
+  this->read_registers(addresses, max_age, [this, registers](const std::vector<std::pair<uint16_t, uint16_t>> &values,
+                                                             const std::vector<uint16_t> &missing) {
+    std::string values_str, missing_str;
+    for (const auto &value : values) {
+      if (!values_str.empty())
+        values_str += ',';
+      values_str += std::to_string(value.first) + ':' + std::to_string(value.second);
+    }
+    for (uint16_t addr : missing) {
+      if (!missing_str.empty())
+        missing_str += ',';
+      missing_str += std::to_string(addr);
+    }
+    ESP_LOGI(TAG, "read_registers %s: %s%s%s", registers.c_str(), values_str.c_str(),
+             missing.empty() ? "" : " missing ", missing_str.c_str());
+#ifdef USE_API_HOMEASSISTANT_SERVICES
+    this->fire_homeassistant_event("esphome.waterfurnace_registers", {{"hub", this->service_suffix_},
+                                                                      {"registers", registers},
+                                                                      {"values", values_str},
+                                                                      {"missing", missing_str}});
+#endif
+  });
+}
+
+void WaterFurnace::on_dump_registers_service_(std::string registers, int32_t duty_cycle) {
+  if (registers.empty())
+    registers = RegisterDump::DEFAULT_RANGES;
+  std::vector<RegisterDump::Range> ranges;
+  if (!parse_register_ranges(registers, ranges) || duty_cycle < 0 || duty_cycle > 100) {
+    ESP_LOGW(TAG, "API dump_registers: invalid args registers='%s' duty_cycle=%d", registers.c_str(), (int) duty_cycle);
+    return;
+  }
+  auto sink = [this](const std::string &text) {
+    // One log line per YAML line; "dump: " marks them for extraction from the log
+    for (size_t start = 0, end; start < text.size(); start = end + 1) {
+      end = text.find('\n', start);
+      if (end == std::string::npos)
+        end = text.size();
+      ESP_LOGI(TAG, "dump: %s", text.substr(start, end - start).c_str());
+    }
+#ifdef USE_API_HOMEASSISTANT_SERVICES
+    this->fire_homeassistant_event("esphome.waterfurnace_dump", {{"hub", this->service_suffix_}, {"data", text}});
+#endif
+  };
+  if (!this->dump_registers(ranges, duty_cycle > 0 ? duty_cycle : 20, sink)) {
+    ESP_LOGW(TAG, "API dump_registers: a dump is already running");
+    return;
+  }
+  ESP_LOGI(TAG, "API dump_registers: %s at %d%% of the bus", registers.c_str(), duty_cycle > 0 ? (int) duty_cycle : 20);
+  sink("# Register dump of " + this->model_number_ + " serial " + this->serial_number_ + ", program " +
+       this->abc_program_ + "\n# Registers " + registers + "\n");
+}
+
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+void WaterFurnace::on_dump_dispatch_profile_service_(int32_t top) {
+  this->log_dispatch_profile(top > 0 ? static_cast<size_t>(top) : 10);
+}
+
+void WaterFurnace::on_reset_dispatch_profile_service_() {
+  ESP_LOGI(TAG, "API reset_dispatch_profile");
+  this->reset_dispatch_profile();
+}
+#endif
+
+void WaterFurnace::on_dump_capture_service_() {
+  // Chunks of 192 bytes are 256 base64 characters, short enough for one log line
+  static const size_t CHUNK = 192;
+  size_t total = this->capture_.file_size();
+  size_t chunks = (total + CHUNK - 1) / CHUNK;
+  ESP_LOGI(TAG, "Capture: %u bytes in %u chunks, %u records, %u dropped", (unsigned) total, (unsigned) chunks,
+           (unsigned) this->capture_.records(), (unsigned) this->capture_.dropped());
+  uint8_t buf[CHUNK];
+  for (size_t seq = 0; seq < chunks; seq++) {
+    size_t n = this->capture_.read(seq * CHUNK, buf, CHUNK);
+    std::string data = base64_encode(buf, n);
+    ESP_LOGI(TAG, "capture %u/%u %s", (unsigned) seq + 1, (unsigned) chunks, data.c_str());
+#ifdef USE_API_HOMEASSISTANT_SERVICES
+    this->fire_homeassistant_event("esphome.waterfurnace_capture", {{"hub", this->service_suffix_},
+                                                                    {"chunk", std::to_string(seq + 1)},
+                                                                    {"chunks", std::to_string(chunks)},
+                                                                    {"data", data}});
+#endif
+  }
+}
+
+void WaterFurnace::on_dump_freeze_frames_service_() {
+  size_t frames = this->freeze_frame_.size();
+  ESP_LOGI(TAG, "API dump_freeze_frames: %u frames, %u faults since boot", (unsigned) frames,
+           (unsigned) this->freeze_frame_.triggers());
+  for (size_t i = 0; i < frames; i++) {
+    std::string text = this->freeze_frame_.to_text(i);
+    // One log line per YAML line, like dump_registers; "freeze: " marks them for extraction from the log
+    for (size_t start = 0, end; start < text.size(); start = end + 1) {
+      end = text.find('\n', start);
+      if (end == std::string::npos)
+        end = text.size();
+      ESP_LOGI(TAG, "freeze: %s", text.substr(start, end - start).c_str());
+    }
+#ifdef USE_API_HOMEASSISTANT_SERVICES
+    this->fire_homeassistant_event("esphome.waterfurnace_freeze_frame", {{"hub", this->service_suffix_},
+                                                                         {"frame", std::to_string(i + 1)},
+                                                                         {"frames", std::to_string(frames)},
+                                                                         {"data", text}});
+#endif
+  }
+}
+
 #endif  // USE_API_CUSTOM_SERVICES
 
 }  // namespace waterfurnace
@@ -2,9 +2,18 @@
 
 #include "esphome/core/component.h"
 #include "esphome/components/binary_sensor/binary_sensor.h"
+#include "esphome/components/sensor/sensor.h"
 #include "esphome/components/uart/uart.h"
+#include "bus_arbiter.h"
+#include "bus_capture.h"
+#include "bus_sniffer.h"
+#include "bus_stats.h"
+#include "bus_task.h"
+#include "freeze_frame.h"
 #include "protocol.h"
+#include "register_dump.h"
 #include "registers.h"
+#include "transport.h"
 
 #ifdef USE_API_CUSTOM_SERVICES
 #include "esphome/components/api/custom_api_device.h"
@@ -18,10 +27,112 @@
 namespace esphome {
 namespace waterfurnace {
 
+// How poll groups are spread over the update interval
+enum class PollMode : uint8_t {
+  BURST,  // All groups back to back at the start of each update interval
+  PACED,  // Groups spaced evenly across the update interval
+};
+
+// Bus transaction priority classes, most urgent first
+enum class TransactionClass : uint8_t {
+  WRITE,         // Queued register writes (func 67)
+  WRITE_VERIFY,  // Read-back of registers just written
+  ON_DEMAND,     // Explicit reads and dependency refreshes
+  POLL_FAST,     // Regular poll cycle, and state-dependent groups while the unit runs
+  POLL_SLOW,     // State-dependent groups in standby
+  DUMP,          // Register map dump batches (dump_registers), behind everything else
+};
+
+// Optional diagnostic sensors published from the hub's bus statistics
+enum class BusStatSensor : uint8_t {
+  TX_BYTES,
+  RX_BYTES,
+  TRANSACTIONS,
+  CRC_ERRORS,
+  EXCEPTIONS,
+  TIMEOUTS,
+  VALUE_COUNT_MISMATCHES,
+  RTT_MIN,
+  RTT_P50,
+  RTT_P99,
+  RTT_MAX,
+  BUS_UTILIZATION,
+  QUEUE_DEPTH,
+  DEADLINE_MISSES,
+  COUNT,
+};
+
+// --- Build-time poll plans (tables generated by poll_plan.py) ---
+
+// Detected hardware, as a key into the generated plan variants
+enum PlanFlag : uint8_t {
+  PLAN_AWL_THERMOSTAT = 1 << 0,
+  PLAN_AWL_AXB = 1 << 1,
+  PLAN_AWL_IZ2 = 1 << 2,
+  PLAN_AXB = 1 << 3,
+  PLAN_REFRIGERATION = 1 << 4,
+  PLAN_ENERGY = 1 << 5,
+  PLAN_VS_DRIVE = 1 << 6,
+  PLAN_IZ2 = 1 << 7,
+};
+
+struct PlannedRange {
+  uint16_t start;
+  uint16_t count;
+};
+
+struct PlannedGroup {
+  const PlannedRange *ranges;
+  const uint16_t *individual;
+  const uint8_t *frame;  // Complete request including CRC
+  uint8_t num_ranges;
+  uint8_t num_individual;
+  uint8_t frame_len;
+  bool state_dependent;
+};
+
+struct PollPlan {
+  const PlannedGroup *groups;
+  uint8_t num_groups;
+  const uint16_t *addresses;  // Sorted pollable addresses the plan was built for
+  uint16_t num_addresses;
+};
+
+struct PollPlanVariant {
+  uint8_t flags;  // PlanFlag bits
+  uint8_t plan;   // Index into the plan table
+};
+
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+// Time spent in listener callbacks (micros(), so it includes publish_state fan-out)
+struct DispatchProfile {
+  uint32_t calls{0};
+  uint32_t total_us{0};
+  uint32_t max_us{0};
+
+  void add(uint32_t us) {
+    this->calls++;
+    this->total_us += us;
+    if (us > this->max_us)
+      this->max_us = us;
+  }
+  void merge(const DispatchProfile &other) {
+    this->calls += other.calls;
+    this->total_us += other.total_us;
+    if (other.max_us > this->max_us)
+      this->max_us = other.max_us;
+  }
+};
+#endif
+
 struct RegisterListener {
   uint16_t address;
   std::function<void(uint16_t)> callback;
   RegisterCapability capability{RegisterCapability::NONE};
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+  const EntityBase *owner{nullptr};  // Entity the callback publishes to, for reports
+  DispatchProfile profile;
+#endif
 };
 
 class WaterFurnace : public PollingComponent, public uart::UARTDevice
@@ -36,17 +147,118 @@ class WaterFurnace : public PollingComponent, public uart::UARTDevice
   void dump_config() override;
   float get_setup_priority() const override { return setup_priority::DATA; }
 
-  // Listener registration (called by child entities during their setup)
+  // Listener registration (called by child entities during their setup).
+  // `owner` only labels the listener in dispatch profiling reports.
   void register_listener(uint16_t register_addr, std::function<void(uint16_t)> callback,
-                          RegisterCapability capability = RegisterCapability::NONE);
-
-  // Write interface (called by climate/switch entities)
-  void write_register(uint16_t addr, uint16_t value);
+                          RegisterCapability capability = RegisterCapability::NONE,
+                          const EntityBase *owner = nullptr);
+
+  // Write interface (called by climate/switch entities); false if the
+  // transaction queue is full and the write was dropped
+  bool write_register(uint16_t addr, uint16_t value);
+  // Read registers ahead of the poll cycle; values go to the cache and listeners
+  void request_read(const std::vector<uint16_t> &addresses);
+  // Read any registers, polled or not, and hand their values to `callback` once
+  // all are in or have failed (`missing`). Values read at most `max_age` ms
+  // before the call come from the cache. Reads requested while an earlier batch
+  // is on the bus are merged into the fewest func 65/66 transactions the
+  // register breakpoints allow.
+  using RegisterReadCallback = std::function<void(const std::vector<std::pair<uint16_t, uint16_t>> &values,
+                                                  const std::vector<uint16_t> &missing)>;
+  void read_registers(const std::vector<uint16_t> &addresses, uint32_t max_age, RegisterReadCallback callback);
+  // Scan `ranges` in as few requests as the protocol allows, passing YAML
+  // fixture text to `sink` a batch at a time. The dump's share of bus time
+  // is held to `duty_cycle` percent, and its requests wait for every other
+  // transaction. False if a dump is already running.
+  bool dump_registers(std::vector<RegisterDump::Range> ranges, uint8_t duty_cycle, RegisterDump::Sink sink);
+  bool dump_active() const { return dump_.active(); }
+  // Fault freeze frames taken so far (see set_freeze_frame_depth())
+  const FreezeFrame &freeze_frame() const { return freeze_frame_; }
+
+  // Register values cached but not yet dispatched to listeners
+  size_t dispatch_backlog() const { return pending_dispatch_.size() - dispatch_head_; }
+  size_t peak_dispatch_backlog() const { return peak_dispatch_backlog_; }
+
+  // Transaction queue statistics
+  size_t queue_depth() const { return queue_.size(); }
+  size_t peak_queue_depth() const { return peak_queue_depth_; }
+  uint32_t deadline_misses() const { return deadline_misses_; }
+  // Bus telemetry (cumulative since boot)
+  const BusStats &bus_stats() const { return bus_stats_; }
+  // Recorded bus traffic (see set_capture_buffer_size())
+  const BusCapture &capture() const { return capture_; }
+
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+  // Log the `top` slowest listeners (by worst single call) and registers
+  void log_dispatch_profile(size_t top = 10) const;
+  void reset_dispatch_profile();
+  const std::vector<RegisterListener> &listeners() const { return listeners_; }
+#endif
 
   // Configuration
-  void set_flow_control_pin(GPIOPin *pin) { flow_control_pin_ = pin; }
+  // ABC slave address this hub talks to
+  void set_address(uint8_t address) { address_ = address; }
+  uint8_t address() const { return address_; }
+  // Share the UART with other hubs (one per heat pump); transactions are interleaved round-robin
+  void set_bus_arbiter(BusArbiter *arbiter) {
+    arbiter_ = arbiter;
+    arbiter_client_ = arbiter->add_client();
+  }
+  // Appended to API service names so several hubs on one node do not clash
+  void set_service_suffix(const std::string &suffix) { service_suffix_ = suffix; }
+  void set_flow_control_pin(GPIOPin *pin) {
+    flow_control_pin_ = pin;
+    uart_transport_.set_flow_control_pin(pin);
+  }
+  // Reach the heat pump through something other than this hub's UART (e.g. a network gateway)
+  void set_transport(Transport *transport) { transport_ = transport; }
   void set_connected_sensor(binary_sensor::BinarySensor *sensor) { connected_sensor_ = sensor; }
   void set_connected_timeout(uint32_t timeout) { connected_timeout_ = timeout; }
+  void set_bus_stat_sensor(BusStatSensor which, sensor::Sensor *sensor) {
+    bus_stat_sensors_[static_cast<uint8_t>(which)] = sensor;
+  }
+  void set_poll_mode(PollMode mode) { poll_mode_ = mode; }
+  void set_min_poll_gap(uint32_t gap) { min_poll_gap_ = gap; }
+  // Listener dispatch time allowed per loop() in µs; 0 dispatches whole frames inline
+  void set_dispatch_budget(uint32_t budget_us) { dispatch_budget_us_ = budget_us; }
+  // Record every frame on the bus into a RAM ring of this many bytes (0 = off)
+  void set_capture_buffer_size(size_t size) { capture_.set_buffer_size(size); }
+  // Keep the last `depth` fault freeze frames (0 = off): snapshots of the
+  // registers set here (empty: FreezeFrame::DEFAULT_REGISTERS), read as soon as
+  // REG_LAST_FAULT shows a new fault or a lockout
+  void set_freeze_frame_depth(uint8_t depth) { freeze_frame_.set_depth(depth); }
+  void set_freeze_frame_registers(const std::vector<uint16_t> &registers) {
+    std::vector<FreezeFrame::Register> regs;
+    for (uint16_t addr : registers)
+      regs.push_back({addr, RegisterCapability::NONE});
+    freeze_frame_.set_registers(regs);
+  }
+  // Poll state-dependent registers every `fast` ms while the unit is running (or
+  // for `hold` ms after an output change) and every `slow` ms in standby
+  void set_adaptive_polling(uint32_t fast, uint32_t slow, uint32_t hold) {
+    adaptive_polling_ = true;
+    fast_poll_interval_ = fast;
+    slow_poll_interval_ = slow;
+    state_hold_time_ = hold;
+  }
+  // Poll plans computed at build time; the variant matching the detected hardware is used
+  void set_poll_plans(const PollPlan *plans, const PollPlanVariant *variants, size_t num_variants) {
+    poll_plans_ = plans;
+    poll_plan_variants_ = variants;
+    num_poll_plan_variants_ = num_variants;
+  }
+  // Passive mode: fill the cache from another master's traffic. Registers
+  // nobody has read for `max_age` ms are polled actively; 0 never polls.
+  void set_passive(uint32_t max_age) {
+    passive_ = true;
+    track_read_times_ = true;
+    passive_max_age_ = max_age;
+  }
+  // Run UART I/O on a dedicated task pinned to `core` instead of inside loop()
+  void set_bus_task_core(uint8_t core) {
+    use_bus_task_ = true;
+    bus_task_core_ = core;
+  }
 
   // Setup completion status (true after component detection completes)
   bool is_setup_complete() const { return setup_complete_; }
@@ -76,6 +288,10 @@ class WaterFurnace : public PollingComponent, public uart::UARTDevice
 
   // Register cache access (for entities that need multi-register values)
   bool get_register(uint16_t addr, uint16_t &value) const;
+  // Record when each register was last read (needed by get_register_age())
+  void track_read_times() { track_read_times_ = true; }
+  // Milliseconds since the cached value of `addr` was read; false if never read
+  bool get_register_age(uint16_t addr, uint32_t &age) const;
 
   // Merge sorted unique addresses into {start, count} ranges (gap ≤ max_gap)
   static std::vector<std::pair<uint16_t, uint16_t>> merge_to_ranges(
@@ -83,24 +299,54 @@ class WaterFurnace : public PollingComponent, public uart::UARTDevice
 
  protected:
   // Protocol communication
-  void send_frame_(const std::vector<uint8_t> &frame);
+  void send_frame_(const uint8_t *frame, size_t len);
+  void send_frame_(const std::vector<uint8_t> &frame) { this->send_frame_(frame.data(), frame.size()); }
   bool read_frame_(std::vector<uint8_t> &frame);
+  bool read_bus_task_frame_(std::vector<uint8_t> &frame);
+  // Frames from other slaves on a shared bus are not ours to process
+  bool is_own_frame_(const std::vector<uint8_t> &frame) const;
+  // Shared bus: hold the bus for one transaction (always true without an arbiter)
+  bool acquire_bus_();
+  void release_bus_();
   void process_response_(const std::vector<uint8_t> &frame);
 
+  // Passive mode
+  // Decode the other master's traffic; true if any register values were seen
+  bool sniff_();
+  bool sniff_bytes_(const uint8_t *data, size_t len, uint32_t now);
+  bool sniffed_all_(const std::vector<std::pair<uint16_t, uint16_t>> &ranges) const;
+  bool bus_quiet_(uint32_t now) const;
+
   // Polling
-  void poll_next_group_();
-  void process_pending_writes_();
+  // Paced mode: time between consecutive group starts within a cycle
+  uint32_t poll_spacing_() const;
+  // Adaptive polling: queue state-dependent groups whose timer has expired
+  void schedule_state_groups_(uint32_t now);
+  bool fast_rate_active_(uint32_t now) const;
+  void note_operating_state_(uint16_t addr, uint16_t value);
+  // Event-triggered refresh: queue groups that depend on `trigger` after its value changed
+  void queue_dependent_refresh_(uint16_t trigger);
 
   // Setup phases
   void read_system_id_();
   void detect_components_();
+  // Decode the setup registers once they are in the cache
+  void finish_system_id_();
+  void finish_component_detection_();
   void build_poll_groups_();
+  uint8_t plan_flags_() const;
+  // Load the prebuilt plan for the detected hardware; false if none matches the listeners
+  bool apply_poll_plan_();
 
   // Capability check: returns true if the listener's capability is satisfied by detected hardware
   bool has_capability_(RegisterCapability cap) const;
 
   // Dispatch register values to listeners
   void dispatch_register_(uint16_t addr, uint16_t value);
+  // Queue a received value for dispatch (or dispatch now if unbudgeted)
+  void queue_dispatch_(uint16_t addr, uint16_t value);
+  // Dispatch queued values in arrival order until the per-loop budget is spent
+  void drain_dispatch_queue_();
 
   // Decode string from consecutive registers
   static std::string decode_string_(const std::map<uint16_t, uint16_t> &regs,
@@ -109,9 +355,25 @@ class WaterFurnace : public PollingComponent, public uart::UARTDevice
   // Connectivity
   void update_connected_(bool connected);
 
+  // Bus telemetry
+  void record_response_(uint32_t rtt);
+  void publish_bus_stats_();
+
 #ifdef USE_API_CUSTOM_SERVICES
   // HA API service for modbus register write
   void on_write_register_service_(int32_t address, int32_t value);
+  // Read a register list ("25, 30-35, 12101") and fire the values as an HA event
+  void on_read_registers_service_(std::string registers, int32_t max_age);
+  // Dump a register list (empty: RegisterDump::DEFAULT_RANGES) to the log and as HA events
+  void on_dump_registers_service_(std::string registers, int32_t duty_cycle);
+#ifdef USE_WATERFURNACE_DISPATCH_PROFILING
+  void on_dump_dispatch_profile_service_(int32_t top);
+  void on_reset_dispatch_profile_service_();
+#endif
+  // Log the capture in base64 chunks, and fire each one as an HA event
+  void on_dump_capture_service_();
+  // Log the fault freeze frames, and fire each one as an HA event
+  void on_dump_freeze_frames_service_();
 #endif
 
   // State machine
@@ -129,9 +391,63 @@ class WaterFurnace : public PollingComponent, public uart::UARTDevice
   struct PollGroup {
     std::vector<std::pair<uint16_t, uint16_t>> ranges;   // For func 65
     std::vector<uint16_t> individual;                      // For func 66
+    uint32_t last_poll{0};                                 // State-dependent groups only
+    bool polled{false};
+    const uint8_t *frame{nullptr};                         // Prebuilt request (poll plan), if any
+    uint8_t frame_len{0};
+    std::vector<uint8_t> request;                          // Built on first send otherwise, then reused
+    RttHistogram rtt;
   };
+  void send_poll_group_(PollGroup &group);
+  // Passive mode: queue a read of the registers in `group` nobody has read
+  // within the max age (the whole group if all of them are stale)
+  void enqueue_stale_(PollGroup *group, TransactionClass cls, uint32_t release, uint32_t deadline, uint32_t now);
+  void build_refresh_targets_();
+  // Build groups for `addrs`; merged ranges are split so they never cover an address in `exclude`
+  void append_poll_groups_(const std::vector<uint16_t> &addrs, std::vector<PollGroup> &groups,
+                           const std::vector<uint16_t> &exclude = {});
   std::vector<PollGroup> poll_groups_;
-  uint8_t current_poll_group_{0};
+  PollMode poll_mode_{PollMode::BURST};
+  uint32_t min_poll_gap_{50};
+
+  // Transaction queue: every bus transaction after setup goes through here. loop()
+  // sends the most urgent released entry: lowest class, then earliest deadline.
+  struct Transaction {
+    TransactionClass cls{TransactionClass::POLL_FAST};
+    uint32_t seq{0};       // FIFO tie-break
+    uint32_t release{0};   // Not sent before this time
+    uint32_t deadline{0};  // Counted as a miss if not sent by this time
+    PollGroup *group{nullptr};                          // Poll group read
+    std::vector<uint16_t> addresses;                    // Ad-hoc func 66 read when group is null
+    std::vector<std::pair<uint16_t, uint16_t>> ranges;  // Ad-hoc func 65 read when group is null
+    std::vector<std::pair<uint16_t, uint16_t>> writes;  // WRITE payload / WRITE_VERIFY expected values
+  };
+  // False (and the transaction dropped) when the queue is full
+  bool enqueue_(Transaction txn);
+  // Queue a group read, or promote an already queued read of the same group
+  bool enqueue_group_(PollGroup *group, TransactionClass cls, uint32_t release, uint32_t deadline);
+  bool is_queued_(const PollGroup *group) const;
+  bool start_next_transaction_(uint32_t now);
+  void complete_transaction_();
+  std::vector<Transaction> queue_;
+  Transaction current_;
+  bool in_flight_{false};
+  uint32_t txn_seq_{0};
+  size_t peak_queue_depth_{0};
+  uint32_t deadline_misses_{0};
+
+  // Adaptive polling (state-dependent groups run on their own timers, outside the cycle)
+  bool adaptive_polling_{false};
+  uint32_t fast_poll_interval_{2000};
+  uint32_t slow_poll_interval_{60000};
+  uint32_t state_hold_time_{30000};
+  std::vector<PollGroup> state_groups_;
+
+  // Trigger register -> group re-read when it changes (from REGISTER_DEPENDENCIES)
+  std::vector<std::pair<uint16_t, PollGroup *>> refresh_targets_;
+  bool unit_active_{false};
+  bool state_changed_{false};
+  uint32_t last_state_change_{0};
 
   // Track which addresses we expect in the current response
   std::vector<uint16_t> expected_addresses_;
@@ -165,11 +481,91 @@ class WaterFurnace : public PollingComponent, public uart::UARTDevice
   // Listeners
   std::vector<RegisterListener> listeners_;
 
-  // Write queue
-  std::vector<std::pair<uint16_t, uint16_t>> pending_writes_;
+  // Build-time poll plans
+  const PollPlan *poll_plans_{nullptr};
+  const PollPlanVariant *poll_plan_variants_{nullptr};
+  size_t num_poll_plan_variants_{0};
+  bool using_poll_plan_{false};
+
+  // Received values awaiting dispatch, oldest frame first. Consumed from
+  // dispatch_head_ and cleared once drained, so the storage is reused every cycle.
+  std::vector<std::pair<uint16_t, uint16_t>> pending_dispatch_;
+  size_t dispatch_head_{0};
+  uint32_t dispatch_budget_us_{0};
+  size_t peak_dispatch_backlog_{0};
 
   // Hardware
   GPIOPin *flow_control_pin_{nullptr};
+  // This hub's own UART unless set_transport() chose another backend
+  UartTransport uart_transport_{this};
+  Transport *transport_{&uart_transport_};
+  uint8_t address_{SLAVE_ADDRESS};
+  BusArbiter *arbiter_{nullptr};
+  uint8_t arbiter_client_{BusArbiter::NO_CLIENT};
+  std::string service_suffix_;
+
+  // Passive mode
+  bool passive_{false};
+  uint32_t passive_max_age_{0};
+  uint32_t passive_since_{0};
+  BusSniffer sniffer_;
+  std::map<uint16_t, uint32_t> read_at_;  // millis() each register was last read, by anyone
+  bool track_read_times_{false};
+
+  // read_registers() requests waiting for values. A request is sent with the
+  // next batch of ad-hoc reads and finishes when its registers are all fresh
+  // or that batch has left the queue.
+  struct RegisterRead {
+    std::vector<uint16_t> addresses;  // Sorted, unique
+    uint32_t requested_at{0};
+    uint32_t max_age{0};
+    bool sent{false};
+    RegisterReadCallback callback;
+  };
+  void schedule_register_reads_(uint32_t now);
+  // Queue the fewest func 65/66 transactions reading `addrs` (sorted, unique)
+  void enqueue_register_reads_(const std::vector<uint16_t> &addrs, uint32_t now);
+  bool register_fresh_(uint16_t addr, const RegisterRead &read) const;
+  bool reading_registers_() const;
+  std::vector<RegisterRead> register_reads_;
+
+  // dump_registers(): one batch queued at a time, released after a pause that
+  // keeps the dump's bus time to dump_duty_cycle_ percent
+  void schedule_dump_(uint32_t now);
+  bool dumping_() const { return this->in_flight_ && this->current_.cls == TransactionClass::DUMP; }
+  RegisterDump dump_;
+  uint8_t dump_duty_cycle_{20};
+  uint32_t dump_release_{0};
+
+  // Bus capture: TX frames and RX bytes with micros() timestamps
+  void record_capture_(BusCapture::Record type, const uint8_t *data, size_t len) {
+    if (this->capture_.enabled())
+      this->capture_.record(type, data, len, micros(), !this->setup_complete_);
+  }
+  BusCapture capture_;
+
+  // Fault freeze frames: a REG_LAST_FAULT listener queues every freeze group
+  // as ON_DEMAND reads; the snapshot closes once none is queued or in flight.
+  // A fault seen while the queue has no room for them waits in fault_pending_.
+  void note_fault_(uint16_t value);
+  bool start_freeze_frame_();
+  void build_freeze_groups_();
+  void schedule_freeze_frame_(uint32_t now);
+  bool is_freeze_group_(const PollGroup *group) const {
+    return group != nullptr && group >= this->freeze_groups_.data() &&
+           group < this->freeze_groups_.data() + this->freeze_groups_.size();
+  }
+  FreezeFrame freeze_frame_;
+  std::vector<PollGroup> freeze_groups_;
+  bool fault_pending_{false};
+  uint16_t pending_fault_{0};
+  uint32_t fault_seen_at_{0};
+
+  // Bus telemetry
+  BusStats bus_stats_;
+  sensor::Sensor *bus_stat_sensors_[static_cast<uint8_t>(BusStatSensor::COUNT)]{};
+  uint32_t last_stats_publish_{0};
+  uint32_t last_stats_busy_ms_{0};
 
   // Connectivity monitoring
   binary_sensor::BinarySensor *connected_sensor_{nullptr};
@@ -182,8 +578,15 @@ class WaterFurnace : public PollingComponent, public uart::UARTDevice
   uint32_t last_response_time_{0};
   uint32_t error_backoff_until_{0};
 
-  // UART receive buffer
+  // Receive buffer (RTU bytes from the transport), and the last complete frame taken from it
   std::vector<uint8_t> rx_buffer_;
+  std::vector<uint8_t> rx_frame_;
+
+  // Optional dedicated bus I/O task (nullptr when UART I/O runs inline in loop())
+  bool use_bus_task_{false};
+  uint8_t bus_task_core_{0};
+  BusTask *bus_task_{nullptr};
+  uint32_t bus_seq_{0};
 
   // Response timeout (ms)
   static constexpr uint32_t RESPONSE_TIMEOUT = 2000;
@@ -191,6 +594,20 @@ class WaterFurnace : public PollingComponent, public uart::UARTDevice
   static constexpr uint32_t ERROR_BACKOFF_TIME = 5000;
   // Inter-frame delay for ModBus RTU at 19200 baud (1.75ms minimum, use 5ms for safety)
   static constexpr uint32_t INTER_FRAME_DELAY = 5;
+  // Transaction deadlines (ms after queueing); poll reads use their own period
+  static constexpr uint32_t WRITE_DEADLINE = 1000;
+  static constexpr uint32_t WRITE_VERIFY_DEADLINE = 2000;
+  static constexpr uint32_t ON_DEMAND_DEADLINE = 1000;
+  static constexpr size_t MAX_QUEUE_DEPTH = 32;
+  // read_registers(): requests waiting at once, registers per request, and the
+  // time after which a request reports whatever it has
+  static constexpr size_t MAX_REGISTER_READS = 8;
+  static constexpr size_t MAX_REGISTER_READ_SIZE = 256;
+  static constexpr uint32_t REGISTER_READ_TIMEOUT = 10000;
+  // Dump batches are never urgent; this only keeps them out of the deadline misses
+  static constexpr uint32_t DUMP_DEADLINE = 60000;
+  // Passive mode: bus silence needed before the hub transmits
+  static constexpr uint32_t PASSIVE_QUIET_TIME = 100;
 };
 
 }  // namespace waterfurnace
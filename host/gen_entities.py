@@ -0,0 +1,100 @@
+"""Emit entities.h: every entity the platform schemas offer, for the host daemon.
+
+The register tables are read straight out of the platform __init__.py files
+(without importing ESPHome), so the daemon publishes exactly what a full
+ESPHome configuration would.
+"""
+
+import ast
+import os
+
+PLATFORMS = os.path.join(os.path.dirname(__file__), "..", "components", "waterfurnace")
+
+
+def load_tables(platform, *names):
+    """Evaluate the named module-level literals, resolving CONF_* constants."""
+    with open(os.path.join(PLATFORMS, platform, "__init__.py")) as f:
+        tree = ast.parse(f.read())
+    constants = {}
+    tables = {}
+    for node in tree.body:
+        if not isinstance(node, ast.Assign) or len(node.targets) != 1:
+            continue
+        target = node.targets[0]
+        if not isinstance(target, ast.Name):
+            continue
+        if isinstance(node.value, ast.Constant):
+            constants[target.id] = node.value.value
+        elif target.id in names:
+            tables[target.id] = evaluate(node.value, constants)
+    return [tables[name] for name in names]
+
+
+def evaluate(node, constants):
+    if isinstance(node, ast.Name):
+        return constants[node.id]
+    if isinstance(node, ast.Constant):
+        return node.value
+    if isinstance(node, ast.Tuple):
+        return tuple(evaluate(e, constants) for e in node.elts)
+    if isinstance(node, ast.List):
+        return [evaluate(e, constants) for e in node.elts]
+    if isinstance(node, ast.Dict):
+        return {evaluate(k, constants): evaluate(v, constants) for k, v in zip(node.keys, node.values)}
+    raise ValueError(f"Unsupported literal: {ast.dump(node)}")
+
+
+def main():
+    (sensors,) = load_tables("sensor", "SENSOR_TYPES")
+    (binary_sensors,) = load_tables("binary_sensor", "BINARY_SENSOR_TYPES")
+    (text_sensors,) = load_tables("text_sensor", "TEXT_SENSOR_TYPES")
+
+    print("#pragma once")
+    print()
+    print("// Generated by gen_entities.py from the platform tables in components/waterfurnace; do not edit")
+    print()
+    print('#include "registers.h"')
+    print()
+    print("namespace esphome {")
+    print("namespace waterfurnace {")
+    print()
+    print("struct HostSensor {")
+    print("  const char *name;")
+    print("  uint16_t address;")
+    print("  RegisterType type;")
+    print("  RegisterCapability capability;")
+    print("};")
+    print()
+    print("struct HostBinarySensor {")
+    print("  const char *name;")
+    print("  uint16_t address;")
+    print("  uint16_t bitmask;")
+    print("  RegisterCapability capability;")
+    print("};")
+    print()
+    print("struct HostTextSensor {")
+    print("  const char *name;")
+    print("  const char *type;")
+    print("};")
+    print()
+    print("static const HostSensor HOST_SENSORS[] = {")
+    for name, (addr, reg_type, cap) in sensors.items():
+        print(f'    {{"{name}", {addr}, RegisterType::{reg_type.upper()}, RegisterCapability::{cap.upper()}}},')
+    print("};")
+    print()
+    print("static const HostBinarySensor HOST_BINARY_SENSORS[] = {")
+    for name, (addr, mask, cap) in binary_sensors.items():
+        print(f'    {{"{name}", {addr}, 0x{mask:04X}, RegisterCapability::{cap.upper()}}},')
+    print("};")
+    print()
+    print("static const HostTextSensor HOST_TEXT_SENSORS[] = {")
+    for name, sensor_type in text_sensors.items():
+        print(f'    {{"{name}", "{sensor_type}"}},')
+    print("};")
+    print()
+    print("}  // namespace waterfurnace")
+    print("}  // namespace esphome")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,256 @@
+// The WaterFurnace hub as a Linux daemon: the same polling engine and entity
+// classes ESPHome builds, talking to the heat pump through a serial device
+// (a USB RS-485 adapter or a pty) or a network gateway, with every entity
+// state written out as a JSON line.
+
+#include "entities.h"
+#include "publisher.h"
+#include "serial_transport.h"
+#include "tcp_transport.h"
+#include "waterfurnace.h"
+#include "binary_sensor/waterfurnace_binary_sensor.h"
+#include "climate/waterfurnace_climate.h"
+#include "sensor/waterfurnace_sensor.h"
+#include "switch/waterfurnace_switch.h"
+#include "text_sensor/waterfurnace_text_sensor.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <getopt.h>
+#include <memory>
+#include <poll.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+
+static const char *const TAG = "waterfurnace.host";
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int) { stop_requested = 1; }
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s (--device PATH | --tcp HOST[:PORT] [--rtu]) [options]\n"
+          "\n"
+          "  -d, --device PATH     Serial device or pty of the RS-485 bus (19200 8E1)\n"
+          "  -t, --tcp HOST[:PORT] Modbus TCP gateway (port 502 by default)\n"
+          "      --rtu             The gateway passes RTU frames through unchanged\n"
+          "  -a, --address N       ABC slave address (default 1)\n"
+          "  -i, --interval SEC    Poll interval (default 5)\n"
+          "  -l, --listen PORT     Also publish states to TCP clients on PORT\n"
+          "  -q, --quiet           Do not publish states to stdout\n"
+          "  -v, --verbose         More logging on stderr (repeat for more)\n"
+          "\n"
+          "States are published as JSON lines. Lines on stdin of the form\n"
+          "'write ADDRESS VALUE' write a register.\n",
+          argv0);
+}
+
+// Components in ESPHome's setup order (highest priority first)
+static std::vector<Component *> components;
+
+static void run_command(WaterFurnace &hub, const char *line) {
+  unsigned address, value;
+  if (sscanf(line, "write %u %u", &address, &value) == 2 && address <= 0xFFFF && value <= 0xFFFF) {
+    hub.write_register(address, value);
+    return;
+  }
+  ESP_LOGW(TAG, "Unknown command: %s", line);
+}
+
+// Hand complete stdin lines to run_command(); false once stdin is closed
+static bool read_commands(WaterFurnace &hub, std::string &pending) {
+  char buf[256];
+  ssize_t n = ::read(STDIN_FILENO, buf, sizeof(buf));
+  if (n == 0)
+    return false;
+  if (n < 0)
+    return true;
+  pending.append(buf, n);
+  size_t pos;
+  while ((pos = pending.find('\n')) != std::string::npos) {
+    std::string line = pending.substr(0, pos);
+    pending.erase(0, pos + 1);
+    if (!line.empty())
+      run_command(hub, line.c_str());
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::string device, tcp;
+  bool rtu = false, quiet = false;
+  int address = 1, interval = 5, listen_port = 0;
+
+  static const struct option OPTIONS[] = {
+      {"device", required_argument, nullptr, 'd'}, {"tcp", required_argument, nullptr, 't'},
+      {"rtu", no_argument, nullptr, 'r'},          {"address", required_argument, nullptr, 'a'},
+      {"interval", required_argument, nullptr, 'i'}, {"listen", required_argument, nullptr, 'l'},
+      {"quiet", no_argument, nullptr, 'q'},        {"verbose", no_argument, nullptr, 'v'},
+      {"help", no_argument, nullptr, 'h'},         {nullptr, 0, nullptr, 0},
+  };
+  int opt;
+  while ((opt = getopt_long(argc, argv, "d:t:a:i:l:qvh", OPTIONS, nullptr)) != -1) {
+    switch (opt) {
+      case 'd':
+        device = optarg;
+        break;
+      case 't':
+        tcp = optarg;
+        break;
+      case 'r':
+        rtu = true;
+        break;
+      case 'a':
+        address = atoi(optarg);
+        break;
+      case 'i':
+        interval = atoi(optarg);
+        break;
+      case 'l':
+        listen_port = atoi(optarg);
+        break;
+      case 'q':
+        quiet = true;
+        break;
+      case 'v':
+        log_level = std::min(log_level + 1, ESPHOME_LOG_LEVEL_VERBOSE);
+        break;
+      default:
+        usage(argv[0]);
+        return opt == 'h' ? 0 : 2;
+    }
+  }
+  if (device.empty() == tcp.empty() || address < 1 || address > 247 || interval < 1 || listen_port < 0 ||
+      listen_port > 65535) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+  signal(SIGPIPE, SIG_IGN);
+
+  static Publisher publisher;
+  publisher.set_stdout(!quiet);
+  if (listen_port != 0 && !publisher.listen(listen_port))
+    return 1;
+  host::publish_hook = [](const char *platform, const EntityBase *entity, const std::string &state) {
+    publisher.publish(platform, entity, state);
+  };
+
+  std::unique_ptr<Transport> transport;
+  if (!device.empty()) {
+    auto serial = std::make_unique<SerialTransport>();
+    serial->set_device(device);
+    transport = std::move(serial);
+  } else {
+    auto gateway = std::make_unique<TcpTransport>(rtu ? TcpTransport::Framing::RTU : TcpTransport::Framing::MBAP);
+    size_t colon = tcp.rfind(':');
+    if (colon != std::string::npos) {
+      gateway->set_port(atoi(tcp.c_str() + colon + 1));
+      tcp.resize(colon);
+    }
+    gateway->set_host(tcp);
+    transport = std::move(gateway);
+  }
+
+  WaterFurnace hub;
+  hub.set_transport(transport.get());
+  hub.set_address(address);
+  hub.set_update_interval(interval * 1000);
+  components.push_back(&hub);
+
+  binary_sensor::BinarySensor connected;
+  connected.set_name("connected");
+  hub.set_connected_sensor(&connected);
+
+  // Every entity a full ESPHome configuration could declare
+  std::vector<std::unique_ptr<Component>> entities;
+  for (const auto &def : HOST_SENSORS) {
+    auto sensor = std::make_unique<WaterFurnaceSensor>();
+    sensor->set_name(def.name);
+    sensor->set_parent(&hub);
+    sensor->set_register_address(def.address);
+    sensor->set_register_type(def.type);
+    sensor->set_capability(def.capability);
+    entities.push_back(std::move(sensor));
+  }
+  for (const auto &def : HOST_BINARY_SENSORS) {
+    auto sensor = std::make_unique<WaterFurnaceBinarySensor>();
+    sensor->set_name(def.name);
+    sensor->set_parent(&hub);
+    sensor->set_register_address(def.address);
+    sensor->set_bitmask(def.bitmask);
+    sensor->set_capability(def.capability);
+    entities.push_back(std::move(sensor));
+  }
+  for (const auto &def : HOST_TEXT_SENSORS) {
+    auto sensor = std::make_unique<WaterFurnaceTextSensor>();
+    sensor->set_name(def.name);
+    sensor->set_parent(&hub);
+    sensor->set_sensor_type(def.type);
+    entities.push_back(std::move(sensor));
+  }
+  // As in switch/__init__.py
+  auto dhw = std::make_unique<WaterFurnaceSwitch>();
+  dhw->set_name("dhw_enable");
+  dhw->set_parent(&hub);
+  dhw->set_register_address(400);
+  dhw->set_write_address(400);
+  dhw->set_capability(RegisterCapability::AXB);
+  entities.push_back(std::move(dhw));
+  auto thermostat = std::make_unique<WaterFurnaceClimate>();
+  thermostat->set_name("thermostat");
+  thermostat->set_parent(&hub);
+  thermostat->set_zone(1);
+  entities.push_back(std::move(thermostat));
+  for (auto &entity : entities)
+    components.push_back(entity.get());
+
+  std::stable_sort(components.begin(), components.end(), [](const Component *a, const Component *b) {
+    return a->get_setup_priority() > b->get_setup_priority();
+  });
+  for (auto *component : components)
+    component->setup();
+  for (auto *component : components)
+    component->dump_config();
+
+  fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+  bool stdin_open = true;
+  std::string pending;
+  // The first poll cycle starts as soon as setup completes
+  bool polling = false;
+  uint32_t last_update = 0;
+
+  while (!stop_requested) {
+    for (auto *component : components)
+      component->loop();
+    publisher.loop();
+
+    uint32_t now = millis();
+    if (!polling && hub.is_setup_complete()) {
+      polling = true;
+      last_update = now;
+      hub.update();
+    } else if (polling && now - last_update >= hub.get_update_interval()) {
+      last_update += hub.get_update_interval();
+      hub.update();
+    }
+
+    // Sleep about a millisecond, waking early for commands
+    struct pollfd fds[1] = {{STDIN_FILENO, POLLIN, 0}};
+    if (::poll(fds, stdin_open ? 1 : 0, 1) > 0 && (fds[0].revents & (POLLIN | POLLHUP)))
+      stdin_open = read_commands(hub, pending);
+  }
+  ESP_LOGI(TAG, "Stopping");
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "publisher.h"
+#include "esphome/core/log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace esphome {
+namespace waterfurnace {
+
+static const char *const PUBLISHER_TAG = "waterfurnace.publisher";
+
+Publisher::~Publisher() {
+  for (int fd : this->clients_)
+    ::close(fd);
+  if (this->listen_fd_ >= 0)
+    ::close(this->listen_fd_);
+}
+
+bool Publisher::listen(uint16_t port) {
+  int fd = ::socket(AF_INET6, SOCK_STREAM, 0);
+  if (fd < 0) {
+    ESP_LOGE(PUBLISHER_TAG, "Could not create socket: %s", strerror(errno));
+    return false;
+  }
+  int enable = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  int v6only = 0;
+  setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, sizeof(v6only));
+  struct sockaddr_in6 addr {};
+  addr.sin6_family = AF_INET6;
+  addr.sin6_addr = in6addr_any;
+  addr.sin6_port = htons(port);
+  if (::bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(fd, 4) != 0) {
+    ESP_LOGE(PUBLISHER_TAG, "Could not listen on port %u: %s", port, strerror(errno));
+    ::close(fd);
+    return false;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  this->listen_fd_ = fd;
+  ESP_LOGI(PUBLISHER_TAG, "Publishing states on port %u", port);
+  return true;
+}
+
+void Publisher::loop() {
+  if (this->listen_fd_ < 0)
+    return;
+  while (true) {
+    int fd = ::accept(this->listen_fd_, nullptr, nullptr);
+    if (fd < 0)
+      return;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    this->clients_.push_back(fd);
+    ESP_LOGD(PUBLISHER_TAG, "Client connected, %u total", this->clients_.size());
+  }
+}
+
+void Publisher::publish(const char *platform, const EntityBase *entity, const std::string &state) {
+  std::string line = "{\"platform\":\"";
+  line += platform;
+  line += "\",\"name\":" + host::json_string(entity->get_name()) + ",\"state\":" + state + "}\n";
+  this->write_line_(line);
+}
+
+void Publisher::write_line_(const std::string &line) {
+  if (this->stdout_) {
+    fputs(line.c_str(), stdout);
+    fflush(stdout);
+  }
+  for (auto it = this->clients_.begin(); it != this->clients_.end();) {
+    ssize_t n = ::send(*it, line.data(), line.size(), MSG_NOSIGNAL);
+    if (n == static_cast<ssize_t>(line.size())) {
+      ++it;
+      continue;
+    }
+    // Gone, or too far behind: a partial line would corrupt the stream anyway
+    ESP_LOGD(PUBLISHER_TAG, "Dropping client (%s)", n < 0 ? strerror(errno) : "send buffer full");
+    ::close(*it);
+    it = this->clients_.erase(it);
+  }
+}
+
+}  // namespace waterfurnace
+}  // namespace esphome
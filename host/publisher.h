@@ -0,0 +1,37 @@
+#pragma once
+
+#include "esphome/core/entity_base.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// Writes every entity state as one JSON line, e.g.
+///   {"platform":"sensor","name":"entering_water_temperature","state":52.3}
+/// to stdout and to each client of an optional listening TCP socket. A client
+/// that cannot keep up is disconnected rather than allowed to stall the loop.
+class Publisher {
+ public:
+  ~Publisher();
+
+  bool listen(uint16_t port);
+  void set_stdout(bool enabled) { stdout_ = enabled; }
+  /// Accept new clients
+  void loop();
+  void publish(const char *platform, const EntityBase *entity, const std::string &state);
+
+  size_t num_clients() const { return clients_.size(); }
+
+ protected:
+  void write_line_(const std::string &line);
+
+  bool stdout_{true};
+  int listen_fd_{-1};
+  std::vector<int> clients_;
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
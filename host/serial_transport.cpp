@@ -0,0 +1,116 @@
+#include "serial_transport.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace esphome {
+namespace waterfurnace {
+
+static const char *const SERIAL_TAG = "waterfurnace.serial";
+
+void SerialTransport::loop() {
+  if (this->fd_ >= 0)
+    return;
+  uint32_t now = millis();
+  if (this->attempted_ && now - this->last_attempt_ < RECONNECT_INTERVAL)
+    return;
+  this->attempted_ = true;
+  this->last_attempt_ = now;
+  this->open_();
+}
+
+bool SerialTransport::open_() {
+  int fd = ::open(this->device_.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0) {
+    ESP_LOGW(SERIAL_TAG, "Could not open %s: %s", this->device_.c_str(), strerror(errno));
+    return false;
+  }
+  struct termios tio;
+  if (tcgetattr(fd, &tio) != 0) {
+    ESP_LOGW(SERIAL_TAG, "%s is not a serial device", this->device_.c_str());
+    ::close(fd);
+    return false;
+  }
+  // 19200 baud, 8 data bits, even parity, 1 stop bit, no flow control, raw bytes
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, B19200);
+  cfsetospeed(&tio, B19200);
+  tio.c_cflag &= ~(CSIZE | CSTOPB | PARODD | CRTSCTS);
+  tio.c_cflag |= CS8 | PARENB | CLOCAL | CREAD;
+  tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+  // VMIN 0 would make an empty read return 0 (indistinguishable from a hangup) instead of EAGAIN
+  tio.c_cc[VMIN] = 1;
+  tio.c_cc[VTIME] = 0;
+  if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+    ESP_LOGW(SERIAL_TAG, "Could not configure %s: %s", this->device_.c_str(), strerror(errno));
+    ::close(fd);
+    return false;
+  }
+  tcflush(fd, TCIOFLUSH);
+  this->fd_ = fd;
+  this->opens_++;
+  ESP_LOGI(SERIAL_TAG, "Opened %s", this->device_.c_str());
+  return true;
+}
+
+void SerialTransport::close_() {
+  if (this->fd_ < 0)
+    return;
+  ::close(this->fd_);
+  this->fd_ = -1;
+}
+
+void SerialTransport::fail_(const char *what) {
+  ESP_LOGW(SERIAL_TAG, "%s failed on %s (%s), reopening", what, this->device_.c_str(), strerror(errno));
+  this->close_();
+  this->last_attempt_ = millis();
+}
+
+void SerialTransport::send(const uint8_t *frame, size_t len) {
+  if (this->fd_ < 0)
+    return;
+  size_t sent = 0;
+  while (sent < len) {
+    ssize_t n = ::write(this->fd_, frame + sent, len - sent);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      // A frame is far smaller than any tty buffer; a full one means nothing is draining it
+      ESP_LOGW(SERIAL_TAG, "Output buffer full, request dropped");
+      return;
+    }
+    if (n < 0) {
+      this->fail_("Write");
+      return;
+    }
+    sent += n;
+  }
+}
+
+size_t SerialTransport::read(uint8_t *buf, size_t len) {
+  if (this->fd_ < 0)
+    return 0;
+  ssize_t n = ::read(this->fd_, buf, len);
+  if (n > 0)
+    return n;
+  if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    return 0;
+  // EOF once the adapter is unplugged, EIO once the pty's other end is closed
+  if (n == 0)
+    errno = EIO;
+  this->fail_("Read");
+  return 0;
+}
+
+void SerialTransport::dump_config() {
+  ESP_LOGCONFIG(SERIAL_TAG, "  Transport: serial %s at 19200 8E1 (%s)", this->device_.c_str(),
+                this->fd_ >= 0 ? "open" : "closed");
+}
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../components/waterfurnace/transport.h"
+
+#include <string>
+
+namespace esphome {
+namespace waterfurnace {
+
+/// RS-485 through a Linux serial device (a USB adapter, or one end of a pty
+/// pair), opened non-blocking at 19200 8E1. The adapter switches direction
+/// itself, so there is no driver-enable pin. A device that disappears (USB
+/// unplugged, pty peer closed) is reopened every RECONNECT_INTERVAL.
+class SerialTransport : public Transport {
+ public:
+  static constexpr uint32_t RECONNECT_INTERVAL = 5000;
+
+  ~SerialTransport() override { this->close_(); }
+
+  void set_device(const std::string &device) { device_ = device; }
+
+  void loop() override;
+  bool is_connected() const override { return fd_ >= 0; }
+  void send(const uint8_t *frame, size_t len) override;
+  size_t read(uint8_t *buf, size_t len) override;
+  void dump_config() override;
+
+  uint32_t opens() const { return opens_; }
+
+ protected:
+  bool open_();
+  void close_();
+  void fail_(const char *what);
+
+  std::string device_;
+  int fd_{-1};
+  uint32_t last_attempt_{0};
+  bool attempted_{false};
+  uint32_t opens_{0};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
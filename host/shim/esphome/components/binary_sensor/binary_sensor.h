@@ -0,0 +1,27 @@
+#pragma once
+
+#include "esphome/core/entity_base.h"
+
+namespace esphome {
+namespace binary_sensor {
+
+class BinarySensor : public EntityBase {
+ public:
+  // Like ESPHome, only changes are published
+  void publish_state(bool value) {
+    if (this->has_state_ && value == this->state)
+      return;
+    this->state = value;
+    this->has_state_ = true;
+    host::publish("binary_sensor", this, value ? "true" : "false");
+  }
+  bool has_state() const { return has_state_; }
+
+  bool state{false};
+
+ protected:
+  bool has_state_{false};
+};
+
+}  // namespace binary_sensor
+}  // namespace esphome
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/optional.h"
+
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace climate {
+
+enum ClimateMode : uint8_t {
+  CLIMATE_MODE_OFF = 0,
+  CLIMATE_MODE_HEAT_COOL = 1,
+  CLIMATE_MODE_COOL = 2,
+  CLIMATE_MODE_HEAT = 3,
+  CLIMATE_MODE_FAN_ONLY = 4,
+  CLIMATE_MODE_DRY = 5,
+  CLIMATE_MODE_AUTO = 6,
+};
+
+enum ClimateFanMode : uint8_t {
+  CLIMATE_FAN_ON = 0,
+  CLIMATE_FAN_OFF = 1,
+  CLIMATE_FAN_AUTO = 2,
+  CLIMATE_FAN_LOW = 3,
+  CLIMATE_FAN_MEDIUM = 4,
+  CLIMATE_FAN_HIGH = 5,
+};
+
+enum ClimatePreset : uint8_t {
+  CLIMATE_PRESET_NONE = 0,
+  CLIMATE_PRESET_HOME = 1,
+  CLIMATE_PRESET_AWAY = 2,
+  CLIMATE_PRESET_BOOST = 3,
+  CLIMATE_PRESET_COMFORT = 4,
+  CLIMATE_PRESET_ECO = 5,
+  CLIMATE_PRESET_SLEEP = 6,
+  CLIMATE_PRESET_ACTIVITY = 7,
+};
+
+inline const char *mode_name(ClimateMode mode) {
+  switch (mode) {
+    case CLIMATE_MODE_OFF:
+      return "off";
+    case CLIMATE_MODE_HEAT_COOL:
+      return "heat_cool";
+    case CLIMATE_MODE_COOL:
+      return "cool";
+    case CLIMATE_MODE_HEAT:
+      return "heat";
+    case CLIMATE_MODE_FAN_ONLY:
+      return "fan_only";
+    case CLIMATE_MODE_DRY:
+      return "dry";
+    case CLIMATE_MODE_AUTO:
+      return "auto";
+  }
+  return "unknown";
+}
+
+inline const char *fan_mode_name(ClimateFanMode mode) {
+  switch (mode) {
+    case CLIMATE_FAN_ON:
+      return "on";
+    case CLIMATE_FAN_OFF:
+      return "off";
+    case CLIMATE_FAN_AUTO:
+      return "auto";
+    case CLIMATE_FAN_LOW:
+      return "low";
+    case CLIMATE_FAN_MEDIUM:
+      return "medium";
+    case CLIMATE_FAN_HIGH:
+      return "high";
+  }
+  return "unknown";
+}
+
+// Feature flags
+constexpr uint32_t CLIMATE_SUPPORTS_CURRENT_TEMPERATURE = 1 << 0;
+constexpr uint32_t CLIMATE_SUPPORTS_TWO_POINT_TARGET_TEMPERATURE = 1 << 1;
+constexpr uint32_t CLIMATE_REQUIRES_TWO_POINT_TARGET_TEMPERATURE = 1 << 2;
+constexpr uint32_t CLIMATE_SUPPORTS_CURRENT_HUMIDITY = 1 << 3;
+
+class ClimateTraits {
+ public:
+  // Only Home Assistant reads the traits; the host has nothing to report them to
+  void add_feature_flags(uint32_t flags) {}
+  void set_supports_current_temperature(bool v) {}
+  void set_supports_two_point_target_temperature(bool v) {}
+  void set_visual_min_temperature(float v) {}
+  void set_visual_max_temperature(float v) {}
+  void set_visual_target_temperature_step(float v) {}
+  void set_visual_current_temperature_step(float v) {}
+  void set_supported_modes(std::vector<ClimateMode> modes) {}
+  void set_supported_modes(std::initializer_list<ClimateMode> modes) {}
+  void set_supported_fan_modes(std::vector<ClimateFanMode> modes) {}
+  void set_supported_fan_modes(std::initializer_list<ClimateFanMode> modes) {}
+  void set_supported_custom_fan_modes(std::initializer_list<const char *> modes) {}
+  void set_supported_custom_fan_modes(const std::vector<const char *> &modes) {}
+  void set_supported_presets(std::vector<ClimatePreset> presets) {}
+  void set_supported_presets(std::initializer_list<ClimatePreset> presets) {}
+  void set_supported_custom_presets(std::initializer_list<const char *> presets) {}
+  void set_supported_custom_presets(const std::vector<const char *> &presets) {}
+};
+
+class ClimateCall {
+ public:
+  optional<ClimateMode> get_mode() const { return mode_; }
+  optional<ClimateFanMode> get_fan_mode() const { return fan_mode_; }
+  optional<ClimatePreset> get_preset() const { return preset_; }
+  optional<float> get_target_temperature() const { return target_; }
+  optional<float> get_target_temperature_low() const { return target_low_; }
+  optional<float> get_target_temperature_high() const { return target_high_; }
+  bool has_custom_fan_mode() const { return custom_fan_mode_.has_value(); }
+  std::string get_custom_fan_mode() const { return custom_fan_mode_.value_or(""); }
+  bool has_custom_preset() const { return custom_preset_.has_value(); }
+  std::string get_custom_preset() const { return custom_preset_.value_or(""); }
+
+  ClimateCall &set_mode(ClimateMode mode) { mode_ = mode; return *this; }
+  ClimateCall &set_fan_mode(ClimateFanMode mode) { fan_mode_ = mode; return *this; }
+  ClimateCall &set_preset(ClimatePreset preset) { preset_ = preset; return *this; }
+  ClimateCall &set_target_temperature(float v) { target_ = v; return *this; }
+  ClimateCall &set_target_temperature_low(float v) { target_low_ = v; return *this; }
+  ClimateCall &set_target_temperature_high(float v) { target_high_ = v; return *this; }
+  ClimateCall &set_custom_fan_mode(const std::string &mode) { custom_fan_mode_ = mode; return *this; }
+  ClimateCall &set_custom_preset(const std::string &preset) { custom_preset_ = preset; return *this; }
+
+ private:
+  optional<ClimateMode> mode_;
+  optional<ClimateFanMode> fan_mode_;
+  optional<ClimatePreset> preset_;
+  optional<float> target_;
+  optional<float> target_low_;
+  optional<float> target_high_;
+  optional<std::string> custom_fan_mode_;
+  optional<std::string> custom_preset_;
+};
+
+class Climate : public EntityBase {
+ public:
+  ClimateMode mode{CLIMATE_MODE_OFF};
+  float current_temperature{NAN};
+  float current_humidity{NAN};
+  float target_temperature{NAN};
+  float target_temperature_low{NAN};
+  float target_temperature_high{NAN};
+  optional<ClimateFanMode> fan_mode{};
+  optional<ClimatePreset> preset{};
+
+  void publish_state() {
+    std::string json = "{\"mode\":" + host::json_string(mode_name(this->mode));
+    json += ",\"current_temperature\":" + host::json_number(this->current_temperature);
+    json += ",\"current_humidity\":" + host::json_number(this->current_humidity);
+    json += ",\"target_temperature_low\":" + host::json_number(this->target_temperature_low);
+    json += ",\"target_temperature_high\":" + host::json_number(this->target_temperature_high);
+    if (this->has_custom_fan_mode()) {
+      json += ",\"fan_mode\":" + host::json_string(this->custom_fan_mode_);
+    } else if (this->fan_mode.has_value()) {
+      json += ",\"fan_mode\":" + host::json_string(fan_mode_name(*this->fan_mode));
+    }
+    if (this->has_custom_preset())
+      json += ",\"preset\":" + host::json_string(this->custom_preset_);
+    host::publish("climate", this, json + "}");
+  }
+  virtual ClimateTraits traits() { return ClimateTraits(); }
+  virtual void control(const ClimateCall &call) {}
+
+  bool has_custom_fan_mode() const { return !custom_fan_mode_.empty(); }
+  std::string get_custom_fan_mode() const { return custom_fan_mode_; }
+  bool has_custom_preset() const { return !custom_preset_.empty(); }
+  std::string get_custom_preset() const { return custom_preset_; }
+
+ protected:
+  bool set_custom_fan_mode_(const char *mode) {
+    custom_fan_mode_ = mode;
+    fan_mode.reset();
+    return true;
+  }
+  void clear_custom_fan_mode_() { custom_fan_mode_.clear(); }
+  bool set_custom_preset_(const char *p) {
+    custom_preset_ = p;
+    preset.reset();
+    return true;
+  }
+  void clear_custom_preset_() { custom_preset_.clear(); }
+  std::string custom_fan_mode_;
+  std::string custom_preset_;
+};
+
+}  // namespace climate
+}  // namespace esphome
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "esphome/core/entity_base.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace sensor {
+
+class Sensor : public EntityBase {
+ public:
+  void publish_state(float value) {
+    this->state = value;
+    host::publish("sensor", this, host::json_number(value));
+  }
+
+  float state{NAN};
+};
+
+}  // namespace sensor
+}  // namespace esphome
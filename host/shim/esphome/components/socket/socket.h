@@ -0,0 +1,89 @@
+#pragma once
+
+// ESPHome's socket API on top of BSD sockets, so the component's network code
+// (TcpTransport, ModbusTcpServer) runs unchanged on a Linux host.
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace esphome {
+namespace socket {
+
+class Socket {
+ public:
+  explicit Socket(int fd) : fd_(fd) {}
+  ~Socket() { this->close(); }
+
+  std::unique_ptr<Socket> accept(struct sockaddr *addr, socklen_t *addrlen) {
+    int fd = ::accept(this->fd_, addr, addrlen);
+    return fd < 0 ? nullptr : std::make_unique<Socket>(fd);
+  }
+  int bind(const struct sockaddr *addr, socklen_t addrlen) { return ::bind(this->fd_, addr, addrlen); }
+  int connect(const struct sockaddr *addr, socklen_t addrlen) { return ::connect(this->fd_, addr, addrlen); }
+  int getpeername(struct sockaddr *addr, socklen_t *addrlen) { return ::getpeername(this->fd_, addr, addrlen); }
+  int getsockopt(int level, int optname, void *optval, socklen_t *optlen) {
+    return ::getsockopt(this->fd_, level, optname, optval, optlen);
+  }
+  int setsockopt(int level, int optname, const void *optval, socklen_t optlen) {
+    return ::setsockopt(this->fd_, level, optname, optval, optlen);
+  }
+  int listen(int backlog) { return ::listen(this->fd_, backlog); }
+  int close() {
+    int res = this->fd_ >= 0 ? ::close(this->fd_) : 0;
+    this->fd_ = -1;
+    return res;
+  }
+  int setblocking(bool blocking) {
+    int flags = ::fcntl(this->fd_, F_GETFL, 0);
+    return ::fcntl(this->fd_, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+  }
+  ssize_t read(void *buf, size_t len) { return ::recv(this->fd_, buf, len, 0); }
+  ssize_t write(const void *buf, size_t len) { return ::send(this->fd_, buf, len, MSG_NOSIGNAL); }
+
+ protected:
+  int fd_;
+};
+
+inline std::unique_ptr<Socket> socket_ip(int type, int protocol) {
+  int fd = ::socket(AF_INET, type, protocol);
+  return fd < 0 ? nullptr : std::make_unique<Socket>(fd);
+}
+
+// Unlike the ESP version this also resolves host names
+inline socklen_t set_sockaddr(struct sockaddr *addr, socklen_t addrlen, const std::string &ip_address,
+                              uint16_t port) {
+  struct addrinfo hints {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo *res = nullptr;
+  if (::getaddrinfo(ip_address.c_str(), nullptr, &hints, &res) != 0 || res == nullptr)
+    return 0;
+  auto *in = reinterpret_cast<struct sockaddr_in *>(addr);
+  std::memset(addr, 0, addrlen);
+  std::memcpy(in, res->ai_addr, sizeof(struct sockaddr_in));
+  in->sin_port = htons(port);
+  ::freeaddrinfo(res);
+  return sizeof(struct sockaddr_in);
+}
+
+inline socklen_t set_sockaddr_any(struct sockaddr *addr, socklen_t addrlen, uint16_t port) {
+  auto *in = reinterpret_cast<struct sockaddr_in *>(addr);
+  std::memset(addr, 0, addrlen);
+  in->sin_family = AF_INET;
+  in->sin_addr.s_addr = htonl(INADDR_ANY);
+  in->sin_port = htons(port);
+  return sizeof(struct sockaddr_in);
+}
+
+}  // namespace socket
+}  // namespace esphome
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "esphome/core/entity_base.h"
+
+namespace esphome {
+namespace switch_ {
+
+class Switch : public EntityBase {
+ public:
+  virtual ~Switch() = default;
+  void publish_state(bool value) {
+    this->state = value;
+    host::publish("switch", this, value ? "true" : "false");
+  }
+  void turn_on() { this->write_state(true); }
+  void turn_off() { this->write_state(false); }
+
+  bool state{false};
+
+ protected:
+  virtual void write_state(bool state) = 0;
+};
+
+}  // namespace switch_
+}  // namespace esphome
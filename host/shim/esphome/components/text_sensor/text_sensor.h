@@ -0,0 +1,21 @@
+#pragma once
+
+#include "esphome/core/entity_base.h"
+
+#include <string>
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor : public EntityBase {
+ public:
+  void publish_state(const std::string &value) {
+    this->state = value;
+    host::publish("text_sensor", this, host::json_string(value));
+  }
+
+  std::string state;
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <cstdint>
+
+namespace esphome {
+
+namespace setup_priority {
+static constexpr float HARDWARE = 800.0f;
+static constexpr float BUS = 1000.0f;
+static constexpr float DATA = 600.0f;
+static constexpr float PROCESSOR = 400.0f;
+static constexpr float AFTER_WIFI = 200.0f;
+static constexpr float LATE = -100.0f;
+}  // namespace setup_priority
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+  void mark_failed() { failed_ = true; }
+  bool is_failed() const { return failed_; }
+
+ protected:
+  bool failed_{false};
+};
+
+class PollingComponent : public Component {
+ public:
+  virtual void update() = 0;
+  void set_update_interval(uint32_t interval) { update_interval_ = interval; }
+  uint32_t get_update_interval() const { return update_interval_; }
+
+ protected:
+  uint32_t update_interval_{10000};
+};
+
+}  // namespace esphome
@@ -0,0 +1,6 @@
+#pragma once
+
+// Host builds have no ESP32, API or other ESPHome features enabled
+
+// ...except the network transport and Modbus TCP server, which run on POSIX sockets
+#define USE_WATERFURNACE_TCP
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace esphome {
+
+class EntityBase {
+ public:
+  const std::string &get_name() const { return name_; }
+  void set_name(const std::string &name) { name_ = name; }
+  uint32_t get_object_id_hash() const { return 0; }
+
+ protected:
+  std::string name_;
+};
+
+namespace host {
+
+// Where entities send their state; `state` is already JSON. Unset drops it.
+inline void (*publish_hook)(const char *platform, const EntityBase *entity, const std::string &state) = nullptr;
+
+inline void publish(const char *platform, const EntityBase *entity, const std::string &state) {
+  if (publish_hook != nullptr)
+    publish_hook(platform, entity, state);
+}
+
+inline std::string json_number(float value) {
+  if (std::isnan(value))
+    return "null";
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%g", value);
+  return buf;
+}
+
+inline std::string json_string(const std::string &value) {
+  std::string out = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<uint8_t>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out += buf;
+    } else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace esphome {
+
+class GPIOPin {
+ public:
+  virtual ~GPIOPin() = default;
+  virtual void setup() {}
+  virtual void digital_write(bool value) = 0;
+  virtual bool digital_read() = 0;
+};
+
+}  // namespace esphome
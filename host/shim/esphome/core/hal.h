@@ -0,0 +1,30 @@
+#pragma once
+
+// Time on the host comes from CLOCK_MONOTONIC, so wall-clock steps (NTP,
+// suspend) never disturb timeouts. Both counters wrap like the ESP's.
+
+#include <cstdint>
+#include <ctime>
+
+namespace esphome {
+
+inline uint32_t millis() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint32_t>(static_cast<uint64_t>(ts.tv_sec) * 1000u + ts.tv_nsec / 1000000);
+}
+
+inline uint32_t micros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint32_t>(static_cast<uint64_t>(ts.tv_sec) * 1000000u + ts.tv_nsec / 1000);
+}
+
+inline void delay(uint32_t ms) {
+  struct timespec ts;
+  ts.tv_sec = ms / 1000;
+  ts.tv_nsec = (ms % 1000) * 1000000L;
+  nanosleep(&ts, nullptr);
+}
+
+}  // namespace esphome
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace esphome {
+
+// "01.41.00.00 (4)", as ESPHome formats bytes for logs
+inline std::string format_hex_pretty(const uint8_t *data, size_t len) {
+  if (len == 0)
+    return "";
+  std::string out;
+  char buf[4];
+  for (size_t i = 0; i < len; i++) {
+    snprintf(buf, sizeof(buf), i == 0 ? "%02X" : ".%02X", data[i]);
+    out += buf;
+  }
+  return out + " (" + std::to_string(len) + ")";
+}
+
+inline std::string format_hex_pretty(const std::vector<uint8_t> &data) {
+  return format_hex_pretty(data.data(), data.size());
+}
+
+}  // namespace esphome
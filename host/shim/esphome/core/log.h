@@ -0,0 +1,43 @@
+#pragma once
+
+// ESPHome's logging macros, written to stderr so stdout stays free for entity states
+
+#include <cstdarg>
+#include <cstdio>
+
+#define ESPHOME_LOG_LEVEL_NONE 0
+#define ESPHOME_LOG_LEVEL_ERROR 1
+#define ESPHOME_LOG_LEVEL_WARN 2
+#define ESPHOME_LOG_LEVEL_INFO 3
+#define ESPHOME_LOG_LEVEL_CONFIG 4
+#define ESPHOME_LOG_LEVEL_DEBUG 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 6
+
+namespace esphome {
+
+// Messages above this level are dropped
+inline int log_level = ESPHOME_LOG_LEVEL_INFO;
+
+inline void host_log(int level, const char *tag, const char *fmt, ...) {
+  static const char LETTERS[] = "?EWICDV";
+  if (level > log_level)
+    return;
+  va_list args;
+  va_start(args, fmt);
+  fprintf(stderr, "[%c][%s]: ", LETTERS[level], tag);
+  vfprintf(stderr, fmt, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+}  // namespace esphome
+
+#define ESP_LOGE(tag, fmt, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_ERROR, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_WARN, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_INFO, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGCONFIG(tag, fmt, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_CONFIG, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_DEBUG, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_VERBOSE, tag, fmt, ##__VA_ARGS__)
+#define YESNO(x) ((x) ? "YES" : "NO")
+// There are no GPIO pins on the host
+#define LOG_PIN(prefix, pin)
@@ -0,0 +1,237 @@
+// Poll cycle benchmark: the real hub and entity classes, configured like an
+// example YAML, polling the simulated ABC in virtual time.
+//
+// Every `platform: waterfurnace` entity of the config (bench_entities.h) is
+// created and set up as ESPHome would, the hub detects the simulated heat
+// pump, and then `--hours` of poll cycles run at the config's update
+// interval. Per cycle it records the transactions and bytes on the bus, the
+// time from update() until the last response byte, and the time from
+// update() until the last listener ran. The summary is written as JSON so
+// runs on two commits can be compared with compare.py.
+
+#include "../sim/abc_simulator.h"
+#include "config_entities.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+using namespace esphome::waterfurnace::sim;
+
+// Exposes the listener table so every callback can be timed
+class BenchHub : public WaterFurnace {
+ public:
+  using WaterFurnace::listeners_;
+};
+
+struct CycleSample {
+  uint32_t transactions;
+  uint64_t bytes;
+  uint64_t bus_us;
+  uint64_t duration_us;  // update() to the last response byte
+  uint64_t dispatch_us;  // update() to the last listener call
+};
+
+struct Summary {
+  double min, mean, p50, p95, max;
+};
+
+static Summary summarize(std::vector<double> values) {
+  Summary s{0, 0, 0, 0, 0};
+  if (values.empty())
+    return s;
+  std::sort(values.begin(), values.end());
+  double total = 0;
+  for (double v : values)
+    total += v;
+  auto percentile = [&values](double p) { return values[static_cast<size_t>(p * (values.size() - 1) + 0.5)]; };
+  s.min = values.front();
+  s.max = values.back();
+  s.mean = total / values.size();
+  s.p50 = percentile(0.50);
+  s.p95 = percentile(0.95);
+  return s;
+}
+
+static void print_summary(FILE *out, const char *name, const Summary &s, bool last = false) {
+  fprintf(out, "    \"%s\": {\"min\": %.3f, \"mean\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"max\": %.3f}%s\n", name,
+          s.min, s.mean, s.p50, s.p95, s.max, last ? "" : ",");
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "\n"
+          "  --hours H                Simulated hours of polling (default 1)\n"
+          "  --processing-delay-us N  ABC turnaround per request (default 10000)\n"
+          "  --loop-us N              Time between loop() calls (default 16000, ESPHome's loop interval)\n"
+          "  --fixture PATH           Register values (default ../fixtures/sample_registers.yml)\n"
+          "  --output PATH            Write the JSON summary here instead of stdout\n"
+          "  --capture PATH           Write the last 256 KiB of bus traffic here, for replay_capture\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  double hours = 1;
+  uint32_t processing_delay_us = 10000, loop_us = 16000;
+  std::string fixture = "../fixtures/sample_registers.yml", output, capture;
+
+  static const struct option OPTIONS[] = {
+      {"hours", required_argument, nullptr, 'H'},     {"processing-delay-us", required_argument, nullptr, 'p'},
+      {"loop-us", required_argument, nullptr, 'l'},   {"fixture", required_argument, nullptr, 'f'},
+      {"output", required_argument, nullptr, 'o'},    {"capture", required_argument, nullptr, 'c'},
+      {"help", no_argument, nullptr, 'h'},            {nullptr, 0, nullptr, 0},
+  };
+  int opt;
+  while ((opt = getopt_long(argc, argv, "h", OPTIONS, nullptr)) != -1) {
+    switch (opt) {
+      case 'H':
+        hours = atof(optarg);
+        break;
+      case 'p':
+        processing_delay_us = atoi(optarg);
+        break;
+      case 'l':
+        loop_us = atoi(optarg);
+        break;
+      case 'f':
+        fixture = optarg;
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'c':
+        capture = optarg;
+        break;
+      default:
+        usage(argv[0]);
+        return opt == 'h' ? 0 : 2;
+    }
+  }
+  if (hours <= 0 || loop_us == 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  SimClock::reset();
+  AbcSimulator abc;
+  if (!abc.load_fixture(fixture)) {
+    fprintf(stderr, "Cannot read %s\n", fixture.c_str());
+    return 1;
+  }
+  abc.timing.processing_delay_us = processing_delay_us;
+
+  BenchHub hub;
+  hub.set_mock_backend(&abc);
+  hub.set_update_interval(bench::UPDATE_INTERVAL);
+  if (!capture.empty())
+    hub.set_capture_buffer_size(262144);
+
+  bench::ConfigEntities entities;
+  entities.create(&hub);
+  std::vector<Component *> components = entities.components(&hub);
+  for (auto *component : components)
+    component->setup();
+  auto loop_once = [&]() {
+    for (auto *component : components)
+      component->loop();
+    SimClock::advance_us(loop_us);
+  };
+  for (uint64_t limit = SimClock::now_us() + 60000000; !hub.is_setup_complete() && SimClock::now_us() < limit;)
+    loop_once();
+  if (!hub.is_setup_complete()) {
+    fprintf(stderr, "Component detection did not finish\n");
+    return 1;
+  }
+  uint64_t setup_us = SimClock::now_us();
+
+  // Timestamp every listener call; nothing registers listeners after setup
+  uint64_t last_dispatch_us = 0;
+  for (auto &listener : hub.listeners_) {
+    auto inner = std::move(listener.callback);
+    listener.callback = [inner, &last_dispatch_us](uint16_t value) {
+      last_dispatch_us = SimClock::now_us();
+      inner(value);
+    };
+  }
+
+  const uint64_t interval_us = static_cast<uint64_t>(bench::UPDATE_INTERVAL) * 1000;
+  const size_t num_cycles = std::max<size_t>(1, static_cast<size_t>(hours * 3600000000.0 / interval_us));
+  std::vector<CycleSample> samples;
+  samples.reserve(num_cycles);
+  for (size_t cycle = 0; cycle < num_cycles; cycle++) {
+    uint64_t start = SimClock::now_us();
+    SimStats before = abc.stats;
+    last_dispatch_us = 0;
+    uint64_t last_byte_us = start;
+    hub.update();
+    while (SimClock::now_us() < start + interval_us) {
+      if (!abc.idle())
+        last_byte_us = abc.line_free_at_us();
+      loop_once();
+    }
+    samples.push_back({abc.stats.requests - before.requests, abc.stats.rx_bytes + abc.stats.tx_bytes - before.rx_bytes - before.tx_bytes,
+                       abc.stats.busy_us - before.busy_us, last_byte_us - start,
+                       last_dispatch_us != 0 ? last_dispatch_us - start : 0});
+  }
+
+  std::vector<double> transactions, bytes, duration_ms, dispatch_ms;
+  uint64_t busy_us = 0;
+  for (const auto &s : samples) {
+    transactions.push_back(s.transactions);
+    bytes.push_back(s.bytes);
+    duration_ms.push_back(s.duration_us / 1000.0);
+    dispatch_ms.push_back(s.dispatch_us / 1000.0);
+    busy_us += s.bus_us;
+  }
+
+  FILE *out = stdout;
+  if (!output.empty() && (out = fopen(output.c_str(), "w")) == nullptr) {
+    perror(output.c_str());
+    return 1;
+  }
+  fprintf(out, "{\n");
+  fprintf(out, "  \"config\": {\n");
+  fprintf(out, "    \"yaml\": \"%s\",\n", bench::CONFIG_NAME);
+  fprintf(out, "    \"entities\": %zu,\n", entities.size());
+  fprintf(out, "    \"listeners\": %zu,\n", hub.listeners_.size());
+  fprintf(out, "    \"update_interval_ms\": %u,\n", bench::UPDATE_INTERVAL);
+  fprintf(out, "    \"loop_us\": %u,\n", loop_us);
+  fprintf(out, "    \"processing_delay_us\": %u,\n", processing_delay_us);
+  fprintf(out, "    \"baud\": %u,\n", abc.timing.baud);
+  fprintf(out, "    \"simulated_hours\": %.3f\n", samples.size() * interval_us / 3600000000.0);
+  fprintf(out, "  },\n");
+  fprintf(out, "  \"cycles\": %zu,\n", samples.size());
+  fprintf(out, "  \"setup_ms\": %.3f,\n", setup_us / 1000.0);
+  fprintf(out, "  \"bus_utilization\": %.5f,\n", static_cast<double>(busy_us) / (samples.size() * interval_us));
+  fprintf(out, "  \"timeouts\": %u,\n", hub.bus_stats().timeouts);
+  fprintf(out, "  \"crc_errors\": %u,\n", hub.bus_stats().crc_errors);
+  fprintf(out, "  \"exceptions\": %u,\n", abc.stats.exceptions);
+  fprintf(out, "  \"deadline_misses\": %u,\n", hub.deadline_misses());
+  fprintf(out, "  \"per_cycle\": {\n");
+  print_summary(out, "transactions", summarize(transactions));
+  print_summary(out, "bytes", summarize(bytes));
+  print_summary(out, "duration_ms", summarize(duration_ms));
+  print_summary(out, "update_to_last_dispatch_ms", summarize(dispatch_ms), true);
+  fprintf(out, "  }\n");
+  fprintf(out, "}\n");
+  if (out != stdout)
+    fclose(out);
+
+  if (!capture.empty()) {
+    std::vector<uint8_t> file(hub.capture().file_size());
+    hub.capture().read(0, file.data(), file.size());
+    FILE *f = fopen(capture.c_str(), "wb");
+    if (f == nullptr || fwrite(file.data(), 1, file.size(), f) != file.size()) {
+      perror(capture.c_str());
+      return 1;
+    }
+    fclose(f);
+  }
+  return 0;
+}
@@ -0,0 +1,51 @@
+"""Rebuild a bus capture from the log lines of the dump_capture service.
+
+    python3 capture_from_log.py device.log capture.bin
+
+Reads "capture N/M <base64>" lines (from `esphome logs`, or the data of the
+esphome.waterfurnace_capture events one per line in the same form) and
+writes the last complete dump as a binary file for replay_capture.
+"""
+
+import argparse
+import base64
+import re
+import sys
+
+LINE = re.compile(r"capture (\d+)/(\d+) ([A-Za-z0-9+/=]+)")
+
+
+def last_dump(lines):
+    dump, complete = {}, None
+    for line in lines:
+        match = LINE.search(line)
+        if not match:
+            continue
+        seq, total, data = int(match.group(1)), int(match.group(2)), match.group(3)
+        if seq == 1:
+            dump = {}
+        dump[seq] = base64.b64decode(data)
+        if seq == total and len(dump) == total:
+            complete = b"".join(dump[i] for i in range(1, total + 1))
+    return complete
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log")
+    parser.add_argument("output")
+    args = parser.parse_args()
+
+    with open(args.log, errors="replace") as f:
+        capture = last_dump(f)
+    if capture is None:
+        sys.exit(f"No complete capture dump in {args.log}")
+    if not capture.startswith(b"WFC1"):
+        sys.exit(f"The dump in {args.log} is not a bus capture")
+    with open(args.output, "wb") as f:
+        f.write(capture)
+    print(f"{args.output}: {len(capture)} bytes")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,61 @@
+"""Compare two bench_poll_cycle results, e.g. from the base and head of a branch.
+
+    python3 compare.py base.json head.json [--threshold PERCENT]
+
+Prints every metric side by side and exits 1 if any got worse by more than
+the threshold (all of them are lower-is-better).
+"""
+
+import argparse
+import json
+import sys
+
+TOTALS = ("bus_utilization", "setup_ms", "timeouts", "crc_errors", "exceptions", "deadline_misses")
+PER_CYCLE = ("transactions", "bytes", "duration_ms", "update_to_last_dispatch_ms")
+STATS = ("mean", "p95", "max")
+
+
+def metrics(results):
+    out = {name: results[name] for name in TOTALS}
+    for name in PER_CYCLE:
+        for stat in STATS:
+            out[f"{name}.{stat}"] = results["per_cycle"][name][stat]
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("base")
+    parser.add_argument("head")
+    parser.add_argument("--threshold", type=float, default=5.0, help="allowed regression in percent (default 5)")
+    args = parser.parse_args()
+
+    with open(args.base) as f:
+        base = json.load(f)
+    with open(args.head) as f:
+        head = json.load(f)
+    if base["config"] != head["config"]:
+        print("warning: the runs used different configurations", file=sys.stderr)
+
+    regressions = []
+    print(f"{'metric':<36} {'base':>12} {'head':>12} {'change':>9}")
+    for name, old in metrics(base).items():
+        new = metrics(head)[name]
+        if old:
+            change = f"{(new - old) / old * 100:+.1f}%"
+            worse = (new - old) / old * 100 > args.threshold
+        else:
+            change = "" if new == old else "new"
+            worse = new > 0
+        print(f"{name:<36} {old:>12.3f} {new:>12.3f} {change:>9}{'  <- worse' if worse else ''}")
+        if worse:
+            regressions.append(name)
+
+    if regressions:
+        print(f"\n{len(regressions)} metric(s) regressed by more than {args.threshold}%", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
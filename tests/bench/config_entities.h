@@ -0,0 +1,97 @@
+#pragma once
+
+// The entities of the benchmark config (bench_entities.h), created and
+// attached to a hub as ESPHome's generated code would.
+
+#include "../../components/waterfurnace/waterfurnace.h"
+#include "../../components/waterfurnace/binary_sensor/waterfurnace_binary_sensor.h"
+#include "../../components/waterfurnace/climate/waterfurnace_climate.h"
+#include "../../components/waterfurnace/sensor/waterfurnace_sensor.h"
+#include "../../components/waterfurnace/switch/waterfurnace_switch.h"
+#include "../../components/waterfurnace/text_sensor/waterfurnace_text_sensor.h"
+#include "bench_entities.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+namespace bench {
+
+struct ConfigEntities {
+  std::vector<std::unique_ptr<WaterFurnaceSensor>> sensors;
+  std::vector<std::unique_ptr<WaterFurnaceBinarySensor>> binary_sensors;
+  std::vector<std::unique_ptr<WaterFurnaceTextSensor>> text_sensors;
+  std::vector<std::unique_ptr<WaterFurnaceSwitch>> switches;
+  std::vector<std::unique_ptr<WaterFurnaceClimate>> climates;
+
+  void create(WaterFurnace *hub) {
+    for (const auto *def = SENSORS; def->name != nullptr; def++) {
+      auto sensor = std::make_unique<WaterFurnaceSensor>();
+      sensor->set_name(def->name);
+      sensor->set_parent(hub);
+      sensor->set_register_address(def->address);
+      sensor->set_register_type(def->type);
+      sensor->set_capability(def->capability);
+      this->sensors.push_back(std::move(sensor));
+    }
+    for (const auto *def = BINARY_SENSORS; def->name != nullptr; def++) {
+      auto sensor = std::make_unique<WaterFurnaceBinarySensor>();
+      sensor->set_name(def->name);
+      sensor->set_parent(hub);
+      sensor->set_register_address(def->address);
+      sensor->set_bitmask(def->bitmask);
+      sensor->set_capability(def->capability);
+      this->binary_sensors.push_back(std::move(sensor));
+    }
+    for (const auto *def = TEXT_SENSORS; def->name != nullptr; def++) {
+      auto sensor = std::make_unique<WaterFurnaceTextSensor>();
+      sensor->set_name(def->name);
+      sensor->set_parent(hub);
+      sensor->set_sensor_type(def->type);
+      this->text_sensors.push_back(std::move(sensor));
+    }
+    for (const auto *def = SWITCHES; def->name != nullptr; def++) {
+      auto sw = std::make_unique<WaterFurnaceSwitch>();
+      sw->set_name(def->name);
+      sw->set_parent(hub);
+      sw->set_register_address(def->address);
+      sw->set_write_address(def->write_address);
+      sw->set_capability(def->capability);
+      this->switches.push_back(std::move(sw));
+    }
+    for (const uint8_t *zone = CLIMATE_ZONES; *zone != 0; zone++) {
+      auto climate = std::make_unique<WaterFurnaceClimate>();
+      climate->set_name("zone " + std::to_string(*zone));
+      climate->set_parent(hub);
+      climate->set_zone(*zone);
+      this->climates.push_back(std::move(climate));
+    }
+  }
+
+  size_t size() const {
+    return this->sensors.size() + this->binary_sensors.size() + this->text_sensors.size() + this->switches.size() +
+           this->climates.size();
+  }
+
+  /// `hub` and then every entity: ESPHome's setup order (the hub has DATA priority)
+  std::vector<Component *> components(WaterFurnace *hub) const {
+    std::vector<Component *> out = {hub};
+    for (const auto &e : this->sensors)
+      out.push_back(e.get());
+    for (const auto &e : this->binary_sensors)
+      out.push_back(e.get());
+    for (const auto &e : this->text_sensors)
+      out.push_back(e.get());
+    for (const auto &e : this->switches)
+      out.push_back(e.get());
+    for (const auto &e : this->climates)
+      out.push_back(e.get());
+    return out;
+  }
+};
+
+}  // namespace bench
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,154 @@
+"""Emit bench_entities.h: every `platform: waterfurnace` entity of an example config.
+
+The entity keys are read out of the YAML with a plain line scanner (the file
+uses ESPHome tags a YAML loader would need to be taught) and looked up in the
+platform tables, so the benchmark polls what that firmware would poll.
+"""
+
+import os
+import re
+import sys
+
+HERE = os.path.dirname(__file__)
+sys.path.insert(0, os.path.join(HERE, "..", "..", "host"))
+
+from gen_entities import load_tables  # noqa: E402
+
+DOMAINS = ("sensor", "binary_sensor", "text_sensor", "switch", "climate")
+# Keys of a platform entry that configure it rather than declare an entity
+ENTRY_OPTIONS = {"platform", "waterfurnace_id"}
+# As in switch/__init__.py: (register address, write address, capability)
+SWITCHES = {"dhw_enable": (400, 400, "axb")}
+
+
+def parse_duration_ms(text):
+    match = re.fullmatch(r"(\d+)\s*(ms|s|min|h)?", text.strip().strip("\"'"))
+    if not match:
+        raise ValueError(f"Unsupported duration: {text}")
+    scale = {"ms": 1, "s": 1000, "min": 60000, "h": 3600000, None: 1000}[match.group(2)]
+    return int(match.group(1)) * scale
+
+
+def scan(path):
+    """Return ({domain: [entity keys or climate zones]}, hub update interval in ms)."""
+    entities = {domain: [] for domain in DOMAINS}
+    update_interval = 60000  # PollingComponent default
+    domain = None
+    in_entry = False
+    with open(path) as f:
+        for raw in f:
+            line = raw.split("#", 1)[0].rstrip()
+            if not line:
+                continue
+            top = re.match(r"^(\w+):", line)
+            if top:
+                domain = top.group(1)
+                in_entry = False
+                continue
+            if domain == "waterfurnace":
+                interval = re.match(r"^  update_interval:\s*(.+)$", line)
+                if interval:
+                    update_interval = parse_duration_ms(interval.group(1))
+                continue
+            if domain not in DOMAINS:
+                continue
+            entry = re.match(r"^  - platform:\s*(\S+)", line)
+            if entry:
+                in_entry = entry.group(1) == "waterfurnace"
+                if in_entry and domain == "climate":
+                    entities["climate"].append(1)
+                continue
+            if not in_entry:
+                continue
+            if domain == "climate":
+                zone = re.match(r"^    zone:\s*(\d+)", line)
+                if zone:
+                    entities["climate"][-1] = int(zone.group(1))
+                continue
+            key = re.match(r"^    (\w+):", line)
+            if key and key.group(1) not in ENTRY_OPTIONS:
+                entities[domain].append(key.group(1))
+    return entities, update_interval
+
+
+def main():
+    config = sys.argv[1] if len(sys.argv) > 1 else os.path.join(HERE, "..", "..", "waterfurnace-esp32-s3.yaml")
+    entities, update_interval = scan(config)
+    (sensors,) = load_tables("sensor", "SENSOR_TYPES")
+    (binary_sensors,) = load_tables("binary_sensor", "BINARY_SENSOR_TYPES")
+    (text_sensors,) = load_tables("text_sensor", "TEXT_SENSOR_TYPES")
+    tables = {"sensor": sensors, "binary_sensor": binary_sensors, "text_sensor": text_sensors, "switch": SWITCHES}
+    for domain, table in tables.items():
+        unknown = [key for key in entities[domain] if key not in table]
+        if unknown:
+            sys.exit(f"{config}: unknown {domain} entities: {', '.join(unknown)}")
+
+    print("#pragma once")
+    print()
+    print(f"// Generated by gen_bench_entities.py from {os.path.basename(config)}; do not edit")
+    print()
+    print('#include "components/waterfurnace/registers.h"')
+    print()
+    print("namespace esphome {")
+    print("namespace waterfurnace {")
+    print("namespace bench {")
+    print()
+    print(f'static const char *const CONFIG_NAME = "{os.path.basename(config)}";')
+    print(f"static const uint32_t UPDATE_INTERVAL = {update_interval};")
+    print()
+    print("struct SensorDef {")
+    print("  const char *name;")
+    print("  uint16_t address;")
+    print("  RegisterType type;")
+    print("  RegisterCapability capability;")
+    print("};")
+    print("struct BinarySensorDef {")
+    print("  const char *name;")
+    print("  uint16_t address;")
+    print("  uint16_t bitmask;")
+    print("  RegisterCapability capability;")
+    print("};")
+    print("struct TextSensorDef {")
+    print("  const char *name;")
+    print("  const char *type;")
+    print("};")
+    print("struct SwitchDef {")
+    print("  const char *name;")
+    print("  uint16_t address;")
+    print("  uint16_t write_address;")
+    print("  RegisterCapability capability;")
+    print("};")
+    print()
+    # Empty tables still need an element; the counts say how many are real
+    print("static const SensorDef SENSORS[] = {")
+    for name in entities["sensor"]:
+        addr, reg_type, cap = sensors[name]
+        print(f'    {{"{name}", {addr}, RegisterType::{reg_type.upper()}, RegisterCapability::{cap.upper()}}},')
+    print('    {nullptr, 0, RegisterType::UNSIGNED, RegisterCapability::NONE},')
+    print("};")
+    print("static const BinarySensorDef BINARY_SENSORS[] = {")
+    for name in entities["binary_sensor"]:
+        addr, mask, cap = binary_sensors[name]
+        print(f'    {{"{name}", {addr}, 0x{mask:04X}, RegisterCapability::{cap.upper()}}},')
+    print('    {nullptr, 0, 0, RegisterCapability::NONE},')
+    print("};")
+    print("static const TextSensorDef TEXT_SENSORS[] = {")
+    for name in entities["text_sensor"]:
+        print(f'    {{"{name}", "{text_sensors[name]}"}},')
+    print("    {nullptr, nullptr},")
+    print("};")
+    print("static const SwitchDef SWITCHES[] = {")
+    for name in entities["switch"]:
+        addr, write_addr, cap = SWITCHES[name]
+        print(f'    {{"{name}", {addr}, {write_addr}, RegisterCapability::{cap.upper()}}},')
+    print("    {nullptr, 0, 0, RegisterCapability::NONE},")
+    print("};")
+    print(f"static const uint8_t CLIMATE_ZONES[] = {{{', '.join(str(z) for z in entities['climate'] + [0])}}};")
+    print()
+    print("}  // namespace bench")
+    print("}  // namespace waterfurnace")
+    print("}  // namespace esphome")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,188 @@
+// Replays a bus capture (from the hub's `capture:` ring, see
+// capture_from_log.py) through the real hub and entity classes, configured
+// like the benchmark's example YAML.
+//
+// The capture is fed through read_frame_(), process_response_() and the
+// listeners in virtual time (tests/sim/capture_replay.h). The report gives
+// what the capture held, the bus errors the hub saw, the host time spent
+// parsing and dispatching, and the state of every entity at the end, as
+// JSON.
+
+#include "../sim/capture_replay.h"
+#include "config_entities.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+using namespace esphome::waterfurnace::sim;
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options] CAPTURE\n"
+          "\n"
+          "  --loop-us N     Time between loop() calls (default 16000, ESPHome's loop interval)\n"
+          "  --repeat N      Replay N times, each into a fresh hub, for steadier timings (default 1)\n"
+          "  --output PATH   Write the JSON report here instead of stdout\n",
+          argv0);
+}
+
+static std::string json_string(const std::string &s) {
+  std::string out = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20)
+      out += c;
+  }
+  return out + "\"";
+}
+
+static std::string json_number(float value) {
+  if (std::isnan(value))
+    return "null";
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%g", value);
+  return buf;
+}
+
+// One "name": value line per entity, commas between
+template<typename T, typename F>
+static void print_states(FILE *out, const char *kind, const std::vector<std::unique_ptr<T>> &entities, F value,
+                         bool last = false) {
+  fprintf(out, "    \"%s\": {", kind);
+  for (size_t i = 0; i < entities.size(); i++)
+    fprintf(out, "%s\n      %s: %s", i > 0 ? "," : "", json_string(entities[i]->get_name()).c_str(),
+            value(*entities[i]).c_str());
+  fprintf(out, "%s}%s\n", entities.empty() ? "" : "\n    ", last ? "" : ",");
+}
+
+int main(int argc, char **argv) {
+  uint32_t loop_us = 16000;
+  int repeat = 1;
+  std::string output;
+
+  static const struct option OPTIONS[] = {
+      {"loop-us", required_argument, nullptr, 'l'}, {"repeat", required_argument, nullptr, 'r'},
+      {"output", required_argument, nullptr, 'o'},  {"help", no_argument, nullptr, 'h'},
+      {nullptr, 0, nullptr, 0},
+  };
+  int opt;
+  while ((opt = getopt_long(argc, argv, "h", OPTIONS, nullptr)) != -1) {
+    switch (opt) {
+      case 'l':
+        loop_us = atoi(optarg);
+        break;
+      case 'r':
+        repeat = atoi(optarg);
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      default:
+        usage(argv[0]);
+        return opt == 'h' ? 0 : 2;
+    }
+  }
+  if (optind != argc - 1 || loop_us == 0 || repeat < 1) {
+    usage(argv[0]);
+    return 2;
+  }
+  const char *path = argv[optind];
+
+  CaptureReplay replay;
+  if (!replay.load_file(path)) {
+    fprintf(stderr, "%s is not a bus capture\n", path);
+    return 1;
+  }
+
+  ReplayStats total;
+  std::unique_ptr<ReplayHub> hub;
+  bench::ConfigEntities entities;
+  for (int run = 0; run < repeat; run++) {
+    SimClock::reset();
+    hub = std::make_unique<ReplayHub>();
+    hub->set_address(replay.slave());
+    hub->set_transport(&replay);
+    hub->set_update_interval(bench::UPDATE_INTERVAL);
+    entities = bench::ConfigEntities();
+    entities.create(hub.get());
+    std::vector<Component *> components = entities.components(hub.get());
+    for (auto *component : components)
+      component->setup();
+
+    ReplayStats stats = replay.run(
+        *hub,
+        [&components]() {
+          for (auto *component : components)
+            component->loop();
+        },
+        loop_us);
+    total.tx_frames += stats.tx_frames;
+    total.rx_chunks += stats.rx_chunks;
+    total.rx_bytes += stats.rx_bytes;
+    total.own_requests += stats.own_requests;
+    total.duration_us += stats.duration_us;
+    total.loop_ns += stats.loop_ns;
+    total.dispatch_calls += stats.dispatch_calls;
+    total.dispatch_ns += stats.dispatch_ns;
+    total.dispatch_max_ns = std::max(total.dispatch_max_ns, stats.dispatch_max_ns);
+  }
+
+  FILE *out = stdout;
+  if (!output.empty() && (out = fopen(output.c_str(), "w")) == nullptr) {
+    perror(output.c_str());
+    return 1;
+  }
+  const BusStats &bus = hub->bus_stats();
+  double parse_s = total.loop_ns / 1e9;
+  fprintf(out, "{\n");
+  fprintf(out, "  \"capture\": %s,\n", json_string(path).c_str());
+  fprintf(out, "  \"config\": \"%s\",\n", bench::CONFIG_NAME);
+  fprintf(out, "  \"runs\": %d,\n", repeat);
+  fprintf(out, "  \"slave\": %u,\n", replay.slave());
+  fprintf(out, "  \"duration_s\": %.3f,\n", total.duration_us / 1e6 / repeat);
+  fprintf(out, "  \"tx_frames\": %u,\n", total.tx_frames / repeat);
+  fprintf(out, "  \"rx_frames\": %u,\n", total.rx_chunks / repeat);
+  fprintf(out, "  \"rx_bytes\": %llu,\n", static_cast<unsigned long long>(total.rx_bytes / repeat));
+  fprintf(out, "  \"own_requests\": %u,\n", total.own_requests / repeat);
+  fprintf(out, "  \"setup_complete\": %s,\n", hub->is_setup_complete() ? "true" : "false");
+  fprintf(out, "  \"model\": %s,\n", json_string(hub->model_number()).c_str());
+  fprintf(out, "  \"crc_errors\": %u,\n", bus.crc_errors);
+  fprintf(out, "  \"timeouts\": %u,\n", bus.timeouts);
+  fprintf(out, "  \"value_count_mismatches\": %u,\n", bus.value_count_mismatches);
+  fprintf(out, "  \"exceptions\": %u,\n", bus.exceptions);
+  fprintf(out, "  \"parse\": {\"host_ms\": %.3f, \"bytes_per_s\": %.0f, \"frames_per_s\": %.0f},\n",
+          total.loop_ns / 1e6, parse_s > 0 ? total.rx_bytes / parse_s : 0.0,
+          parse_s > 0 ? total.rx_chunks / parse_s : 0.0);
+  fprintf(out, "  \"dispatch\": {\"calls\": %llu, \"host_ms\": %.3f, \"mean_us\": %.3f, \"max_us\": %.3f},\n",
+          static_cast<unsigned long long>(total.dispatch_calls), total.dispatch_ns / 1e6,
+          total.dispatch_calls > 0 ? total.dispatch_ns / 1e3 / total.dispatch_calls : 0.0,
+          total.dispatch_max_ns / 1e3);
+  fprintf(out, "  \"entities\": {\n");
+  print_states(out, "sensor", entities.sensors, [](const WaterFurnaceSensor &e) { return json_number(e.state); });
+  print_states(out, "binary_sensor", entities.binary_sensors, [](const WaterFurnaceBinarySensor &e) {
+    return std::string(e.has_state_ ? (e.state ? "true" : "false") : "null");
+  });
+  print_states(out, "text_sensor", entities.text_sensors,
+               [](const WaterFurnaceTextSensor &e) { return json_string(e.state); });
+  print_states(out, "switch", entities.switches,
+               [](const WaterFurnaceSwitch &e) { return std::string(e.state ? "true" : "false"); });
+  print_states(
+      out, "climate", entities.climates,
+      [](const WaterFurnaceClimate &e) {
+        return "{\"mode\": " + std::to_string(e.mode) + ", \"current_temperature\": " +
+               json_number(e.current_temperature) + ", \"target_temperature\": " + json_number(e.target_temperature) +
+               "}";
+      },
+      true);
+  fprintf(out, "  }\n");
+  fprintf(out, "}\n");
+  if (out != stdout)
+    fclose(out);
+  return 0;
+}
@@ -40,6 +40,9 @@ run_test() {
 # Unit tests (gtest)
 run_test "Unit tests" make -C "${ROOT}/tests/unit" test
 
+# Host daemon build
+run_test "Host daemon build" make -C "${ROOT}/host"
+
 # Integration tests
 run_test "Integration tests" bash -c '
   cd tests
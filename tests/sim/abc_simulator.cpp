@@ -0,0 +1,209 @@
+#include "abc_simulator.h"
+
+#include <cstdlib>
+#include <fstream>
+
+namespace esphome {
+namespace waterfurnace {
+namespace sim {
+
+bool AbcSimulator::load_fixture(const std::string &path) {
+  std::ifstream in(path);
+  if (!in)
+    return false;
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t hash = line.find('#');
+    if (hash != std::string::npos)
+      line.resize(hash);
+    size_t colon = line.find(':');
+    if (colon == std::string::npos)
+      continue;
+    char *end;
+    long addr = strtol(line.c_str(), &end, 10);
+    if (end == line.c_str() || addr < 0 || addr > 0xFFFF)
+      continue;
+    long value = strtol(line.c_str() + colon + 1, &end, 10);
+    // Signed values are stored as their 16-bit two's complement
+    this->registers[addr] = static_cast<uint16_t>(value);
+  }
+  return true;
+}
+
+uint16_t AbcSimulator::read(uint16_t addr) const {
+  auto it = this->registers.find(addr);
+  return it != this->registers.end() ? it->second : 0;
+}
+
+void AbcSimulator::set_string(uint16_t start, const char *str, uint8_t num_regs) {
+  for (uint8_t i = 0; i < num_regs; i++) {
+    char hi = *str ? *str++ : ' ';
+    char lo = *str ? *str++ : ' ';
+    this->registers[start + i] = (static_cast<uint8_t>(hi) << 8) | static_cast<uint8_t>(lo);
+  }
+}
+
+bool AbcSimulator::readable_(uint16_t addr) const {
+  if (this->illegal_addresses.count(addr))
+    return false;
+  return !this->strict || this->registers.count(addr);
+}
+
+void AbcSimulator::on_write(const uint8_t *data, size_t len) {
+  uint64_t now = SimClock::now_us();
+  uint64_t request_end = now + this->timing.wire_time_us(len);
+  this->stats.rx_bytes += len;
+  this->stats.busy_us += request_end - now;
+  if (!this->tx_.empty() && this->tx_.back().ready_us > now) {
+    // Both ends drove the line at once: the ABC cannot make sense of the
+    // request, and whatever it was sending meanwhile arrives garbled
+    this->stats.collisions++;
+    for (auto &b : this->tx_) {
+      if (b.ready_us > now && b.ready_us <= request_end + this->timing.wire_time_us(1))
+        b.value = ~b.value;
+    }
+    return;
+  }
+  if (len < MIN_FRAME_SIZE || !validate_frame_crc(data, len) ||
+      (this->address != 0 && data[0] != this->address)) {
+    this->stats.ignored++;
+    return;
+  }
+  this->stats.requests++;
+  this->requests.push_back(std::vector<uint8_t>(data, data + len));
+
+  std::vector<uint8_t> resp = {data[0], data[1]};
+  size_t touched = 0;
+  uint8_t exception = this->exception_next;
+  this->exception_next = 0;
+  if (exception == 0)
+    exception = this->handle_(data, len, resp, touched);
+  if (exception == NO_RESPONSE) {
+    this->stats.unanswered++;
+    return;
+  }
+  if (exception != 0) {
+    resp.resize(2);
+    resp[1] |= ERROR_MASK;
+    resp.push_back(exception);
+    this->stats.exceptions++;
+  }
+  this->schedule_(resp, request_end + this->timing.processing_delay_us + touched * this->timing.per_register_us);
+}
+
+uint8_t AbcSimulator::handle_(const uint8_t *data, size_t len, std::vector<uint8_t> &resp, size_t &touched) {
+  const uint8_t *payload = data + 2;
+  size_t payload_len = len - 4;
+  auto word = [payload](size_t i) -> uint16_t { return (payload[i] << 8) | payload[i + 1]; };
+  auto push = [&resp](uint16_t v) {
+    resp.push_back(v >> 8);
+    resp.push_back(v & 0xFF);
+  };
+
+  switch (data[1]) {
+    case FUNC_READ_RANGES: {
+      if (payload_len == 0 || payload_len % 4 != 0)
+        return EXCEPTION_ILLEGAL_VALUE;
+      for (size_t i = 0; i < payload_len; i += 4) {
+        uint16_t start = word(i), count = word(i + 2);
+        if (count == 0 || start + count > 0x10000)
+          return EXCEPTION_ILLEGAL_VALUE;
+        touched += count;
+        for (uint32_t addr = start; addr < start + count; addr++) {
+          if (this->silent_addresses.count(addr))
+            return NO_RESPONSE;
+          if (!this->readable_(addr))
+            return EXCEPTION_ILLEGAL_ADDRESS;
+        }
+      }
+      if (touched > MAX_REGISTERS_PER_REQUEST)
+        return EXCEPTION_ILLEGAL_VALUE;
+      resp.push_back(touched * 2);
+      for (size_t i = 0; i < payload_len; i += 4) {
+        for (uint32_t addr = word(i); addr < word(i) + word(i + 2); addr++)
+          push(this->read(addr));
+      }
+      return 0;
+    }
+    case FUNC_READ_REGISTERS: {
+      if (payload_len == 0 || payload_len % 2 != 0 || payload_len / 2 > MAX_REGISTERS_PER_REQUEST)
+        return EXCEPTION_ILLEGAL_VALUE;
+      for (size_t i = 0; i < payload_len; i += 2) {
+        if (this->silent_addresses.count(word(i)))
+          return NO_RESPONSE;
+        if (!this->readable_(word(i)))
+          return EXCEPTION_ILLEGAL_ADDRESS;
+      }
+      touched = payload_len / 2;
+      resp.push_back(payload_len);
+      for (size_t i = 0; i < payload_len; i += 2)
+        push(this->read(word(i)));
+      return 0;
+    }
+    case FUNC_WRITE_REGISTERS: {
+      if (payload_len == 0 || payload_len % 4 != 0)
+        return EXCEPTION_ILLEGAL_VALUE;
+      for (size_t i = 0; i < payload_len; i += 4) {
+        if (this->illegal_addresses.count(word(i)))
+          return EXCEPTION_ILLEGAL_ADDRESS;
+      }
+      for (size_t i = 0; i < payload_len; i += 4)
+        this->registers[word(i)] = word(i + 2);
+      touched = payload_len / 4;
+      return 0;
+    }
+    case FUNC_WRITE_SINGLE: {
+      if (payload_len != 4)
+        return EXCEPTION_ILLEGAL_VALUE;
+      if (this->illegal_addresses.count(word(0)))
+        return EXCEPTION_ILLEGAL_ADDRESS;
+      this->registers[word(0)] = word(2);
+      touched = 1;
+      resp.insert(resp.end(), payload, payload + 4);
+      return 0;
+    }
+    default:
+      return EXCEPTION_ILLEGAL_FUNCTION;
+  }
+}
+
+void AbcSimulator::schedule_(std::vector<uint8_t> &resp, uint64_t start_us) {
+  uint16_t crc = crc16(resp.data(), resp.size());
+  resp.push_back(crc & 0xFF);
+  resp.push_back(crc >> 8);
+  this->stats.responses++;
+  this->transmit_(resp, start_us);
+}
+
+void AbcSimulator::transmit_(const std::vector<uint8_t> &frame, uint64_t start_us) {
+  // Never overlap whatever is already on the line
+  if (!this->tx_.empty() && this->tx_.back().ready_us > start_us)
+    start_us = this->tx_.back().ready_us;
+  for (size_t i = 0; i < frame.size(); i++)
+    this->tx_.push_back({frame[i], start_us + this->timing.wire_time_us(i + 1)});
+  this->stats.tx_bytes += frame.size();
+  this->stats.busy_us += this->timing.wire_time_us(frame.size());
+}
+
+size_t AbcSimulator::available() {
+  uint64_t now = SimClock::now_us();
+  size_t n = 0;
+  for (const auto &b : this->tx_) {
+    if (b.ready_us > now)
+      break;
+    n++;
+  }
+  return n;
+}
+
+bool AbcSimulator::read_byte(uint8_t *data) {
+  if (this->tx_.empty() || this->tx_.front().ready_us > SimClock::now_us())
+    return false;
+  *data = this->tx_.front().value;
+  this->tx_.pop_front();
+  return true;
+}
+
+}  // namespace sim
+}  // namespace waterfurnace
+}  // namespace esphome
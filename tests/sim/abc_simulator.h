@@ -0,0 +1,139 @@
+#pragma once
+
+// In-process simulated Aurora ABC on a simulated RS-485 line.
+//
+// FakeABC answers the moment a request is written, which is all the state
+// machine tests need. AbcSimulator also models the bus: the request takes
+// its bytes' worth of line time at 19200 8E1 (11 bits per character), the
+// ABC thinks for a configurable processing delay, and the response then
+// arrives one byte per character time. Time is virtual (SimClock), so whole
+// poll cycles run in microseconds of real time and come out with the bus
+// time they would take on a real heat pump.
+//
+// Attach it to the hub's UART mock with set_mock_backend().
+
+#include "../../components/waterfurnace/protocol.h"
+#include "../unit/mocks/esphome_types.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+namespace sim {
+
+/// Virtual time for the mocks' millis() and micros()
+class SimClock {
+ public:
+  static uint64_t now_us() { return now_us_; }
+  static void reset(uint64_t us = 0) { set_(us); }
+  static void advance_us(uint64_t us) { set_(now_us_ + us); }
+  static void advance_to_us(uint64_t us) {
+    if (us > now_us_)
+      set_(us);
+  }
+
+ protected:
+  static void set_(uint64_t us) {
+    now_us_ = us;
+    mock_micros = static_cast<uint32_t>(us);
+    mock_millis = static_cast<uint32_t>(us / 1000);
+  }
+  static inline uint64_t now_us_ = 0;
+};
+
+struct LineTiming {
+  uint32_t baud{19200};
+  uint8_t bits_per_char{11};  // Start, 8 data, even parity, stop
+  /// Time from the end of a request to the first byte of the response
+  uint32_t processing_delay_us{10000};
+  /// Extra processing time per register read or written
+  uint32_t per_register_us{0};
+
+  /// Line time for `bytes` characters
+  uint64_t wire_time_us(size_t bytes) const {
+    return (static_cast<uint64_t>(bytes) * bits_per_char * 1000000 + baud / 2) / baud;
+  }
+};
+
+/// Modbus exception codes the ABC answers with
+enum ExceptionCode : uint8_t {
+  EXCEPTION_ILLEGAL_FUNCTION = 0x01,
+  EXCEPTION_ILLEGAL_ADDRESS = 0x02,
+  EXCEPTION_ILLEGAL_VALUE = 0x03,
+};
+
+struct SimStats {
+  uint32_t requests{0};
+  uint32_t responses{0};
+  uint32_t exceptions{0};
+  uint32_t ignored{0};     // Bad CRC, another slave's address, or garbage
+  uint32_t unanswered{0};  // Reads of silent_addresses
+  uint32_t collisions{0};  // Requests sent while a response was still on the line
+  uint64_t rx_bytes{0};    // Request bytes
+  uint64_t tx_bytes{0};    // Response bytes
+  uint64_t busy_us{0};     // Line time of both directions
+};
+
+class AbcSimulator : public uart::UARTMockBackend {
+ public:
+  virtual ~AbcSimulator() = default;
+
+  /// Load "address: value" lines (the fixture format of tests/fixtures);
+  /// false if the file cannot be read
+  bool load_fixture(const std::string &path);
+
+  uint16_t read(uint16_t addr) const;
+  void set_string(uint16_t start, const char *str, uint8_t num_regs);
+
+  // uart::UARTMockBackend
+  void on_write(const uint8_t *data, size_t len) override;
+  size_t available() override;
+  bool read_byte(uint8_t *data) override;
+
+  /// Nothing scheduled on the line
+  bool idle() const { return tx_.empty(); }
+  /// When the line goes quiet (now if it already is)
+  uint64_t line_free_at_us() const { return tx_.empty() ? SimClock::now_us() : tx_.back().ready_us; }
+
+  std::map<uint16_t, uint16_t> registers;
+  /// Reads and writes touching these get exception 2
+  std::set<uint16_t> illegal_addresses;
+  /// Reads touching these get no answer at all
+  std::set<uint16_t> silent_addresses;
+  /// Registers missing from `registers` get exception 2 instead of reading as 0
+  bool strict{false};
+  uint8_t address{SLAVE_ADDRESS};  // 0 answers any slave address
+  /// Answer the next request with this exception code (0: none)
+  uint8_t exception_next{0};
+  LineTiming timing;
+  SimStats stats;
+  std::vector<std::vector<uint8_t>> requests;  // Every request answered, in order
+
+ protected:
+  struct TimedByte {
+    uint8_t value;
+    uint64_t ready_us;  // When the byte has fully arrived at the hub
+  };
+
+  // handle_() result for a request the ABC leaves unanswered
+  static constexpr uint8_t NO_RESPONSE = 0xFF;
+  // Build the response PDU for a valid request; returns registers touched or an exception code
+  // (or NO_RESPONSE)
+  uint8_t handle_(const uint8_t *data, size_t len, std::vector<uint8_t> &resp, size_t &touched);
+  bool readable_(uint16_t addr) const;
+  // Append the CRC and hand the response to transmit_()
+  void schedule_(std::vector<uint8_t> &resp, uint64_t start_us);
+  // Put a complete response on the line, first byte starting at `start_us`
+  virtual void transmit_(const std::vector<uint8_t> &frame, uint64_t start_us);
+
+  std::deque<TimedByte> tx_;
+};
+
+}  // namespace sim
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,134 @@
+#include "capture_replay.h"
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+namespace esphome {
+namespace waterfurnace {
+namespace sim {
+
+static uint64_t host_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void ReplayHub::replay_request(const uint8_t *frame, size_t len) {
+  if (len < MIN_FRAME_SIZE)
+    return;
+  // The addresses the response carries, decoded from the request as it was sent
+  this->expected_addresses_.clear();
+  size_t end = len - 2;
+  if (frame[1] == FUNC_READ_RANGES) {
+    for (size_t i = 2; i + 4 <= end; i += 4) {
+      uint16_t start = (frame[i] << 8) | frame[i + 1];
+      uint16_t count = (frame[i + 2] << 8) | frame[i + 3];
+      for (uint16_t n = 0; n < count; n++)
+        this->expected_addresses_.push_back(start + n);
+    }
+  } else if (frame[1] == FUNC_READ_REGISTERS) {
+    for (size_t i = 2; i + 2 <= end; i += 2)
+      this->expected_addresses_.push_back((frame[i] << 8) | frame[i + 1]);
+  }
+
+  if (!this->setup_complete_) {
+    // The response finishes system identification or component detection
+    this->setup_phase_ = 1;
+  } else {
+    this->current_ = Transaction();
+    this->current_.cls = TransactionClass::ON_DEMAND;
+    this->in_flight_ = true;
+  }
+  this->send_frame_(frame, len);
+  this->state_ = State::WAITING_RESPONSE;
+}
+
+bool CaptureReplay::load(std::vector<uint8_t> data) {
+  CaptureReader reader;
+  if (!reader.open(data.data(), data.size()))
+    return false;
+  this->slave_ = reader.slave();
+  this->data_ = std::move(data);
+  return true;
+}
+
+bool CaptureReplay::load_file(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  return this->load(std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+}
+
+size_t CaptureReplay::read(uint8_t *buf, size_t len) {
+  size_t n = 0;
+  for (; n < len && !this->rx_.empty(); n++) {
+    buf[n] = this->rx_.front();
+    this->rx_.pop_front();
+  }
+  return n;
+}
+
+void CaptureReplay::wrap_listeners_(ReplayHub &hub) {
+  for (; this->wrapped_ < hub.listeners_.size(); this->wrapped_++) {
+    auto &listener = hub.listeners_[this->wrapped_];
+    auto inner = std::move(listener.callback);
+    listener.callback = [inner, this](uint16_t value) {
+      uint64_t start = host_ns();
+      inner(value);
+      uint64_t ns = host_ns() - start;
+      this->stats_.dispatch_calls++;
+      this->stats_.dispatch_ns += ns;
+      this->stats_.dispatch_max_ns = std::max(this->stats_.dispatch_max_ns, ns);
+    };
+  }
+}
+
+ReplayStats CaptureReplay::run(ReplayHub &hub, const std::function<void()> &loop, uint32_t loop_us) {
+  this->stats_ = ReplayStats();
+  this->sends_ = 0;
+  this->wrapped_ = 0;
+  this->rx_.clear();
+  auto timed_loop = [&]() {
+    this->wrap_listeners_(hub);
+    uint64_t dispatch_before = this->stats_.dispatch_ns;
+    uint64_t start = host_ns();
+    loop();
+    this->stats_.loop_ns += host_ns() - start - (this->stats_.dispatch_ns - dispatch_before);
+  };
+
+  CaptureReader reader;
+  reader.open(this->data_.data(), this->data_.size());
+  uint64_t start_us = SimClock::now_us();
+  CaptureReader::Entry entry;
+  while (reader.next(entry)) {
+    uint64_t at_us = start_us + entry.at_us;
+    while (SimClock::now_us() + loop_us <= at_us) {
+      this->wrap_listeners_(hub);
+      loop();
+      SimClock::advance_us(loop_us);
+    }
+    SimClock::advance_to_us(at_us);
+    if (entry.type == BusCapture::Record::TX) {
+      this->stats_.tx_frames++;
+      hub.replay_request(entry.data, entry.len);
+    } else {
+      this->stats_.rx_chunks++;
+      this->stats_.rx_bytes += entry.len;
+      this->rx_.insert(this->rx_.end(), entry.data, entry.data + entry.len);
+      timed_loop();
+    }
+  }
+  this->stats_.duration_us = SimClock::now_us() - start_us;
+
+  // Let the last values reach their listeners
+  for (int i = 0; i < 100 && hub.dispatch_backlog() > 0; i++) {
+    timed_loop();
+    SimClock::advance_us(loop_us);
+  }
+  this->stats_.own_requests = this->sends_ - this->stats_.tx_frames;
+  return this->stats_;
+}
+
+}  // namespace sim
+}  // namespace waterfurnace
+}  // namespace esphome
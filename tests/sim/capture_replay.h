@@ -0,0 +1,82 @@
+#pragma once
+
+// Replays a bus capture (BusCapture's file format) through a real hub.
+//
+// The capture decides what happens on the bus: each recorded request puts
+// the hub in the state of having just sent it, and each recorded chunk of
+// received bytes reaches the hub's transport at its recorded time. The
+// hub's own read_frame_(), process_response_() and listener dispatch then
+// run as they did on the device, in virtual time (SimClock), so a field
+// capture reproduces its CRC errors, timeouts and value count mismatches
+// along with the values. Requests the hub makes up on its own are sent
+// nowhere; the capture only answers the ones it recorded.
+//
+// Captures from a passive hub are not supported: the replay hub always
+// polls.
+
+#include "../../components/waterfurnace/waterfurnace.h"
+#include "abc_simulator.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+namespace sim {
+
+/// A hub whose in-flight request can be set from a capture
+class ReplayHub : public WaterFurnace {
+ public:
+  using WaterFurnace::listeners_;
+
+  /// The hub has just sent `frame`, in place of whatever it would have sent itself
+  void replay_request(const uint8_t *frame, size_t len);
+};
+
+struct ReplayStats {
+  uint32_t tx_frames{0};
+  uint32_t rx_chunks{0};
+  uint64_t rx_bytes{0};
+  uint32_t own_requests{0};     // Sent by the hub on its own and not in the capture
+  uint64_t duration_us{0};      // Virtual time the capture covers
+  uint64_t loop_ns{0};          // Host time in loop() after received bytes, listeners excluded
+  uint64_t dispatch_calls{0};   // Listener calls
+  uint64_t dispatch_ns{0};      // Host time in listeners
+  uint64_t dispatch_max_ns{0};  // Slowest single listener call
+};
+
+class CaptureReplay : public Transport {
+ public:
+  /// False if `data` is not a capture
+  bool load(std::vector<uint8_t> data);
+  bool load_file(const std::string &path);
+  uint8_t slave() const { return this->slave_; }
+
+  /// Run every record through `hub`, which uses this replay as its
+  /// transport and has been set up with its entities. `loop` runs loop()
+  /// once on the hub and every entity; it is called every `loop_us` of
+  /// virtual time and after each chunk of received bytes.
+  ReplayStats run(ReplayHub &hub, const std::function<void()> &loop, uint32_t loop_us = 16000);
+
+  // Transport
+  void send(const uint8_t *frame, size_t len) override { this->sends_++; }
+  size_t read(uint8_t *buf, size_t len) override;
+
+ protected:
+  // Time every listener the hub has gained since the last call
+  void wrap_listeners_(ReplayHub &hub);
+
+  std::vector<uint8_t> data_;
+  uint8_t slave_{0};
+  std::deque<uint8_t> rx_;
+  uint32_t sends_{0};
+  size_t wrapped_{0};
+  ReplayStats stats_;
+};
+
+}  // namespace sim
+}  // namespace waterfurnace
+}  // namespace esphome
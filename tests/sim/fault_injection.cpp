@@ -0,0 +1,88 @@
+#include "fault_injection.h"
+
+namespace esphome {
+namespace waterfurnace {
+namespace sim {
+
+const char *fault_name(Fault fault) {
+  switch (fault) {
+    case Fault::NONE:
+      return "none";
+    case Fault::DROPPED_BYTE:
+      return "dropped_byte";
+    case Fault::BAD_CRC:
+      return "bad_crc";
+    case Fault::TRUNCATED:
+      return "truncated";
+    case Fault::LATE:
+      return "late";
+    case Fault::DUPLICATE:
+      return "duplicate";
+  }
+  return "unknown";
+}
+
+void FaultyAbcSimulator::randomize(uint32_t seed, double rate, const std::vector<Fault> &faults) {
+  this->rng_.seed(seed);
+  this->rate_ = rate;
+  this->faults_ = faults;
+}
+
+void FaultyAbcSimulator::clear_faults() {
+  this->planned_.clear();
+  this->rate_ = 0;
+}
+
+Fault FaultyAbcSimulator::next_fault_() {
+  uint32_t response = this->responses_++;
+  auto it = this->planned_.find(response);
+  if (it != this->planned_.end()) {
+    Fault fault = it->second;
+    this->planned_.erase(it);
+    return fault;
+  }
+  if (this->rate_ <= 0 || this->faults_.empty())
+    return Fault::NONE;
+  // Raw generator output only, so a seed means the same faults with any standard library
+  if (this->rng_() >= this->rate_ * 4294967296.0)
+    return Fault::NONE;
+  return this->faults_[this->rng_() % this->faults_.size()];
+}
+
+void FaultyAbcSimulator::transmit_(const std::vector<uint8_t> &frame, uint64_t start_us) {
+  Fault fault = this->next_fault_();
+  if (fault == Fault::NONE) {
+    AbcSimulator::transmit_(frame, start_us);
+    return;
+  }
+  this->events.push_back({fault, this->responses_ - 1, start_us});
+
+  std::vector<uint8_t> mangled = frame;
+  switch (fault) {
+    case Fault::DROPPED_BYTE:
+      mangled.erase(mangled.begin() + this->rng_() % mangled.size());
+      break;
+    case Fault::BAD_CRC: {
+      // Past address, function and byte count, so the hub still knows how long the frame is
+      size_t header = frame.size() > 5 ? 3 : 2;
+      mangled[header + this->rng_() % (frame.size() - header)] ^= 1 << (this->rng_() % 8);
+      break;
+    }
+    case Fault::TRUNCATED:
+      mangled.resize(1 + this->rng_() % (frame.size() - 1));
+      break;
+    case Fault::LATE:
+      start_us += this->late_by_us;
+      break;
+    case Fault::DUPLICATE:
+      AbcSimulator::transmit_(frame, start_us);
+      break;
+    case Fault::NONE:
+      break;
+  }
+  AbcSimulator::transmit_(mangled, start_us);
+}
+
+}  // namespace sim
+}  // namespace waterfurnace
+}  // namespace esphome
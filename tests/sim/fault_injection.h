@@ -0,0 +1,67 @@
+#pragma once
+
+// AbcSimulator with line faults injected into its responses.
+//
+// Faults follow a schedule: either explicit (response N gets fault F) or
+// drawn from a seeded generator at a given rate, so a failing soak run can
+// be replayed exactly from its seed. Every injected fault is logged with
+// the time its response would have started, which is what the recovery
+// measurements in the tests count from.
+
+#include "abc_simulator.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+namespace sim {
+
+enum class Fault : uint8_t {
+  NONE,
+  DROPPED_BYTE,  // One byte of the response lost on the line
+  BAD_CRC,       // One bit flipped after the header, so the frame size still parses
+  TRUNCATED,     // The response stops part way through
+  LATE,          // The response starts `late_by_us` after it should
+  DUPLICATE,     // The response is sent twice, back to back
+};
+
+const char *fault_name(Fault fault);
+
+struct FaultEvent {
+  Fault fault;
+  uint32_t response;  // Index of the response (0 = the first one)
+  uint64_t at_us;     // When the intact response would have started
+};
+
+class FaultyAbcSimulator : public AbcSimulator {
+ public:
+  /// Inject `fault` into response number `response`
+  void inject(uint32_t response, Fault fault) { planned_[response] = fault; }
+  /// Responses sent so far; inject(responses(), ...) hits the next one
+  uint32_t responses() const { return responses_; }
+  /// Inject a fault into each response with probability `rate`, choosing
+  /// among `faults`; the same seed gives the same faults
+  void randomize(uint32_t seed, double rate, const std::vector<Fault> &faults);
+  /// Stop injecting (already scheduled faults included)
+  void clear_faults();
+
+  uint64_t late_by_us{2500000};  // Longer than the hub's RESPONSE_TIMEOUT
+  std::vector<FaultEvent> events;
+
+ protected:
+  void transmit_(const std::vector<uint8_t> &frame, uint64_t start_us) override;
+  Fault next_fault_();
+
+  std::map<uint32_t, Fault> planned_;
+  std::mt19937 rng_;
+  double rate_{0};
+  std::vector<Fault> faults_;
+  uint32_t responses_{0};
+};
+
+}  // namespace sim
+}  // namespace waterfurnace
+}  // namespace esphome
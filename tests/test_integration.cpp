@@ -1,32 +1,36 @@
-// Integration test: uses our actual C++ protocol code to talk to the Ruby
-// ModBus TCP mock server, verifying the protocol implementation end-to-end.
+// Integration test: uses our actual C++ code to talk to the Ruby ModBus TCP
+// mock server, verifying the protocol implementation end-to-end.
 //
-// ModBus TCP wraps the same PDU as RTU but with an MBAP header instead of
-// slave_addr + CRC. This test extracts the PDU from our RTU frame builders
-// and wraps it in MBAP for TCP transport, then uses our parse functions on
-// the response. This tests the real code path - no reimplementation.
+// Requests are built with our RTU frame builders and go out through the
+// component's own Modbus TCP transport (TcpTransport), which swaps slave
+// address and CRC for an MBAP header and turns the answers back into RTU
+// frames. The second half runs the whole hub - setup, poll planning, cache,
+// writes - against the mock through the same transport. The component code
+// builds against the host daemon's POSIX shim (../host/shim): BSD sockets for
+// ESPHome's socket component and millis() from CLOCK_MONOTONIC.
 //
-// Compile: g++ -std=c++17 -I../components/waterfurnace -o test_integration test_integration.cpp ../components/waterfurnace/protocol.cpp
+// Compile: g++ -std=c++17 -I../host/shim -I../components/waterfurnace -o test_integration
+//            test_integration.cpp ../components/waterfurnace/{protocol,bus_sniffer,bus_capture,register_dump,freeze_frame,bus_task,waterfurnace,tcp_transport}.cpp
+//            -pthread
 // Run:     docker compose up -d mock && ./test_integration localhost 5020
 
 #include "protocol.h"
 #include "registers.h"
+#include "tcp_transport.h"
+#include "waterfurnace.h"
 
-#include <arpa/inet.h>
-#include <cassert>
+#include <chrono>
 #include <cstdio>
-#include <cstring>
-#include <netdb.h>
+#include <cstdlib>
+#include <functional>
 #include <string>
-#include <sys/socket.h>
-#include <unistd.h>
+#include <thread>
 #include <vector>
 
 using namespace esphome::waterfurnace;
 
 static int tests_passed = 0;
 static int tests_failed = 0;
-static uint16_t txn_id = 0;
 
 #define TEST(name, condition) do { \
     bool _ok = (condition); \
@@ -35,99 +39,69 @@ static uint16_t txn_id = 0;
   } while(0)
 
 // --------------------------------------------------------------------------
-// TCP transport: converts our RTU frames to/from ModBus TCP (MBAP)
+// Transport: our RTU frames through TcpTransport
 // --------------------------------------------------------------------------
 
-// Extract PDU from RTU frame: strip slave_addr (byte 0) and CRC (last 2 bytes)
-static std::vector<uint8_t> rtu_to_pdu(const std::vector<uint8_t> &rtu_frame) {
-  // RTU: [slave][func][data...][crc_lo][crc_hi]
-  // PDU: [func][data...]
-  return std::vector<uint8_t>(rtu_frame.begin() + 1, rtu_frame.end() - 2);
-}
-
-// Send a PDU over ModBus TCP (wraps in MBAP header) and return response PDU
-static std::vector<uint8_t> send_modbus_tcp(int sock, const std::vector<uint8_t> &pdu) {
-  txn_id++;
-
-  // MBAP header: txn_id(2) + protocol(2) + length(2) + unit_id(1)
-  uint16_t length = pdu.size() + 1;  // +1 for unit_id
-  uint8_t header[7];
-  header[0] = (txn_id >> 8) & 0xFF;
-  header[1] = txn_id & 0xFF;
-  header[2] = 0; header[3] = 0;  // protocol = 0
-  header[4] = (length >> 8) & 0xFF;
-  header[5] = length & 0xFF;
-  header[6] = SLAVE_ADDRESS;
-
-  // Send header + PDU
-  std::vector<uint8_t> msg(header, header + 7);
-  msg.insert(msg.end(), pdu.begin(), pdu.end());
-  send(sock, msg.data(), msg.size(), 0);
-
-  // Read response header (7 bytes)
-  uint8_t resp_header[7];
-  size_t got = 0;
-  while (got < 7) {
-    ssize_t n = recv(sock, resp_header + got, 7 - got, 0);
-    if (n <= 0) { fprintf(stderr, "Connection lost\n"); return {}; }
-    got += n;
-  }
-
-  uint16_t resp_len = (resp_header[4] << 8) | resp_header[5];
-  size_t remaining = resp_len - 1;  // subtract unit_id
+static void tick() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
 
-  // Read response PDU
-  std::vector<uint8_t> resp_pdu(remaining);
-  got = 0;
-  while (got < remaining) {
-    ssize_t n = recv(sock, resp_pdu.data() + got, remaining - got, 0);
-    if (n <= 0) { fprintf(stderr, "Connection lost\n"); return {}; }
-    got += n;
+static bool wait_connected(TcpTransport &gw, uint32_t timeout_ms) {
+  uint32_t start = esphome::millis();
+  while (!gw.is_connected() && esphome::millis() - start < timeout_ms) {
+    gw.loop();
+    tick();
   }
-
-  return resp_pdu;
+  return gw.is_connected();
 }
 
-// Build RTU frame using our C++ code, convert to PDU, send via TCP, return response
-static std::vector<uint16_t> read_ranges(int sock, const std::vector<std::pair<uint16_t, uint16_t>> &ranges) {
-  auto rtu = build_read_ranges_request(ranges);
-  auto pdu = rtu_to_pdu(rtu);
-  auto resp = send_modbus_tcp(sock, pdu);
-
-  if (resp.empty() || is_error_response(resp[0])) {
-    fprintf(stderr, "Error response for func 65\n");
-    return {};
+// Send an RTU request and wait for the RTU response frame (empty on timeout)
+static std::vector<uint8_t> transact(TcpTransport &gw, const std::vector<uint8_t> &request) {
+  gw.send(request.data(), request.size());
+  std::vector<uint8_t> resp;
+  uint32_t start = esphome::millis();
+  while (esphome::millis() - start < 5000) {
+    uint8_t buf[64];
+    size_t n = gw.read(buf, sizeof(buf));
+    resp.insert(resp.end(), buf, buf + n);
+    size_t size = get_response_frame_size(resp.data(), resp.size());
+    if (size > 0 && resp.size() >= size) {
+      resp.resize(size);
+      if (!validate_frame_crc(resp.data(), resp.size())) {
+        fprintf(stderr, "Bad CRC on rebuilt frame\n");
+        return {};
+      }
+      return resp;
+    }
+    tick();
   }
-
-  // resp[0] = func, resp[1] = byte_count, resp[2..] = data
-  uint8_t byte_count = resp[1];
-  return parse_register_values(resp.data() + 2, byte_count);
+  fprintf(stderr, "No response\n");
+  return {};
 }
 
-static std::vector<uint16_t> read_registers(int sock, const std::vector<uint16_t> &addresses) {
-  auto rtu = build_read_registers_request(addresses);
-  auto pdu = rtu_to_pdu(rtu);
-  auto resp = send_modbus_tcp(sock, pdu);
-
-  if (resp.empty() || is_error_response(resp[0])) {
-    fprintf(stderr, "Error response for func 66\n");
+static std::vector<uint16_t> read_values(TcpTransport &gw, const std::vector<uint8_t> &request, const char *what) {
+  auto resp = transact(gw, request);
+  if (resp.size() < MIN_FRAME_SIZE || is_error_response(resp[1])) {
+    fprintf(stderr, "Error response for %s\n", what);
     return {};
   }
+  // resp[0] = slave, resp[1] = func, resp[2] = byte_count, resp[3..] = data
+  return parse_register_values(resp.data() + 3, resp[2]);
+}
 
-  uint8_t byte_count = resp[1];
-  return parse_register_values(resp.data() + 2, byte_count);
+static std::vector<uint16_t> read_ranges(TcpTransport &gw, const std::vector<std::pair<uint16_t, uint16_t>> &ranges) {
+  return read_values(gw, build_read_ranges_request(ranges), "func 65");
 }
 
-static bool write_registers(int sock, const std::vector<std::pair<uint16_t, uint16_t>> &writes) {
-  auto rtu = build_write_registers_request(writes);
-  auto pdu = rtu_to_pdu(rtu);
-  auto resp = send_modbus_tcp(sock, pdu);
+static std::vector<uint16_t> read_registers(TcpTransport &gw, const std::vector<uint16_t> &addresses) {
+  return read_values(gw, build_read_registers_request(addresses), "func 66");
+}
 
-  if (resp.empty() || is_error_response(resp[0])) {
+static bool write_registers(TcpTransport &gw, const std::vector<std::pair<uint16_t, uint16_t>> &writes) {
+  auto resp = transact(gw, build_write_registers_request(writes));
+  if (resp.size() < MIN_FRAME_SIZE || is_error_response(resp[1])) {
     fprintf(stderr, "Error response for func 67\n");
     return false;
   }
-  return resp[0] == FUNC_WRITE_REGISTERS;
+  return resp[1] == FUNC_WRITE_REGISTERS;
 }
 
 // Compute expected values for a range read from known fixture data
@@ -222,38 +196,15 @@ int main(int argc, char *argv[]) {
 
   printf("Connecting to ModBus TCP mock at %s:%d...\n", host, port);
 
-  // Connect with retries
-  int sock = -1;
-  for (int attempt = 0; attempt < 10; attempt++) {
-    sock = socket(AF_INET, SOCK_STREAM, 0);
-    struct sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-
-    struct hostent *he = gethostbyname(host);
-    if (!he) {
-      printf("  DNS resolution failed, retrying (%d/10)...\n", attempt + 1);
-      close(sock);
-      sleep(2);
-      continue;
-    }
-    memcpy(&addr.sin_addr, he->h_addr_list[0], he->h_length);
-
-    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0) break;
-    printf("  Connection refused, retrying (%d/10)...\n", attempt + 1);
-    close(sock);
-    sock = -1;
-    sleep(2);
-  }
-  if (sock < 0) {
+  // TcpTransport retries every RECONNECT_INTERVAL while the mock starts up
+  TcpTransport gw(TcpTransport::Framing::MBAP);
+  gw.set_host(host);
+  gw.set_port(port);
+  if (!wait_connected(gw, 20000)) {
     printf("  Could not connect to mock server\n");
     return 1;
   }
 
-  // Set socket timeout
-  struct timeval tv{5, 0};
-  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-
   printf("Connected.\n\n");
 
   // ============================================================
@@ -263,7 +214,7 @@ int main(int argc, char *argv[]) {
   // Test 1: System ID registers - uses get_system_id_ranges() from registers.h
   {
     auto ranges = get_system_id_ranges();
-    auto values = read_ranges(sock, ranges);
+    auto values = read_ranges(gw, ranges);
     auto expected = expected_range_values(ranges);
     TEST("System ID ranges: correct count", values.size() == expected.size());
     TEST("System ID ranges: values match", values == expected);
@@ -282,7 +233,7 @@ int main(int argc, char *argv[]) {
     ranges.push_back({502, 1});   // AWL thermostat
     ranges.push_back({745, 3});   // AWL thermostat setpoints
     ranges.push_back({740, 3});   // AWL AXB + communicating
-    auto values = read_ranges(sock, ranges);
+    auto values = read_ranges(gw, ranges);
     auto expected = expected_range_values(ranges);
     TEST("Thermostat ranges: values match", values == expected);
 
@@ -306,7 +257,7 @@ int main(int argc, char *argv[]) {
   // Test 3: Component detection - uses get_component_detect_ranges()
   {
     auto ranges = get_component_detect_ranges();
-    auto values = read_ranges(sock, ranges);
+    auto values = read_ranges(gw, ranges);
     auto expected = expected_range_values(ranges);
     TEST("Component detect ranges: values match", values == expected);
 
@@ -331,7 +282,7 @@ int main(int argc, char *argv[]) {
     std::vector<std::pair<uint16_t, uint16_t>> ranges = {
         {400, 2}, {1103, 6}, {1109, 11}, {1124, 2}, {1134, 3},
     };
-    auto values = read_ranges(sock, ranges);
+    auto values = read_ranges(gw, ranges);
     auto expected = expected_range_values(ranges);
     TEST("AXB ranges: values match", values == expected);
   }
@@ -341,7 +292,7 @@ int main(int argc, char *argv[]) {
     std::vector<std::pair<uint16_t, uint16_t>> ranges = {
         {16, 1}, {1146, 12}, {1164, 2},
     };
-    auto values = read_ranges(sock, ranges);
+    auto values = read_ranges(gw, ranges);
     auto expected = expected_range_values(ranges);
     TEST("Power ranges: values match", values == expected);
 
@@ -359,7 +310,7 @@ int main(int argc, char *argv[]) {
         {3000, 2}, {3027, 1}, {3220, 8}, {3322, 11},
         {3422, 4}, {3522, 3}, {3808, 1}, {3903, 4},
     };
-    auto values = read_ranges(sock, ranges);
+    auto values = read_ranges(gw, ranges);
     auto expected = expected_range_values(ranges);
     TEST("VS Drive ranges: values match", values == expected);
   }
@@ -371,7 +322,7 @@ int main(int argc, char *argv[]) {
   // Test: Thermostat config
   {
     std::vector<uint16_t> addrs = {12005, 12006};
-    auto values = read_registers(sock, addrs);
+    auto values = read_registers(gw, addrs);
     auto expected = expected_individual_values(addrs);
     TEST("Thermostat config: values match", values == expected);
 
@@ -391,7 +342,7 @@ int main(int argc, char *argv[]) {
   {
     std::vector<uint16_t> addrs = {REG_LINE_VOLTAGE, REG_HEATING_SETPOINT,
                                    REG_ENTERING_WATER, REG_VS_SPEED_ACTUAL};
-    auto values = read_registers(sock, addrs);
+    auto values = read_registers(gw, addrs);
     auto expected = expected_individual_values(addrs);
     TEST("Sparse individual reads: values match", values == expected);
   }
@@ -402,12 +353,12 @@ int main(int argc, char *argv[]) {
 
   // Test: Write setpoints
   {
-    bool ok = write_registers(sock, {{REG_WRITE_HEATING_SP, 700},
+    bool ok = write_registers(gw, {{REG_WRITE_HEATING_SP, 700},
                                      {REG_WRITE_COOLING_SP, 730}});
     TEST("Write response received (no error)", ok);
 
     // Read back using func 66
-    auto values = read_registers(sock, {REG_WRITE_HEATING_SP, REG_WRITE_COOLING_SP});
+    auto values = read_registers(gw, {REG_WRITE_HEATING_SP, REG_WRITE_COOLING_SP});
     TEST("  Readback heating SP = 700", values.size() >= 2 && values[0] == 700);
     TEST("  Readback cooling SP = 730", values.size() >= 2 && values[1] == 730);
   }
@@ -418,7 +369,7 @@ int main(int argc, char *argv[]) {
 
   // Temperature conversions using our convert_register()
   {
-    auto values = read_registers(sock, {REG_ENTERING_WATER, REG_LEAVING_WATER,
+    auto values = read_registers(gw, {REG_ENTERING_WATER, REG_LEAVING_WATER,
                                         REG_OUTDOOR_TEMP, REG_LEAVING_AIR});
 
     float ewt = convert_register(values[0], RegisterType::SIGNED_TENTHS);
@@ -439,7 +390,7 @@ int main(int argc, char *argv[]) {
 
   // Fault code parsing using our constants
   {
-    auto values = read_registers(sock, {REG_LAST_FAULT});
+    auto values = read_registers(gw, {REG_LAST_FAULT});
     bool locked_out = (values[0] & 0x8000) != 0;
     uint16_t fault_code = values[0] & 0x7FFF;
     TEST("  No fault (code=0, no lockout)", fault_code == 0 && !locked_out);
@@ -447,7 +398,7 @@ int main(int argc, char *argv[]) {
 
   // System outputs bitmask using our constants
   {
-    auto values = read_registers(sock, {REG_SYSTEM_OUTPUTS});
+    auto values = read_registers(gw, {REG_SYSTEM_OUTPUTS});
     uint16_t outputs = values[0];
     char buf[80];
     snprintf(buf, sizeof(buf), "  Compressor ON (outputs=0x%04X)", outputs);
@@ -458,7 +409,54 @@ int main(int argc, char *argv[]) {
   }
 
   // ============================================================
-  close(sock);
+  printf("\nHub end to end (WaterFurnace over TcpTransport)\n");
+  printf("============================================================\n");
+
+  {
+    TcpTransport hub_gw(TcpTransport::Framing::MBAP);
+    hub_gw.set_host(host);
+    hub_gw.set_port(port);
+    WaterFurnace hub;
+    hub.set_transport(&hub_gw);
+    hub.set_update_interval(10000);
+    uint16_t heating_sp = 0, ewt = 0, outputs = 0, line_voltage = 0;
+    hub.register_listener(REG_HEATING_SETPOINT, [&](uint16_t v) { heating_sp = v; });
+    hub.register_listener(REG_ENTERING_WATER, [&](uint16_t v) { ewt = v; }, RegisterCapability::AXB);
+    hub.register_listener(REG_SYSTEM_OUTPUTS, [&](uint16_t v) { outputs = v; });
+    hub.register_listener(REG_LINE_VOLTAGE, [&](uint16_t v) { line_voltage = v; });
+
+    auto run_until = [&](const std::function<bool()> &done, uint32_t timeout_ms) {
+      uint32_t start = esphome::millis();
+      while (!done() && esphome::millis() - start < timeout_ms) {
+        hub.loop();
+        tick();
+      }
+      return done();
+    };
+
+    hub.setup();
+    TEST("Hub setup completes", run_until([&] { return hub.is_setup_complete(); }, 20000));
+    TEST(("  Program = 'ABCSPLVS' (got '" + hub.abc_program() + "')").c_str(), hub.abc_program() == "ABCSPLVS");
+    TEST("  AWL thermostat and AXB detected", hub.has_thermostat() && hub.has_axb());
+    TEST("  IZ2 not detected", !hub.has_iz2());
+
+    hub.update();
+    TEST("Poll cycle dispatches values",
+         run_until([&] { return heating_sp != 0 && ewt != 0 && outputs != 0 && line_voltage != 0; }, 10000));
+    TEST("  Heating SP = 680", heating_sp == fixture_value(REG_HEATING_SETPOINT));
+    TEST("  EWT = 450", ewt == fixture_value(REG_ENTERING_WATER));
+    TEST("  Outputs = 9", outputs == fixture_value(REG_SYSTEM_OUTPUTS));
+    TEST("  Line voltage = 240", line_voltage == fixture_value(REG_LINE_VOLTAGE));
+
+    hub.write_register(REG_WRITE_HEATING_SP, 690);
+    run_until([&] { return hub.queue_depth() == 0 && hub.bus_stats().write_registers > 0; }, 5000);
+    auto values = read_registers(gw, {REG_WRITE_HEATING_SP});
+    TEST("  Hub write reached the mock (690)", values.size() == 1 && values[0] == 690);
+    TEST("  No CRC errors or timeouts",
+         hub.bus_stats().crc_errors == 0 && hub.bus_stats().timeouts == 0);
+  }
+
+  // ============================================================
   printf("\n============================================================\n");
   printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
   return tests_failed > 0 ? 1 : 0;
@@ -0,0 +1,232 @@
+#pragma once
+
+// Minimal simulated ABC for driving the real WaterFurnace hub state machine in
+// unit tests. Attach it to the hub with set_mock_backend(); it answers function
+// 65/66/67/6 requests from a register map as soon as the request is written.
+// Unknown registers read as 0.
+//
+// SimHubTest is the fixture for tests that need bus timing as well: the hub
+// polling an AbcSimulator (tests/sim) in virtual time.
+
+#include <gtest/gtest.h>
+#include "../../components/waterfurnace/protocol.h"
+#include "../../components/waterfurnace/registers.h"
+#include "../../components/waterfurnace/waterfurnace.h"
+#include "../sim/abc_simulator.h"
+#include "mocks/esphome_types.h"
+
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace esphome {
+namespace waterfurnace {
+
+class FakeABC : public uart::UARTMockBackend {
+ public:
+  FakeABC() {
+    // Program "ABCVSP" (VS drive), model "TESTMODEL", serial "12345"
+    set_string(REG_ABC_PROGRAM, "ABCVSP", 4);
+    set_string(REG_MODEL_NUMBER, "TESTMODEL", 12);
+    set_string(REG_SERIAL_NUMBER, "12345", 5);
+    // AWL thermostat v3.00, AWL AXB v2.00, energy monitoring
+    registers[REG_THERMOSTAT_STATUS] = COMPONENT_ACTIVE;
+    registers[REG_THERMOSTAT_VERSION] = 300;
+    registers[REG_AXB_STATUS] = COMPONENT_ACTIVE;
+    registers[REG_AXB_VERSION] = 200;
+    registers[REG_IZ2_STATUS] = COMPONENT_MISSING;
+    registers[REG_ENERGY_MONITOR] = 2;
+  }
+
+  void set_string(uint16_t start, const char *str, uint8_t num_regs) {
+    for (uint8_t i = 0; i < num_regs; i++) {
+      char hi = *str ? *str++ : ' ';
+      char lo = *str ? *str++ : ' ';
+      registers[start + i] = (static_cast<uint8_t>(hi) << 8) | static_cast<uint8_t>(lo);
+    }
+  }
+
+  uint16_t read(uint16_t addr) const {
+    auto it = registers.find(addr);
+    return it != registers.end() ? it->second : 0;
+  }
+
+  void on_write(const uint8_t *data, size_t len) override {
+    if (address != 0 && (len == 0 || data[0] != address))
+      return;  // Another unit's request on a shared bus
+    requests.push_back(std::vector<uint8_t>(data, data + len));
+    if (silent || len < MIN_FRAME_SIZE || !validate_frame_crc(data, len))
+      return;
+
+    std::vector<uint8_t> resp = {data[0], data[1]};
+    if (exception_next) {
+      exception_next = false;
+      resp[1] |= ERROR_MASK;
+      resp.push_back(0x02);  // Illegal data address
+      finish_(resp);
+      return;
+    }
+    const uint8_t *payload = data + 2;
+    size_t payload_len = len - 4;
+
+    switch (data[1]) {
+      case FUNC_READ_RANGES: {
+        resp.push_back(0);
+        for (size_t i = 0; i + 4 <= payload_len; i += 4) {
+          uint16_t start = (payload[i] << 8) | payload[i + 1];
+          uint16_t count = (payload[i + 2] << 8) | payload[i + 3];
+          for (uint16_t j = 0; j < count; j++)
+            push_value_(resp, read(start + j));
+        }
+        resp[2] = resp.size() - 3;
+        break;
+      }
+      case FUNC_READ_REGISTERS: {
+        resp.push_back(0);
+        for (size_t i = 0; i + 2 <= payload_len; i += 2)
+          push_value_(resp, read((payload[i] << 8) | payload[i + 1]));
+        resp[2] = resp.size() - 3;
+        break;
+      }
+      case FUNC_WRITE_REGISTERS: {
+        for (size_t i = 0; i + 4 <= payload_len; i += 4)
+          registers[(payload[i] << 8) | payload[i + 1]] = (payload[i + 2] << 8) | payload[i + 3];
+        break;
+      }
+      case FUNC_WRITE_SINGLE: {
+        registers[(payload[0] << 8) | payload[1]] = (payload[2] << 8) | payload[3];
+        resp.insert(resp.end(), payload, payload + 4);
+        break;
+      }
+      default:
+        resp[1] |= ERROR_MASK;
+        resp.push_back(0x01);  // Illegal function
+        break;
+    }
+
+    finish_(resp);
+  }
+
+  size_t available() override { return mock_millis >= rx_ready_ ? rx.size() : 0; }
+  bool read_byte(uint8_t *b) override {
+    if (rx.empty())
+      return false;
+    *b = rx.front();
+    rx.pop_front();
+    return true;
+  }
+
+  std::map<uint16_t, uint16_t> registers;
+  std::vector<std::vector<uint8_t>> requests;
+  std::deque<uint8_t> rx;
+  uint8_t address{0};  // Answer only this slave address (0: any)
+  bool silent{false};  // Drop requests without answering (simulates a dead bus)
+  uint32_t latency_ms{0};       // Hold each response back this long
+  bool corrupt_next{false};     // Flip a CRC bit in the next response
+  bool exception_next{false};   // Answer the next request with an exception
+  uint32_t rx_ready_{0};
+
+ protected:
+  void finish_(std::vector<uint8_t> &resp) {
+    uint16_t crc = crc16(resp.data(), resp.size());
+    if (corrupt_next) {
+      corrupt_next = false;
+      crc ^= 1;
+    }
+    resp.push_back(crc & 0xFF);
+    resp.push_back(crc >> 8);
+    rx.insert(rx.end(), resp.begin(), resp.end());
+    rx_ready_ = mock_millis + latency_ms;
+  }
+
+  static void push_value_(std::vector<uint8_t> &resp, uint16_t v) {
+    resp.push_back(v >> 8);
+    resp.push_back(v & 0xFF);
+  }
+};
+
+// Several FakeABCs on one RS-485 bus: every request reaches all units and
+// their responses share the receive line
+class SharedBus : public uart::UARTMockBackend {
+ public:
+  void add_unit(FakeABC *unit) { units.push_back(unit); }
+
+  void on_write(const uint8_t *data, size_t len) override {
+    for (auto *unit : units) {
+      if (!unit->rx.empty())
+        collisions++;  // Request sent while a response was still on the line
+    }
+    if (len > 0)
+      writes.push_back(data[0]);
+    for (auto *unit : units)
+      unit->on_write(data, len);
+  }
+  size_t available() override {
+    size_t n = 0;
+    for (auto *unit : units)
+      n += unit->available();
+    return n;
+  }
+  bool read_byte(uint8_t *b) override {
+    for (auto *unit : units) {
+      if (unit->available())
+        return unit->read_byte(b);
+    }
+    return false;
+  }
+
+  std::vector<FakeABC *> units;
+  std::vector<uint8_t> writes;  // Slave address of every request, in bus order
+  uint32_t collisions{0};
+};
+
+// One pass of the main loop: update() once the poll interval is due (after
+// setup), then loop(). `last_update` is the caller's update() clock.
+inline void step_hub(WaterFurnace &hub, uint32_t interval, uint32_t &last_update) {
+  if (hub.is_setup_complete() && mock_millis - last_update >= interval) {
+    hub.update();
+    last_update = mock_millis;
+  }
+  hub.loop();
+}
+
+// The hub set up against the sample fixture in an AbcSimulator; polled_
+// counts the updates of a register from each of the hub's poll groups
+class SimHubTest : public ::testing::Test {
+ protected:
+  static constexpr uint32_t INTERVAL = 10000;
+  static constexpr const char *FIXTURE = "../fixtures/sample_registers.yml";
+
+  void SetUp() override {
+    sim::SimClock::reset();
+    ASSERT_TRUE(abc_.load_fixture(FIXTURE));
+    hub_.set_mock_backend(&abc_);
+    hub_.set_update_interval(INTERVAL);
+    this->configure_();
+    for (uint16_t addr : {19, 20, 30, 31, 344, 1110, 1111, 1117}) {
+      hub_.register_listener(addr, [this, addr](uint16_t) { polled_[addr]++; });
+    }
+    hub_.setup();
+    run_ms(2000);
+    ASSERT_TRUE(hub_.is_setup_complete());
+    polled_.clear();
+  }
+
+  // Hub options to set before setup()
+  virtual void configure_() {}
+
+  void run_ms(uint32_t ms) {
+    for (uint32_t end = mock_millis + ms; mock_millis < end;) {
+      step_hub(hub_, INTERVAL, last_update_);
+      sim::SimClock::advance_us(1000);
+    }
+  }
+
+  sim::AbcSimulator abc_;
+  WaterFurnace hub_;
+  std::map<uint16_t, uint32_t> polled_;
+  uint32_t last_update_{0};
+};
+
+}  // namespace waterfurnace
+}  // namespace esphome
@@ -0,0 +1,91 @@
+"""Emit poll_plan_fixture.h: build-time poll plans for a full configuration.
+
+test_poll_groups.cpp registers the same listeners on a hub and checks the
+prebuilt plans against the runtime planner for every hardware variant.
+"""
+
+import os
+import sys
+
+sys.path.insert(
+    0, os.path.join(os.path.dirname(__file__), "..", "..", "components", "waterfurnace")
+)
+
+import poll_plan  # noqa: E402
+
+# (address, capability, when): a full sensor set plus a zone 1 climate
+LISTENERS = [
+    (6, "none", None), (19, "none", None), (20, "none", None), (25, "none", None),
+    (26, "none", None), (27, "none", None), (28, "none", None), (30, "none", None),
+    (31, "none", None), (344, "none", None), (362, "vs_drive", None),
+    (16, "energy", None), (740, "none", None), (741, "awl_communicating", None),
+    (742, "awl_communicating", None), (747, "awl_thermostat", None), (900, "awl_axb", None),
+    (400, "axb", None), (1104, "axb", None), (1105, "axb", None), (1106, "axb", None),
+    (1107, "axb", None), (1108, "axb", None), (1109, "refrigeration", None),
+    (1110, "axb", None), (1111, "axb", None), (1112, "axb", None), (1113, "axb", None),
+    (1114, "axb", None), (1115, "axb", None), (1116, "axb", None), (1117, "axb", None),
+    (1119, "axb", None), (1124, "refrigeration", None), (1125, "refrigeration", None),
+    (1134, "refrigeration", None), (1135, "vs_drive", None), (1136, "vs_drive", None),
+    (1146, "energy", None), (1147, "energy", None), (1148, "energy", None),
+    (1149, "energy", None), (1150, "energy", None), (1151, "energy", None),
+    (1152, "energy", None), (1153, "energy", None), (1154, "refrigeration", None),
+    (1155, "refrigeration", None), (1156, "refrigeration", None),
+    (1157, "refrigeration", None), (1164, "energy", None), (1165, "energy", None),
+    (3001, "vs_drive", None), (3027, "vs_drive", None), (3322, "vs_drive", None),
+    (3323, "vs_drive", None), (3325, "vs_drive", None), (3326, "vs_drive", None),
+    (3327, "vs_drive", None), (3330, "vs_drive", None), (3331, "vs_drive", None),
+    (3332, "vs_drive", None), (3422, "vs_drive", None), (3423, "vs_drive", None),
+    (3424, "vs_drive", None), (3425, "vs_drive", None), (3522, "vs_drive", None),
+    (3523, "vs_drive", None), (3524, "vs_drive", None), (3808, "vs_drive", None),
+    (3903, "vs_drive", None), (3905, "vs_drive", None), (3906, "vs_drive", None),
+    (502, "awl_thermostat", poll_plan.WHEN_NO_IZ2),
+    (745, "awl_thermostat", poll_plan.WHEN_NO_IZ2),
+    (746, "awl_thermostat", poll_plan.WHEN_NO_IZ2),
+    (12005, "awl_thermostat", poll_plan.WHEN_NO_IZ2),
+    (12006, "awl_thermostat", poll_plan.WHEN_NO_IZ2),
+    (31007, "iz2", poll_plan.WHEN_IZ2),
+    (31008, "iz2", poll_plan.WHEN_IZ2),
+    (31009, "iz2", poll_plan.WHEN_IZ2),
+]
+
+CAPABILITY_ENUM = {
+    "none": "NONE",
+    "awl_thermostat": "AWL_THERMOSTAT",
+    "awl_axb": "AWL_AXB",
+    "awl_communicating": "AWL_COMMUNICATING",
+    "axb": "AXB",
+    "refrigeration": "REFRIGERATION",
+    "energy": "ENERGY",
+    "vs_drive": "VS_DRIVE",
+    "iz2": "IZ2",
+}
+WHEN_ENUM = {
+    poll_plan.WHEN_ALWAYS: "FixtureWhen::ALWAYS",
+    poll_plan.WHEN_IZ2: "FixtureWhen::IZ2",
+    poll_plan.WHEN_NO_IZ2: "FixtureWhen::NO_IZ2",
+}
+
+
+def main():
+    print("// Generated by gen_poll_plan_fixture.py, do not edit")
+    print("#pragma once")
+    print("enum class FixtureWhen { ALWAYS, IZ2, NO_IZ2 };")
+    print("struct FixtureListener {")
+    print("  uint16_t address;")
+    print("  esphome::waterfurnace::RegisterCapability capability;")
+    print("  FixtureWhen when;")
+    print("};")
+    entries = ",\n".join(
+        f"    {{{addr}, esphome::waterfurnace::RegisterCapability::{CAPABILITY_ENUM[cap]}, "
+        f"{WHEN_ENUM[when]}}}"
+        for addr, cap, when in LISTENERS
+    )
+    print(f"static const FixtureListener FIXTURE_LISTENERS[] = {{\n{entries}\n}};")
+    for prefix, adaptive in (("fixture", False), ("fixture_adaptive", True)):
+        plans, variants = poll_plan.plan_variants(LISTENERS, adaptive)
+        print(poll_plan.render_cpp(prefix, plans, variants))
+        print(f"static const size_t {prefix}_num_variants = {len(variants)};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,14 @@
+#pragma once
+
+// The hub and everything it links against, compiled into the including test
+// as one translation unit. Tests that drive the real hub include this rather
+// than listing the sources themselves (test_allocations builds the same list
+// as separate objects: HUB_SRCS in the Makefile).
+
+#include "../../components/waterfurnace/protocol.cpp"
+#include "../../components/waterfurnace/bus_sniffer.cpp"
+#include "../../components/waterfurnace/bus_capture.cpp"
+#include "../../components/waterfurnace/register_dump.cpp"
+#include "../../components/waterfurnace/freeze_frame.cpp"
+#include "../../components/waterfurnace/bus_task.cpp"
+#include "../../components/waterfurnace/waterfurnace.cpp"
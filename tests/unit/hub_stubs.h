@@ -22,12 +22,13 @@ void WaterFurnace::dump_config() {}
 
 void WaterFurnace::register_listener(uint16_t register_addr,
                                       std::function<void(uint16_t)> callback,
-                                      RegisterCapability capability) {
+                                      RegisterCapability capability, const EntityBase *) {
   listeners_.push_back({register_addr, std::move(callback), capability});
 }
 
-void WaterFurnace::write_register(uint16_t addr, uint16_t value) {
+bool WaterFurnace::write_register(uint16_t addr, uint16_t value) {
   written_registers.push_back({addr, value});
+  return true;
 }
 
 void WaterFurnace::dispatch_register_(uint16_t addr, uint16_t value) {
@@ -49,11 +50,11 @@ bool WaterFurnace::get_register(uint16_t addr, uint16_t &value) const {
 }
 
 // Stubs for protocol methods (not used by child component tests)
-void WaterFurnace::send_frame_(const std::vector<uint8_t> &) {}
+void WaterFurnace::send_frame_(const uint8_t *, size_t) {}
 bool WaterFurnace::read_frame_(std::vector<uint8_t> &) { return false; }
 void WaterFurnace::process_response_(const std::vector<uint8_t> &) {}
-void WaterFurnace::poll_next_group_() {}
-void WaterFurnace::process_pending_writes_() {}
+bool WaterFurnace::start_next_transaction_(uint32_t) { return false; }
+void WaterFurnace::complete_transaction_() {}
 void WaterFurnace::read_system_id_() {}
 void WaterFurnace::detect_components_() {}
 void WaterFurnace::build_poll_groups_() {}
@@ -0,0 +1,134 @@
+#pragma once
+
+// In-memory stand-in for ESPHome's socket component. A listener returned by
+// socket_ip() hands out whatever connections a test queues in pending_accept;
+// each connection reads from `rx` and appends what the code under test sends
+// to `tx`. Outgoing connections succeed at once unless `connect_pending` is
+// set, in which case they stay in progress until the test clears it.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+namespace esphome {
+namespace socket {
+
+class Socket {
+ public:
+  std::unique_ptr<Socket> accept(struct sockaddr *, socklen_t *) {
+    if (pending_accept.empty()) {
+      errno = EWOULDBLOCK;
+      return nullptr;
+    }
+    auto sock = std::move(pending_accept.front());
+    pending_accept.pop_front();
+    return sock;
+  }
+  int bind(const struct sockaddr *, socklen_t) { return bind_result; }
+  int connect(const struct sockaddr *, socklen_t) {
+    if (connect_pending) {
+      errno = EINPROGRESS;
+      return -1;
+    }
+    return 0;
+  }
+  int getpeername(struct sockaddr *, socklen_t *) {
+    if (connect_pending) {
+      errno = ENOTCONN;
+      return -1;
+    }
+    return 0;
+  }
+  int getsockopt(int, int optname, void *optval, socklen_t *) {
+    if (optname == SO_ERROR)
+      *static_cast<int *>(optval) = so_error;
+    return 0;
+  }
+  int listen(int backlog) {
+    this->backlog = backlog;
+    return 0;
+  }
+  int close();
+  int setblocking(bool blocking) {
+    this->blocking = blocking;
+    return 0;
+  }
+  int setsockopt(int, int, const void *, socklen_t) { return 0; }
+  ssize_t read(void *buf, size_t len) {
+    if (rx.empty()) {
+      if (peer_closed)
+        return 0;
+      errno = EWOULDBLOCK;
+      return -1;
+    }
+    size_t n = std::min(len, rx.size());
+    for (size_t i = 0; i < n; i++) {
+      static_cast<uint8_t *>(buf)[i] = rx.front();
+      rx.pop_front();
+    }
+    return n;
+  }
+  ssize_t write(const void *buf, size_t len) {
+    auto *p = static_cast<const uint8_t *>(buf);
+    tx.insert(tx.end(), p, p + len);
+    return len;
+  }
+
+  std::deque<std::unique_ptr<Socket>> pending_accept;
+  std::deque<uint8_t> rx;
+  std::vector<uint8_t> tx;
+  bool peer_closed{false};
+  bool closed{false};
+  bool blocking{true};
+  int backlog{0};
+  int bind_result{0};
+  bool connect_pending{false};
+  int so_error{0};
+};
+
+// The most recent socket_ip() result, so tests can reach sockets the code under test creates
+inline Socket *last_socket = nullptr;
+inline int sockets_created = 0;
+// Sockets the code under test closes are usually freed right after, so count closes here
+inline int sockets_closed = 0;
+
+inline int Socket::close() {
+  closed = true;
+  sockets_closed++;
+  return 0;
+}
+// Applied to every socket socket_ip() creates
+inline bool next_connect_pending = false;
+
+inline std::unique_ptr<Socket> socket_ip(int, int) {
+  auto sock = std::make_unique<Socket>();
+  sock->connect_pending = next_connect_pending;
+  last_socket = sock.get();
+  sockets_created++;
+  return sock;
+}
+
+inline socklen_t set_sockaddr(struct sockaddr *addr, socklen_t addrlen, const std::string &ip_address,
+                              uint16_t port) {
+  if (ip_address.empty())
+    return 0;
+  std::memset(addr, 0, addrlen);
+  return addrlen;
+}
+
+inline socklen_t set_sockaddr_any(struct sockaddr *addr, socklen_t addrlen, uint16_t port) {
+  std::memset(addr, 0, addrlen);
+  return addrlen;
+}
+
+}  // namespace socket
+}  // namespace esphome
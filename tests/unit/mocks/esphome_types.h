@@ -9,34 +9,40 @@
 #include <string>
 #include <vector>
 
-// Controllable millis for testing
+// Controllable millis/micros for testing
 inline uint32_t mock_millis = 0;
+inline uint32_t mock_micros = 0;
 
 namespace esphome {
 
 inline uint32_t millis() { return mock_millis; }
+inline uint32_t micros() { return mock_micros; }
 inline void delay(uint32_t) {}
 
 template<typename T>
 using optional = std::optional<T>;
 
 // Logging macros - no-ops
-#define ESP_LOGCONFIG(tag, fmt, ...)
-#define ESP_LOGI(tag, fmt, ...)
-#define ESP_LOGW(tag, fmt, ...)
-#define ESP_LOGD(tag, fmt, ...)
-#define ESP_LOGE(tag, fmt, ...)
-#define ESP_LOGV(tag, fmt, ...)
+// Arguments are still evaluated so values that only feed log lines count as used
+inline void mock_log(const char *, ...) {}
+#define ESP_LOGCONFIG(tag, fmt, ...) ::esphome::mock_log(fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ::esphome::mock_log(fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ::esphome::mock_log(fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ::esphome::mock_log(fmt, ##__VA_ARGS__)
+#define ESP_LOGE(tag, fmt, ...) ::esphome::mock_log(fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) ::esphome::mock_log(fmt, ##__VA_ARGS__)
 #define YESNO(x) ((x) ? "YES" : "NO")
 #define LOG_PIN(prefix, pin)
 
 inline std::string format_hex_pretty(const std::vector<uint8_t> &v) { return ""; }
+inline std::string format_hex_pretty(const uint8_t *data, size_t len) { return ""; }
 
 namespace setup_priority {
 static constexpr float HARDWARE = 100.0f;
 static constexpr float BUS = 90.0f;
 static constexpr float DATA = 50.0f;
 static constexpr float PROCESSOR = 10.0f;
+static constexpr float AFTER_WIFI = 5.0f;
 static constexpr float LATE = -100.0f;
 }  // namespace setup_priority
 
@@ -62,12 +68,21 @@ class Component {
   virtual void loop() {}
   virtual void dump_config() {}
   virtual float get_setup_priority() const { return 0.0f; }
+  void mark_failed() { failed_ = true; }
+  bool is_failed() const { return failed_; }
+
+ protected:
+  bool failed_{false};
 };
 
 class PollingComponent : public Component {
  public:
   virtual void update() {}
-  void set_update_interval(uint32_t interval) {}
+  void set_update_interval(uint32_t interval) { update_interval_ = interval; }
+  uint32_t get_update_interval() const { return update_interval_; }
+
+ protected:
+  uint32_t update_interval_{10000};
 };
 
 namespace sensor {
@@ -148,6 +163,7 @@ enum ClimatePreset : uint8_t {
 constexpr uint32_t CLIMATE_SUPPORTS_CURRENT_TEMPERATURE = 1 << 0;
 constexpr uint32_t CLIMATE_SUPPORTS_TWO_POINT_TARGET_TEMPERATURE = 1 << 1;
 constexpr uint32_t CLIMATE_REQUIRES_TWO_POINT_TARGET_TEMPERATURE = 1 << 2;
+constexpr uint32_t CLIMATE_SUPPORTS_CURRENT_HUMIDITY = 1 << 3;
 
 class ClimateTraits {
  public:
@@ -207,6 +223,7 @@ class Climate : public EntityBase {
  public:
   ClimateMode mode{CLIMATE_MODE_OFF};
   float current_temperature{NAN};
+  float current_humidity{NAN};
   float target_temperature{NAN};
   float target_temperature_low{NAN};
   float target_temperature_high{NAN};
@@ -243,12 +260,31 @@ class Climate : public EntityBase {
 }  // namespace climate
 
 namespace uart {
+
+// Tests attach a backend to simulate the device on the other end of the bus.
+// Without one the UART is silent and writes are discarded.
+class UARTMockBackend {
+ public:
+  virtual ~UARTMockBackend() = default;
+  virtual void on_write(const uint8_t *data, size_t len) {}
+  virtual size_t available() { return 0; }
+  virtual bool read_byte(uint8_t *data) { return false; }
+};
+
 class UARTDevice {
  public:
-  bool available() { return false; }
-  bool read_byte(uint8_t *data) { return false; }
-  void write_array(const uint8_t *data, size_t len) {}
+  void set_mock_backend(UARTMockBackend *backend) { mock_backend_ = backend; }
+
+  size_t available() { return mock_backend_ != nullptr ? mock_backend_->available() : 0; }
+  bool read_byte(uint8_t *data) { return mock_backend_ != nullptr && mock_backend_->read_byte(data); }
+  void write_array(const uint8_t *data, size_t len) {
+    if (mock_backend_ != nullptr)
+      mock_backend_->on_write(data, len);
+  }
   void flush() {}
+
+ protected:
+  UARTMockBackend *mock_backend_{nullptr};
 };
 }  // namespace uart
 
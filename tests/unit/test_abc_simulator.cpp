@@ -0,0 +1,195 @@
+// Unit tests for the simulated ABC, and a hub poll cycle timed against it
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "../sim/abc_simulator.cpp"
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+using namespace esphome::waterfurnace::sim;
+
+static const char *const FIXTURE = "../fixtures/sample_registers.yml";
+
+class AbcSimulatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { SimClock::reset(); }
+
+  // Everything the simulator sends, once the line has gone quiet
+  std::vector<uint8_t> respond(const std::vector<uint8_t> &request) {
+    sim_.on_write(request.data(), request.size());
+    SimClock::advance_to_us(sim_.line_free_at_us());
+    std::vector<uint8_t> out;
+    uint8_t b;
+    while (sim_.read_byte(&b))
+      out.push_back(b);
+    return out;
+  }
+
+  AbcSimulator sim_;
+};
+
+TEST_F(AbcSimulatorTest, LoadsTheFixture) {
+  ASSERT_TRUE(sim_.load_fixture(FIXTURE));
+  EXPECT_EQ(sim_.read(2), 705);                     // ABC version
+  EXPECT_EQ(sim_.read(REG_ABC_PROGRAM), 0x4142);    // "AB"
+  EXPECT_EQ(sim_.read(REG_HEATING_SETPOINT), 680);
+  EXPECT_EQ(sim_.read(REG_ENTERING_WATER), 450);
+  EXPECT_FALSE(sim_.load_fixture("no-such-file.yml"));
+}
+
+TEST_F(AbcSimulatorTest, ByteTimingAt19200Even) {
+  // 11 bits per character at 19200 baud
+  EXPECT_EQ(sim_.timing.wire_time_us(1), 573u);
+  EXPECT_EQ(sim_.timing.wire_time_us(96), 55000u);
+
+  sim_.registers[REG_HEATING_SETPOINT] = 680;
+  sim_.timing.processing_delay_us = 5000;
+  auto request = build_read_registers_request({REG_HEATING_SETPOINT});  // 6 bytes
+  sim_.on_write(request.data(), request.size());
+  uint64_t first_byte = sim_.timing.wire_time_us(6) + 5000 + sim_.timing.wire_time_us(1);
+
+  SimClock::reset(first_byte - 1);
+  EXPECT_EQ(sim_.available(), 0u);
+  SimClock::reset(first_byte);
+  EXPECT_EQ(sim_.available(), 1u);
+  // Seven bytes: address, function, byte count, one value, CRC
+  SimClock::reset(sim_.timing.wire_time_us(6) + 5000 + sim_.timing.wire_time_us(7));
+  EXPECT_EQ(sim_.available(), 7u);
+  EXPECT_TRUE(sim_.idle() == false);
+  EXPECT_EQ(sim_.stats.busy_us, sim_.timing.wire_time_us(6) + sim_.timing.wire_time_us(7));
+}
+
+TEST_F(AbcSimulatorTest, ProcessingTimeScalesWithRegisters) {
+  sim_.timing.processing_delay_us = 1000;
+  sim_.timing.per_register_us = 100;
+  auto request = build_read_ranges_request({{1100, 20}});
+  sim_.on_write(request.data(), request.size());
+  EXPECT_EQ(sim_.line_free_at_us(),
+            sim_.timing.wire_time_us(request.size()) + 1000 + 20 * 100 + sim_.timing.wire_time_us(3 + 40 + 2));
+}
+
+TEST_F(AbcSimulatorTest, AnswersAllFunctions) {
+  ASSERT_TRUE(sim_.load_fixture(FIXTURE));
+
+  auto resp = respond(build_read_ranges_request({{REG_ABC_PROGRAM, 4}, {REG_HEATING_SETPOINT, 1}}));
+  ASSERT_EQ(resp.size(), 3u + 10 + 2);
+  EXPECT_TRUE(validate_frame_crc(resp.data(), resp.size()));
+  EXPECT_EQ(resp[1], FUNC_READ_RANGES);
+  EXPECT_EQ(resp[2], 10);
+  auto values = parse_register_values(resp.data() + 3, resp[2]);
+  EXPECT_EQ(values, (std::vector<uint16_t>{0x4142, 0x4353, 0x504C, 0x5653, 680}));
+
+  resp = respond(build_read_registers_request({REG_ENTERING_WATER, 2}));
+  ASSERT_EQ(resp.size(), 3u + 4 + 2);
+  EXPECT_EQ(parse_register_values(resp.data() + 3, resp[2]), (std::vector<uint16_t>{450, 705}));
+
+  resp = respond(build_write_registers_request({{REG_WRITE_HEATING_SP, 700}, {REG_WRITE_COOLING_SP, 760}}));
+  EXPECT_EQ(resp.size(), 4u);
+  EXPECT_EQ(resp[1], FUNC_WRITE_REGISTERS);
+  EXPECT_EQ(sim_.read(REG_WRITE_HEATING_SP), 700);
+  EXPECT_EQ(sim_.read(REG_WRITE_COOLING_SP), 760);
+
+  auto request = build_write_single_request(400, 1);
+  resp = respond(request);
+  // Function 6 echoes the request
+  EXPECT_EQ(resp, request);
+  EXPECT_EQ(sim_.read(400), 1);
+  EXPECT_EQ(sim_.stats.requests, 4u);
+  EXPECT_EQ(sim_.stats.exceptions, 0u);
+}
+
+TEST_F(AbcSimulatorTest, Exceptions) {
+  sim_.registers[REG_HEATING_SETPOINT] = 680;
+  auto code = [this](const std::vector<uint8_t> &request) -> int {
+    auto resp = this->respond(request);
+    if (resp.size() != 5 || !validate_frame_crc(resp.data(), resp.size()) || !is_error_response(resp[1]))
+      return -1;
+    return resp[2];
+  };
+
+  std::vector<uint8_t> unknown = {SLAVE_ADDRESS, 0x03, 0x00, 0x00, 0x00, 0x01};
+  uint16_t crc = crc16(unknown.data(), unknown.size());
+  unknown.push_back(crc & 0xFF);
+  unknown.push_back(crc >> 8);
+  EXPECT_EQ(code(unknown), EXCEPTION_ILLEGAL_FUNCTION);
+
+  sim_.illegal_addresses.insert(1300);
+  EXPECT_EQ(code(build_read_ranges_request({{1290, 20}})), EXCEPTION_ILLEGAL_ADDRESS);
+  EXPECT_EQ(code(build_read_registers_request({1300})), EXCEPTION_ILLEGAL_ADDRESS);
+  EXPECT_EQ(code(build_write_registers_request({{1300, 1}})), EXCEPTION_ILLEGAL_ADDRESS);
+  EXPECT_EQ(code(build_read_ranges_request({{0, 101}})), EXCEPTION_ILLEGAL_VALUE);
+
+  // Unknown registers read as 0 unless strict
+  EXPECT_EQ(code(build_read_registers_request({9999})), -1);
+  sim_.strict = true;
+  EXPECT_EQ(code(build_read_registers_request({9999})), EXCEPTION_ILLEGAL_ADDRESS);
+  EXPECT_EQ(code(build_read_registers_request({REG_HEATING_SETPOINT})), -1);
+
+  sim_.exception_next = 0x04;
+  EXPECT_EQ(code(build_read_registers_request({REG_HEATING_SETPOINT})), 0x04);
+  EXPECT_EQ(code(build_read_registers_request({REG_HEATING_SETPOINT})), -1);
+  EXPECT_EQ(sim_.stats.exceptions, 7u);
+}
+
+TEST_F(AbcSimulatorTest, IgnoresWhatARealSlaveWould) {
+  auto request = build_read_registers_request({REG_HEATING_SETPOINT});
+  request.back() ^= 1;
+  EXPECT_TRUE(respond(request).empty());
+  EXPECT_TRUE(respond(build_read_registers_request({REG_HEATING_SETPOINT}, 2)).empty());
+  EXPECT_EQ(sim_.stats.ignored, 2u);
+
+  // A request on top of a response still on the line is lost
+  request = build_read_registers_request({REG_HEATING_SETPOINT});
+  sim_.on_write(request.data(), request.size());
+  SimClock::advance_to_us(sim_.line_free_at_us() - 1);
+  sim_.on_write(request.data(), request.size());
+  EXPECT_EQ(sim_.stats.collisions, 1u);
+  EXPECT_EQ(sim_.stats.requests, 1u);
+}
+
+TEST_F(AbcSimulatorTest, TimesAHubPollCycle) {
+  ASSERT_TRUE(sim_.load_fixture(FIXTURE));
+  WaterFurnace hub;
+  hub.set_mock_backend(&sim_);
+  hub.set_update_interval(30000);
+  uint16_t ewt = 0, setpoint = 0;
+  hub.register_listener(REG_ENTERING_WATER, [&](uint16_t v) { ewt = v; }, RegisterCapability::AXB);
+  hub.register_listener(REG_HEATING_SETPOINT, [&](uint16_t v) { setpoint = v; },
+                        RegisterCapability::AWL_THERMOSTAT);
+  // Every register the fixture has, so the cycle takes several transactions
+  for (const auto &reg : sim_.registers)
+    hub.register_listener(reg.first, [](uint16_t) {});
+
+  auto run_until_idle = [&]() {
+    // Hub loop every 100 µs of virtual time, until the queue and dispatch backlog drain and the line is quiet
+    for (int i = 0; i < 200000; i++) {
+      hub.loop();
+      SimClock::advance_us(100);
+      if (hub.is_setup_complete() && hub.queue_depth() == 0 && hub.dispatch_backlog() == 0 && sim_.idle())
+        break;
+    }
+  };
+
+  hub.setup();
+  run_until_idle();
+  ASSERT_TRUE(hub.is_setup_complete());
+  EXPECT_EQ(hub.abc_program(), "ABCSPLVS");
+
+  SimStats before = sim_.stats;
+  uint64_t start = SimClock::now_us();
+  hub.update();
+  run_until_idle();
+  uint64_t cycle = SimClock::now_us() - start;
+  uint32_t requests = sim_.stats.requests - before.requests;
+  uint64_t busy = sim_.stats.busy_us - before.busy_us;
+
+  EXPECT_EQ(ewt, 450);
+  EXPECT_EQ(setpoint, 680);
+  ASSERT_GT(requests, 0u);
+  EXPECT_EQ(sim_.stats.exceptions, 0u);
+  EXPECT_EQ(hub.bus_stats().timeouts, 0u);
+  // Line time plus the ABC's turnaround per request, plus the hub's 5 ms inter-frame gap and loop granularity
+  uint64_t floor = busy + requests * sim_.timing.processing_delay_us;
+  EXPECT_GE(cycle, floor);
+  EXPECT_LE(cycle, floor + requests * 6000);
+}
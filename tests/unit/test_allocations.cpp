@@ -0,0 +1,243 @@
+// Heap allocations in steady-state polling, with every entity type registered.
+//
+// Global operator new/delete are replaced for this binary. While counting is
+// on, each allocation records a short backtrace; afterwards the allocations
+// are charged to the first frame in esphome:: code that is not a lambda or
+// std:: template, so the report names the hub or entity function responsible.
+// Heap churn on the ESP32 fragments memory over weeks of uptime, so the
+// polling path has a fixed per-cycle budget. The simulated ABC's own
+// allocations are reported but not charged to it.
+
+#include <gtest/gtest.h>
+#include "../../components/waterfurnace/waterfurnace.h"
+#include "../../components/waterfurnace/binary_sensor/waterfurnace_binary_sensor.h"
+#include "../../components/waterfurnace/climate/waterfurnace_climate.h"
+#include "../../components/waterfurnace/sensor/waterfurnace_sensor.h"
+#include "../../components/waterfurnace/switch/waterfurnace_switch.h"
+#include "../../components/waterfurnace/text_sensor/waterfurnace_text_sensor.h"
+#include "../sim/abc_simulator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <new>
+
+namespace alloc_trace {
+
+static const int DEPTH = 12;
+static const size_t MAX_RECORDS = 1 << 16;
+
+struct Record {
+  size_t size;
+  int depth;
+  void *frames[DEPTH];
+};
+
+static bool counting = false;
+static bool in_hook = false;
+static size_t allocations = 0;
+static size_t bytes = 0;
+static size_t records_used = 0;
+static Record records[MAX_RECORDS];
+
+static void *allocate(size_t size) {
+  void *p = malloc(size == 0 ? 1 : size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  if (counting && !in_hook) {
+    in_hook = true;
+    allocations++;
+    bytes += size;
+    if (records_used < MAX_RECORDS) {
+      Record &r = records[records_used++];
+      r.size = size;
+      r.depth = backtrace(r.frames, DEPTH);
+    }
+    in_hook = false;
+  }
+  return p;
+}
+
+static void start() {
+  // backtrace() loads the unwinder on first use, which allocates
+  void *warmup[2];
+  backtrace(warmup, 2);
+  allocations = bytes = records_used = 0;
+  counting = true;
+}
+
+static void stop() { counting = false; }
+
+static std::string demangle(void *addr) {
+  Dl_info info;
+  if (dladdr(addr, &info) == 0 || info.dli_sname == nullptr)
+    return "";
+  int status;
+  char *name = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+  std::string out = status == 0 ? name : info.dli_sname;
+  free(name);
+  return out;
+}
+
+// The first frame that is hub or entity code rather than a library template
+static std::string call_site(const Record &r) {
+  for (int i = 1; i < r.depth; i++) {
+    std::string name = demangle(r.frames[i]);
+    if (name.compare(0, 9, "esphome::") != 0 || name.find("{lambda") != std::string::npos)
+      continue;
+    size_t paren = name.find('(');
+    return paren == std::string::npos ? name : name.substr(0, paren);
+  }
+  return "(outside esphome::)";
+}
+
+struct Site {
+  std::string name;
+  size_t count{0};
+  size_t bytes{0};
+  bool simulator() const { return name.compare(0, 28, "esphome::waterfurnace::sim::") == 0; }
+};
+
+static std::vector<Site> by_call_site() {
+  std::map<std::string, Site> sites;
+  for (size_t i = 0; i < records_used; i++) {
+    std::string name = call_site(records[i]);
+    Site &site = sites[name];
+    site.name = name;
+    site.count++;
+    site.bytes += records[i].size;
+  }
+  std::vector<Site> out;
+  for (auto &entry : sites)
+    out.push_back(entry.second);
+  std::sort(out.begin(), out.end(), [](const Site &a, const Site &b) { return a.count > b.count; });
+  return out;
+}
+
+}  // namespace alloc_trace
+
+void *operator new(size_t size) { return alloc_trace::allocate(size); }
+void *operator new[](size_t size) { return alloc_trace::allocate(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+using namespace esphome::waterfurnace::sim;
+
+static const char *const FIXTURE = "../fixtures/sample_registers.yml";
+static const uint32_t INTERVAL = 10000;
+static const size_t CYCLES = 1000;
+// Allocations allowed per steady-state poll cycle
+static const double BUDGET_PER_CYCLE = 0;
+
+class AllocationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SimClock::reset();
+    ASSERT_TRUE(abc_.load_fixture(FIXTURE));
+    hub_.set_mock_backend(&abc_);
+    hub_.set_update_interval(INTERVAL);
+
+    // Every entity type, and both single and 32-bit sensors
+    add_sensor(REG_ENTERING_WATER, RegisterType::SIGNED_TENTHS, RegisterCapability::AXB);
+    add_sensor(REG_LEAVING_WATER, RegisterType::SIGNED_TENTHS, RegisterCapability::AXB);
+    add_sensor(740, RegisterType::SIGNED_TENTHS, RegisterCapability::NONE);
+    add_sensor(1146, RegisterType::UINT32, RegisterCapability::ENERGY);
+    add_sensor(1164, RegisterType::INT32, RegisterCapability::ENERGY);
+    add_sensor(3001, RegisterType::UNSIGNED, RegisterCapability::VS_DRIVE);
+    for (uint16_t mask : {0x01, 0x02, 0x08, 0x400}) {
+      auto sensor = std::make_unique<WaterFurnaceBinarySensor>();
+      sensor->set_parent(&hub_);
+      sensor->set_register_address(REG_SYSTEM_OUTPUTS);
+      sensor->set_bitmask(mask);
+      entities_.push_back(std::move(sensor));
+    }
+    for (const char *type : {"fault", "model", "serial", "mode", "outputs_at_lockout", "inputs_at_lockout"}) {
+      auto sensor = std::make_unique<WaterFurnaceTextSensor>();
+      sensor->set_parent(&hub_);
+      sensor->set_sensor_type(type);
+      entities_.push_back(std::move(sensor));
+    }
+    auto dhw = std::make_unique<WaterFurnaceSwitch>();
+    dhw->set_parent(&hub_);
+    dhw->set_register_address(400);
+    dhw->set_write_address(400);
+    dhw->set_capability(RegisterCapability::AXB);
+    entities_.push_back(std::move(dhw));
+    auto climate = std::make_unique<WaterFurnaceClimate>();
+    climate->set_parent(&hub_);
+    climate->set_zone(1);
+    entities_.push_back(std::move(climate));
+
+    hub_.setup();
+    for (auto &entity : entities_)
+      entity->setup();
+    for (int i = 0; i < 10000 && !hub_.is_setup_complete(); i++)
+      step();
+    ASSERT_TRUE(hub_.is_setup_complete());
+  }
+
+  void add_sensor(uint16_t addr, RegisterType type, RegisterCapability cap) {
+    auto sensor = std::make_unique<WaterFurnaceSensor>();
+    sensor->set_parent(&hub_);
+    sensor->set_register_address(addr);
+    sensor->set_register_type(type);
+    sensor->set_capability(cap);
+    entities_.push_back(std::move(sensor));
+  }
+
+  void step() {
+    hub_.loop();
+    for (auto &entity : entities_)
+      entity->loop();
+    SimClock::advance_us(1000);
+  }
+
+  void run_cycles(size_t n) {
+    for (size_t i = 0; i < n; i++) {
+      uint64_t next = SimClock::now_us() + INTERVAL * 1000ULL;
+      hub_.update();
+      while (!(hub_.queue_depth() == 0 && hub_.dispatch_backlog() == 0 && abc_.idle()) || SimClock::now_us() < next - INTERVAL * 500ULL)
+        step();
+      // Nothing happens on the bus for the rest of the interval
+      SimClock::advance_to_us(next);
+    }
+  }
+
+  AbcSimulator abc_;
+  WaterFurnace hub_;
+  std::vector<std::unique_ptr<Component>> entities_;
+};
+
+TEST_F(AllocationTest, SteadyStatePolling) {
+  // Warm up: first publishes, cache entries and buffer capacities
+  run_cycles(5);
+  uint32_t requests = abc_.stats.requests;
+
+  alloc_trace::start();
+  run_cycles(CYCLES);
+  alloc_trace::stop();
+
+  ASSERT_EQ(hub_.bus_stats().timeouts, 0u);
+  size_t counted = 0;
+  size_t counted_bytes = 0;
+  auto sites = alloc_trace::by_call_site();
+  for (const auto &site : sites) {
+    if (!site.simulator()) {
+      counted += site.count;
+      counted_bytes += site.bytes;
+    }
+  }
+  double per_cycle = static_cast<double>(counted) / CYCLES;
+  printf("[ allocs   ] %zu cycles, %u transactions: %zu allocations (%.2f per cycle), %zu bytes\n", CYCLES,
+         abc_.stats.requests - requests, counted, per_cycle, counted_bytes);
+  for (const auto &site : sites)
+    printf("[ allocs   ] %8zu x %8zu bytes  %s%s\n", site.count, site.bytes, site.name.c_str(),
+           site.simulator() ? "  (simulator, not counted)" : "");
+  EXPECT_LE(per_cycle, BUDGET_PER_CYCLE);
+}
@@ -0,0 +1,217 @@
+// Bus capture: the file format, the ring dropping its oldest records, and a
+// capture replayed through a second hub ending in the state of the first.
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "../sim/abc_simulator.cpp"
+#include "../sim/capture_replay.cpp"
+#include "../sim/fault_injection.cpp"
+
+#include <map>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+using namespace esphome::waterfurnace::sim;
+
+static const char *const FIXTURE = "../fixtures/sample_registers.yml";
+static const uint32_t INTERVAL = 10000;
+
+static std::vector<uint8_t> file_of(const BusCapture &capture) {
+  std::vector<uint8_t> file(capture.file_size());
+  EXPECT_EQ(capture.read(0, file.data(), file.size()), file.size());
+  return file;
+}
+
+static std::vector<CaptureReader::Entry> entries_of(const std::vector<uint8_t> &file) {
+  CaptureReader reader;
+  EXPECT_TRUE(reader.open(file.data(), file.size()));
+  std::vector<CaptureReader::Entry> entries;
+  CaptureReader::Entry entry;
+  while (reader.next(entry))
+    entries.push_back(entry);
+  return entries;
+}
+
+TEST(BusCaptureTest, DisabledWithoutBuffer) {
+  BusCapture capture;
+  capture.begin();
+  EXPECT_FALSE(capture.enabled());
+  const uint8_t frame[] = {1, 2, 3, 4};
+  capture.record(BusCapture::Record::TX, frame, sizeof(frame), 0, false);
+  EXPECT_EQ(capture.records(), 0u);
+}
+
+TEST(BusCaptureTest, RoundTrip) {
+  BusCapture capture;
+  capture.set_buffer_size(256);
+  capture.set_slave(3);
+  capture.begin();
+  const uint8_t request[] = {3, 65, 0, 88, 0, 4, 0x12, 0x34};
+  const uint8_t chunk[] = {3, 65, 8, 'A', 'B', 'C', 'V'};
+  capture.record(BusCapture::Record::TX, request, sizeof(request), 1000, true);
+  capture.record(BusCapture::Record::RX, chunk, sizeof(chunk), 1100, true);
+  capture.record(BusCapture::Record::TX, request, sizeof(request), 5000000, false);
+  capture.record(BusCapture::Record::RX, chunk, 3, 5000100, false);
+
+  auto file = file_of(capture);
+  // Type, one-byte delta and length per record, and the TIME record before the ring
+  EXPECT_EQ(file.size(), BusCapture::HEADER_SIZE + (3 + 8) + (3 + 7) + 7 + (3 + 8) + (3 + 3));
+  CaptureReader reader;
+  ASSERT_TRUE(reader.open(file.data(), file.size()));
+  EXPECT_EQ(reader.slave(), 3);
+
+  auto entries = entries_of(file);
+  ASSERT_EQ(entries.size(), 4u);
+  EXPECT_EQ(entries[0].type, BusCapture::Record::TX);
+  EXPECT_EQ(entries[1].type, BusCapture::Record::RX);
+  EXPECT_EQ(std::vector<uint8_t>(entries[0].data, entries[0].data + entries[0].len),
+            std::vector<uint8_t>(request, request + sizeof(request)));
+  EXPECT_EQ(entries[3].len, 3u);
+  // Times from the first record, across the jump from the setup frames to the ring
+  EXPECT_EQ(entries[0].at_us, 0u);
+  EXPECT_EQ(entries[1].at_us, 100u);
+  EXPECT_EQ(entries[2].at_us, 4999000u);
+  EXPECT_EQ(entries[3].at_us, 4999100u);
+}
+
+TEST(BusCaptureTest, RingDropsOldestRecords) {
+  BusCapture capture;
+  capture.set_buffer_size(64);
+  capture.begin();
+  // Across a micros() wrap
+  const uint32_t start = 0xFFFFF000;
+  uint8_t chunk[10] = {};
+  for (uint8_t i = 0; i < 20; i++) {
+    chunk[0] = i;
+    capture.record(BusCapture::Record::RX, chunk, sizeof(chunk), start + i * 1000u, false);
+  }
+  EXPECT_EQ(capture.records(), 20u);
+  EXPECT_GT(capture.dropped(), 0u);
+
+  auto entries = entries_of(file_of(capture));
+  ASSERT_EQ(entries.size(), 20u - capture.dropped());
+  EXPECT_EQ(entries.back().data[0], 19);
+  for (size_t i = 1; i < entries.size(); i++) {
+    EXPECT_EQ(entries[i].data[0], entries[i - 1].data[0] + 1);
+    EXPECT_EQ(entries[i].at_us - entries[i - 1].at_us, 1000u);
+  }
+}
+
+TEST(BusCaptureTest, SetupFramesAreKept) {
+  BusCapture capture;
+  capture.set_buffer_size(64);
+  capture.begin();
+  const uint8_t request[] = {1, 65, 0, 88, 0, 4, 0x12, 0x34};
+  capture.record(BusCapture::Record::TX, request, sizeof(request), 0, true);
+  capture.restart_setup();
+  capture.record(BusCapture::Record::TX, request, sizeof(request), 100, true);
+  uint8_t chunk[10] = {};
+  for (int i = 0; i < 20; i++)
+    capture.record(BusCapture::Record::RX, chunk, sizeof(chunk), 1000 + i * 1000, false);
+
+  auto entries = entries_of(file_of(capture));
+  ASSERT_GT(entries.size(), 1u);
+  EXPECT_EQ(entries[0].type, BusCapture::Record::TX);
+  EXPECT_EQ(entries[0].at_us, 0u);
+  EXPECT_EQ(entries[1].type, BusCapture::Record::RX);
+  EXPECT_EQ(entries.back().at_us, 20000u - 100u);
+}
+
+// A hub polling the simulator with a capture running, then a second hub fed the capture
+class CaptureReplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SimClock::reset();
+    ASSERT_TRUE(abc_.load_fixture(FIXTURE));
+  }
+
+  // Listeners on every register the fixture has; each value seen is kept per hub
+  void listen(WaterFurnace &hub, std::map<uint16_t, uint16_t> &seen, size_t &calls) {
+    for (const auto &reg : abc_.registers) {
+      uint16_t addr = reg.first;
+      hub.register_listener(addr, [addr, &seen, &calls](uint16_t value) {
+        seen[addr] = value;
+        calls++;
+      });
+    }
+  }
+
+  std::vector<uint8_t> record(size_t buffer_size, size_t cycles) {
+    WaterFurnace hub;
+    hub.set_mock_backend(&abc_);
+    hub.set_update_interval(INTERVAL);
+    hub.set_capture_buffer_size(buffer_size);
+    listen(hub, recorded_, recorded_calls_);
+    hub.setup();
+    for (int i = 0; i < 10000 && !hub.is_setup_complete(); i++) {
+      hub.loop();
+      SimClock::advance_us(1000);
+    }
+    EXPECT_TRUE(hub.is_setup_complete());
+    for (size_t i = 0; i < cycles; i++) {
+      hub.update();
+      for (uint64_t end = SimClock::now_us() + INTERVAL * 1000ULL; SimClock::now_us() < end;) {
+        hub.loop();
+        SimClock::advance_us(1000);
+      }
+    }
+    model_ = hub.model_number();
+    crc_errors_ = hub.bus_stats().crc_errors;
+    timeouts_ = hub.bus_stats().timeouts;
+    return file_of(hub.capture());
+  }
+
+  ReplayStats replay(const std::vector<uint8_t> &file, ReplayHub &hub) {
+    SimClock::reset(1000000000);
+    EXPECT_TRUE(replay_.load(file));
+    hub.set_transport(&replay_);
+    hub.set_update_interval(INTERVAL);
+    listen(hub, replayed_, replayed_calls_);
+    hub.setup();
+    return replay_.run(hub, [&hub]() { hub.loop(); }, 1000);
+  }
+
+  FaultyAbcSimulator abc_;
+  CaptureReplay replay_;
+  std::map<uint16_t, uint16_t> recorded_, replayed_;
+  size_t recorded_calls_{0}, replayed_calls_{0};
+  std::string model_;
+  uint32_t crc_errors_{0}, timeouts_{0};
+};
+
+TEST_F(CaptureReplayTest, ReplayReachesTheSameState) {
+  abc_.inject(4, Fault::BAD_CRC);
+  abc_.inject(7, Fault::TRUNCATED);
+  auto file = record(16384, 4);
+  ASSERT_EQ(crc_errors_, 1u);
+  ASSERT_EQ(timeouts_, 2u);
+
+  ReplayHub hub;
+  ReplayStats stats = replay(file, hub);
+  EXPECT_TRUE(hub.is_setup_complete());
+  EXPECT_EQ(hub.model_number(), model_);
+  EXPECT_EQ(stats.tx_frames, abc_.stats.requests);
+  EXPECT_EQ(replayed_, recorded_);
+  EXPECT_EQ(replayed_calls_, recorded_calls_);
+  EXPECT_EQ(stats.dispatch_calls, recorded_calls_);
+  // The line faults come back out of the capture
+  EXPECT_EQ(hub.bus_stats().crc_errors, crc_errors_);
+  EXPECT_EQ(hub.bus_stats().timeouts, timeouts_);
+  // Four cycles of 10 s, give or take the setup exchange
+  EXPECT_GT(stats.duration_us, 3ULL * INTERVAL * 1000);
+  EXPECT_LT(stats.duration_us, 5ULL * INTERVAL * 1000);
+}
+
+TEST_F(CaptureReplayTest, WrappedRingReplaysFromSetup) {
+  auto file = record(1024, 30);
+  ASSERT_LT(file.size(), 1024u + BusCapture::SETUP_SIZE + 32);
+
+  ReplayHub hub;
+  ReplayStats stats = replay(file, hub);
+  EXPECT_TRUE(hub.is_setup_complete());
+  EXPECT_EQ(hub.model_number(), model_);
+  EXPECT_LT(stats.tx_frames, abc_.stats.requests);
+  // The last cycles are in the ring, so every register ends at its last value
+  EXPECT_EQ(replayed_, recorded_);
+  EXPECT_EQ(hub.bus_stats().crc_errors, 0u);
+}
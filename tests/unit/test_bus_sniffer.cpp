@@ -0,0 +1,113 @@
+// Unit tests for the passive bus decoder (BusSniffer)
+
+#include <gtest/gtest.h>
+#include "../../components/waterfurnace/protocol.cpp"
+#include "../../components/waterfurnace/bus_sniffer.cpp"
+#include "fake_abc.h"
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+
+class BusSnifferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    abc_.registers[30] = 0x0101;
+    abc_.registers[31] = 0x0202;
+    abc_.registers[32] = 0x0303;
+    abc_.registers[745] = 680;
+    abc_.registers[1110] = 500;
+  }
+
+  // Bytes another master's request and the ABC's answer put on the line
+  std::vector<uint8_t> exchange(const std::vector<uint8_t> &request) {
+    std::vector<uint8_t> line(request);
+    abc_.on_write(request.data(), request.size());
+    line.insert(line.end(), abc_.rx.begin(), abc_.rx.end());
+    abc_.rx.clear();
+    return line;
+  }
+
+  // Feed everything and collect the values of every decoded pair
+  std::vector<std::pair<uint16_t, uint16_t>> feed_all(const std::vector<uint8_t> &bytes, uint32_t now = 0) {
+    std::vector<std::pair<uint16_t, uint16_t>> seen;
+    for (bool decoded = sniffer_.feed(bytes.data(), bytes.size(), now); decoded;
+         decoded = sniffer_.feed(nullptr, 0, now))
+      seen.insert(seen.end(), sniffer_.values().begin(), sniffer_.values().end());
+    return seen;
+  }
+
+  using Values = std::vector<std::pair<uint16_t, uint16_t>>;
+  FakeABC abc_;
+  BusSniffer sniffer_;
+};
+
+TEST_F(BusSnifferTest, DecodesReadRangesPair) {
+  auto seen = feed_all(exchange(build_read_ranges_request({{30, 3}, {1110, 1}})));
+  EXPECT_EQ(seen, (Values{{30, 0x0101}, {31, 0x0202}, {32, 0x0303}, {1110, 500}}));
+  EXPECT_EQ(sniffer_.frames(), 1u);
+}
+
+TEST_F(BusSnifferTest, DecodesReadRegistersPair) {
+  auto seen = feed_all(exchange(build_read_registers_request({745, 31})));
+  EXPECT_EQ(seen, (Values{{745, 680}, {31, 0x0202}}));
+}
+
+TEST_F(BusSnifferTest, WritesCarryTheirValues) {
+  auto seen = feed_all(exchange(build_write_registers_request({{340, 1}, {341, 2}})));
+  EXPECT_EQ(seen, (Values{{340, 1}, {341, 2}}));
+  seen = feed_all(exchange(build_write_single_request(745, 700)));
+  EXPECT_EQ(seen, (Values{{745, 700}}));
+}
+
+TEST_F(BusSnifferTest, DecodesByteByByte) {
+  auto line = exchange(build_read_ranges_request({{30, 2}}));
+  auto more = exchange(build_read_registers_request({1110}));
+  line.insert(line.end(), more.begin(), more.end());
+  Values seen;
+  for (uint8_t b : line) {
+    for (bool decoded = sniffer_.feed(&b, 1, 0); decoded; decoded = sniffer_.feed(nullptr, 0, 0))
+      seen.insert(seen.end(), sniffer_.values().begin(), sniffer_.values().end());
+  }
+  EXPECT_EQ(seen, (Values{{30, 0x0101}, {31, 0x0202}, {1110, 500}}));
+  EXPECT_EQ(sniffer_.dropped_bytes(), 0u);
+}
+
+TEST_F(BusSnifferTest, ExceptionEndsThePair) {
+  abc_.exception_next = true;
+  EXPECT_TRUE(feed_all(exchange(build_read_registers_request({745}))).empty());
+  EXPECT_EQ(sniffer_.exceptions(), 1u);
+  EXPECT_EQ(feed_all(exchange(build_read_registers_request({745}))), (Values{{745, 680}}));
+}
+
+TEST_F(BusSnifferTest, IgnoresOtherSlaves) {
+  auto line = build_read_registers_request({745}, 2);
+  line.push_back(0x02);  // Partial answer from unit 2
+  auto ours = exchange(build_read_registers_request({1110}));
+  line.insert(line.end(), ours.begin(), ours.end());
+  EXPECT_EQ(feed_all(line), (Values{{1110, 500}}));
+}
+
+TEST_F(BusSnifferTest, SkipsResponseWithoutRequest) {
+  // Listening started mid-transaction: only the response was heard
+  auto first = exchange(build_read_ranges_request({{30, 3}}));
+  std::vector<uint8_t> line(first.begin() + 8, first.end());
+  auto next = exchange(build_read_registers_request({1110}));
+  line.insert(line.end(), next.begin(), next.end());
+  EXPECT_EQ(feed_all(line), (Values{{1110, 500}}));
+}
+
+TEST_F(BusSnifferTest, ResyncsAfterGarbage) {
+  std::vector<uint8_t> line = {0x01, 0x41, 0x99, 0x13, 0x01, 0x37};
+  auto pair = exchange(build_read_registers_request({745}));
+  EXPECT_TRUE(feed_all(line, 0).empty());
+  // The noise never completes a frame; the silence before the next exchange drops it
+  EXPECT_EQ(feed_all(pair, BusSniffer::RESYNC_TIME + 1), (Values{{745, 680}}));
+  EXPECT_EQ(sniffer_.dropped_bytes(), line.size());
+}
+
+TEST_F(BusSnifferTest, UnansweredRequestIsReplaced) {
+  auto lost = build_read_ranges_request({{30, 3}});
+  auto line = exchange(build_read_registers_request({745}));
+  line.insert(line.begin(), lost.begin(), lost.end());
+  EXPECT_EQ(feed_all(line), (Values{{745, 680}}));
+}
@@ -0,0 +1,285 @@
+// Unit tests for the SPSC ring buffer and the dedicated bus I/O task
+
+#include <gtest/gtest.h>
+#include "../../components/waterfurnace/protocol.cpp"
+#include "../../components/waterfurnace/bus_capture.cpp"
+#include "../../components/waterfurnace/register_dump.cpp"
+#include "../../components/waterfurnace/freeze_frame.cpp"
+#include "../../components/waterfurnace/bus_task.cpp"
+
+#include <chrono>
+#include <deque>
+#include <thread>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+
+// ====== SpscQueue ======
+
+TEST(SpscQueue, FifoOrder) {
+  SpscQueue<int, 4> q;
+  EXPECT_TRUE(q.empty());
+  EXPECT_TRUE(q.push(1));
+  EXPECT_TRUE(q.push(2));
+  EXPECT_TRUE(q.push(3));
+  EXPECT_EQ(q.size(), 3u);
+
+  int v;
+  ASSERT_TRUE(q.pop(v));
+  EXPECT_EQ(v, 1);
+  ASSERT_TRUE(q.pop(v));
+  EXPECT_EQ(v, 2);
+  ASSERT_TRUE(q.pop(v));
+  EXPECT_EQ(v, 3);
+  EXPECT_FALSE(q.pop(v));
+}
+
+TEST(SpscQueue, FullRejectsPush) {
+  SpscQueue<int, 4> q;
+  for (int i = 0; i < 4; i++)
+    EXPECT_TRUE(q.push(i));
+  EXPECT_FALSE(q.push(99));
+  EXPECT_EQ(q.size(), 4u);
+
+  int v;
+  ASSERT_TRUE(q.pop(v));
+  EXPECT_EQ(v, 0);
+  EXPECT_TRUE(q.push(4));
+}
+
+TEST(SpscQueue, WrapsAround) {
+  SpscQueue<uint32_t, 2> q;
+  uint32_t v;
+  for (uint32_t i = 0; i < 100; i++) {
+    ASSERT_TRUE(q.push(i));
+    ASSERT_TRUE(q.pop(v));
+    EXPECT_EQ(v, i);
+  }
+}
+
+TEST(SpscQueue, ConcurrentStressNoLossInOrder) {
+  static constexpr uint32_t COUNT = 1000000;
+  SpscQueue<uint32_t, 8> q;
+
+  std::thread producer([&q]() {
+    for (uint32_t i = 0; i < COUNT; i++) {
+      while (!q.push(i))
+        std::this_thread::yield();
+    }
+  });
+
+  uint32_t expected = 0;
+  bool in_order = true;
+  while (expected < COUNT) {
+    uint32_t v;
+    if (q.pop(v)) {
+      if (v != expected)
+        in_order = false;
+      expected++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(expected, COUNT);
+  EXPECT_TRUE(q.empty());
+}
+
+// ====== BusTask ======
+
+// Answers func 65 requests with value = address ^ 0x5A5A for every register.
+// Only the bus task thread touches this after start().
+class EchoABC : public uart::UARTMockBackend {
+ public:
+  void on_write(const uint8_t *data, size_t len) override {
+    writes++;
+    if (len < 4 || data[1] != FUNC_READ_RANGES)
+      return;
+    std::vector<uint8_t> resp = {data[0], FUNC_READ_RANGES, 0};
+    for (size_t i = 2; i + 4 <= len - 2; i += 4) {
+      uint16_t start = (data[i] << 8) | data[i + 1];
+      uint16_t count = (data[i + 2] << 8) | data[i + 3];
+      for (uint16_t j = 0; j < count; j++) {
+        uint16_t val = (start + j) ^ 0x5A5A;
+        resp.push_back(val >> 8);
+        resp.push_back(val & 0xFF);
+      }
+    }
+    resp[2] = resp.size() - 3;
+    uint16_t crc = crc16(resp.data(), resp.size());
+    resp.push_back(crc & 0xFF);
+    resp.push_back(crc >> 8);
+    if (corrupt_next) {
+      resp[3] ^= 0xFF;
+      corrupt_next = false;
+    }
+    rx.insert(rx.end(), resp.begin(), resp.end());
+    if (trailing_garbage)
+      rx.push_back(0xEE);
+  }
+  size_t available() override {
+    if (rx.empty())
+      return 0;
+    // Trickle mode: expose one byte at a time to exercise partial frames
+    return trickle ? 1 : rx.size();
+  }
+  bool read_byte(uint8_t *b) override {
+    if (rx.empty())
+      return false;
+    *b = rx.front();
+    rx.pop_front();
+    return true;
+  }
+
+  std::deque<uint8_t> rx;
+  size_t writes{0};
+  bool trickle{false};
+  bool trailing_garbage{false};
+  bool corrupt_next{false};
+};
+
+class BusTaskTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_millis = 0;
+    uart_.set_mock_backend(&abc_);
+  }
+
+  // Poll until a response arrives (real time, bounded)
+  bool wait_response(BusTask &task, BusResponse &resp) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+      if (task.poll(resp))
+        return true;
+      std::this_thread::yield();
+    }
+    return false;
+  }
+
+  static uint16_t first_value(const BusResponse &resp) { return (resp.data[3] << 8) | resp.data[4]; }
+
+  uart::UARTDevice uart_;
+  EchoABC abc_;
+};
+
+TEST_F(BusTaskTest, SingleTransaction) {
+  BusTask task(&uart_, nullptr, 2000);
+  ASSERT_TRUE(task.start(0));
+
+  ASSERT_TRUE(task.submit(1, build_read_ranges_request({{19, 2}})));
+  BusResponse resp;
+  ASSERT_TRUE(wait_response(task, resp));
+  task.stop();
+
+  EXPECT_EQ(resp.seq, 1u);
+  EXPECT_EQ(resp.status, BusResponse::Status::OK);
+  ASSERT_EQ(resp.len, 3u + 4u + 2u);
+  EXPECT_EQ(resp.data[1], FUNC_READ_RANGES);
+  auto values = parse_register_values(resp.data + 3, resp.data[2]);
+  ASSERT_EQ(values.size(), 2u);
+  EXPECT_EQ(values[0], 19 ^ 0x5A5A);
+  EXPECT_EQ(values[1], 20 ^ 0x5A5A);
+}
+
+TEST_F(BusTaskTest, PartialFramesReassembled) {
+  abc_.trickle = true;
+  BusTask task(&uart_, nullptr, 2000);
+  ASSERT_TRUE(task.start(0));
+
+  ASSERT_TRUE(task.submit(7, build_read_ranges_request({{1100, 20}})));
+  BusResponse resp;
+  ASSERT_TRUE(wait_response(task, resp));
+  task.stop();
+
+  EXPECT_EQ(resp.status, BusResponse::Status::OK);
+  EXPECT_EQ(resp.len, 3u + 40u + 2u);
+}
+
+TEST_F(BusTaskTest, CrcErrorReported) {
+  abc_.corrupt_next = true;
+  BusTask task(&uart_, nullptr, 2000);
+  ASSERT_TRUE(task.start(0));
+
+  ASSERT_TRUE(task.submit(3, build_read_ranges_request({{30, 1}})));
+  BusResponse resp;
+  ASSERT_TRUE(wait_response(task, resp));
+  EXPECT_EQ(resp.seq, 3u);
+  EXPECT_EQ(resp.status, BusResponse::Status::CRC_ERROR);
+
+  // The next transaction is unaffected
+  ASSERT_TRUE(task.submit(4, build_read_ranges_request({{30, 1}})));
+  ASSERT_TRUE(wait_response(task, resp));
+  task.stop();
+  EXPECT_EQ(resp.seq, 4u);
+  EXPECT_EQ(resp.status, BusResponse::Status::OK);
+}
+
+TEST_F(BusTaskTest, TrailingGarbageDiscardedBetweenTransactions) {
+  abc_.trailing_garbage = true;
+  BusTask task(&uart_, nullptr, 2000);
+  ASSERT_TRUE(task.start(0));
+
+  BusResponse resp;
+  for (uint32_t seq = 1; seq <= 5; seq++) {
+    ASSERT_TRUE(task.submit(seq, build_read_ranges_request({{static_cast<uint16_t>(seq * 10), 1}})));
+    ASSERT_TRUE(wait_response(task, resp));
+    EXPECT_EQ(resp.seq, seq);
+    EXPECT_EQ(resp.status, BusResponse::Status::OK);
+    EXPECT_EQ(first_value(resp), (seq * 10) ^ 0x5A5A);
+  }
+  task.stop();
+}
+
+TEST_F(BusTaskTest, SubmitRejectsWhenQueueFull) {
+  // Not started: nothing drains the request queue
+  BusTask task(&uart_, nullptr, 2000);
+  auto frame = build_read_ranges_request({{30, 1}});
+  for (size_t i = 0; i < BusTask::QUEUE_DEPTH; i++)
+    EXPECT_TRUE(task.submit(i, frame));
+  EXPECT_FALSE(task.submit(99, frame));
+  EXPECT_EQ(task.pending_requests(), BusTask::QUEUE_DEPTH);
+}
+
+TEST_F(BusTaskTest, StressPipelinedOrderingAndLoss) {
+  static constexpr uint32_t COUNT = 5000;
+  BusTask task(&uart_, nullptr, 2000);
+  ASSERT_TRUE(task.start(0));
+
+  uint32_t next_submit = 1;
+  uint32_t next_expected = 1;
+  bool in_order = true;
+  bool payload_ok = true;
+  bool all_ok = true;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+  while (next_expected <= COUNT && std::chrono::steady_clock::now() < deadline) {
+    // Keep the request queue as full as it will go
+    while (next_submit <= COUNT) {
+      uint16_t addr = next_submit & 0x7FFF;
+      if (!task.submit(next_submit, build_read_ranges_request({{addr, 1}})))
+        break;
+      next_submit++;
+    }
+
+    BusResponse resp;
+    while (task.poll(resp)) {
+      if (resp.seq != next_expected)
+        in_order = false;
+      if (resp.status != BusResponse::Status::OK)
+        all_ok = false;
+      else if (first_value(resp) != ((resp.seq & 0x7FFF) ^ 0x5A5A))
+        payload_ok = false;
+      next_expected = resp.seq + 1;
+    }
+    std::this_thread::yield();
+  }
+  task.stop();
+
+  EXPECT_EQ(next_expected, COUNT + 1) << "responses lost";
+  EXPECT_TRUE(in_order);
+  EXPECT_TRUE(all_ok);
+  EXPECT_TRUE(payload_ok);
+  EXPECT_EQ(abc_.writes, COUNT);
+}
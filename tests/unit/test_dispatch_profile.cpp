@@ -0,0 +1,96 @@
+// Unit tests for per-listener dispatch profiling (compile-time opt-in).
+// Callbacks advance mock_micros by a fixed cost so the timings are exact.
+
+#define USE_WATERFURNACE_DISPATCH_PROFILING
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "fake_abc.h"
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+
+class ProfiledHub : public WaterFurnace {
+ public:
+  using WaterFurnace::dispatch_register_;
+};
+
+static std::function<void(uint16_t)> costs(uint32_t us) {
+  return [us](uint16_t) { mock_micros += us; };
+}
+
+static const RegisterListener &find(const ProfiledHub &hub, const EntityBase *owner, uint16_t addr) {
+  for (const auto &listener : hub.listeners()) {
+    if (listener.owner == owner && listener.address == addr)
+      return listener;
+  }
+  throw std::runtime_error("listener not found");
+}
+
+TEST(DispatchProfileTest, RecordsMaxAndTotalPerListener) {
+  ProfiledHub hub;
+  sensor::Sensor slow, fast;
+  slow.set_name("Slow");
+  fast.set_name("Fast");
+  uint32_t slow_cost = 800;
+  hub.register_listener(REG_LINE_VOLTAGE, [&slow_cost](uint16_t) { mock_micros += slow_cost; },
+                        RegisterCapability::NONE, &slow);
+  hub.register_listener(REG_LINE_VOLTAGE, costs(50), RegisterCapability::NONE, &fast);
+
+  hub.dispatch_register_(REG_LINE_VOLTAGE, 240);
+  slow_cost = 200;
+  hub.dispatch_register_(REG_LINE_VOLTAGE, 241);
+
+  const auto &s = find(hub, &slow, REG_LINE_VOLTAGE).profile;
+  EXPECT_EQ(s.calls, 2u);
+  EXPECT_EQ(s.max_us, 800u);
+  EXPECT_EQ(s.total_us, 1000u);
+  const auto &f = find(hub, &fast, REG_LINE_VOLTAGE).profile;
+  EXPECT_EQ(f.calls, 2u);
+  EXPECT_EQ(f.max_us, 50u);
+  EXPECT_EQ(f.total_us, 100u);
+}
+
+TEST(DispatchProfileTest, ListenersOnOtherRegistersUntouched) {
+  ProfiledHub hub;
+  sensor::Sensor a, b;
+  hub.register_listener(REG_LINE_VOLTAGE, costs(10), RegisterCapability::NONE, &a);
+  hub.register_listener(REG_DHW_SETPOINT, costs(10), RegisterCapability::NONE, &b);
+  hub.dispatch_register_(REG_LINE_VOLTAGE, 240);
+  EXPECT_EQ(find(hub, &a, REG_LINE_VOLTAGE).profile.calls, 1u);
+  EXPECT_EQ(find(hub, &b, REG_DHW_SETPOINT).profile.calls, 0u);
+}
+
+TEST(DispatchProfileTest, ResetClearsCounters) {
+  ProfiledHub hub;
+  sensor::Sensor a;
+  hub.register_listener(REG_LINE_VOLTAGE, costs(10), RegisterCapability::NONE, &a);
+  hub.dispatch_register_(REG_LINE_VOLTAGE, 240);
+  hub.reset_dispatch_profile();
+  const auto &p = find(hub, &a, REG_LINE_VOLTAGE).profile;
+  EXPECT_EQ(p.calls, 0u);
+  EXPECT_EQ(p.max_us, 0u);
+  EXPECT_EQ(p.total_us, 0u);
+  hub.log_dispatch_profile();  // Empty profile must not divide by zero
+}
+
+TEST(DispatchProfileTest, ProfilesCallbacksFromPolledFrames) {
+  mock_millis = 0;
+  ProfiledHub hub;
+  FakeABC abc;
+  hub.set_mock_backend(&abc);
+  sensor::Sensor voltage;
+  hub.register_listener(REG_LINE_VOLTAGE, costs(1200), RegisterCapability::NONE, &voltage);
+
+  hub.setup();
+  for (uint32_t t = 0; t < 3000; t++, mock_millis++) {
+    if (hub.is_setup_complete() && t % 1000 == 0)
+      hub.update();
+    hub.loop();
+  }
+  const auto &p = find(hub, &voltage, REG_LINE_VOLTAGE).profile;
+  EXPECT_GT(p.calls, 0u);
+  EXPECT_EQ(p.max_us, 1200u);
+  EXPECT_EQ(p.total_us, 1200u * p.calls);
+  hub.log_dispatch_profile(5);
+}
@@ -0,0 +1,243 @@
+// Line faults against the whole hub: no wrong value may ever reach a
+// listener, and the hub must get back to complete poll cycles. The
+// recovery time and registers lost per fault are printed, as the numbers
+// to weigh RESPONSE_TIMEOUT, ERROR_BACKOFF_TIME and the resync logic against.
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "../sim/abc_simulator.cpp"
+#include "../sim/fault_injection.cpp"
+
+#include <cstdio>
+#include <set>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+using namespace esphome::waterfurnace::sim;
+
+static const char *const FIXTURE = "../fixtures/sample_registers.yml";
+static const uint32_t INTERVAL = 10000;  // As in waterfurnace-esp32-s3.yaml
+static const uint64_t STEP_US = 1000;
+
+static const std::vector<Fault> ALL_FAULTS = {Fault::DROPPED_BYTE, Fault::BAD_CRC, Fault::TRUNCATED, Fault::LATE,
+                                              Fault::DUPLICATE};
+
+struct Cycle {
+  uint64_t start_us;
+  uint64_t last_value_us{0};
+  std::set<uint16_t> read;  // Registers that reached their listener this cycle
+};
+
+// The impact of one fault: from the fault until a poll cycle completes with every register read
+struct Recovery {
+  bool recovered{false};
+  uint64_t recovery_us{0};
+  size_t registers_lost{0};
+};
+
+class FaultInjectionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SimClock::reset();
+    ASSERT_TRUE(abc_.load_fixture(FIXTURE));
+    hub_.set_mock_backend(&abc_);
+    hub_.set_update_interval(INTERVAL);
+    // A listener on every register the fixture has, checking each value against the ABC
+    for (const auto &reg : abc_.registers) {
+      uint16_t addr = reg.first;
+      polled_.insert(addr);
+      hub_.register_listener(addr, [this, addr](uint16_t value) {
+        if (value != abc_.read(addr)) {
+          wrong_values_++;
+          ADD_FAILURE() << "register " << addr << " got " << value << ", ABC has " << abc_.read(addr);
+        }
+        if (!cycles_.empty()) {
+          cycles_.back().read.insert(addr);
+          cycles_.back().last_value_us = SimClock::now_us();
+        }
+      });
+    }
+    hub_.setup();
+    for (int i = 0; i < 10000 && !hub_.is_setup_complete(); i++)
+      step();
+    ASSERT_TRUE(hub_.is_setup_complete());
+  }
+
+  void step() {
+    hub_.loop();
+    SimClock::advance_us(STEP_US);
+  }
+
+  void run_cycles(size_t n) {
+    for (size_t i = 0; i < n; i++) {
+      cycles_.push_back({SimClock::now_us()});
+      hub_.update();
+      for (uint64_t end = SimClock::now_us() + INTERVAL * 1000ULL; SimClock::now_us() < end;)
+        step();
+    }
+  }
+
+  bool complete(const Cycle &cycle) const { return cycle.read.size() == polled_.size(); }
+
+  Recovery recovery_from(const FaultEvent &event) const {
+    Recovery r;
+    for (const auto &cycle : cycles_) {
+      if (cycle.start_us + INTERVAL * 1000ULL <= event.at_us)
+        continue;
+      if (complete(cycle) && cycle.last_value_us > event.at_us) {
+        r.recovered = true;
+        r.recovery_us = cycle.last_value_us - event.at_us;
+        return r;
+      }
+      r.registers_lost += polled_.size() - cycle.read.size();
+    }
+    return r;
+  }
+
+  FaultyAbcSimulator abc_;
+  WaterFurnace hub_;
+  std::set<uint16_t> polled_;
+  std::vector<Cycle> cycles_;
+  uint32_t wrong_values_{0};
+};
+
+TEST_F(FaultInjectionTest, CleanLineCompletesEveryCycle) {
+  run_cycles(5);
+  for (const auto &cycle : cycles_)
+    EXPECT_TRUE(complete(cycle));
+  EXPECT_TRUE(abc_.events.empty());
+  EXPECT_EQ(hub_.bus_stats().timeouts, 0u);
+  EXPECT_EQ(hub_.bus_stats().crc_errors, 0u);
+}
+
+class SingleFaultTest : public FaultInjectionTest, public ::testing::WithParamInterface<Fault> {};
+
+TEST_P(SingleFaultTest, RecoversWithoutWrongValues) {
+  run_cycles(2);
+  // Hit the second response of the third cycle
+  abc_.inject(abc_.responses() + 1, GetParam());
+  run_cycles(4);
+
+  ASSERT_EQ(abc_.events.size(), 1u);
+  Recovery r = recovery_from(abc_.events[0]);
+  printf("[ metrics  ] %-12s recovery %6.0f ms, %3zu register reads lost, timeouts %u, crc errors %u\n",
+         fault_name(GetParam()), r.recovery_us / 1000.0, r.registers_lost, hub_.bus_stats().timeouts,
+         hub_.bus_stats().crc_errors);
+  RecordProperty("recovery_ms", static_cast<int>(r.recovery_us / 1000));
+  RecordProperty("registers_lost", static_cast<int>(r.registers_lost));
+
+  EXPECT_EQ(wrong_values_, 0u);
+  ASSERT_TRUE(r.recovered);
+  // The next cycle is complete again
+  EXPECT_LE(r.recovery_us, 2ULL * INTERVAL * 1000);
+  EXPECT_TRUE(complete(cycles_.back()));
+}
+
+INSTANTIATE_TEST_SUITE_P(Faults, SingleFaultTest, ::testing::ValuesIn(ALL_FAULTS),
+                         [](const ::testing::TestParamInfo<Fault> &info) { return std::string(fault_name(info.param)); });
+
+TEST_F(FaultInjectionTest, SeededSoak) {
+  // One simulated hour with a fault in about one response in twenty
+  const uint32_t seed = 20240611;
+  abc_.randomize(seed, 0.05, ALL_FAULTS);
+  run_cycles(360);
+  abc_.clear_faults();
+  run_cycles(2);
+
+  EXPECT_EQ(wrong_values_, 0u) << "seed " << seed;
+  ASSERT_FALSE(abc_.events.empty());
+  EXPECT_TRUE(complete(cycles_.back())) << "seed " << seed;
+
+  struct Totals {
+    size_t faults{0}, recovered{0}, lost{0};
+    uint64_t recovery_us{0}, worst_us{0};
+  };
+  std::map<Fault, Totals> totals;
+  for (const auto &event : abc_.events) {
+    Recovery r = recovery_from(event);
+    auto &t = totals[event.fault];
+    t.faults++;
+    t.lost += r.registers_lost;
+    if (r.recovered) {
+      t.recovered++;
+      t.recovery_us += r.recovery_us;
+      t.worst_us = std::max(t.worst_us, r.recovery_us);
+    }
+  }
+  size_t complete_cycles = 0;
+  for (const auto &cycle : cycles_)
+    complete_cycles += complete(cycle);
+  printf("[ metrics  ] seed %u: %zu faults, %zu/%zu cycles complete\n", seed, abc_.events.size(), complete_cycles,
+         cycles_.size());
+  for (const auto &entry : totals) {
+    const Totals &t = entry.second;
+    printf("[ metrics  ] %-12s %3zu faults, recovery mean %6.0f ms max %6.0f ms, %5.1f register reads lost each\n",
+           fault_name(entry.first), t.faults, t.recovered ? t.recovery_us / 1000.0 / t.recovered : 0.0,
+           t.worst_us / 1000.0, static_cast<double>(t.lost) / t.faults);
+    // Overlapping faults are charged to each of them, but every one is recovered from
+    EXPECT_EQ(t.recovered, t.faults) << fault_name(entry.first) << ", seed " << seed;
+  }
+}
+
+TEST(FaultScheduleTest, SameSeedSameFaults) {
+  auto run = [](uint32_t seed) {
+    SimClock::reset();
+    FaultyAbcSimulator abc;
+    abc.registers[REG_HEATING_SETPOINT] = 680;
+    abc.randomize(seed, 0.3, ALL_FAULTS);
+    std::vector<uint8_t> line;
+    auto request = build_read_registers_request({REG_HEATING_SETPOINT});
+    for (int i = 0; i < 200; i++) {
+      abc.on_write(request.data(), request.size());
+      SimClock::advance_to_us(abc.line_free_at_us());
+      uint8_t b;
+      while (abc.read_byte(&b))
+        line.push_back(b);
+    }
+    return std::make_pair(abc.events.size(), line);
+  };
+  auto a = run(7);
+  EXPECT_GT(a.first, 0u);
+  EXPECT_EQ(run(7), a);
+  EXPECT_NE(run(8), a);
+}
+
+TEST(FaultScheduleTest, FaultShapes) {
+  SimClock::reset();
+  FaultyAbcSimulator abc;
+  abc.registers[REG_HEATING_SETPOINT] = 680;
+  auto request = build_read_registers_request({REG_HEATING_SETPOINT});
+  auto exchange = [&]() {
+    abc.on_write(request.data(), request.size());
+    uint64_t sent = SimClock::now_us();
+    SimClock::advance_to_us(abc.line_free_at_us());
+    std::vector<uint8_t> out;
+    uint8_t b;
+    while (abc.read_byte(&b))
+      out.push_back(b);
+    return std::make_pair(out, SimClock::now_us() - sent);
+  };
+
+  auto intact = exchange();
+  ASSERT_EQ(intact.first.size(), 7u);
+  abc.inject(1, Fault::DROPPED_BYTE);
+  abc.inject(2, Fault::BAD_CRC);
+  abc.inject(3, Fault::TRUNCATED);
+  abc.inject(4, Fault::LATE);
+  abc.inject(5, Fault::DUPLICATE);
+
+  EXPECT_EQ(exchange().first.size(), 6u);
+  auto bad = exchange().first;
+  ASSERT_EQ(bad.size(), 7u);
+  EXPECT_EQ(get_response_frame_size(bad.data(), bad.size()), 7u);
+  EXPECT_FALSE(validate_frame_crc(bad.data(), bad.size()));
+  EXPECT_LT(exchange().first.size(), 7u);
+  auto late = exchange();
+  EXPECT_EQ(late.first, intact.first);
+  EXPECT_EQ(late.second, intact.second + abc.late_by_us);
+  auto twice = exchange().first;
+  ASSERT_EQ(twice.size(), 14u);
+  EXPECT_TRUE(std::equal(intact.first.begin(), intact.first.end(), twice.begin() + 7));
+  ASSERT_EQ(abc.events.size(), 5u);
+  EXPECT_EQ(abc.events[3].fault, Fault::LATE);
+}
@@ -0,0 +1,201 @@
+// Fault freeze frames: fault transitions that start a snapshot, the snapshot
+// ring, and the hub reading a frame from the simulator as soon as a fault
+// shows up, without holding up the poll cycle.
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "../sim/abc_simulator.cpp"
+#include "fake_abc.h"
+
+#include <fstream>
+#include <map>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+using namespace esphome::waterfurnace::sim;
+
+TEST(FreezeFrameTest, NewFaultCodesAndLockoutsTrigger) {
+  FreezeFrame frame;
+  // A fault from before boot is the baseline, not a trigger
+  EXPECT_FALSE(frame.on_fault(5));
+  EXPECT_FALSE(frame.on_fault(5));
+  // Clearing the fault is not a fault
+  EXPECT_FALSE(frame.on_fault(0));
+  EXPECT_TRUE(frame.on_fault(5));
+  EXPECT_TRUE(frame.on_fault(7));
+  // The same code going to lockout
+  EXPECT_TRUE(frame.on_fault(7 | FAULT_LOCKOUT_FLAG));
+  // Lockout reset with the code left in place
+  EXPECT_FALSE(frame.on_fault(7));
+  EXPECT_TRUE(frame.on_fault(9 | FAULT_LOCKOUT_FLAG));
+}
+
+TEST(FreezeFrameTest, RingKeepsTheLastSnapshots) {
+  FreezeFrame frame;
+  frame.set_registers({{1116, RegisterCapability::AXB}, {19, RegisterCapability::NONE}, {1115, RegisterCapability::AXB}});
+  frame.set_depth(3);
+  ASSERT_TRUE(frame.begin());
+  ASSERT_EQ(frame.registers().size(), 3u);
+  EXPECT_EQ(frame.registers()[0].address, 19);
+
+  for (uint16_t n = 1; n <= 5; n++) {
+    frame.open(n * 1000, n);
+    EXPECT_TRUE(frame.capturing());
+    frame.record(19, n);
+    frame.record(1115, n * 100);
+    frame.record(20, 1);  // Not in the set
+    frame.close(n * 1000 + 40);
+  }
+  EXPECT_FALSE(frame.capturing());
+  EXPECT_EQ(frame.triggers(), 5u);
+  ASSERT_EQ(frame.size(), 3u);
+  for (size_t i = 0; i < 3; i++) {
+    uint16_t n = 5 - i;
+    EXPECT_EQ(frame.snapshot(i).fault, n);
+    EXPECT_EQ(frame.snapshot(i).at, n * 1000u);
+    EXPECT_EQ(frame.snapshot(i).duration, 40u);
+    uint16_t value;
+    ASSERT_TRUE(frame.value(i, 1, value));
+    EXPECT_EQ(value, n * 100);
+    // 1116 was never read
+    EXPECT_FALSE(frame.value(i, 2, value));
+  }
+  EXPECT_EQ(frame.to_text(0), "# Freeze frame 1/3: E5 Freeze Detect FP1 at 5000 ms, read in 40 ms\n19: 5\n1115: 500\n");
+  EXPECT_EQ(frame.to_text(3), "");
+}
+
+TEST(FreezeFrameTest, OffWithoutDepth) {
+  FreezeFrame frame;
+  EXPECT_FALSE(frame.begin());
+  EXPECT_FALSE(frame.enabled());
+  frame.open(0, 5);
+  EXPECT_FALSE(frame.capturing());
+  EXPECT_EQ(frame.size(), 0u);
+}
+
+// The hub polling the simulator when the ABC reports a fault
+class HubFreezeFrameTest : public SimHubTest {
+ protected:
+  void configure_() override { hub_.set_freeze_frame_depth(2); }
+
+  void SetUp() override {
+    SimHubTest::SetUp();
+    if (HasFatalFailure())
+      return;
+    // Past the first poll cycle, which sets the fault baseline
+    run_ms(INTERVAL);
+    polled_.clear();
+  }
+
+  // Index of `addr` in the frame's register set
+  size_t reg(uint16_t addr) const {
+    const auto &regs = hub_.freeze_frame().registers();
+    for (size_t i = 0; i < regs.size(); i++) {
+      if (regs[i].address == addr)
+        return i;
+    }
+    return regs.size();
+  }
+};
+
+TEST_F(HubFreezeFrameTest, FaultReadsAFrameAtOnce) {
+  const FreezeFrame &frame = hub_.freeze_frame();
+  ASSERT_TRUE(frame.enabled());
+  EXPECT_EQ(frame.registers().size(), FreezeFrame::NUM_DEFAULT_REGISTERS);
+  EXPECT_EQ(frame.size(), 0u);
+
+  // High pressure lockout, with the discharge pressure that caused it; the
+  // pressure is back to normal by the next poll cycle
+  uint32_t start = mock_millis;
+  abc_.registers[REG_LAST_FAULT] = 2 | FAULT_LOCKOUT_FLAG;
+  abc_.registers[REG_DISCHARGE_PRESSURE] = 6000;
+  uint32_t requests = abc_.stats.requests;
+  while (frame.size() == 0 || frame.capturing()) {
+    ASSERT_LT(mock_millis - start, INTERVAL);
+    run_ms(1);
+  }
+  abc_.registers[REG_DISCHARGE_PRESSURE] = 3500;
+  uint32_t seen = mock_millis - start;
+
+  const auto &snapshot = frame.snapshot(0);
+  EXPECT_EQ(snapshot.fault, 2 | FAULT_LOCKOUT_FLAG);
+  uint16_t value;
+  ASSERT_TRUE(frame.value(0, reg(REG_DISCHARGE_PRESSURE), value));
+  EXPECT_EQ(value, 6000);
+  ASSERT_TRUE(frame.value(0, reg(REG_VS_DRIVE_STATUS), value));
+  ASSERT_TRUE(frame.value(0, reg(REG_FP1_TEMP), value));
+  EXPECT_EQ(value, abc_.registers[REG_FP1_TEMP]);
+  // The frame is read right after the poll that saw the fault, in a couple of requests
+  printf("[ metrics  ] fault seen after %u ms, frame read in %u ms, %u registers\n", seen, snapshot.duration,
+         static_cast<unsigned>(__builtin_popcountll(snapshot.read)));
+  EXPECT_LT(snapshot.duration, 500u);
+  EXPECT_LE(abc_.stats.requests - requests, 12u);
+
+  // A second fault fills the other slot; the frame text loads as a fixture
+  run_ms(INTERVAL);
+  abc_.registers[REG_LAST_FAULT] = 0;
+  run_ms(INTERVAL);
+  EXPECT_EQ(frame.size(), 1u);
+  abc_.registers[REG_LAST_FAULT] = 3;
+  run_ms(INTERVAL);
+  ASSERT_EQ(frame.size(), 2u);
+  EXPECT_EQ(frame.snapshot(0).fault, 3);
+  EXPECT_EQ(frame.snapshot(1).fault, 2 | FAULT_LOCKOUT_FLAG);
+  ASSERT_TRUE(frame.value(0, reg(REG_DISCHARGE_PRESSURE), value));
+  EXPECT_EQ(value, 3500);
+
+  const char *path = "freeze_frame_test.yml";
+  std::ofstream(path) << frame.to_text(1);
+  AbcSimulator reloaded;
+  ASSERT_TRUE(reloaded.load_fixture(path));
+  std::remove(path);
+  EXPECT_EQ(reloaded.registers[REG_DISCHARGE_PRESSURE], 6000);
+
+  // Polling kept its interval throughout
+  uint32_t elapsed = mock_millis - start;
+  for (const auto &entry : polled_)
+    EXPECT_GE(entry.second, elapsed / INTERVAL) << "register " << entry.first;
+  EXPECT_EQ(hub_.deadline_misses(), 0u);
+}
+
+TEST_F(HubFreezeFrameTest, FullQueueDefersTheFrame) {
+  const FreezeFrame &frame = hub_.freeze_frame();
+  uint32_t seen = 0;
+  hub_.register_listener(REG_LAST_FAULT, [&seen](uint16_t value) {
+    if (value != 0 && seen == 0)
+      seen = mock_millis;
+  });
+  abc_.registers[REG_LAST_FAULT] = 5;
+  hub_.request_read({REG_LAST_FAULT});
+  while (hub_.queue_depth() > 0) {
+    hub_.loop();
+    SimClock::advance_us(1000);
+  }
+  // The fault arrives with no room left for the frame's reads
+  size_t full;
+  do {
+    full = hub_.queue_depth();
+    hub_.request_read({REG_FP1_TEMP});
+  } while (hub_.queue_depth() > full);
+  while (seen == 0) {
+    ASSERT_LT(hub_.queue_depth(), full + 1);
+    hub_.loop();
+    SimClock::advance_us(1000);
+  }
+  EXPECT_FALSE(frame.capturing());
+  EXPECT_EQ(frame.triggers(), 0u);
+
+  // Opened once all of them fit, not as an empty snapshot
+  while (frame.size() == 0 || frame.capturing()) {
+    ASSERT_LT(mock_millis - seen, INTERVAL);
+    run_ms(1);
+  }
+  EXPECT_EQ(frame.triggers(), 1u);
+  ASSERT_EQ(frame.size(), 1u);
+  EXPECT_EQ(frame.snapshot(0).fault, 5);
+  EXPECT_EQ(frame.snapshot(0).at, seen);
+  EXPECT_NE(frame.snapshot(0).read, 0u);
+  uint16_t value;
+  ASSERT_TRUE(frame.value(0, reg(REG_FP1_TEMP), value));
+  EXPECT_EQ(value, abc_.registers[REG_FP1_TEMP]);
+}
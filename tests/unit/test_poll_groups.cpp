@@ -1,8 +1,8 @@
 // Unit tests for listener-driven poll group building
 
 #include <gtest/gtest.h>
-#include "../../components/waterfurnace/protocol.cpp"
-#include "../../components/waterfurnace/waterfurnace.cpp"
+#include "hub_sources.h"
+#include "poll_plan_fixture.h"
 
 using namespace esphome::waterfurnace;
 
@@ -14,6 +14,9 @@ class TestableHub : public WaterFurnace {
   using WaterFurnace::poll_groups_;
   using WaterFurnace::listeners_;
   using WaterFurnace::dispatch_register_;
+  using WaterFurnace::state_groups_;
+  using WaterFurnace::using_poll_plan_;
+  using PollGroup = WaterFurnace::PollGroup;
 
   void set_awl_thermostat(bool v) { awl_thermostat_ = v; }
   void set_awl_axb(bool v) { awl_axb_ = v; }
@@ -23,6 +26,18 @@ class TestableHub : public WaterFurnace {
   void set_has_energy_monitoring(bool v) { has_energy_monitoring_ = v; }
   void set_has_refrigeration_monitoring(bool v) { has_refrigeration_monitoring_ = v; }
   void set_setup_complete(bool v) { setup_complete_ = v; }
+  void set_has_iz2(bool v) { has_iz2_ = v; }
+
+  void set_plan_flags(uint8_t flags) {
+    awl_thermostat_ = flags & PLAN_AWL_THERMOSTAT;
+    awl_axb_ = flags & PLAN_AWL_AXB;
+    awl_iz2_ = flags & PLAN_AWL_IZ2;
+    has_axb_ = flags & PLAN_AXB;
+    has_refrigeration_monitoring_ = flags & PLAN_REFRIGERATION;
+    has_energy_monitoring_ = flags & PLAN_ENERGY;
+    has_vs_drive_ = flags & PLAN_VS_DRIVE;
+    has_iz2_ = flags & PLAN_IZ2;
+  }
 
   // Count total registers across all poll groups
   size_t total_polled_registers() const {
@@ -625,3 +640,111 @@ TEST_F(BuildPollGroupsTest, NoneCapabilityAlwaysPasses) {
   EXPECT_TRUE(hub_.is_address_polled(740));
   EXPECT_TRUE(hub_.is_address_polled(1117));
 }
+
+// ====== Prebuilt poll plans (poll_plan.py) ======
+
+static void register_fixture_listeners(TestableHub &hub) {
+  for (const auto &listener : FIXTURE_LISTENERS) {
+    if (listener.when == FixtureWhen::IZ2 && !hub.has_iz2())
+      continue;
+    if (listener.when == FixtureWhen::NO_IZ2 && hub.has_iz2())
+      continue;
+    hub.register_listener(listener.address, [](uint16_t) {}, listener.capability);
+  }
+}
+
+static void expect_same_groups(const std::vector<TestableHub::PollGroup> &planned,
+                               const std::vector<TestableHub::PollGroup> &runtime,
+                               uint8_t flags) {
+  ASSERT_EQ(planned.size(), runtime.size()) << "flags 0x" << std::hex << int(flags);
+  for (size_t i = 0; i < planned.size(); i++) {
+    EXPECT_EQ(planned[i].ranges, runtime[i].ranges) << "flags 0x" << std::hex << int(flags) << " group " << i;
+    EXPECT_EQ(planned[i].individual, runtime[i].individual) << "flags 0x" << std::hex << int(flags);
+    auto expected = planned[i].ranges.empty() ? build_read_registers_request(planned[i].individual)
+                                              : build_read_ranges_request(planned[i].ranges);
+    ASSERT_NE(planned[i].frame, nullptr);
+    EXPECT_EQ(std::vector<uint8_t>(planned[i].frame, planned[i].frame + planned[i].frame_len), expected);
+  }
+}
+
+static void check_plans_match_runtime(const PollPlan *plans, const PollPlanVariant *variants, size_t num_variants,
+                                      bool adaptive) {
+  for (size_t v = 0; v < num_variants; v++) {
+    uint8_t flags = variants[v].flags;
+    TestableHub runtime, planned;
+    for (TestableHub *hub : {&runtime, &planned}) {
+      hub->set_plan_flags(flags);
+      if (adaptive)
+        hub->set_adaptive_polling(2000, 60000, 30000);
+      register_fixture_listeners(*hub);
+    }
+    planned.set_poll_plans(plans, variants, num_variants);
+    runtime.build_poll_groups_();
+    planned.build_poll_groups_();
+
+    ASSERT_TRUE(planned.using_poll_plan_) << "flags 0x" << std::hex << int(flags);
+    EXPECT_FALSE(runtime.using_poll_plan_);
+    expect_same_groups(planned.poll_groups_, runtime.poll_groups_, flags);
+    expect_same_groups(planned.state_groups_, runtime.state_groups_, flags);
+  }
+}
+
+TEST(PrebuiltPollPlan, MatchesRuntimePlannerForEveryVariant) {
+  check_plans_match_runtime(fixture_plans, fixture_variants, fixture_num_variants, false);
+}
+
+TEST(PrebuiltPollPlan, MatchesRuntimePlannerWithAdaptivePolling) {
+  check_plans_match_runtime(fixture_adaptive_plans, fixture_adaptive_variants, fixture_adaptive_num_variants, true);
+}
+
+TEST(PrebuiltPollPlan, ExtraListenerFallsBackToRuntime) {
+  TestableHub hub;
+  hub.set_plan_flags(PLAN_AXB);
+  register_fixture_listeners(hub);
+  hub.register_listener(1103, [](uint16_t) {});  // Not known at build time
+  hub.set_poll_plans(fixture_plans, fixture_variants, fixture_num_variants);
+  hub.build_poll_groups_();
+
+  EXPECT_FALSE(hub.using_poll_plan_);
+  EXPECT_TRUE(hub.is_address_polled(1103));
+  for (const auto &group : hub.poll_groups_)
+    EXPECT_EQ(group.frame, nullptr);
+}
+
+TEST(PrebuiltPollPlan, UnusedPlanRegisterFallsBackToRuntime) {
+  // Plan built for the full listener set, but only one listener registered
+  TestableHub hub;
+  hub.set_plan_flags(PLAN_AXB);
+  hub.register_listener(30, [](uint16_t) {});
+  hub.set_poll_plans(fixture_plans, fixture_variants, fixture_num_variants);
+  hub.build_poll_groups_();
+
+  EXPECT_FALSE(hub.using_poll_plan_);
+  EXPECT_EQ(hub.all_polled_addresses(), (std::vector<uint16_t>{30, REG_ENTERING_AIR_ABC}));
+}
+
+TEST(PrebuiltPollPlan, UnknownHardwareFallsBackToRuntime) {
+  TestableHub hub;
+  hub.set_plan_flags(PLAN_AWL_AXB);  // AWL AXB without an AXB is never planned
+  register_fixture_listeners(hub);
+  hub.set_poll_plans(fixture_plans, fixture_variants, fixture_num_variants);
+  hub.build_poll_groups_();
+
+  EXPECT_FALSE(hub.using_poll_plan_);
+  EXPECT_FALSE(hub.poll_groups_.empty());
+}
+
+TEST(PrebuiltPollPlan, OtherSlaveAddressBuildsFramesAtRuntime) {
+  // Fixture frames are addressed to slave 1; a hub on address 2 keeps the plan but not the frames
+  TestableHub hub;
+  hub.set_address(2);
+  hub.set_plan_flags(PLAN_AXB);
+  register_fixture_listeners(hub);
+  hub.set_poll_plans(fixture_plans, fixture_variants, fixture_num_variants);
+  hub.build_poll_groups_();
+
+  EXPECT_TRUE(hub.using_poll_plan_);
+  ASSERT_FALSE(hub.poll_groups_.empty());
+  for (const auto &group : hub.poll_groups_)
+    EXPECT_EQ(group.frame, nullptr);
+}
@@ -4,6 +4,8 @@
 #include "../../components/waterfurnace/protocol.cpp"
 #include "../../components/waterfurnace/registers.h"
 
+#include <algorithm>
+
 using namespace esphome::waterfurnace;
 
 // ====== CRC16 ======
@@ -95,6 +97,20 @@ TEST(FrameBuilding, WriteSingleRequest) {
   EXPECT_TRUE(validate_frame_crc(frame.data(), frame.size()));
 }
 
+TEST(FrameBuilding, SlaveAddressParameter) {
+  auto ranges = build_read_ranges_request({{88, 4}}, 3);
+  auto regs = build_read_registers_request({745}, 3);
+  auto writes = build_write_registers_request({{340, 1}}, 3);
+  auto single = build_write_single_request(340, 1, 3);
+  for (const auto *frame : {&ranges, &regs, &writes, &single}) {
+    EXPECT_EQ((*frame)[0], 3);
+    EXPECT_TRUE(validate_frame_crc(frame->data(), frame->size()));
+  }
+  // Only the address byte and CRC differ from the default-slave frame
+  auto dflt = build_read_ranges_request({{88, 4}});
+  EXPECT_TRUE(std::equal(dflt.begin() + 1, dflt.end() - 2, ranges.begin() + 1));
+}
+
 // ====== Frame Validation ======
 
 TEST(FrameValidation, ValidCRC) {
@@ -135,6 +151,32 @@ TEST(ResponseParsing, OddBytes) {
   EXPECT_EQ(values[0], 700u);
 }
 
+TEST(RegisterList, AddressesAndRanges) {
+  std::vector<uint16_t> addrs;
+  ASSERT_TRUE(parse_register_list("31, 25,30-32 ,12101", addrs));
+  EXPECT_EQ(addrs, (std::vector<uint16_t>{25, 30, 31, 32, 12101}));
+  ASSERT_TRUE(parse_register_list("65535", addrs));
+  EXPECT_EQ(addrs, (std::vector<uint16_t>{65535}));
+}
+
+TEST(RegisterList, RangesMerge) {
+  std::vector<std::pair<uint16_t, uint16_t>> ranges;
+  ASSERT_TRUE(parse_register_ranges("100-110, 0-9, 105-120, 121, 200", ranges));
+  EXPECT_EQ(ranges, (std::vector<std::pair<uint16_t, uint16_t>>{{0, 10}, {100, 22}, {200, 1}}));
+  ASSERT_TRUE(parse_register_ranges("0-65535", ranges));
+  EXPECT_EQ(ranges, (std::vector<std::pair<uint16_t, uint16_t>>{{0, 65535}, {65535, 1}}));
+}
+
+TEST(RegisterList, Rejects) {
+  std::vector<uint16_t> addrs;
+  EXPECT_FALSE(parse_register_list("", addrs));
+  EXPECT_FALSE(parse_register_list("25,", addrs));
+  EXPECT_FALSE(parse_register_list("25;26", addrs));
+  EXPECT_FALSE(parse_register_list("35-30", addrs));
+  EXPECT_FALSE(parse_register_list("65536", addrs));
+  EXPECT_FALSE(parse_register_list("0-999", addrs, 100));
+}
+
 TEST(ResponseParsing, ErrorResponseTrue) {
   EXPECT_TRUE(is_error_response(0xC1));
   EXPECT_TRUE(is_error_response(0xC2));
@@ -165,6 +207,31 @@ TEST(ResponseHeader, WriteRegisters) {
   EXPECT_EQ(get_response_header_size(FUNC_WRITE_REGISTERS), 4u);
 }
 
+// ====== Response Frame Size ======
+
+TEST(ResponseFrameSize, TooShort) {
+  uint8_t buf[] = {0x01, 0x41};
+  EXPECT_EQ(get_response_frame_size(buf, 0), 0u);
+  EXPECT_EQ(get_response_frame_size(buf, 2), 0u);
+}
+
+TEST(ResponseFrameSize, ReadRangesUsesByteCount) {
+  uint8_t buf[] = {0x01, FUNC_READ_RANGES, 0x06};
+  EXPECT_EQ(get_response_frame_size(buf, sizeof(buf)), 3u + 6u + 2u);
+}
+
+TEST(ResponseFrameSize, ErrorResponse) {
+  uint8_t buf[] = {0x01, 0xC1, 0x02};
+  EXPECT_EQ(get_response_frame_size(buf, sizeof(buf)), 5u);
+}
+
+TEST(ResponseFrameSize, WriteEchoes) {
+  uint8_t w67[] = {0x01, FUNC_WRITE_REGISTERS, 0x00};
+  uint8_t w6[] = {0x01, FUNC_WRITE_SINGLE, 0x00};
+  EXPECT_EQ(get_response_frame_size(w67, sizeof(w67)), 4u);
+  EXPECT_EQ(get_response_frame_size(w6, sizeof(w6)), 8u);
+}
+
 // ====== Register Type Conversions ======
 
 TEST(RegisterConversion, Unsigned) {
@@ -215,6 +282,28 @@ TEST(Register32Bit, Int32Negative) {
   EXPECT_EQ(to_int32(uval >> 16, uval & 0xFFFF), -1000);
 }
 
+// ====== Register Metadata ======
+
+TEST(RegisterMeta, TypeInfoWords) {
+  static_assert(RegisterMeta{1146, RegisterType::UINT32, RegisterCapability::ENERGY}.is_32bit(), "");
+  static_assert(!RegisterMeta{16, RegisterType::UNSIGNED, RegisterCapability::ENERGY}.is_32bit(), "");
+  EXPECT_EQ(register_type_info(RegisterType::INT32).words, 2);
+  EXPECT_EQ(register_type_info(RegisterType::SIGNED_TENTHS).words, 1);
+}
+
+TEST(RegisterMeta, SentinelOnlyOnTenths) {
+  EXPECT_TRUE(register_type_info(RegisterType::TENTHS).has_sentinel);
+  EXPECT_TRUE(register_type_info(RegisterType::SIGNED_TENTHS).has_sentinel);
+  EXPECT_FALSE(register_type_info(RegisterType::UNSIGNED).has_sentinel);
+  EXPECT_FALSE(register_type_info(RegisterType::HUNDREDTHS).has_sentinel);
+}
+
+TEST(RegisterMeta, Names) {
+  EXPECT_STREQ(register_type_info(RegisterType::SIGNED_TENTHS).name, "signed_tenths");
+  EXPECT_STREQ(capability_name(RegisterCapability::VS_DRIVE), "vs_drive");
+  EXPECT_STREQ(capability_name(RegisterCapability::NONE), "none");
+}
+
 // ====== IZ2 Zone Extraction ======
 
 TEST(IZ2, FanModeAuto) {
@@ -270,6 +359,61 @@ TEST(FaultCodes, Known) {
 TEST(FaultCodes, Unknown) {
   EXPECT_STREQ(fault_code_to_string(50), "Unknown Fault");
   EXPECT_STREQ(fault_code_to_string(0), "Unknown Fault");
+  EXPECT_STREQ(fault_code_to_string(128), "Unknown Fault");
+  EXPECT_STREQ(fault_code_to_string(0x7FFF), "Unknown Fault");
+}
+
+TEST(FaultCodes, DirectTableMatchesFaultTable) {
+  for (size_t i = 0; i < FAULT_TABLE_SIZE; i++)
+    EXPECT_STREQ(fault_code_to_string(FAULT_TABLE[i].code), FAULT_TABLE[i].description);
+}
+
+// ====== Bit labels ======
+
+TEST(BitLabels, DirectTableIndexedByBit) {
+  EXPECT_STREQ(bit_label(OUTPUT_BIT_LABELS, 10), "Lockout");
+  EXPECT_STREQ(bit_label(AXB_OUTPUT_BIT_LABELS, 1), "Loop Pump");
+  EXPECT_EQ(bit_label(OUTPUT_BIT_LABELS, 6), nullptr);  // Unnamed bit
+  EXPECT_EQ(bit_label(INPUT_BIT_LABELS, 16), nullptr);
+}
+
+TEST(BitLabels, FormatSkipsUnnamedBits) {
+  char buf[FAULT_HISTORY_BUFFER_SIZE];
+  format_bit_labels(buf, sizeof(buf), OUTPUT_CC | 0x40 | OUTPUT_ALARM, OUTPUT_BIT_LABELS);
+  EXPECT_STREQ(buf, "CC, Alarm");
+  format_bit_labels(buf, sizeof(buf), 0x40, OUTPUT_BIT_LABELS);
+  EXPECT_STREQ(buf, "None");
+  format_bit_labels(buf, sizeof(buf), AXB_OUTPUT_DHW | AXB_OUTPUT_ACCESSORY2, AXB_OUTPUT_BIT_LABELS);
+  EXPECT_STREQ(buf, "DHW, Accessory 2");
+}
+
+TEST(BitLabels, FormatTruncatesToBuffer) {
+  char buf[8];
+  format_bit_labels(buf, sizeof(buf), 0xFFFF, INPUT_BIT_LABELS);
+  EXPECT_STREQ(buf, "Y1, Y2,");
+}
+
+// ====== Fault history ======
+
+TEST(FaultHistory, DecodesRegisters25To28) {
+  char buf[FAULT_HISTORY_BUFFER_SIZE];
+  ASSERT_TRUE(format_fault_history(REG_LAST_FAULT, 0x8002, buf, sizeof(buf)));
+  EXPECT_STREQ(buf, "E2 High Pressure (LOCKOUT)");
+  ASSERT_TRUE(format_fault_history(REG_LAST_LOCKOUT, 42, buf, sizeof(buf)));
+  EXPECT_STREQ(buf, "E42 High Discharge Temp");
+  ASSERT_TRUE(format_fault_history(REG_LAST_LOCKOUT, 0, buf, sizeof(buf)));
+  EXPECT_STREQ(buf, "No Fault");
+  ASSERT_TRUE(format_fault_history(REG_OUTPUTS_AT_LOCKOUT, OUTPUT_CC | OUTPUT_LOCKOUT, buf, sizeof(buf)));
+  EXPECT_STREQ(buf, "CC, Lockout");
+  ASSERT_TRUE(format_fault_history(REG_INPUTS_AT_LOCKOUT, INPUT_HPS, buf, sizeof(buf)));
+  EXPECT_STREQ(buf, "HPS");
+}
+
+TEST(FaultHistory, RejectsOtherRegisters) {
+  char buf[FAULT_HISTORY_BUFFER_SIZE];
+  EXPECT_FALSE(format_fault_history(REG_SYSTEM_OUTPUTS, 0, buf, sizeof(buf)));
+  EXPECT_FALSE(is_fault_history_register(24));
+  EXPECT_TRUE(is_fault_history_register(REG_LAST_LOCKOUT));
 }
 
 // ====== Register Groups ======
@@ -0,0 +1,207 @@
+// Register map dump: batching at the protocol limits and breakpoints,
+// bisection of rejected batches, and a dump run by the hub against the
+// simulator while it keeps polling.
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "../sim/abc_simulator.cpp"
+#include "fake_abc.h"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+using namespace esphome::waterfurnace::sim;
+
+using Ranges = std::vector<RegisterDump::Range>;
+
+// Every "address: value" line of YAML fixture text
+static std::map<uint16_t, uint16_t> parse_yaml(const std::string &text) {
+  std::map<uint16_t, uint16_t> values;
+  std::istringstream in(text);
+  std::string line;
+  unsigned addr, value;
+  while (std::getline(in, line)) {
+    if (sscanf(line.c_str(), "%u: %u", &addr, &value) == 2)
+      values[addr] = value;
+  }
+  return values;
+}
+
+class RegisterDumpTest : public ::testing::Test {
+ protected:
+  void start(const Ranges &ranges) {
+    dump_.start(ranges, [this](const std::string &text) { out_ += text; });
+  }
+  // Answer every batch from `registers`, rejecting those touching `illegal`
+  void run(const std::map<uint16_t, uint16_t> &registers, const std::set<uint16_t> &illegal) {
+    RegisterDump::Batch batch;
+    while (dump_.next(batch)) {
+      batches_.push_back(batch);
+      std::vector<uint8_t> data;
+      bool rejected = false;
+      for (const auto &range : batch.ranges) {
+        for (uint32_t addr = range.first; addr < static_cast<uint32_t>(range.first) + range.second; addr++) {
+          rejected |= illegal.count(addr) > 0;
+          auto it = registers.find(addr);
+          uint16_t value = it != registers.end() ? it->second : 0;
+          data.push_back(value >> 8);
+          data.push_back(value & 0xFF);
+        }
+      }
+      if (rejected) {
+        dump_.on_exception(2);
+      } else {
+        dump_.on_values(data.data(), data.size() / 2);
+      }
+    }
+  }
+
+  RegisterDump dump_;
+  std::string out_;
+  std::vector<RegisterDump::Batch> batches_;
+};
+
+TEST_F(RegisterDumpTest, FullBatchesSplitAtBreakpoints) {
+  start({{0, 250}, {12050, 100}, {12450, 100}});
+  run({{5, 55}, {12101, 7}}, {});
+  // 100 + 100 + 50 below 12100 (the last joined by 12050-12099), then one
+  // func 66 request between the breakpoints, then func 65 from 12500
+  ASSERT_EQ(batches_.size(), 5u);
+  EXPECT_EQ(batches_[0].ranges, (Ranges{{0, 100}}));
+  EXPECT_EQ(batches_[2].ranges, (Ranges{{200, 50}, {12050, 50}}));
+  EXPECT_TRUE(batches_[3].individual);
+  EXPECT_EQ(batches_[3].ranges, (Ranges{{12100, 50}, {12450, 50}}));
+  EXPECT_FALSE(batches_[4].individual);
+  EXPECT_EQ(batches_[4].ranges, (Ranges{{12500, 50}}));
+  EXPECT_EQ(dump_.registers_read(), 450u);
+  auto values = parse_yaml(out_);
+  EXPECT_EQ(values.size(), 450u);
+  EXPECT_EQ(values[5], 55);
+  EXPECT_EQ(values[12101], 7);
+  EXPECT_NE(out_.find("# 450 registers read, 0 left out"), std::string::npos);
+}
+
+TEST_F(RegisterDumpTest, ManySmallRangesFillOneFrame) {
+  Ranges ranges;
+  for (uint16_t i = 0; i < 80; i++)
+    ranges.push_back({static_cast<uint16_t>(i * 10), 1});
+  start(ranges);
+  run({}, {});
+  // 63 ranges fill a func 65 request frame
+  ASSERT_EQ(batches_.size(), 2u);
+  EXPECT_EQ(batches_[0].ranges.size(), 63u);
+  EXPECT_EQ(batches_[1].ranges.size(), 17u);
+}
+
+TEST_F(RegisterDumpTest, BisectionQuarantinesRejectedAddresses) {
+  start({{0, 100}});
+  run({{41, 4100}}, {40, 77});
+  auto values = parse_yaml(out_);
+  EXPECT_EQ(values.size(), 98u);
+  EXPECT_EQ(values.count(40), 0u);
+  EXPECT_EQ(values.count(77), 0u);
+  EXPECT_EQ(values[41], 4100);
+  EXPECT_EQ(dump_.quarantined(), 2u);
+  EXPECT_NE(out_.find("# 40: exception 2\n"), std::string::npos);
+  EXPECT_NE(out_.find("# 77: exception 2\n"), std::string::npos);
+  // Each rejected address costs two requests per halving, about log2(100) times
+  EXPECT_LE(batches_.size(), 1u + 2 * 2 * 7);
+}
+
+TEST_F(RegisterDumpTest, SilentBatchRetriedThenSkipped) {
+  start({{10, 5}, {20, 1}});
+  RegisterDump::Batch batch;
+  for (uint8_t i = 0; i < RegisterDump::MAX_ATTEMPTS; i++) {
+    ASSERT_TRUE(dump_.next(batch));
+    EXPECT_EQ(batch.ranges, (Ranges{{10, 5}, {20, 1}}));
+    dump_.on_failure();
+  }
+  EXPECT_FALSE(dump_.next(batch));
+  EXPECT_FALSE(dump_.active());
+  EXPECT_NE(out_.find("# 10-14, 20: no response\n"), std::string::npos);
+  EXPECT_EQ(dump_.quarantined(), 6u);
+}
+
+// The hub dumping the simulator's registers while it polls
+class HubDumpTest : public SimHubTest {
+ protected:
+  std::string out_;
+};
+
+TEST_F(HubDumpTest, DumpMatchesTheFixtureAndPollingGoesOn) {
+  abc_.illegal_addresses = {150, 151, 1130};
+  Ranges ranges;
+  ASSERT_TRUE(parse_register_ranges("0-1199", ranges));
+  ASSERT_TRUE(hub_.dump_registers(ranges, 20, [this](const std::string &text) { out_ += text; }));
+  EXPECT_FALSE(hub_.dump_registers(ranges, 20, nullptr));
+  uint32_t busy_before = hub_.bus_stats().busy_ms;
+  uint32_t start = mock_millis;
+  while (hub_.dump_active() && mock_millis - start < 600000)
+    run_ms(1000);
+  ASSERT_FALSE(hub_.dump_active());
+  uint32_t elapsed = mock_millis - start;
+
+  auto values = parse_yaml(out_);
+  EXPECT_EQ(values.size(), 1200u - 3);
+  for (const auto &reg : abc_.registers) {
+    if (reg.first < 1200 && !abc_.illegal_addresses.count(reg.first)) {
+      EXPECT_EQ(values[reg.first], reg.second) << "register " << reg.first;
+    }
+  }
+  EXPECT_EQ(values.count(1130), 0u);
+  // The output loads as a fixture
+  const char *path = "register_dump_test.yml";
+  std::ofstream(path) << out_;
+  AbcSimulator reloaded;
+  ASSERT_TRUE(reloaded.load_fixture(path));
+  std::remove(path);
+  EXPECT_EQ(reloaded.registers.size(), values.size());
+  EXPECT_NE(out_.find("# 1130: exception 2"), std::string::npos);
+  // Dumped values stay out of the cache
+  uint16_t value;
+  EXPECT_FALSE(hub_.get_register(1000, value));
+
+  // Polling kept its interval, and the whole bus stayed under the dump's
+  // 20% plus what polling itself uses
+  for (const auto &entry : polled_)
+    EXPECT_GE(entry.second, elapsed / INTERVAL) << "register " << entry.first;
+  EXPECT_EQ(hub_.deadline_misses(), 0u);
+  double utilization = static_cast<double>(hub_.bus_stats().busy_ms - busy_before) / elapsed;
+  printf("[ metrics  ] dump of 1200 registers: %u ms, bus utilization %.1f%%\n", elapsed, utilization * 100);
+  EXPECT_LT(utilization, 0.30);
+}
+
+TEST_F(HubDumpTest, SilentBatchDoesNotStallPolling) {
+  // The ABC never answers a read of 350, so the batch 300-399 times out
+  // MAX_ATTEMPTS times and is left out. 344, polled, shares that batch.
+  abc_.silent_addresses = {350};
+  run_ms(INTERVAL);
+  polled_.clear();
+  Ranges ranges;
+  ASSERT_TRUE(parse_register_ranges("0-1199", ranges));
+  ASSERT_TRUE(hub_.dump_registers(ranges, 20, [this](const std::string &text) { out_ += text; }));
+  uint32_t start = mock_millis;
+  uint16_t value;
+  while (hub_.dump_active() && mock_millis - start < 600000) {
+    run_ms(100);
+    // Timed-out dump batches leave the cache alone
+    ASSERT_TRUE(hub_.get_register(344, value)) << "at " << mock_millis - start << " ms";
+  }
+  ASSERT_FALSE(hub_.dump_active());
+  uint32_t elapsed = mock_millis - start;
+
+  EXPECT_EQ(abc_.stats.unanswered, RegisterDump::MAX_ATTEMPTS);
+  EXPECT_NE(out_.find("# 300-399: no response"), std::string::npos);
+  auto values = parse_yaml(out_);
+  EXPECT_EQ(values.size(), 1100u);
+  EXPECT_EQ(values.count(344), 0u);
+
+  // No error backoff: polling kept its interval while the dump waited out its timeouts
+  for (const auto &entry : polled_)
+    EXPECT_GE(entry.second, elapsed / INTERVAL) << "register " << entry.first;
+  EXPECT_EQ(hub_.deadline_misses(), 0u);
+  EXPECT_EQ(hub_.bus_stats().timeouts, RegisterDump::MAX_ATTEMPTS);
+}
@@ -0,0 +1,1168 @@
+// Unit tests for poll scheduling, driving the real hub state machine against
+// a simulated ABC with virtual time (mock_millis advances 1 ms per loop()).
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "fake_abc.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+
+class SchedHub : public WaterFurnace {
+ public:
+  using WaterFurnace::poll_groups_;
+  using WaterFurnace::setup_complete_;
+  using WaterFurnace::poll_spacing_;
+  using WaterFurnace::state_groups_;
+  using WaterFurnace::PollGroup;
+};
+
+// True if a captured func 65/66 request reads `addr`
+static bool request_reads(const std::vector<uint8_t> &req, uint16_t addr) {
+  if (req.size() < 4)
+    return false;
+  const uint8_t *payload = req.data() + 2;
+  size_t payload_len = req.size() - 4;
+  if (req[1] == FUNC_READ_RANGES) {
+    for (size_t i = 0; i + 4 <= payload_len; i += 4) {
+      uint16_t start = (payload[i] << 8) | payload[i + 1];
+      uint16_t count = (payload[i + 2] << 8) | payload[i + 3];
+      if (addr >= start && addr < start + count)
+        return true;
+    }
+  } else if (req[1] == FUNC_READ_REGISTERS) {
+    for (size_t i = 0; i + 2 <= payload_len; i += 2) {
+      if (((payload[i] << 8) | payload[i + 1]) == addr)
+        return true;
+    }
+  }
+  return false;
+}
+
+// Every register a full-featured config (waterfurnace-esp32-s3.yaml) listens on
+static const std::vector<std::pair<uint16_t, RegisterCapability>> FULL_CONFIG_REGISTERS = {
+    {6, RegisterCapability::NONE},      {19, RegisterCapability::NONE},    {20, RegisterCapability::NONE},
+    {25, RegisterCapability::NONE},     {26, RegisterCapability::NONE},    {27, RegisterCapability::NONE},
+    {28, RegisterCapability::NONE},     {30, RegisterCapability::NONE},    {31, RegisterCapability::NONE},
+    {344, RegisterCapability::NONE},    {362, RegisterCapability::VS_DRIVE},
+    {16, RegisterCapability::ENERGY},   {502, RegisterCapability::AWL_THERMOSTAT},
+    {740, RegisterCapability::NONE},    {741, RegisterCapability::AWL_COMMUNICATING},
+    {742, RegisterCapability::AWL_COMMUNICATING},
+    {745, RegisterCapability::AWL_THERMOSTAT}, {746, RegisterCapability::AWL_THERMOSTAT},
+    {747, RegisterCapability::AWL_THERMOSTAT}, {900, RegisterCapability::AWL_AXB},
+    {400, RegisterCapability::AXB},     {1104, RegisterCapability::AXB},   {1105, RegisterCapability::AXB},
+    {1106, RegisterCapability::AXB},    {1107, RegisterCapability::AXB},   {1108, RegisterCapability::AXB},
+    {1109, RegisterCapability::REFRIGERATION}, {1110, RegisterCapability::AXB},
+    {1111, RegisterCapability::AXB},    {1112, RegisterCapability::AXB},   {1113, RegisterCapability::AXB},
+    {1114, RegisterCapability::AXB},    {1115, RegisterCapability::AXB},   {1116, RegisterCapability::AXB},
+    {1117, RegisterCapability::AXB},    {1119, RegisterCapability::AXB},
+    {1124, RegisterCapability::REFRIGERATION}, {1125, RegisterCapability::REFRIGERATION},
+    {1134, RegisterCapability::REFRIGERATION}, {1135, RegisterCapability::VS_DRIVE},
+    {1136, RegisterCapability::VS_DRIVE},
+    {1146, RegisterCapability::ENERGY}, {1147, RegisterCapability::ENERGY}, {1148, RegisterCapability::ENERGY},
+    {1149, RegisterCapability::ENERGY}, {1150, RegisterCapability::ENERGY}, {1151, RegisterCapability::ENERGY},
+    {1152, RegisterCapability::ENERGY}, {1153, RegisterCapability::ENERGY}, {1154, RegisterCapability::REFRIGERATION},
+    {1155, RegisterCapability::REFRIGERATION}, {1156, RegisterCapability::REFRIGERATION},
+    {1157, RegisterCapability::REFRIGERATION}, {1164, RegisterCapability::ENERGY},
+    {1165, RegisterCapability::ENERGY},
+    {3001, RegisterCapability::VS_DRIVE}, {3027, RegisterCapability::VS_DRIVE},
+    {3322, RegisterCapability::VS_DRIVE}, {3323, RegisterCapability::VS_DRIVE},
+    {3325, RegisterCapability::VS_DRIVE}, {3326, RegisterCapability::VS_DRIVE},
+    {3327, RegisterCapability::VS_DRIVE}, {3330, RegisterCapability::VS_DRIVE},
+    {3331, RegisterCapability::VS_DRIVE}, {3332, RegisterCapability::VS_DRIVE},
+    {3422, RegisterCapability::VS_DRIVE}, {3423, RegisterCapability::VS_DRIVE},
+    {3424, RegisterCapability::VS_DRIVE}, {3425, RegisterCapability::VS_DRIVE},
+    {3522, RegisterCapability::VS_DRIVE}, {3523, RegisterCapability::VS_DRIVE},
+    {3524, RegisterCapability::VS_DRIVE}, {3808, RegisterCapability::VS_DRIVE},
+    {3903, RegisterCapability::VS_DRIVE}, {3905, RegisterCapability::VS_DRIVE},
+    {3906, RegisterCapability::VS_DRIVE},
+    {12005, RegisterCapability::AWL_THERMOSTAT}, {12006, RegisterCapability::AWL_THERMOSTAT},
+};
+
+// Load statistics collected while the hub runs
+struct LoadStats {
+  uint32_t max_iteration_cost_us{0};  // Worst single loop() iteration
+  uint32_t peak_window_dispatches{0};  // Most listener calls inside any 1 s window
+  uint32_t total_dispatches{0};
+  double mean_register_age_ms{0};      // Age of a register's value sampled every ms
+};
+
+class SchedulingTest : public ::testing::Test {
+ protected:
+  // Virtual cost of one listener callback (publish_state fan-out on a real device)
+  static constexpr uint32_t CALLBACK_COST_US = 300;
+  static constexpr uint32_t INTERVAL = 10000;
+
+  void SetUp() override {
+    mock_millis = 0;
+    hub_.set_mock_backend(&abc_);
+    hub_.set_update_interval(INTERVAL);
+    for (const auto &reg : FULL_CONFIG_REGISTERS) {
+      uint16_t addr = reg.first;
+      hub_.register_listener(addr, [this, addr](uint16_t) {
+        this->iteration_cost_us_ += CALLBACK_COST_US;
+        mock_micros += CALLBACK_COST_US;
+        this->dispatch_times_.push_back(mock_millis);
+        this->last_seen_[addr] = mock_millis;
+      }, reg.second);
+    }
+  }
+
+  // Run the hub for `ms` of virtual time, calling update() on the interval
+  LoadStats run_for(uint32_t ms, uint16_t sampled_addr = 1107) {
+    LoadStats stats;
+    uint32_t end = mock_millis + ms;
+    uint64_t age_sum = 0;
+    uint32_t age_samples = 0;
+    while (mock_millis < end) {
+      if (!started_) {
+        hub_.setup();
+        started_ = true;
+      }
+      this->iteration_cost_us_ = 0;
+      step_hub(hub_, INTERVAL, last_update_);
+      stats.max_iteration_cost_us = std::max(stats.max_iteration_cost_us, this->iteration_cost_us_);
+      auto it = last_seen_.find(sampled_addr);
+      if (it != last_seen_.end()) {
+        age_sum += mock_millis - it->second;
+        age_samples++;
+      }
+      mock_millis++;
+    }
+
+    // Sliding 1 s window over dispatch timestamps
+    size_t lo = 0;
+    for (size_t hi = 0; hi < dispatch_times_.size(); hi++) {
+      while (dispatch_times_[hi] - dispatch_times_[lo] >= 1000)
+        lo++;
+      stats.peak_window_dispatches = std::max<uint32_t>(stats.peak_window_dispatches, hi - lo + 1);
+    }
+    stats.total_dispatches = dispatch_times_.size();
+    stats.mean_register_age_ms = age_samples ? static_cast<double>(age_sum) / age_samples : 0;
+    return stats;
+  }
+
+  // Bring the hub through setup and into steady state, then reset counters
+  void warm_up() {
+    run_for(INTERVAL + 2000);
+    dispatch_times_.clear();
+  }
+
+  size_t reads_of(uint16_t addr, size_t since = 0) const {
+    size_t n = 0;
+    for (size_t i = since; i < abc_.requests.size(); i++)
+      n += request_reads(abc_.requests[i], addr);
+    return n;
+  }
+
+  SchedHub hub_;
+  FakeABC abc_;
+  bool started_{false};
+  uint32_t last_update_{0};
+  uint32_t iteration_cost_us_{0};
+  std::vector<uint32_t> dispatch_times_;
+  std::map<uint16_t, uint32_t> last_seen_;
+};
+
+TEST_F(SchedulingTest, BurstPollsEveryGroupEachInterval) {
+  warm_up();
+  ASSERT_TRUE(hub_.setup_complete_);
+  ASSERT_GE(hub_.poll_groups_.size(), 3u);
+
+  size_t before = abc_.requests.size();
+  run_for(INTERVAL * 3);
+  EXPECT_EQ(abc_.requests.size() - before, hub_.poll_groups_.size() * 3);
+}
+
+TEST_F(SchedulingTest, PacedPollsEveryGroupEachInterval) {
+  hub_.set_poll_mode(PollMode::PACED);
+  warm_up();
+  ASSERT_GE(hub_.poll_groups_.size(), 3u);
+
+  size_t before = abc_.requests.size();
+  run_for(INTERVAL * 3);
+  EXPECT_EQ(abc_.requests.size() - before, hub_.poll_groups_.size() * 3);
+}
+
+TEST_F(SchedulingTest, PacedSpacingSpreadsGroupsAcrossInterval) {
+  hub_.set_poll_mode(PollMode::PACED);
+  warm_up();
+  size_t groups = hub_.poll_groups_.size();
+  EXPECT_EQ(hub_.poll_spacing_(), INTERVAL / groups);
+
+  // Request timestamps within one cycle are at least one spacing apart
+  std::vector<uint32_t> sent_at;
+  size_t seen = abc_.requests.size();
+  uint32_t end = mock_millis + INTERVAL;
+  while (mock_millis < end) {
+    run_for(1);
+    if (abc_.requests.size() != seen) {
+      sent_at.push_back(mock_millis);
+      seen = abc_.requests.size();
+    }
+  }
+  ASSERT_EQ(sent_at.size(), groups);
+  for (size_t i = 1; i < sent_at.size(); i++) {
+    EXPECT_GE(sent_at[i] - sent_at[i - 1], hub_.poll_spacing_() - 1);
+  }
+}
+
+TEST_F(SchedulingTest, PacedMinGapWins) {
+  hub_.set_poll_mode(PollMode::PACED);
+  hub_.set_min_poll_gap(5000);
+  warm_up();
+  EXPECT_EQ(hub_.poll_spacing_(), 5000u);
+}
+
+TEST_F(SchedulingTest, PacedWriteDoesNotSkipGroup) {
+  hub_.set_poll_mode(PollMode::PACED);
+  warm_up();
+
+  // Align to the start of a cycle, then queue a write between two paced groups
+  run_for(last_update_ + INTERVAL - mock_millis);
+  size_t before = abc_.requests.size();
+  run_for(hub_.poll_spacing_() + 10);
+  hub_.write_register(REG_DHW_ENABLE, 1);
+  run_for(INTERVAL * 2 - hub_.poll_spacing_() - 10);
+
+  // Two full cycles of reads plus the write and its verify read-back
+  EXPECT_EQ(abc_.requests.size() - before, hub_.poll_groups_.size() * 2 + 2);
+  EXPECT_EQ(abc_.read(REG_DHW_ENABLE), 1);
+}
+
+// Instrumentation comparison: burst vs paced over the same simulated minute
+TEST(SchedulingComparison, BurstVersusPaced) {
+  LoadStats results[2];
+  const char *names[2] = {"burst", "paced"};
+  for (int mode = 0; mode < 2; mode++) {
+    class Runner : public SchedulingTest {
+     public:
+      void TestBody() override {}
+      LoadStats run(PollMode m) {
+        SetUp();
+        hub_.set_poll_mode(m);
+        warm_up();
+        return run_for(60000);
+      }
+    } runner;
+    results[mode] = runner.run(mode == 0 ? PollMode::BURST : PollMode::PACED);
+  }
+
+  printf("  %-6s  %22s  %22s  %16s  %18s\n", "mode", "max loop iteration (us)", "peak dispatches / 1 s",
+         "total dispatches", "mean age 1107 (ms)");
+  for (int mode = 0; mode < 2; mode++) {
+    printf("  %-6s  %22u  %22u  %16u  %18.0f\n", names[mode], results[mode].max_iteration_cost_us,
+           results[mode].peak_window_dispatches, results[mode].total_dispatches,
+           results[mode].mean_register_age_ms);
+  }
+
+  // Same amount of work overall
+  EXPECT_EQ(results[0].total_dispatches, results[1].total_dispatches);
+  // A single iteration never handles more than one response in either mode
+  EXPECT_LE(results[1].max_iteration_cost_us, results[0].max_iteration_cost_us);
+  // Pacing spreads the work: the busiest second carries far fewer callbacks
+  EXPECT_LT(results[1].peak_window_dispatches * 2, results[0].peak_window_dispatches);
+}
+
+// ====== Adaptive polling ======
+
+class AdaptivePollingTest : public SchedulingTest {
+ protected:
+  void SetUp() override {
+    SchedulingTest::SetUp();
+    hub_.set_adaptive_polling(2000, 60000, 30000);
+  }
+};
+
+TEST_F(AdaptivePollingTest, StateDependentRegistersSplitOut) {
+  warm_up();
+  ASSERT_FALSE(hub_.state_groups_.empty());
+
+  auto group_reads = [](const std::vector<SchedHub::PollGroup> &groups, uint16_t addr) {
+    for (const auto &g : groups) {
+      for (const auto &r : g.ranges)
+        if (addr >= r.first && addr < r.first + r.second)
+          return true;
+      for (uint16_t a : g.individual)
+        if (a == addr)
+          return true;
+    }
+    return false;
+  };
+  // Amps, watts and VS speed are state-dependent; outputs/status and temperatures are not
+  EXPECT_TRUE(group_reads(hub_.state_groups_, REG_COMPRESSOR_1_AMPS));
+  EXPECT_TRUE(group_reads(hub_.state_groups_, REG_TOTAL_WATTS_HI));
+  EXPECT_TRUE(group_reads(hub_.state_groups_, REG_VS_SPEED_ACTUAL));
+  EXPECT_FALSE(group_reads(hub_.poll_groups_, REG_COMPRESSOR_1_AMPS));
+  EXPECT_TRUE(group_reads(hub_.poll_groups_, REG_SYSTEM_OUTPUTS));
+  EXPECT_TRUE(group_reads(hub_.poll_groups_, REG_STATUS));
+  EXPECT_TRUE(group_reads(hub_.poll_groups_, REG_TSTAT_AMBIENT));
+  EXPECT_FALSE(group_reads(hub_.state_groups_, REG_TSTAT_AMBIENT));
+}
+
+TEST_F(AdaptivePollingTest, IdleUsesSlowRate) {
+  warm_up();
+  size_t since = abc_.requests.size();
+  run_for(120000);
+  // Two slow reads of the state groups, twelve base cycles for the outputs register
+  EXPECT_EQ(reads_of(REG_COMPRESSOR_1_AMPS, since), 2u);
+  EXPECT_EQ(reads_of(REG_SYSTEM_OUTPUTS, since), 12u);
+}
+
+TEST_F(AdaptivePollingTest, RunningUsesFastRate) {
+  abc_.registers[REG_SYSTEM_OUTPUTS] = OUTPUT_CC | OUTPUT_BLOWER;
+  warm_up();
+  size_t since = abc_.requests.size();
+  run_for(20000);
+  EXPECT_EQ(reads_of(REG_COMPRESSOR_1_AMPS, since), 10u);
+}
+
+TEST_F(AdaptivePollingTest, OutputChangeHoldsFastRate) {
+  abc_.registers[REG_SYSTEM_OUTPUTS] = OUTPUT_CC | OUTPUT_BLOWER;
+  warm_up();
+
+  // Unit shuts off: picked up by the next base cycle, then the fast rate holds
+  abc_.registers[REG_SYSTEM_OUTPUTS] = 0;
+  run_for(INTERVAL);
+  size_t since = abc_.requests.size();
+  run_for(20000);
+  EXPECT_GE(reads_of(REG_COMPRESSOR_1_AMPS, since), 9u);
+
+  // After the hold time expires it drops back to the slow rate
+  run_for(20000);
+  since = abc_.requests.size();
+  run_for(50000);
+  EXPECT_LE(reads_of(REG_COMPRESSOR_1_AMPS, since), 1u);
+}
+
+TEST_F(AdaptivePollingTest, StatusChangeAloneTriggersFastRate) {
+  warm_up();
+  run_for(60000);
+  // An input change (e.g. a thermostat call) with no outputs yet
+  abc_.registers[REG_STATUS] = 0x01;
+  run_for(INTERVAL);
+  size_t since = abc_.requests.size();
+  run_for(10000);
+  EXPECT_GE(reads_of(REG_COMPRESSOR_1_AMPS, since), 4u);
+}
+
+TEST_F(AdaptivePollingTest, BurstCycleNotLostWhileStateGroupInFlight) {
+  abc_.registers[REG_SYSTEM_OUTPUTS] = OUTPUT_CC;
+  warm_up();
+  size_t since = abc_.requests.size();
+  run_for(INTERVAL * 6);
+  EXPECT_EQ(reads_of(REG_SYSTEM_OUTPUTS, since), 6u);
+}
+
+// Instrumentation comparison: fixed 10 s vs adaptive, idle and running
+TEST(SchedulingComparison, FixedVersusAdaptive) {
+  struct Result {
+    size_t transactions;
+    size_t compressor_amp_reads;
+    uint32_t dispatches;
+  };
+  auto run = [](bool adaptive, uint16_t outputs) {
+    class Runner : public SchedulingTest {
+     public:
+      void TestBody() override {}
+      Result run(bool adaptive, uint16_t outputs) {
+        SetUp();
+        if (adaptive)
+          hub_.set_adaptive_polling(2000, 60000, 30000);
+        abc_.registers[REG_SYSTEM_OUTPUTS] = outputs;
+        warm_up();
+        size_t since = abc_.requests.size();
+        LoadStats stats = run_for(300000);
+        return {abc_.requests.size() - since, reads_of(REG_COMPRESSOR_1_AMPS, since), stats.total_dispatches};
+      }
+    } runner;
+    return runner.run(adaptive, outputs);
+  };
+
+  Result fixed_idle = run(false, 0);
+  Result adaptive_idle = run(true, 0);
+  Result fixed_running = run(false, OUTPUT_CC | OUTPUT_BLOWER);
+  Result adaptive_running = run(true, OUTPUT_CC | OUTPUT_BLOWER);
+
+  printf("  %-18s  %12s  %22s  %16s\n", "5 min, 10 s base", "transactions", "compressor amp reads",
+         "dispatches");
+  auto row = [](const char *name, const Result &r) {
+    printf("  %-18s  %12zu  %22zu  %16u\n", name, r.transactions, r.compressor_amp_reads, r.dispatches);
+  };
+  row("fixed, idle", fixed_idle);
+  row("adaptive, idle", adaptive_idle);
+  row("fixed, running", fixed_running);
+  row("adaptive, running", adaptive_running);
+
+  EXPECT_LT(adaptive_idle.transactions, fixed_idle.transactions);
+  EXPECT_LT(adaptive_idle.dispatches, fixed_idle.dispatches);
+  EXPECT_GT(adaptive_running.compressor_amp_reads, fixed_running.compressor_amp_reads * 4);
+}
+
+// ====== Event-triggered dependent refresh ======
+
+class RefreshTest : public SchedulingTest {
+ protected:
+  // Change the outputs register, then time how long until `dependent` is re-read
+  // after the change is first observed
+  uint32_t lag_after_output_change(uint16_t outputs, uint16_t dependent) {
+    abc_.registers[REG_SYSTEM_OUTPUTS] = outputs;
+    size_t seen = abc_.requests.size();
+    uint32_t observed_at = 0;
+    bool observed = false;
+    uint32_t end = mock_millis + INTERVAL * 3;
+    while (mock_millis < end) {
+      run_for(1);
+      for (; seen < abc_.requests.size(); seen++) {
+        if (!observed && request_reads(abc_.requests[seen], REG_SYSTEM_OUTPUTS)) {
+          observed = true;
+          observed_at = mock_millis;
+        } else if (observed && request_reads(abc_.requests[seen], dependent)) {
+          return mock_millis - observed_at;
+        }
+      }
+    }
+    return UINT32_MAX;
+  }
+};
+
+TEST_F(RefreshTest, PacedRefreshesDependentsImmediately) {
+  hub_.set_poll_mode(PollMode::PACED);
+  warm_up();
+  // Without the refresh the amps group is several paced slots (seconds) behind
+  EXPECT_LE(lag_after_output_change(OUTPUT_CC | OUTPUT_BLOWER, REG_COMPRESSOR_1_AMPS), 5u);
+  EXPECT_LE(lag_after_output_change(OUTPUT_CC | OUTPUT_CC2 | OUTPUT_BLOWER, REG_VS_SPEED_ACTUAL), 5u);
+}
+
+TEST_F(RefreshTest, AdaptiveRefreshesStateGroupsImmediately) {
+  hub_.set_adaptive_polling(2000, 60000, 30000);
+  warm_up();
+  run_for(5000);
+  EXPECT_LE(lag_after_output_change(OUTPUT_CC | OUTPUT_BLOWER, REG_TOTAL_WATTS_HI), 5u);
+}
+
+TEST_F(RefreshTest, BurstDoesNotDoubleRead) {
+  warm_up();
+  run_for(INTERVAL - 2000 - 1);  // Just before the next burst
+  abc_.registers[REG_SYSTEM_OUTPUTS] = OUTPUT_CC;
+  size_t since = abc_.requests.size();
+  run_for(INTERVAL);
+  // The change is seen mid-burst; later groups in the same burst are already fresh
+  EXPECT_EQ(reads_of(REG_COMPRESSOR_1_AMPS, since), 1u);
+  EXPECT_EQ(abc_.requests.size() - since, hub_.poll_groups_.size());
+}
+
+TEST_F(RefreshTest, NoRefreshWithoutChange) {
+  hub_.set_poll_mode(PollMode::PACED);
+  warm_up();
+  size_t since = abc_.requests.size();
+  run_for(INTERVAL * 3);
+  EXPECT_EQ(abc_.requests.size() - since, hub_.poll_groups_.size() * 3);
+}
+
+// ====== Transaction queue ======
+
+TEST_F(SchedulingTest, QueueRunsMostUrgentClassFirst) {
+  warm_up();
+  // Everything lands in the same tick: a burst, an on-demand read and a write
+  run_for(last_update_ + INTERVAL - mock_millis - 1);
+  hub_.request_read({REG_LINE_VOLTAGE});
+  hub_.write_register(REG_DHW_ENABLE, 1);
+  size_t since = abc_.requests.size();
+  run_for(100);
+
+  ASSERT_GE(abc_.requests.size() - since, 3u + hub_.poll_groups_.size());
+  // Write, its verify read-back, the on-demand read, then the poll cycle
+  EXPECT_EQ(abc_.requests[since][1], FUNC_WRITE_REGISTERS);
+  EXPECT_EQ(abc_.requests[since + 1][1], FUNC_READ_REGISTERS);
+  EXPECT_TRUE(request_reads(abc_.requests[since + 1], REG_DHW_ENABLE));
+  EXPECT_EQ(abc_.requests[since + 2][1], FUNC_READ_REGISTERS);
+  EXPECT_TRUE(request_reads(abc_.requests[since + 2], REG_LINE_VOLTAGE));
+  for (size_t i = since + 3; i < abc_.requests.size(); i++)
+    EXPECT_EQ(abc_.requests[i][1], FUNC_READ_RANGES);
+  EXPECT_EQ(hub_.deadline_misses(), 0u);
+}
+
+TEST_F(SchedulingTest, WriteJumpsAheadOfPacedSlots) {
+  hub_.set_poll_mode(PollMode::PACED);
+  warm_up();
+  run_for(last_update_ + INTERVAL - mock_millis + 10);  // Just into a new paced cycle
+  EXPECT_GT(hub_.queue_depth(), 0u);
+
+  size_t since = abc_.requests.size();
+  hub_.write_register(REG_DHW_ENABLE, 1);
+  run_for(2);
+  ASSERT_EQ(abc_.requests.size() - since, 2u);
+  EXPECT_EQ(abc_.requests[since][1], FUNC_WRITE_REGISTERS);
+  EXPECT_EQ(abc_.read(REG_DHW_ENABLE), 1);
+}
+
+TEST_F(SchedulingTest, QueuedWritesCoalesce) {
+  warm_up();
+  abc_.silent = true;  // Hold the bus so the writes stay queued
+  hub_.request_read({REG_LINE_VOLTAGE});
+  run_for(1);
+  abc_.silent = false;
+  hub_.write_register(REG_DHW_ENABLE, 1);
+  hub_.write_register(REG_DHW_SETPOINT, 1200);
+  hub_.write_register(REG_DHW_ENABLE, 0);
+  EXPECT_EQ(hub_.queue_depth(), 1u);
+
+  size_t since = abc_.requests.size();
+  run_for(8000);  // Timeout and backoff for the silent read, then the write
+  size_t writes = 0;
+  for (size_t i = since; i < abc_.requests.size(); i++)
+    writes += abc_.requests[i][1] == FUNC_WRITE_REGISTERS;
+  EXPECT_EQ(writes, 1u);
+  EXPECT_EQ(abc_.read(REG_DHW_ENABLE), 0);
+  EXPECT_EQ(abc_.read(REG_DHW_SETPOINT), 1200);
+}
+
+TEST_F(SchedulingTest, CoalescedWritesStayWithinAFrame) {
+  warm_up();
+  abc_.silent = true;  // Hold the bus so the writes stay queued
+  hub_.request_read({REG_LINE_VOLTAGE});
+  run_for(1);
+  abc_.silent = false;
+  const uint16_t count = MAX_WRITES_PER_REQUEST * 2 + 10;
+  for (uint16_t i = 0; i < count; i++)
+    hub_.write_register(2000 + i, i);
+  EXPECT_EQ(hub_.queue_depth(), 3u);
+
+  size_t since = abc_.requests.size();
+  run_for(8000);
+  size_t writes = 0;
+  for (size_t i = since; i < abc_.requests.size(); i++) {
+    EXPECT_LE(abc_.requests[i].size(), MAX_FRAME_SIZE);
+    writes += abc_.requests[i][1] == FUNC_WRITE_REGISTERS;
+  }
+  EXPECT_EQ(writes, 3u);
+  for (uint16_t i = 0; i < count; i++)
+    EXPECT_EQ(abc_.read(2000 + i), i) << "register " << 2000 + i;
+}
+
+TEST_F(SchedulingTest, DeadlineMissesCountedWhenBusStalls) {
+  warm_up();
+  EXPECT_EQ(hub_.deadline_misses(), 0u);
+
+  // A dead bus: every transaction times out and backs off while writes pile up
+  abc_.silent = true;
+  for (int i = 0; i < 5; i++) {
+    hub_.write_register(REG_DHW_SETPOINT, 1000 + i);
+    hub_.request_read({REG_LINE_VOLTAGE});
+    run_for(3000);
+  }
+  EXPECT_GT(hub_.queue_depth(), 0u);
+  EXPECT_GT(hub_.peak_queue_depth(), 1u);
+  EXPECT_GT(hub_.deadline_misses(), 0u);
+
+  // Bus recovers: the queue drains
+  abc_.silent = false;
+  run_for(INTERVAL * 2);
+  EXPECT_EQ(hub_.queue_depth(), 0u);
+}
+
+TEST_F(SchedulingTest, OnDemandReadDispatches) {
+  warm_up();
+  abc_.registers[REG_LINE_VOLTAGE] = 240;
+  hub_.request_read({REG_LINE_VOLTAGE});
+  run_for(2);  // Request, then response: cache and listeners in the same loop
+  uint16_t value = 0;
+  ASSERT_TRUE(hub_.get_register(REG_LINE_VOLTAGE, value));
+  EXPECT_EQ(value, 240);
+  EXPECT_EQ(last_seen_[REG_LINE_VOLTAGE], mock_millis - 1);
+}
+
+// Runs until `hub_.read_registers()` calls back, or gives up after 20 s
+struct RegisterReadResult {
+  bool done{false};
+  std::vector<std::pair<uint16_t, uint16_t>> values;
+  std::vector<uint16_t> missing;
+  WaterFurnace::RegisterReadCallback callback() {
+    return [this](const std::vector<std::pair<uint16_t, uint16_t>> &v, const std::vector<uint16_t> &m) {
+      done = true;
+      values = v;
+      missing = m;
+    };
+  }
+};
+
+TEST_F(SchedulingTest, ReadRegistersMergesConcurrentRequests) {
+  warm_up();
+  abc_.registers[40] = 4;
+  abc_.registers[12101] = 7;
+  abc_.registers[31010] = 9;
+  RegisterReadResult a, b, c;
+  hub_.read_registers({40, 41, 42, 1200}, 0, a.callback());
+  hub_.read_registers({42, 43, 12101, 12102}, 0, b.callback());
+  hub_.read_registers({31010}, 0, c.callback());
+  size_t before = abc_.requests.size();
+  while (!(a.done && b.done && c.done) && mock_millis < 30000)
+    run_for(1);
+  ASSERT_TRUE(a.done && b.done && c.done);
+  // One func 65 request below the first breakpoint, one func 66 between the
+  // breakpoints and one func 65 above the second, for all three requests
+  ASSERT_EQ(abc_.requests.size() - before, 3u);
+  EXPECT_EQ(abc_.requests[before][1], FUNC_READ_RANGES);
+  EXPECT_EQ(abc_.requests[before + 1][1], FUNC_READ_REGISTERS);
+  EXPECT_EQ(abc_.requests[before + 2][1], FUNC_READ_RANGES);
+  EXPECT_EQ(reads_of(42, before), 1u);
+  EXPECT_EQ(a.values, (std::vector<std::pair<uint16_t, uint16_t>>{{40, 4}, {41, 0}, {42, 0}, {1200, 0}}));
+  EXPECT_EQ(b.values[2], (std::pair<uint16_t, uint16_t>{12101, 7}));
+  EXPECT_EQ(c.values, (std::vector<std::pair<uint16_t, uint16_t>>{{31010, 9}}));
+  EXPECT_TRUE(a.missing.empty() && b.missing.empty() && c.missing.empty());
+}
+
+TEST_F(SchedulingTest, ReadRegistersUsesTheCacheWithinMaxAge) {
+  hub_.track_read_times();  // As setup() does with the read_registers service
+  warm_up();
+  RegisterReadResult cached, fresh;
+  size_t before = abc_.requests.size();
+  // Polled every 10 s, so never older than that
+  hub_.read_registers({REG_LINE_VOLTAGE, 31}, INTERVAL, cached.callback());
+  run_for(1);
+  ASSERT_TRUE(cached.done);
+  EXPECT_EQ(cached.values.size(), 2u);
+  EXPECT_EQ(abc_.requests.size(), before);
+
+  abc_.registers[31] = 1234;
+  hub_.read_registers({REG_LINE_VOLTAGE, 31}, 0, fresh.callback());
+  run_for(10);
+  ASSERT_TRUE(fresh.done);
+  EXPECT_EQ(fresh.values[1], (std::pair<uint16_t, uint16_t>{31, 1234}));
+  EXPECT_EQ(reads_of(31, before), 1u);
+}
+
+TEST_F(SchedulingTest, ReadRegistersReportsRejectedAddresses) {
+  warm_up();
+  RegisterReadResult result;
+  abc_.exception_next = true;
+  hub_.read_registers({40, 12101}, 0, result.callback());
+  run_for(20);
+  ASSERT_TRUE(result.done);
+  // The func 65 batch was rejected; the func 66 one was answered
+  EXPECT_EQ(result.missing, (std::vector<uint16_t>{40}));
+  EXPECT_EQ(result.values, (std::vector<std::pair<uint16_t, uint16_t>>{{12101, 0}}));
+}
+
+// --- Bus telemetry ---
+
+TEST(RttHistogramTest, EmptyReportsZero) {
+  RttHistogram h;
+  EXPECT_EQ(h.count(), 0u);
+  EXPECT_EQ(h.min(), 0u);
+  EXPECT_EQ(h.max(), 0u);
+  EXPECT_EQ(h.percentile(50), 0u);
+}
+
+TEST(RttHistogramTest, PercentilesWithinBucketResolution) {
+  RttHistogram h;
+  for (uint32_t ms = 1; ms <= 100; ms++)
+    h.record(ms);
+  EXPECT_EQ(h.count(), 100u);
+  EXPECT_EQ(h.min(), 1u);
+  EXPECT_EQ(h.max(), 100u);
+  // Buckets are at most 25% wide, reported at their upper edge
+  EXPECT_GE(h.percentile(50), 50u);
+  EXPECT_LE(h.percentile(50), 63u);
+  EXPECT_GE(h.percentile(99), 99u);
+  EXPECT_LE(h.percentile(99), 100u);
+  EXPECT_EQ(h.percentile(100), 100u);
+}
+
+TEST(RttHistogramTest, OutliersLandInLastBucket) {
+  RttHistogram h;
+  h.record(5);
+  h.record(60000);
+  EXPECT_EQ(h.max(), 60000u);
+  EXPECT_EQ(h.percentile(50), 5u);
+  EXPECT_EQ(h.percentile(99), 60000u);
+}
+
+TEST_F(SchedulingTest, BusStatsCountBytesAndFunctions) {
+  warm_up();
+  const BusStats &stats = hub_.bus_stats();
+  uint32_t tx = 0;
+  uint32_t per_func[256] = {};
+  for (const auto &req : abc_.requests) {
+    tx += req.size();
+    per_func[req[1]]++;
+  }
+  EXPECT_EQ(stats.tx_bytes, tx);
+  EXPECT_GT(stats.rx_bytes, 0u);
+  EXPECT_EQ(stats.read_ranges, per_func[FUNC_READ_RANGES]);
+  EXPECT_EQ(stats.read_registers, per_func[FUNC_READ_REGISTERS]);
+  EXPECT_EQ(stats.transactions(), abc_.requests.size());
+  EXPECT_EQ(stats.rtt.count(), abc_.requests.size());
+  EXPECT_EQ(stats.crc_errors + stats.exceptions + stats.timeouts + stats.value_count_mismatches, 0u);
+}
+
+TEST_F(SchedulingTest, BusStatsCountFailures) {
+  warm_up();
+  // Each failure is followed by a timeout and/or backoff before the next request
+  abc_.corrupt_next = true;
+  hub_.request_read({REG_LINE_VOLTAGE});
+  run_for(8000);
+  abc_.exception_next = true;
+  hub_.request_read({REG_LINE_VOLTAGE});
+  run_for(8000);
+  abc_.silent = true;
+  hub_.request_read({REG_LINE_VOLTAGE});
+  run_for(3000);
+
+  const BusStats &stats = hub_.bus_stats();
+  // The corrupt frame is discarded and the request then times out
+  EXPECT_EQ(stats.crc_errors, 1u);
+  EXPECT_EQ(stats.exceptions, 1u);
+  EXPECT_EQ(stats.timeouts, 2u);
+}
+
+TEST_F(SchedulingTest, GroupRttTracksResponseLatency) {
+  abc_.latency_ms = 40;
+  run_for(INTERVAL * 3);
+  for (const auto &group : hub_.poll_groups_) {
+    ASSERT_GT(group.rtt.count(), 0u);
+    EXPECT_GE(group.rtt.min(), 40u);
+    EXPECT_LE(group.rtt.max(), 45u);
+  }
+  EXPECT_GE(hub_.bus_stats().rtt.percentile(50), 40u);
+}
+
+TEST_F(SchedulingTest, BusStatSensorsPublishOnUpdate) {
+  sensor::Sensor transactions, utilization, p99;
+  hub_.set_bus_stat_sensor(BusStatSensor::TRANSACTIONS, &transactions);
+  hub_.set_bus_stat_sensor(BusStatSensor::BUS_UTILIZATION, &utilization);
+  hub_.set_bus_stat_sensor(BusStatSensor::RTT_P99, &p99);
+  abc_.latency_ms = 50;
+  warm_up();
+  run_for(INTERVAL);  // One full interval between two publishes
+
+  // Published at the last update(), before that cycle's burst went out
+  EXPECT_GT(transactions.state, 0.0f);
+  EXPECT_LT(transactions.state, hub_.bus_stats().transactions());
+  EXPECT_GE(p99.state, 50.0f);
+  // One burst of groups at ~50 ms each per interval
+  float expected = hub_.poll_groups_.size() * 50 * 100.0f / INTERVAL;
+  EXPECT_NEAR(utilization.state, expected, 0.5f);
+}
+
+// --- Budgeted dispatch ---
+
+// Addresses a captured func 65/66 request reads, in response order
+static std::vector<uint16_t> request_addresses(const std::vector<uint8_t> &req) {
+  std::vector<uint16_t> addrs;
+  const uint8_t *payload = req.data() + 2;
+  size_t payload_len = req.size() - 4;
+  if (req[1] == FUNC_READ_RANGES) {
+    for (size_t i = 0; i + 4 <= payload_len; i += 4) {
+      uint16_t start = (payload[i] << 8) | payload[i + 1];
+      uint16_t count = (payload[i + 2] << 8) | payload[i + 3];
+      for (uint16_t j = 0; j < count; j++)
+        addrs.push_back(start + j);
+    }
+  } else if (req[1] == FUNC_READ_REGISTERS) {
+    for (size_t i = 0; i + 2 <= payload_len; i += 2)
+      addrs.push_back((payload[i] << 8) | payload[i + 1]);
+  }
+  return addrs;
+}
+
+TEST_F(SchedulingTest, DispatchBudgetBoundsIterationCost) {
+  hub_.set_dispatch_budget(0);  // Whole frame per loop, as before budgeting
+  LoadStats inline_stats = run_for(INTERVAL * 3);
+
+  SchedHub budgeted;
+  FakeABC abc;
+  budgeted.set_mock_backend(&abc);
+  budgeted.set_update_interval(INTERVAL);
+  budgeted.set_dispatch_budget(1000);
+  uint32_t cost = 0;
+  uint32_t dispatches = 0;
+  for (const auto &reg : FULL_CONFIG_REGISTERS) {
+    budgeted.register_listener(reg.first, [&](uint16_t) {
+      cost += CALLBACK_COST_US;
+      mock_micros += CALLBACK_COST_US;
+      dispatches++;
+    }, reg.second);
+  }
+  uint32_t max_cost = 0;
+  uint32_t last_update = 0;
+  mock_millis = 0;
+  budgeted.setup();
+  for (; mock_millis < INTERVAL * 3; mock_millis++) {
+    if (budgeted.is_setup_complete() && mock_millis - last_update >= INTERVAL) {
+      budgeted.update();
+      last_update = mock_millis;
+    }
+    cost = 0;
+    budgeted.loop();
+    max_cost = std::max(max_cost, cost);
+  }
+
+  // The budget is checked after each register, so one register's listeners may overshoot it
+  EXPECT_GT(inline_stats.max_iteration_cost_us, 1000u + CALLBACK_COST_US);
+  EXPECT_LE(max_cost, 1000u + CALLBACK_COST_US);
+  EXPECT_GT(budgeted.peak_dispatch_backlog(), 0u);
+  EXPECT_EQ(budgeted.dispatch_backlog(), 0u);
+  EXPECT_EQ(dispatches, inline_stats.total_dispatches);
+}
+
+TEST_F(SchedulingTest, BudgetedDispatchKeepsFrameOrder) {
+  std::set<uint16_t> listened;
+  for (const auto &reg : FULL_CONFIG_REGISTERS)
+    listened.insert(reg.first);
+  std::vector<uint16_t> order;
+  for (uint16_t addr : listened)
+    hub_.register_listener(addr, [&order, addr](uint16_t) { order.push_back(addr); });
+
+  warm_up();
+  order.clear();
+  size_t since = abc_.requests.size();
+  hub_.set_dispatch_budget(1);  // One register per loop, so several frames back up
+  run_for(INTERVAL);
+  run_for(INTERVAL);  // Drain
+  ASSERT_EQ(hub_.dispatch_backlog(), 0u);
+  EXPECT_GT(hub_.peak_dispatch_backlog(), 21u);  // Larger than any single frame
+
+  std::vector<uint16_t> expected;
+  for (size_t i = since; i < abc_.requests.size(); i++) {
+    for (uint16_t addr : request_addresses(abc_.requests[i])) {
+      if (listened.count(addr))
+        expected.push_back(addr);
+    }
+  }
+  EXPECT_EQ(order, expected);
+}
+
+// ====== Shared bus (several hubs, one UART) ======
+
+TEST(BusArbiterTest, GrantsOneClientAtATime) {
+  BusArbiter arb;
+  uint8_t a = arb.add_client();
+  uint8_t b = arb.add_client();
+  EXPECT_TRUE(arb.acquire(a));
+  EXPECT_TRUE(arb.acquire(a));  // Re-entrant for the owner
+  EXPECT_FALSE(arb.acquire(b));
+  arb.release(b);  // Not the owner: ignored
+  EXPECT_EQ(arb.owner(), a);
+  arb.release(a);
+  EXPECT_TRUE(arb.acquire(b));
+}
+
+TEST(BusArbiterTest, RoundRobinAfterRelease) {
+  BusArbiter arb;
+  uint8_t a = arb.add_client();
+  uint8_t b = arb.add_client();
+  uint8_t c = arb.add_client();
+  ASSERT_TRUE(arb.acquire(a));
+  EXPECT_FALSE(arb.acquire(c));
+  EXPECT_FALSE(arb.acquire(b));
+  arb.release(a);
+  // a asks again first, but b and c were waiting and come before it
+  EXPECT_FALSE(arb.acquire(a));
+  EXPECT_FALSE(arb.acquire(c));
+  EXPECT_TRUE(arb.acquire(b));
+  arb.release(b);
+  EXPECT_FALSE(arb.acquire(a));
+  EXPECT_TRUE(arb.acquire(c));
+  arb.release(c);
+  EXPECT_TRUE(arb.acquire(a));
+}
+
+TEST(BusArbiterTest, WithdrawnClientDoesNotBlock) {
+  BusArbiter arb;
+  uint8_t a = arb.add_client();
+  uint8_t b = arb.add_client();
+  ASSERT_TRUE(arb.acquire(b));
+  EXPECT_FALSE(arb.acquire(a));
+  arb.release(b);
+  arb.withdraw(a);
+  EXPECT_TRUE(arb.acquire(b));
+}
+
+TEST(BusArbiterTest, RejectsClientsBeyondLimit) {
+  BusArbiter arb;
+  for (uint8_t i = 0; i < BusArbiter::MAX_CLIENTS; i++)
+    EXPECT_EQ(arb.add_client(), i);
+  EXPECT_EQ(arb.add_client(), BusArbiter::NO_CLIENT);
+  EXPECT_FALSE(arb.acquire(BusArbiter::NO_CLIENT));
+}
+
+class MultiHub : public SchedHub {
+ public:
+  using WaterFurnace::registers_;
+  using WaterFurnace::connected_;
+};
+
+class SharedBusTest : public ::testing::Test {
+ protected:
+  static constexpr uint32_t INTERVAL = 5000;
+
+  void SetUp() override {
+    mock_millis = 0;
+    abc_[0].address = 1;
+    abc_[1].address = 2;
+    abc_[1].registers[REG_SERIAL_NUMBER] = 0x3939;  // "99"
+    for (int i = 0; i < 2; i++) {
+      bus_.add_unit(&abc_[i]);
+      hub_[i].set_address(i + 1);
+      hub_[i].set_bus_arbiter(&arbiter_);
+      hub_[i].set_mock_backend(&bus_);
+      hub_[i].set_update_interval(INTERVAL);
+      for (const auto &reg : FULL_CONFIG_REGISTERS)
+        hub_[i].register_listener(reg.first, [](uint16_t) {}, reg.second);
+    }
+  }
+
+  void run_for(uint32_t ms) {
+    uint32_t end = mock_millis + ms;
+    while (mock_millis < end) {
+      for (int i = 0; i < 2; i++) {
+        if (!started_) {
+          hub_[i].setup();
+          continue;
+        }
+        if (hub_[i].is_setup_complete() && mock_millis - last_update_[i] >= INTERVAL) {
+          hub_[i].update();
+          last_update_[i] = mock_millis;
+        }
+        hub_[i].loop();
+      }
+      started_ = true;
+      mock_millis++;
+    }
+  }
+
+  BusArbiter arbiter_;
+  SharedBus bus_;
+  FakeABC abc_[2];
+  MultiHub hub_[2];
+  bool started_{false};
+  uint32_t last_update_[2]{0, 0};
+};
+
+TEST_F(SharedBusTest, EachHubPollsItsOwnUnit) {
+  abc_[0].registers[1110] = 500;
+  abc_[1].registers[1110] = 620;
+  run_for(INTERVAL * 3);
+
+  for (int i = 0; i < 2; i++) {
+    ASSERT_TRUE(hub_[i].is_setup_complete()) << i;
+    EXPECT_TRUE(hub_[i].connected_) << i;
+    EXPECT_GT(abc_[i].requests.size(), 3u) << i;
+    for (const auto &req : abc_[i].requests)
+      EXPECT_EQ(req[0], i + 1);
+  }
+  EXPECT_EQ(hub_[0].registers_[1110], 500);
+  EXPECT_EQ(hub_[1].registers_[1110], 620);
+  EXPECT_EQ(hub_[0].registers_[REG_SERIAL_NUMBER], abc_[0].read(REG_SERIAL_NUMBER));
+  EXPECT_EQ(hub_[1].registers_[REG_SERIAL_NUMBER], 0x3939);
+}
+
+TEST_F(SharedBusTest, NeverTwoRequestsOnTheBus) {
+  abc_[0].latency_ms = 30;
+  abc_[1].latency_ms = 30;
+  run_for(INTERVAL * 4);
+  EXPECT_GT(bus_.writes.size(), 10u);
+  EXPECT_EQ(bus_.collisions, 0u);
+}
+
+TEST_F(SharedBusTest, InterleavesHubsFairly) {
+  run_for(INTERVAL * 2);
+  // Both hubs have a full cycle queued at once: the bus alternates between them
+  size_t before = bus_.writes.size();
+  hub_[0].update();
+  hub_[1].update();
+  last_update_[0] = last_update_[1] = mock_millis;
+  run_for(INTERVAL - 1);
+  size_t n = bus_.writes.size() - before;
+  ASSERT_GE(n, 6u);
+  for (size_t i = before + 1; i < before + n - 1; i++)
+    EXPECT_NE(bus_.writes[i], bus_.writes[i - 1]) << "request " << i - before;
+}
+
+TEST_F(SharedBusTest, DeadUnitDoesNotStallTheOther) {
+  run_for(INTERVAL * 2);
+  abc_[1].silent = true;
+  size_t before = abc_[0].requests.size();
+  run_for(INTERVAL * 4);
+  EXPECT_TRUE(hub_[0].connected_);
+  EXPECT_GE(abc_[0].requests.size() - before, hub_[0].poll_groups_.size() * 3);
+}
+
+TEST(SharedBusFrames, ForeignSlaveFrameIgnored) {
+  mock_millis = 0;
+  FakeABC abc;
+  MultiHub hub;
+  hub.set_address(2);
+  hub.set_mock_backend(&abc);
+  abc.registers[1110] = 777;
+  abc.address = 0;
+  hub.register_listener(1110, [](uint16_t) {}, RegisterCapability::NONE);
+  hub.setup();
+  // The echoing fake answers as slave 2; rewrite its answers to come from slave 1
+  for (int i = 0; i < 200; i++) {
+    hub.loop();
+    if (!abc.rx.empty() && abc.rx.front() == 2) {
+      abc.rx.front() = 1;
+      uint8_t buf[MAX_FRAME_SIZE];
+      size_t n = 0;
+      for (uint8_t b : abc.rx)
+        buf[n++] = b;
+      uint16_t crc = crc16(buf, n - 2);
+      abc.rx[n - 2] = crc & 0xFF;
+      abc.rx[n - 1] = crc >> 8;
+    }
+    mock_millis++;
+  }
+  EXPECT_FALSE(hub.is_setup_complete());
+  EXPECT_TRUE(hub.registers_.empty());
+}
+
+// ====== Passive mode (another master polls the ABC) ======
+
+// One line shared with another master: its exchanges and the hub's own both
+// show up in the hub's receive stream
+class SniffedBus : public uart::UARTMockBackend {
+ public:
+  void other_master(const std::vector<uint8_t> &request) {
+    line.insert(line.end(), request.begin(), request.end());
+    this->answer_(request.data(), request.size());
+    last_other_activity = mock_millis;
+  }
+  void on_write(const uint8_t *data, size_t len) override {
+    hub_requests.push_back(std::vector<uint8_t>(data, data + len));
+    if (mock_millis - last_other_activity < min_hub_gap)
+      min_hub_gap = mock_millis - last_other_activity;
+    this->answer_(data, len);
+  }
+  size_t available() override { return line.size(); }
+  bool read_byte(uint8_t *b) override {
+    if (line.empty())
+      return false;
+    *b = line.front();
+    line.pop_front();
+    return true;
+  }
+
+  FakeABC abc;
+  std::deque<uint8_t> line;
+  std::vector<std::vector<uint8_t>> hub_requests;
+  uint32_t last_other_activity{0};
+  uint32_t min_hub_gap{UINT32_MAX};  // Shortest time from the other master's traffic to a hub request
+
+ protected:
+  void answer_(const uint8_t *data, size_t len) {
+    abc.on_write(data, len);
+    line.insert(line.end(), abc.rx.begin(), abc.rx.end());
+    abc.rx.clear();
+  }
+};
+
+class PassiveTest : public ::testing::Test {
+ protected:
+  static constexpr uint32_t INTERVAL = 5000;
+  static constexpr uint32_t OTHER_PERIOD = 1000;
+
+  void SetUp() override {
+    mock_millis = 0;
+    bus_.abc.registers[30] = 1;
+    bus_.abc.registers[31] = 2;
+    bus_.abc.registers[3322] = 1234;
+    hub_.set_mock_backend(&bus_);
+    hub_.set_update_interval(INTERVAL);
+    for (uint16_t addr : {30, 31, 3322}) {
+      hub_.register_listener(addr, [this, addr](uint16_t value) { this->published_[addr] = value; },
+                             addr == 3322 ? RegisterCapability::VS_DRIVE : RegisterCapability::NONE);
+    }
+  }
+
+  // Run with the other master sending `requests` every OTHER_PERIOD ms
+  void run_for(uint32_t ms, const std::vector<std::vector<uint8_t>> &requests) {
+    uint32_t end = mock_millis + ms;
+    while (mock_millis < end) {
+      if (!started_) {
+        hub_.setup();
+        started_ = true;
+      }
+      if (mock_millis % OTHER_PERIOD == 0) {
+        for (const auto &req : requests)
+          bus_.other_master(req);
+      }
+      step_hub(hub_, INTERVAL, last_update_);
+      mock_millis++;
+    }
+  }
+
+  static std::vector<std::vector<uint8_t>> setup_reads() {
+    return {build_read_ranges_request(get_system_id_ranges()),
+            build_read_ranges_request(get_component_detect_ranges())};
+  }
+
+  SniffedBus bus_;
+  MultiHub hub_;
+  std::map<uint16_t, uint16_t> published_;
+  bool started_{false};
+  uint32_t last_update_{0};
+};
+
+TEST_F(PassiveTest, ListenOnlyNeverTransmits) {
+  hub_.set_passive(0);
+  auto reads = setup_reads();
+  reads.push_back(build_read_ranges_request({{30, 2}}));
+  reads.push_back(build_read_registers_request({3322}));
+  run_for(INTERVAL * 4, reads);
+
+  EXPECT_TRUE(bus_.hub_requests.empty());
+  ASSERT_TRUE(hub_.is_setup_complete());
+  EXPECT_TRUE(hub_.has_vs_drive());
+  EXPECT_TRUE(hub_.connected_);
+  EXPECT_EQ(published_[30], 1);
+  EXPECT_EQ(published_[31], 2);
+  EXPECT_EQ(published_[3322], 1234);
+}
+
+TEST_F(PassiveTest, PollsOnlyWhatTheOtherMasterSkips) {
+  hub_.set_passive(3000);
+  auto reads = setup_reads();
+  reads.push_back(build_read_ranges_request({{30, 2}}));
+  run_for(INTERVAL * 4, reads);
+
+  ASSERT_TRUE(hub_.is_setup_complete());
+  ASSERT_FALSE(bus_.hub_requests.empty());
+  for (const auto &req : bus_.hub_requests) {
+    EXPECT_FALSE(request_reads(req, 30));
+    EXPECT_TRUE(request_reads(req, 3322));
+  }
+  EXPECT_EQ(published_[3322], 1234);
+  EXPECT_GE(bus_.min_hub_gap, 100u);
+}
+
+TEST_F(PassiveTest, SetsUpActivelyWhenNobodyReadsTheIdentification) {
+  hub_.set_passive(3000);
+  run_for(INTERVAL * 2, {build_read_ranges_request({{30, 2}})});
+
+  ASSERT_TRUE(hub_.is_setup_complete());
+  ASSERT_GE(bus_.hub_requests.size(), 2u);
+  EXPECT_EQ(published_[3322], 1234);
+}
+
+TEST_F(PassiveTest, WaitsMaxAgeBeforeActiveSetup) {
+  hub_.set_passive(3000);
+  run_for(2990, {build_read_ranges_request({{30, 2}})});
+  EXPECT_TRUE(bus_.hub_requests.empty());
+  run_for(200, {});
+  EXPECT_FALSE(bus_.hub_requests.empty());
+}
+
+TEST_F(PassiveTest, SniffedWritesUpdateTheCache) {
+  hub_.set_passive(0);
+  run_for(INTERVAL, setup_reads());
+  bus_.other_master(build_write_single_request(30, 9));
+  run_for(10, {});
+  EXPECT_EQ(published_[30], 9);
+}
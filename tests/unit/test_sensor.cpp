@@ -38,7 +38,7 @@ class SensorTest : public ::testing::Test {
 
 TEST_F(SensorTest, UnsignedType) {
   sensor_->set_register_address(740);
-  sensor_->set_register_type("unsigned");
+  sensor_->set_register_type(RegisterType::UNSIGNED);
   sensor_->setup();
 
   hub_->dispatch_register_(740, 240);
@@ -47,7 +47,7 @@ TEST_F(SensorTest, UnsignedType) {
 
 TEST_F(SensorTest, SignedTenthsPositive) {
   sensor_->set_register_address(740);
-  sensor_->set_register_type("signed_tenths");
+  sensor_->set_register_type(RegisterType::SIGNED_TENTHS);
   sensor_->setup();
 
   hub_->dispatch_register_(740, 700);  // 70.0°F
@@ -56,7 +56,7 @@ TEST_F(SensorTest, SignedTenthsPositive) {
 
 TEST_F(SensorTest, SignedTenthsNegative) {
   sensor_->set_register_address(740);
-  sensor_->set_register_type("signed_tenths");
+  sensor_->set_register_type(RegisterType::SIGNED_TENTHS);
   sensor_->setup();
 
   uint16_t neg = static_cast<uint16_t>(static_cast<int16_t>(-105));
@@ -66,7 +66,7 @@ TEST_F(SensorTest, SignedTenthsNegative) {
 
 TEST_F(SensorTest, TenthsType) {
   sensor_->set_register_address(745);
-  sensor_->set_register_type("tenths");
+  sensor_->set_register_type(RegisterType::TENTHS);
   sensor_->setup();
 
   hub_->dispatch_register_(745, 735);  // 73.5
@@ -75,7 +75,7 @@ TEST_F(SensorTest, TenthsType) {
 
 TEST_F(SensorTest, SignedType) {
   sensor_->set_register_address(502);
-  sensor_->set_register_type("signed");
+  sensor_->set_register_type(RegisterType::SIGNED);
   sensor_->setup();
 
   hub_->dispatch_register_(502, 0xFF9C);  // -100
@@ -84,7 +84,7 @@ TEST_F(SensorTest, SignedType) {
 
 TEST_F(SensorTest, HundredthsType) {
   sensor_->set_register_address(2);
-  sensor_->set_register_type("hundredths");
+  sensor_->set_register_type(RegisterType::HUNDREDTHS);
   sensor_->setup();
 
   hub_->dispatch_register_(2, 705);  // 7.05
@@ -95,8 +95,7 @@ TEST_F(SensorTest, HundredthsType) {
 
 TEST_F(SensorTest, Uint32Value) {
   sensor_->set_register_address(1152);
-  sensor_->set_register_type("uint32");
-  sensor_->set_is_32bit(true);
+  sensor_->set_register_type(RegisterType::UINT32);
   sensor_->setup();
 
   // hi word at 1152, lo word at 1153
@@ -108,8 +107,7 @@ TEST_F(SensorTest, Uint32Value) {
 
 TEST_F(SensorTest, Int32NegativeValue) {
   sensor_->set_register_address(1154);
-  sensor_->set_register_type("int32");
-  sensor_->set_is_32bit(true);
+  sensor_->set_register_type(RegisterType::INT32);
   sensor_->setup();
 
   // -1000 as int32 = 0xFFFFFC18
@@ -123,8 +121,7 @@ TEST_F(SensorTest, Int32NegativeValue) {
 
 TEST_F(SensorTest, Uint32WaitsForBothWords) {
   sensor_->set_register_address(1152);
-  sensor_->set_register_type("uint32");
-  sensor_->set_is_32bit(true);
+  sensor_->set_register_type(RegisterType::UINT32);
   sensor_->setup();
 
   // Only send lo word - should not update
@@ -136,7 +133,7 @@ TEST_F(SensorTest, Uint32WaitsForBothWords) {
 
 TEST_F(SensorTest, DedupSameValue) {
   sensor_->set_register_address(740);
-  sensor_->set_register_type("unsigned");
+  sensor_->set_register_type(RegisterType::UNSIGNED);
   sensor_->setup();
 
   hub_->dispatch_register_(740, 100);
@@ -152,7 +149,7 @@ TEST_F(SensorTest, DedupSameValue) {
 
 TEST_F(SensorTest, DedupDifferentValue) {
   sensor_->set_register_address(740);
-  sensor_->set_register_type("unsigned");
+  sensor_->set_register_type(RegisterType::UNSIGNED);
   sensor_->setup();
 
   hub_->dispatch_register_(740, 100);
@@ -166,7 +163,7 @@ TEST_F(SensorTest, DedupDifferentValue) {
 
 TEST_F(SensorTest, NegativeSentinelSignedTenths) {
   sensor_->set_register_address(1116);
-  sensor_->set_register_type("signed_tenths");
+  sensor_->set_register_type(RegisterType::SIGNED_TENTHS);
   sensor_->setup();
 
   // -9999 raw as uint16 -> signed_tenths -> -999.9 -> NaN
@@ -177,7 +174,7 @@ TEST_F(SensorTest, NegativeSentinelSignedTenths) {
 
 TEST_F(SensorTest, PositiveSentinelSignedTenths) {
   sensor_->set_register_address(1117);
-  sensor_->set_register_type("signed_tenths");
+  sensor_->set_register_type(RegisterType::SIGNED_TENTHS);
   sensor_->setup();
 
   // 9999 raw -> signed_tenths -> 999.9 -> NaN (e.g. waterflow not supported)
@@ -187,7 +184,7 @@ TEST_F(SensorTest, PositiveSentinelSignedTenths) {
 
 TEST_F(SensorTest, PositiveSentinelTenths) {
   sensor_->set_register_address(1117);
-  sensor_->set_register_type("tenths");
+  sensor_->set_register_type(RegisterType::TENTHS);
   sensor_->setup();
 
   // 9999 raw -> tenths -> 999.9 -> NaN
@@ -197,7 +194,7 @@ TEST_F(SensorTest, PositiveSentinelTenths) {
 
 TEST_F(SensorTest, ValidValueNotSentinel) {
   sensor_->set_register_address(1117);
-  sensor_->set_register_type("signed_tenths");
+  sensor_->set_register_type(RegisterType::SIGNED_TENTHS);
   sensor_->setup();
 
   // 50 raw -> 5.0 gpm (valid, not sentinel)
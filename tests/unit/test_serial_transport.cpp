@@ -0,0 +1,183 @@
+// Unit tests for the host build's serial transport, over a real pty pair
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "../../host/serial_transport.cpp"
+#include "fake_abc.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+
+// The transport opens the pty's device path; the test plays the bus on the master side
+class SerialTransportTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_millis = 0;
+    int slave;
+    char name[64];
+    ASSERT_EQ(openpty(&master_, &slave, name, nullptr, nullptr), 0);
+    // Keep the slave side open so the master never sees a hangup between transport opens
+    slave_ = slave;
+    device_ = name;
+    fcntl(master_, F_SETFL, fcntl(master_, F_GETFL) | O_NONBLOCK);
+  }
+  void TearDown() override {
+    if (master_ >= 0)
+      close(master_);
+    close(slave_);
+  }
+
+  // What has reached the master side within `timeout_ms` (pty data is delivered asynchronously)
+  std::vector<uint8_t> receive(size_t want, int timeout_ms = 500) {
+    std::vector<uint8_t> out;
+    while (out.size() < want) {
+      struct pollfd pfd = {master_, POLLIN, 0};
+      if (poll(&pfd, 1, timeout_ms) <= 0)
+        break;
+      uint8_t buf[256];
+      ssize_t n = read(master_, buf, sizeof(buf));
+      if (n <= 0)
+        break;
+      out.insert(out.end(), buf, buf + n);
+    }
+    return out;
+  }
+
+  std::vector<uint8_t> transport_read(size_t want) {
+    std::vector<uint8_t> out;
+    for (int i = 0; i < 500 && out.size() < want; i++) {
+      uint8_t buf[64];
+      size_t n = transport_.read(buf, sizeof(buf));
+      out.insert(out.end(), buf, buf + n);
+      if (n == 0)
+        usleep(1000);
+    }
+    return out;
+  }
+
+  int master_{-1};
+  int slave_{-1};
+  std::string device_;
+  SerialTransport transport_;
+};
+
+TEST_F(SerialTransportTest, OpensRawAt19200) {
+  transport_.set_device(device_);
+  transport_.loop();
+  ASSERT_TRUE(transport_.is_connected());
+
+  struct termios tio;
+  ASSERT_EQ(tcgetattr(slave_, &tio), 0);
+  EXPECT_EQ(cfgetospeed(&tio), B19200);
+  EXPECT_EQ(cfgetispeed(&tio), B19200);
+  EXPECT_EQ(tio.c_cflag & CSIZE, static_cast<tcflag_t>(CS8));
+  EXPECT_FALSE(tio.c_cflag & CSTOPB);
+  // Parity cannot be checked here: the pty driver clears PARENB whatever is asked for
+  // Raw: no echo, no line editing, no CR/NL translation of frame bytes
+  EXPECT_FALSE(tio.c_lflag & (ECHO | ICANON));
+  EXPECT_FALSE(tio.c_iflag & (ICRNL | IXON));
+  EXPECT_FALSE(tio.c_oflag & OPOST);
+}
+
+TEST_F(SerialTransportTest, FramesPassThroughUnchanged) {
+  transport_.set_device(device_);
+  transport_.loop();
+  // 0x0D and 0x11 would be mangled by a cooked tty (CR translation, XON)
+  std::vector<uint8_t> request = {0x01, 0x42, 0x00, 0x0D, 0x00, 0x11};
+  uint16_t crc = crc16(request.data(), request.size());
+  request.push_back(crc & 0xFF);
+  request.push_back(crc >> 8);
+  transport_.send(request.data(), request.size());
+  EXPECT_EQ(receive(request.size()), request);
+
+  std::vector<uint8_t> response = {0x01, 0x42, 0x02, 0x0A, 0x0D, 0x13, 0x11};
+  ASSERT_EQ(write(master_, response.data(), response.size()), static_cast<ssize_t>(response.size()));
+  EXPECT_EQ(transport_read(response.size()), response);
+  // Nothing more to read is not a hangup
+  uint8_t b;
+  EXPECT_EQ(transport_.read(&b, 1), 0u);
+  EXPECT_TRUE(transport_.is_connected());
+}
+
+TEST_F(SerialTransportTest, MissingDeviceIsRetried) {
+  transport_.set_device("/dev/does-not-exist");
+  transport_.loop();
+  EXPECT_FALSE(transport_.is_connected());
+
+  transport_.set_device(device_);
+  mock_millis = SerialTransport::RECONNECT_INTERVAL - 1;
+  transport_.loop();
+  EXPECT_FALSE(transport_.is_connected());
+  mock_millis = SerialTransport::RECONNECT_INTERVAL;
+  transport_.loop();
+  EXPECT_TRUE(transport_.is_connected());
+  EXPECT_EQ(transport_.opens(), 1u);
+}
+
+TEST_F(SerialTransportTest, HangupClosesTheDevice) {
+  transport_.set_device(device_);
+  transport_.loop();
+  ASSERT_TRUE(transport_.is_connected());
+  close(master_);
+  master_ = -1;
+  uint8_t buf[8];
+  EXPECT_EQ(transport_.read(buf, sizeof(buf)), 0u);
+  EXPECT_FALSE(transport_.is_connected());
+  // The pty is gone for good, so reopening keeps failing without blocking
+  mock_millis = SerialTransport::RECONNECT_INTERVAL;
+  transport_.loop();
+  EXPECT_FALSE(transport_.is_connected());
+}
+
+TEST_F(SerialTransportTest, HubOverPty) {
+  FakeABC abc;
+  abc.registers[REG_HEATING_SETPOINT] = 680;
+  transport_.set_device(device_);
+  WaterFurnace hub;
+  hub.set_transport(&transport_);
+  uint16_t setpoint = 0;
+  hub.register_listener(REG_HEATING_SETPOINT, [&](uint16_t v) { setpoint = v; });
+
+  // The ABC answers each request once its CRC checks out on the master side
+  std::vector<uint8_t> pending;
+  auto run_for = [&](uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+      hub.loop();
+      auto bytes = receive(MAX_FRAME_SIZE, 0);
+      pending.insert(pending.end(), bytes.begin(), bytes.end());
+      size_t size = MIN_FRAME_SIZE;
+      while (size <= pending.size() && !validate_frame_crc(pending.data(), size))
+        size++;
+      if (size <= pending.size()) {
+        abc.on_write(pending.data(), size);
+        pending.erase(pending.begin(), pending.begin() + size);
+        std::vector<uint8_t> resp(abc.rx.begin(), abc.rx.end());
+        abc.rx.clear();
+        ASSERT_EQ(write(master_, resp.data(), resp.size()), static_cast<ssize_t>(resp.size()));
+      }
+      usleep(200);
+      mock_millis++;
+    }
+  };
+
+  hub.setup();
+  run_for(200);
+  ASSERT_TRUE(hub.is_setup_complete());
+  EXPECT_EQ(hub.model_number(), "TESTMODEL");
+
+  hub.update();
+  run_for(100);
+  EXPECT_EQ(setpoint, 680);
+
+  hub.write_register(REG_WRITE_HEATING_SP, 700);
+  run_for(100);
+  EXPECT_EQ(abc.read(REG_WRITE_HEATING_SP), 700);
+  EXPECT_EQ(hub.bus_stats().crc_errors, 0u);
+  EXPECT_EQ(hub.bus_stats().timeouts, 0u);
+}
@@ -0,0 +1,205 @@
+// Unit tests for the Modbus TCP server in front of the register cache
+
+#define USE_WATERFURNACE_TCP
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "../../components/waterfurnace/tcp_server.cpp"
+#include "fake_abc.h"
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+
+class TcpServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_millis = 0;
+    abc_.registers[30] = 9;
+    abc_.registers[31] = 4;
+    abc_.registers[745] = 680;
+    hub_.set_mock_backend(&abc_);
+    hub_.set_update_interval(10000);
+    for (uint16_t addr : {30, 31, 745})
+      hub_.register_listener(addr, [](uint16_t) {});
+    hub_.setup();
+    run_for(100);
+    hub_.update();
+    run_for(100);
+    ASSERT_TRUE(hub_.is_setup_complete());
+
+    server_.set_port(5020);
+    server_.setup();
+    ASSERT_FALSE(server_.is_failed());
+    auto client = std::make_unique<socket::Socket>();
+    client_ = client.get();
+    socket::last_socket->pending_accept.push_back(std::move(client));
+    server_.loop();
+  }
+
+  void run_for(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+      hub_.loop();
+      mock_millis++;
+    }
+  }
+
+  // Send one ADU with `pdu` and return the response PDU (MBAP header checked and stripped)
+  std::vector<uint8_t> transact(const std::vector<uint8_t> &pdu, uint16_t txn = 0x1234) {
+    std::vector<uint8_t> adu = {uint8_t(txn >> 8), uint8_t(txn & 0xFF), 0, 0,
+                                uint8_t((pdu.size() + 1) >> 8), uint8_t((pdu.size() + 1) & 0xFF), SLAVE_ADDRESS};
+    adu.insert(adu.end(), pdu.begin(), pdu.end());
+    client_->rx.insert(client_->rx.end(), adu.begin(), adu.end());
+    client_->tx.clear();
+    server_.loop();
+    if (client_->tx.size() < 7)
+      return {};
+    EXPECT_EQ(client_->tx[0], txn >> 8);
+    EXPECT_EQ(client_->tx[1], txn & 0xFF);
+    EXPECT_EQ(client_->tx[6], SLAVE_ADDRESS);
+    EXPECT_EQ(((client_->tx[4] << 8) | client_->tx[5]) + 6u, client_->tx.size());
+    return std::vector<uint8_t>(client_->tx.begin() + 7, client_->tx.end());
+  }
+
+  // Request PDU from one of our RTU frame builders
+  static std::vector<uint8_t> pdu_of(const std::vector<uint8_t> &rtu) {
+    return std::vector<uint8_t>(rtu.begin() + 1, rtu.end() - 2);
+  }
+
+  FakeABC abc_;
+  WaterFurnace hub_;
+  ModbusTcpServer server_{&hub_};
+  socket::Socket *client_{nullptr};
+};
+
+TEST_F(TcpServerTest, ReadsComeFromTheCache) {
+  size_t bus_requests = abc_.requests.size();
+  EXPECT_EQ(transact(pdu_of(build_read_ranges_request({{30, 2}}))),
+            (std::vector<uint8_t>{FUNC_READ_RANGES, 4, 0, 9, 0, 4}));
+  EXPECT_EQ(transact(pdu_of(build_read_registers_request({745, 30}))),
+            (std::vector<uint8_t>{FUNC_READ_REGISTERS, 4, 0x02, 0xA8, 0, 9}));
+  EXPECT_EQ(transact({3, 0, 30, 0, 2}), (std::vector<uint8_t>{3, 4, 0, 9, 0, 4}));
+  EXPECT_EQ(abc_.requests.size(), bus_requests);
+  EXPECT_EQ(server_.requests(), 3u);
+}
+
+TEST_F(TcpServerTest, UncachedRegisterIsRefused) {
+  EXPECT_EQ(transact(pdu_of(build_read_registers_request({30, 1110}))),
+            (std::vector<uint8_t>{FUNC_READ_REGISTERS | ERROR_MASK, ModbusTcpServer::EXC_ILLEGAL_ADDRESS}));
+}
+
+TEST_F(TcpServerTest, MaxAgeRefusesStaleValues) {
+  // Ages count from the next poll cycle, once read times are tracked
+  server_.set_max_age(5000);
+  hub_.update();
+  run_for(100);
+  EXPECT_EQ(transact({3, 0, 30, 0, 1}), (std::vector<uint8_t>{3, 2, 0, 9}));
+  abc_.silent = true;
+  run_for(6000);
+  EXPECT_EQ(transact({3, 0, 30, 0, 1}),
+            (std::vector<uint8_t>{3 | ERROR_MASK, ModbusTcpServer::EXC_TARGET_NO_RESPONSE}));
+}
+
+TEST_F(TcpServerTest, WritesRefusedUnlessAllowed) {
+  auto single = pdu_of(build_write_single_request(745, 700));
+  EXPECT_EQ(transact(single),
+            (std::vector<uint8_t>{FUNC_WRITE_SINGLE | ERROR_MASK, ModbusTcpServer::EXC_ILLEGAL_FUNCTION}));
+  EXPECT_EQ(transact(pdu_of(build_write_registers_request({{340, 1}}))),
+            (std::vector<uint8_t>{FUNC_WRITE_REGISTERS | ERROR_MASK, ModbusTcpServer::EXC_ILLEGAL_FUNCTION}));
+  run_for(100);
+  EXPECT_EQ(abc_.read(745), 680);
+  EXPECT_EQ(abc_.read(340), 0);
+}
+
+TEST_F(TcpServerTest, WritesGoThroughTheWriteQueue) {
+  server_.set_allow_writes(true);
+  EXPECT_EQ(transact(pdu_of(build_write_registers_request({{340, 1}, {341, 2}}))),
+            (std::vector<uint8_t>{FUNC_WRITE_REGISTERS}));
+  auto single = pdu_of(build_write_single_request(745, 700));
+  EXPECT_EQ(transact(single), single);
+  run_for(100);
+  EXPECT_EQ(abc_.read(340), 1);
+  EXPECT_EQ(abc_.read(341), 2);
+  EXPECT_EQ(abc_.read(745), 700);
+
+  // Two full requests while a read holds the bus: each is queued and sent
+  // within one frame
+  abc_.silent = true;
+  hub_.request_read({30});
+  run_for(1);
+  abc_.silent = false;
+  std::vector<std::pair<uint16_t, uint16_t>> writes;
+  for (uint16_t i = 0; i < 2 * MAX_WRITES_PER_REQUEST; i++)
+    writes.push_back({2000 + i, i});
+  auto half = writes.begin() + MAX_WRITES_PER_REQUEST;
+  EXPECT_EQ(transact(pdu_of(build_write_registers_request({writes.begin(), half}))),
+            (std::vector<uint8_t>{FUNC_WRITE_REGISTERS}));
+  EXPECT_EQ(transact(pdu_of(build_write_registers_request({half, writes.end()}))),
+            (std::vector<uint8_t>{FUNC_WRITE_REGISTERS}));
+  size_t since = abc_.requests.size();
+  run_for(8000);  // Timeout and backoff for the silent read, then the writes
+  for (size_t i = since; i < abc_.requests.size(); i++)
+    EXPECT_LE(abc_.requests[i].size(), MAX_FRAME_SIZE);
+  for (const auto &write : writes)
+    EXPECT_EQ(abc_.read(write.first), write.second) << "register " << write.first;
+
+  // Busy while the queue is full
+  abc_.silent = true;
+  hub_.request_read({30});
+  run_for(1);
+  size_t full;
+  do {
+    full = hub_.queue_depth();
+    hub_.request_read({31});
+  } while (hub_.queue_depth() > full);
+  EXPECT_EQ(transact(single),
+            (std::vector<uint8_t>{FUNC_WRITE_SINGLE | ERROR_MASK, ModbusTcpServer::EXC_SLAVE_BUSY}));
+}
+
+TEST_F(TcpServerTest, BadRequestsGetExceptions) {
+  EXPECT_EQ(transact({16, 0, 1, 0, 1, 2, 0, 1}),
+            (std::vector<uint8_t>{16 | ERROR_MASK, ModbusTcpServer::EXC_ILLEGAL_FUNCTION}));
+  EXPECT_EQ(transact({3, 0, 30, 0, 200}),
+            (std::vector<uint8_t>{3 | ERROR_MASK, ModbusTcpServer::EXC_ILLEGAL_VALUE}));
+  EXPECT_EQ(transact({FUNC_READ_RANGES, 0, 30, 0}),
+            (std::vector<uint8_t>{FUNC_READ_RANGES | ERROR_MASK, ModbusTcpServer::EXC_ILLEGAL_VALUE}));
+  EXPECT_EQ(server_.exceptions(), 3u);
+}
+
+TEST_F(TcpServerTest, SplitAndBackToBackAdus) {
+  std::vector<uint8_t> two = {0, 1, 0, 0, 0, 6, 1, 3, 0, 30, 0, 1, 0, 2, 0, 0, 0, 6, 1, 3, 0, 31, 0, 1};
+  client_->rx.insert(client_->rx.end(), two.begin(), two.begin() + 5);
+  server_.loop();
+  EXPECT_TRUE(client_->tx.empty());
+  client_->rx.insert(client_->rx.end(), two.begin() + 5, two.end());
+  server_.loop();
+  EXPECT_EQ(client_->tx, (std::vector<uint8_t>{0, 1, 0, 0, 0, 5, 1, 3, 2, 0, 9, 0, 2, 0, 0, 0, 5, 1, 3, 2, 0, 4}));
+}
+
+TEST_F(TcpServerTest, MalformedHeaderClosesConnection) {
+  int closed = socket::sockets_closed;
+  client_->rx.insert(client_->rx.end(), {0, 1, 0, 7, 0, 6, 1, 3, 0, 30, 0, 1});
+  server_.loop();
+  EXPECT_EQ(socket::sockets_closed, closed + 1);
+}
+
+TEST_F(TcpServerTest, RefusesClientsBeyondLimit) {
+  std::vector<socket::Socket *> extra;
+  for (int i = 0; i < ModbusTcpServer::MAX_CLIENTS; i++) {
+    auto sock = std::make_unique<socket::Socket>();
+    extra.push_back(sock.get());
+    socket::last_socket->pending_accept.push_back(std::move(sock));
+  }
+  int closed = socket::sockets_closed;
+  server_.loop();
+  for (int i = 0; i + 1 < ModbusTcpServer::MAX_CLIENTS; i++)
+    EXPECT_FALSE(extra[i]->closed);
+  // The one over the limit is closed and dropped
+  EXPECT_EQ(socket::sockets_closed, closed + 1);
+}
+
+TEST_F(TcpServerTest, PeerCloseFreesTheSlot) {
+  int closed = socket::sockets_closed;
+  client_->peer_closed = true;
+  server_.loop();
+  EXPECT_EQ(socket::sockets_closed, closed + 1);
+}
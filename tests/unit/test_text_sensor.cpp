@@ -60,6 +60,14 @@ TEST_F(TextSensorTest, FaultUnknownCode) {
   EXPECT_EQ(ts_->state, "E50 Unknown Fault");
 }
 
+TEST_F(TextSensorTest, LastLockout) {
+  ts_->set_sensor_type("last_lockout");
+  ts_->setup();
+
+  hub_->dispatch_register_(REG_LAST_LOCKOUT, 5);
+  EXPECT_EQ(ts_->state, "E5 Freeze Detect FP1");
+}
+
 // ====== Mode Sensor (system outputs) ======
 
 TEST_F(TextSensorTest, ModeIdle) {
@@ -465,3 +473,34 @@ TEST_F(TextSensorTest, DedupDifferentValue) {
   hub_->dispatch_register_(REG_SYSTEM_OUTPUTS, OUTPUT_CC);
   EXPECT_EQ(ts_->state, "Heating");
 }
+
+TEST_F(TextSensorTest, DedupFaultOnRawValue) {
+  ts_->set_sensor_type("fault");
+  ts_->setup();
+
+  hub_->dispatch_register_(REG_LAST_FAULT, 0x8002);
+  ts_->state = "corrupted";
+  hub_->dispatch_register_(REG_LAST_FAULT, 0x8002);
+  EXPECT_EQ(ts_->state, "corrupted");  // Same raw value is not formatted again
+
+  hub_->dispatch_register_(REG_LAST_FAULT, 0x0002);  // Lockout bit cleared
+  EXPECT_EQ(ts_->state, "E2 High Pressure");
+}
+
+TEST_F(TextSensorTest, DedupLockoutBitmaskOnRawValue) {
+  ts_->set_sensor_type("inputs_at_lockout");
+  ts_->setup();
+
+  hub_->dispatch_register_(REG_INPUTS_AT_LOCKOUT, INPUT_LPS);
+  ts_->state = "corrupted";
+  hub_->dispatch_register_(REG_INPUTS_AT_LOCKOUT, INPUT_LPS);
+  EXPECT_EQ(ts_->state, "corrupted");
+}
+
+TEST_F(TextSensorTest, InputsAtLockoutAllBitsFitBuffer) {
+  ts_->set_sensor_type("inputs_at_lockout");
+  ts_->setup();
+
+  hub_->dispatch_register_(REG_INPUTS_AT_LOCKOUT, 0xFFFF);
+  EXPECT_EQ(ts_->state, "Y1, Y2, W, O, G, DH/RH, Emergency Shutdown, LPS, HPS, Load Shed");
+}
@@ -0,0 +1,371 @@
+// Unit tests for the transport backends, and the hub running end to end over a network gateway
+
+#define USE_WATERFURNACE_TCP
+
+#include <gtest/gtest.h>
+#include "hub_sources.h"
+#include "../../components/waterfurnace/tcp_transport.cpp"
+#include "fake_abc.h"
+
+using namespace esphome;
+using namespace esphome::waterfurnace;
+
+// A network gateway in front of a FakeABC: unwraps what the transport sent
+// into RTU requests and wraps the ABC's answers the way the framing expects
+class FakeGateway {
+ public:
+  FakeGateway(FakeABC *abc, TcpTransport::Framing framing) : abc_(abc), framing_(framing) {}
+
+  void pump(socket::Socket *sock) {
+    if (sock == nullptr)
+      return;
+    std::vector<uint8_t> sent(sock->tx.begin(), sock->tx.end());
+    sock->tx.clear();
+    if (this->framing_ == TcpTransport::Framing::RTU) {
+      if (!sent.empty())
+        this->abc_->on_write(sent.data(), sent.size());
+      while (this->abc_->available()) {
+        uint8_t b;
+        this->abc_->read_byte(&b);
+        sock->rx.push_back(b);
+      }
+      return;
+    }
+
+    this->pending_.insert(this->pending_.end(), sent.begin(), sent.end());
+    while (this->pending_.size() >= 7) {
+      size_t length = (this->pending_[4] << 8) | this->pending_[5];
+      if (this->pending_.size() < 6 + length)
+        break;
+      this->requests.push_back(std::vector<uint8_t>(this->pending_.begin(), this->pending_.begin() + 6 + length));
+      std::vector<uint8_t> rtu(this->pending_.begin() + 6, this->pending_.begin() + 6 + length);
+      uint16_t crc = crc16(rtu.data(), rtu.size());
+      rtu.push_back(crc & 0xFF);
+      rtu.push_back(crc >> 8);
+      this->abc_->on_write(rtu.data(), rtu.size());
+
+      std::vector<uint8_t> resp;
+      while (this->abc_->available()) {
+        uint8_t b;
+        this->abc_->read_byte(&b);
+        resp.push_back(b);
+      }
+      if (resp.size() >= MIN_FRAME_SIZE) {
+        size_t pdu_len = resp.size() - 2;  // Unit id and PDU
+        std::vector<uint8_t> adu = {this->pending_[0], this->pending_[1], 0, 0, uint8_t(pdu_len >> 8),
+                                    uint8_t(pdu_len & 0xFF)};
+        adu.insert(adu.end(), resp.begin(), resp.end() - 2);
+        sock->rx.insert(sock->rx.end(), adu.begin(), adu.end());
+      }
+      this->pending_.erase(this->pending_.begin(), this->pending_.begin() + 6 + length);
+    }
+  }
+
+  std::vector<std::vector<uint8_t>> requests;  // MBAP ADUs as received
+
+ protected:
+  FakeABC *abc_;
+  TcpTransport::Framing framing_;
+  std::vector<uint8_t> pending_;
+};
+
+class TransportTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_millis = 0;
+    socket::last_socket = nullptr;
+    socket::next_connect_pending = false;
+  }
+  void TearDown() override { socket::next_connect_pending = false; }
+
+  static std::vector<uint8_t> drain(Transport &transport) {
+    std::vector<uint8_t> out;
+    uint8_t buf[16];
+    for (size_t n = transport.read(buf, sizeof(buf)); n > 0; n = transport.read(buf, sizeof(buf)))
+      out.insert(out.end(), buf, buf + n);
+    return out;
+  }
+};
+
+// ====== UartTransport ======
+
+class RecordingPin : public GPIOPin {
+ public:
+  void digital_write(bool value) override { writes.push_back(value); }
+  std::vector<bool> writes;
+};
+
+TEST_F(TransportTest, UartSendsWithDriverEnable) {
+  FakeABC abc;
+  uart::UARTDevice uart;
+  uart.set_mock_backend(&abc);
+  RecordingPin pin;
+  UartTransport transport(&uart);
+  transport.set_flow_control_pin(&pin);
+
+  auto frame = build_read_registers_request({745});
+  transport.send(frame.data(), frame.size());
+  ASSERT_EQ(abc.requests.size(), 1u);
+  EXPECT_EQ(abc.requests[0], frame);
+  EXPECT_EQ(pin.writes, (std::vector<bool>{true, false}));
+
+  auto resp = drain(transport);
+  EXPECT_TRUE(validate_frame_crc(resp.data(), resp.size()));
+  EXPECT_EQ(resp.size(), 7u);
+}
+
+// ====== TcpTransport, Modbus TCP ======
+
+TEST_F(TransportTest, MbapWrapsRequests) {
+  TcpTransport transport(TcpTransport::Framing::MBAP);
+  transport.set_host("192.168.1.50");
+  transport.loop();
+  ASSERT_TRUE(transport.is_connected());
+  auto *sock = socket::last_socket;
+
+  auto frame = build_read_ranges_request({{745, 3}}, 3);
+  transport.send(frame.data(), frame.size());
+  std::vector<uint8_t> expected = {0, 1, 0, 0, 0, 6, 3};
+  expected.insert(expected.end(), frame.begin() + 1, frame.end() - 2);
+  EXPECT_EQ(sock->tx, expected);
+
+  sock->tx.clear();
+  transport.send(frame.data(), frame.size());
+  EXPECT_EQ(sock->tx[1], 2);  // Next transaction id
+}
+
+TEST_F(TransportTest, MbapResponsesBecomeRtuFrames) {
+  TcpTransport transport(TcpTransport::Framing::MBAP);
+  transport.set_host("192.168.1.50");
+  transport.loop();
+  auto *sock = socket::last_socket;
+  auto frame = build_read_registers_request({745});
+  transport.send(frame.data(), frame.size());
+
+  std::vector<uint8_t> adu = {0, 1, 0, 0, 0, 5, 1, FUNC_READ_REGISTERS, 2, 0x02, 0xA8};
+  // Split across reads: nothing comes out until the ADU is complete
+  sock->rx.insert(sock->rx.end(), adu.begin(), adu.begin() + 4);
+  EXPECT_TRUE(drain(transport).empty());
+  sock->rx.insert(sock->rx.end(), adu.begin() + 4, adu.end());
+  auto rtu = drain(transport);
+  ASSERT_EQ(rtu.size(), 7u);
+  EXPECT_TRUE(validate_frame_crc(rtu.data(), rtu.size()));
+  EXPECT_EQ(std::vector<uint8_t>(rtu.begin(), rtu.end() - 2),
+            (std::vector<uint8_t>{1, FUNC_READ_REGISTERS, 2, 0x02, 0xA8}));
+}
+
+TEST_F(TransportTest, MbapDropsStaleTransactions) {
+  TcpTransport transport(TcpTransport::Framing::MBAP);
+  transport.set_host("192.168.1.50");
+  transport.loop();
+  auto *sock = socket::last_socket;
+  auto frame = build_read_registers_request({745});
+  transport.send(frame.data(), frame.size());
+  transport.send(frame.data(), frame.size());
+
+  // Late answer to transaction 1, then the answer to transaction 2
+  sock->rx.insert(sock->rx.end(), {0, 1, 0, 0, 0, 5, 1, FUNC_READ_REGISTERS, 2, 0, 1});
+  sock->rx.insert(sock->rx.end(), {0, 2, 0, 0, 0, 5, 1, FUNC_READ_REGISTERS, 2, 0, 2});
+  auto rtu = drain(transport);
+  ASSERT_EQ(rtu.size(), 7u);
+  EXPECT_EQ(rtu[4], 2);
+}
+
+TEST_F(TransportTest, MbapMalformedHeaderDisconnects) {
+  TcpTransport transport(TcpTransport::Framing::MBAP);
+  transport.set_host("192.168.1.50");
+  transport.loop();
+  auto *sock = socket::last_socket;
+  int closed = socket::sockets_closed;
+  sock->rx.insert(sock->rx.end(), {0, 1, 0, 9, 0, 5, 1, FUNC_READ_REGISTERS, 2, 0, 1});
+  EXPECT_TRUE(drain(transport).empty());
+  EXPECT_FALSE(transport.is_connected());
+  EXPECT_EQ(socket::sockets_closed, closed + 1);
+  EXPECT_EQ(transport.disconnects(), 1u);
+}
+
+// ====== TcpTransport, RTU over TCP ======
+
+TEST_F(TransportTest, RtuPassesFramesThrough) {
+  TcpTransport transport(TcpTransport::Framing::RTU);
+  transport.set_host("192.168.1.50");
+  transport.set_port(4001);
+  transport.loop();
+  auto *sock = socket::last_socket;
+
+  auto frame = build_read_registers_request({745});
+  transport.send(frame.data(), frame.size());
+  EXPECT_EQ(sock->tx, frame);
+  sock->rx.insert(sock->rx.end(), {1, FUNC_READ_REGISTERS, 2, 0x02});
+  EXPECT_EQ(drain(transport), (std::vector<uint8_t>{1, FUNC_READ_REGISTERS, 2, 0x02}));
+}
+
+// ====== Connection handling ======
+
+TEST_F(TransportTest, PendingConnectCompletesLater) {
+  socket::next_connect_pending = true;
+  TcpTransport transport(TcpTransport::Framing::MBAP);
+  transport.set_host("192.168.1.50");
+  transport.loop();
+  EXPECT_FALSE(transport.is_connected());
+  auto *sock = socket::last_socket;
+
+  // Nothing goes out before the connection is up
+  auto frame = build_read_registers_request({745});
+  transport.send(frame.data(), frame.size());
+  EXPECT_TRUE(sock->tx.empty());
+
+  mock_millis = 100;
+  sock->connect_pending = false;
+  transport.loop();
+  EXPECT_TRUE(transport.is_connected());
+  EXPECT_EQ(transport.connects(), 1u);
+}
+
+TEST_F(TransportTest, UnansweredConnectTimesOutAndRetries) {
+  socket::next_connect_pending = true;
+  TcpTransport transport(TcpTransport::Framing::MBAP);
+  transport.set_host("192.168.1.50");
+  transport.loop();
+  int created = socket::sockets_created;
+  int closed = socket::sockets_closed;
+
+  mock_millis = TcpTransport::CONNECT_TIMEOUT;
+  transport.loop();
+  EXPECT_EQ(socket::sockets_closed, closed + 1);
+  EXPECT_FALSE(transport.is_connected());
+
+  // No new attempt until the reconnect interval has passed
+  socket::next_connect_pending = false;
+  mock_millis = TcpTransport::RECONNECT_INTERVAL - 1;
+  transport.loop();
+  EXPECT_EQ(socket::sockets_created, created);
+  mock_millis = TcpTransport::RECONNECT_INTERVAL;
+  transport.loop();
+  EXPECT_EQ(socket::sockets_created, created + 1);
+  EXPECT_TRUE(transport.is_connected());
+}
+
+TEST_F(TransportTest, RefusedConnectRetries) {
+  socket::next_connect_pending = true;
+  TcpTransport transport(TcpTransport::Framing::MBAP);
+  transport.set_host("192.168.1.50");
+  transport.loop();
+  socket::last_socket->so_error = ECONNREFUSED;
+  int closed = socket::sockets_closed;
+  mock_millis = 10;
+  transport.loop();
+  EXPECT_EQ(socket::sockets_closed, closed + 1);
+  EXPECT_FALSE(transport.is_connected());
+  EXPECT_EQ(transport.connects(), 0u);
+}
+
+TEST_F(TransportTest, GatewayCloseReconnects) {
+  TcpTransport transport(TcpTransport::Framing::RTU);
+  transport.set_host("192.168.1.50");
+  transport.loop();
+  auto *first = socket::last_socket;
+  int created = socket::sockets_created;
+  first->rx.push_back(0x01);
+  first->peer_closed = true;
+  // Bytes already received go with the connection
+  drain(transport);
+  EXPECT_FALSE(transport.is_connected());
+
+  mock_millis = TcpTransport::RECONNECT_INTERVAL;
+  transport.loop();
+  EXPECT_EQ(socket::sockets_created, created + 1);
+  EXPECT_TRUE(transport.is_connected());
+  EXPECT_EQ(transport.connects(), 2u);
+}
+
+// ====== Hub end to end ======
+
+class GatewayHubTest : public ::testing::TestWithParam<TcpTransport::Framing> {
+ protected:
+  void SetUp() override {
+    mock_millis = 0;
+    socket::last_socket = nullptr;
+    socket::next_connect_pending = false;
+    abc_.registers[REG_HEATING_SETPOINT] = 680;
+    abc_.registers[REG_SYSTEM_OUTPUTS] = 9;
+    transport_.set_host("192.168.1.50");
+    hub_.set_transport(&transport_);
+    hub_.set_update_interval(10000);
+    hub_.register_listener(REG_HEATING_SETPOINT, [this](uint16_t v) { setpoint_ = v; });
+    hub_.register_listener(REG_SYSTEM_OUTPUTS, [this](uint16_t v) { outputs_ = v; });
+  }
+
+  void run_for(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+      hub_.loop();
+      gateway_.pump(socket::last_socket);
+      mock_millis++;
+    }
+  }
+
+  FakeABC abc_;
+  TcpTransport transport_{GetParam()};
+  FakeGateway gateway_{&abc_, GetParam()};
+  WaterFurnace hub_;
+  uint16_t setpoint_{0};
+  uint16_t outputs_{0};
+};
+
+TEST_P(GatewayHubTest, SetupPollAndWrite) {
+  hub_.setup();
+  run_for(100);
+  ASSERT_TRUE(hub_.is_setup_complete());
+  EXPECT_EQ(hub_.model_number(), "TESTMODEL");
+
+  hub_.update();
+  run_for(100);
+  EXPECT_EQ(setpoint_, 680);
+  EXPECT_EQ(outputs_, 9);
+
+  hub_.write_register(REG_WRITE_HEATING_SP, 700);
+  run_for(100);
+  EXPECT_EQ(abc_.read(REG_WRITE_HEATING_SP), 700);
+  EXPECT_EQ(hub_.bus_stats().crc_errors, 0u);
+  EXPECT_EQ(hub_.bus_stats().timeouts, 0u);
+}
+
+TEST_P(GatewayHubTest, WaitsForTheGateway) {
+  socket::next_connect_pending = true;
+  hub_.setup();
+  run_for(1000);
+  EXPECT_TRUE(abc_.requests.empty());
+  EXPECT_FALSE(hub_.is_setup_complete());
+
+  socket::last_socket->connect_pending = false;
+  run_for(100);
+  EXPECT_TRUE(hub_.is_setup_complete());
+}
+
+INSTANTIATE_TEST_SUITE_P(Framing, GatewayHubTest,
+                         ::testing::Values(TcpTransport::Framing::MBAP, TcpTransport::Framing::RTU),
+                         [](const ::testing::TestParamInfo<TcpTransport::Framing> &info) {
+                           return info.param == TcpTransport::Framing::MBAP ? "ModbusTcp" : "RtuOverTcp";
+                         });
+
+TEST(GatewayHub, MbapCarriesTheHubSlaveAddress) {
+  mock_millis = 0;
+  socket::next_connect_pending = false;
+  FakeABC abc;
+  TcpTransport transport(TcpTransport::Framing::MBAP);
+  transport.set_host("192.168.1.50");
+  FakeGateway gateway(&abc, TcpTransport::Framing::MBAP);
+  WaterFurnace hub;
+  hub.set_address(2);
+  hub.set_transport(&transport);
+  hub.setup();
+  for (int i = 0; i < 50; i++) {
+    hub.loop();
+    gateway.pump(socket::last_socket);
+    mock_millis++;
+  }
+  ASSERT_FALSE(gateway.requests.empty());
+  for (const auto &adu : gateway.requests)
+    EXPECT_EQ(adu[6], 2);  // Unit id
+  EXPECT_TRUE(hub.is_setup_complete());
+}